@@ -0,0 +1,451 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the limits on the argument list of a command and
+ *              the batch inbuilt command including:
+ *
+ *               measuring an argument list as execve does
+ *               splitting an argument list that is too long into batches
+ *               that each fit, as xargs does
+ *               running the batches one after the other or up to a limit
+ *               at once
+ *               putting the exit statuses of the batches together into
+ *               one status
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 6.7 and
+ *  27.2, and execve(2) on the limits of the argument list
+ *
+ **************************************************************************/
+
+#include "argumentBatch.h"
+#include "bashShell.h"  /* for the command and launching it */
+
+extern char **environ;
+
+/* Reads a positive whole number of an option up to a limit, returning -1
+ * if it isn't one
+ */
+static int parseCount(char *word, int limit)
+{
+    char *end;
+    long count;
+
+    if (word == NULL)
+    {
+        return -1;
+    }
+
+    errno = 0;
+    count = strtol(word, &end, 10);
+    if (errno != 0 || end == word || *end != '\0' || count <= 0 || count > limit)
+    {
+        return -1;
+    }
+
+    return (int)count;
+}
+
+/* Takes "batch [-n N] [-P N]" off the front of the commandline, leaving
+ * the command.
+ */
+int stripBatchPrefix(char commandLine[], struct batchOptions *options)
+{
+    char *cursor = commandLine + strlen("batch");
+    char *option;
+    char *value;
+    int count;
+    int length;
+
+    options->enabled = true;
+    options->maxArgs = 0;
+    options->maxJobs = 1;
+
+    while (true)
+    {
+        while (isspace((unsigned char)*cursor))
+        {
+            ++cursor;
+        }
+
+        if (strncmp(cursor, "-n", 2) != 0 && strncmp(cursor, "-P", 2) != 0)
+        {
+            break;
+        }
+
+        /* the count is either attached to the option or the next word */
+        option = cursor;
+        value = cursor + 2;
+        if (*value == '\0' || isspace((unsigned char)*value))
+        {
+            while (isspace((unsigned char)*value))
+            {
+                ++value;
+            }
+        }
+
+        length = strcspn(value, " \t\n");
+        if (length == 0)
+        {
+            return -1;
+        }
+
+        cursor = value + length;
+        if (*cursor != '\0')
+        {
+            *cursor++ = '\0';
+        }
+
+        /* -n can be more than fits, which is the same as no -n, but -P is
+         * at most MAX_NUM_ARGS jobs
+         */
+        if ((count = parseCount(value, (option[1] == 'n') ? INT_MAX : MAX_NUM_ARGS)) == -1)
+        {
+            return -1;
+        }
+
+        if (option[1] == 'n')
+        {
+            options->maxArgs = count;
+        }
+        else
+        {
+            options->maxJobs = count;
+        }
+    }
+
+    /* there must be a command to run */
+    if (*cursor == '\0')
+    {
+        return -1;
+    }
+
+    /* shift the command to the start of the commandline */
+    memmove(commandLine, cursor, strlen(cursor) + 1);
+
+    return 0;
+}
+
+/* Returns the bytes execve needs for the arguments: each string, its '\0'
+ * and its pointer.
+ */
+size_t argumentListSize(char *args[], int numArgs)
+{
+    size_t size = 0;
+    int i;
+
+    for (i = 0; i < numArgs; i++)
+    {
+        size += strlen(args[i]) + 1 + sizeof(char *);
+    }
+
+    return size;
+}
+
+/* Returns the bytes left under ARG_MAX for arguments once the environment
+ * and ARG_HEADROOM are taken off.
+ */
+size_t argumentSpace(void)
+{
+    long argMax = sysconf(_SC_ARG_MAX);
+    size_t used = ARG_HEADROOM;
+    char **variable;
+
+    for (variable = environ; variable != NULL && *variable != NULL; variable++)
+    {
+        used += strlen(*variable) + 1 + sizeof(char *);
+    }
+
+    if (argMax <= 0 || (size_t)argMax <= used)
+    {
+        return 0;
+    }
+
+    return (size_t)argMax - used;
+}
+
+/* Returns true if a single argument is longer than the kernel takes */
+static bool hasLongArgument(char *args[], int numArgs)
+{
+    int i;
+
+    for (i = 0; i < numArgs; i++)
+    {
+        if (strlen(args[i]) >= ARG_MAX_STRLEN)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Returns true if the arguments can be passed to a single execve. */
+bool argumentListFits(char *args[], int numArgs)
+{
+    /* the args array ends with a NULL pointer */
+    return numArgs < MAX_NUM_ARGS && !hasLongArgument(args, numArgs)
+           && argumentListSize(args, numArgs) + sizeof(char *) <= argumentSpace();
+}
+
+/* Fills argv with the fixed arguments and as many of the rest from next on
+ * as fit, returning the number of arguments in argv.
+ */
+static int fillBatch(struct command *command, int numFixed, size_t fixedSize, size_t space,
+                     int *next, char *argv[])
+{
+    int numBatchArgs = numFixed;
+    size_t size = fixedSize;
+    size_t argSize;
+    int numItems = 0;
+
+    while (*next < command->numArgs && numBatchArgs < MAX_NUM_ARGS - 1
+           && (command->batch.maxArgs == 0 || numItems < command->batch.maxArgs))
+    {
+        argSize = strlen(command->args[*next]) + 1 + sizeof(char *);
+        if (size + argSize > space)
+        {
+            break;
+        }
+
+        argv[numBatchArgs++] = command->args[(*next)++];
+        size += argSize;
+        ++numItems;
+    }
+
+    argv[numBatchArgs] = NULL;
+
+    return numBatchArgs;
+}
+
+/* Waits for one of the running batches to finish, returning its index.
+ * A single batch is waited on with its time limit; parallel batches are
+ * waited on through their pidfds.
+ */
+static int waitForBatch(struct command *command, pid_t pids[], int pidfds[], int numRunning,
+                        int *childExitMethod, bool *timedOut)
+{
+    struct pollfd pollFds[MAX_NUM_ARGS];
+    bool havePidfds = true;
+    int numPollFds = 0;
+    int i;
+
+    *timedOut = false;
+
+    if (command->batch.maxJobs == 1)
+    {
+        waitWithTimeout(pids[0], childExitMethod, command->timeout, command->killAfter, timedOut);
+        return 0;
+    }
+
+    while (true)
+    {
+        for (i = 0; i < numRunning; i++)
+        {
+            if (waitpid(pids[i], childExitMethod, WNOHANG) > 0)
+            {
+                return i;
+            }
+        }
+
+        numPollFds = 0;
+        for (i = 0; i < numRunning; i++)
+        {
+            if (pidfds[i] == NO_PIDFD)
+            {
+                havePidfds = false;
+                continue;
+            }
+            pollFds[numPollFds].fd = pidfds[i];
+            pollFds[numPollFds].events = POLLIN;
+            pollFds[numPollFds].revents = 0;
+            ++numPollFds;
+        }
+
+        if (poll(pollFds, numPollFds, havePidfds ? -1 : BATCH_POLL_FALLBACK) == -1 && errno != EINTR)
+        {
+            perror("poll() unsuccessful");
+        }
+    }
+}
+
+/* Puts the counts of the batches that failed or were signaled into one
+ * exit status, as xargs does.
+ */
+static void reportBatches(struct shellState *shell, int numBatches, int numFailed, int numSignaled,
+                          int lastSignal)
+{
+    if (numSignaled > 0)
+    {
+        shell->lastStatus = BATCH_SIGNALED;
+        snprintf(shell->exitStatusStr, STATUS_LENGTH, "terminated by signal %d in %d of %d batches",
+                 lastSignal, numSignaled, numBatches);
+        printf("%s\n", shell->exitStatusStr);
+    }
+    else if (numFailed > 0)
+    {
+        shell->lastStatus = BATCH_FAILED;
+        snprintf(shell->exitStatusStr, STATUS_LENGTH, "exit value %d, %d of %d batches failed",
+                 BATCH_FAILED, numFailed, numBatches);
+    }
+    else
+    {
+        shell->lastStatus = 0;
+        sprintf(shell->exitStatusStr, "exit value %d", 0);
+    }
+}
+
+/* Runs a command in foreground batches that each fit, or prints an error
+ * if the command wasn't run with batch, and sets the exit status of the
+ * shell.
+ */
+void runBatches(struct shellState *shell, struct command *command)
+{
+    /* The command and the arguments before the first one from a $(...)
+     * are in every batch
+     */
+    int numFixed = (command->firstSubstitutedArg > 0) ? command->firstSubstitutedArg : 1;
+    size_t space = argumentSpace();
+    size_t fixedSize = argumentListSize(command->args, numFixed) + sizeof(char *);
+    char *argv[MAX_NUM_ARGS];
+    pid_t pids[MAX_NUM_ARGS];
+    int pidfds[MAX_NUM_ARGS];
+    int numRunning = 0;
+    int numBatches = 0;
+    int numFailed = 0;
+    int numSignaled = 0;
+    int lastSignal = 0;
+    int next = numFixed;  /* the first argument not yet in a batch */
+    int numBatchArgs;
+    int childExitMethod;
+    int terminationSignal;
+    bool timedOut;
+    bool tooLong = false;
+    sigset_t blockSet, prevMask;
+    pid_t spawnPid;
+    int i;
+
+    if (command->batch.enabled == false || hasLongArgument(command->args, command->numArgs)
+        || numFixed >= MAX_NUM_ARGS - 1 || fixedSize > space)
+    {
+        fprintf(stderr, "%s: argument list too long: %d arguments of %zu bytes, the most is %d "
+                "arguments of %zu bytes and %d bytes each%s\n", command->args[0], command->numArgs,
+                argumentListSize(command->args, command->numArgs), MAX_NUM_ARGS - 1, space,
+                ARG_MAX_STRLEN - 1, (command->batch.enabled == false) ? "; run it with batch" : "");
+        sprintf(shell->exitStatusStr,"exit value %d",BATCH_TOO_LONG);
+        shell->lastStatus = BATCH_TOO_LONG;
+        return;
+    }
+
+    if (command->batch.maxJobs > 1 && command->haveTimeout == true)
+    {
+        printf("timeout: ignored for parallel batches\n");
+    }
+
+    /* The batches share the files, so there is no one command whose output
+     * a thread of the shell could compress
+     */
+    if (hasCompressedOutput(&command->redirections))
+    {
+        fprintf(stderr, "batch: >z isn't supported for batches\n");
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
+
+    /* The files are opened once so every batch writes to the same ones */
+    if (openRedirections(&command->redirections) == -1)
+    {
+        closeRedirections(&command->redirections);
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
+
+    for (i = 0; i < numFixed; i++)
+    {
+        argv[i] = command->args[i];
+    }
+
+    /* ^Z waits until the batches have run, as for a foreground job */
+    sigemptyset(&blockSet);
+    sigaddset(&blockSet, SIGTSTP);
+    sigprocmask(SIG_BLOCK, &blockSet, &prevMask);
+
+    /* A command without any arguments to split runs once */
+    while (numRunning > 0 || (tooLong == false && (next < command->numArgs || numBatches == 0)))
+    {
+        while (tooLong == false && numRunning < command->batch.maxJobs
+               && (next < command->numArgs || numBatches == 0))
+        {
+            numBatchArgs = fillBatch(command, numFixed, fixedSize, space, &next, argv);
+
+            if (numBatchArgs == numFixed && next < command->numArgs)
+            {
+                tooLong = true;
+                break;
+            }
+
+            fflush(stdout);
+
+            spawnPid = fork();
+            if (spawnPid == -1)
+            {
+                perror("Error creating fork\n");
+                exit(1);
+            }
+            if (spawnPid == 0)
+            {
+                command->args = argv;
+                command->numArgs = numBatchArgs;
+                execCommand(command);
+                exit(1);
+            }
+
+            shell->foregroundPID = spawnPid;
+            pids[numRunning] = spawnPid;
+            pidfds[numRunning] = (command->batch.maxJobs > 1) ? pidfdOpen(spawnPid) : NO_PIDFD;
+            ++numRunning;
+            ++numBatches;
+        }
+
+        if (numRunning == 0)
+        {
+            break;
+        }
+
+        i = waitForBatch(command, pids, pidfds, numRunning, &childExitMethod, &timedOut);
+
+        terminationSignal = 0;
+        if (terminationStatus(childExitMethod, shell->exitStatusStr, &terminationSignal) != 0)
+        {
+            ++numFailed;
+        }
+        if (terminationSignal != 0 || timedOut == true)
+        {
+            ++numSignaled;
+            lastSignal = terminationSignal;
+        }
+
+        /* keep the running batches at the front */
+        if (pidfds[i] != NO_PIDFD)
+        {
+            close(pidfds[i]);
+        }
+        --numRunning;
+        pids[i] = pids[numRunning];
+        pidfds[i] = pidfds[numRunning];
+    }
+
+    sigprocmask(SIG_SETMASK, &prevMask, NULL);
+    closeRedirections(&command->redirections);
+
+    if (tooLong == true)
+    {
+        fprintf(stderr, "%s: argument %d doesn't fit in a batch\n", command->args[0], next);
+        sprintf(shell->exitStatusStr,"exit value %d",BATCH_TOO_LONG);
+        shell->lastStatus = BATCH_TOO_LONG;
+        return;
+    }
+
+    reportBatches(shell, numBatches, numFailed, numSignaled, lastSignal);
+}
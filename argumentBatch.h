@@ -0,0 +1,112 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the limits on the argument list of a command and
+ *              the batch inbuilt command including:
+ *
+ *               measuring an argument list as execve does, against the
+ *               kernel's ARG_MAX less the environment and against
+ *               MAX_NUM_ARGS
+ *               splitting an argument list that is too long into batches
+ *               that each fit, as xargs does
+ *               running the batches one after the other or up to a limit
+ *               at once
+ *               putting the exit statuses of the batches together into
+ *               one status
+ *
+ *              "batch [-n N] [-P N] command args" runs the command once for
+ *              every N of its arguments, with N jobs at once. The command
+ *              and the arguments before the first one from a $(...) are
+ *              repeated in every batch. Without -n each batch holds as many
+ *              arguments as fit. Any other command whose argument list
+ *              doesn't fit isn't run.
+ *
+ **************************************************************************/
+
+#ifndef ARGUMENT_BATCH_H
+#define ARGUMENT_BATCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>      /* for INT_MAX */
+#include <poll.h>        /* for waiting on the pidfds of parallel batches */
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <signal.h>      /* for holding ^Z while batches run */
+
+/* The room left under ARG_MAX for the kernel's own use, as xargs leaves */
+#define ARG_HEADROOM 2048
+
+/* The longest single argument the kernel takes, MAX_ARG_STRLEN, which is
+ * 32 pages of 4096 bytes
+ */
+#define ARG_MAX_STRLEN (32 * 4096)
+
+/* The exit statuses of batch, as in xargs:
+ * BATCH_FAILED     a batch exited with 1 - 125
+ * BATCH_SIGNALED   a batch was terminated by a signal
+ * BATCH_TOO_LONG   an argument list couldn't be made to fit
+ * BATCH_USAGE_ERROR  the options of batch aren't valid
+ */
+#define BATCH_FAILED 123
+#define BATCH_SIGNALED 125
+#define BATCH_TOO_LONG 126
+#define BATCH_USAGE_ERROR 2
+
+/* The poll interval in milliseconds when a batch has no pidfd */
+#define BATCH_POLL_FALLBACK 10
+
+/* How a command is split into batches */
+struct batchOptions
+{
+    bool enabled;  /* true if the command was run with batch */
+    int maxArgs;  /* -n, or 0 for as many as fit */
+    int maxJobs;  /* -P, the batches run at once */
+};
+
+struct shellState;
+struct command;
+
+/* Takes "batch [-n N] [-P N]" off the front of the commandline, leaving
+ * the command.
+ * input: the commandline: char[]
+ *        the options to fill in: struct batchOptions *
+ * output: 0 if successful or -1 if the options aren't valid or there is no
+ *         command
+ */
+int stripBatchPrefix(char commandLine[], struct batchOptions *options);
+
+/* Returns the bytes execve needs for the arguments: each string, its '\0'
+ * and its pointer.
+ * input: the arguments: char *[]
+ *        the number of arguments: int
+ */
+size_t argumentListSize(char *args[], int numArgs);
+
+/* Returns the bytes left under ARG_MAX for arguments once the environment
+ * and ARG_HEADROOM are taken off.
+ */
+size_t argumentSpace(void);
+
+/* Returns true if the arguments can be passed to a single execve: there
+ * are fewer than MAX_NUM_ARGS, no argument is longer than ARG_MAX_STRLEN
+ * and together they fit in argumentSpace.
+ * input: the arguments: char *[]
+ *        the number of arguments: int
+ */
+bool argumentListFits(char *args[], int numArgs);
+
+/* Runs a command in foreground batches that each fit, or prints an error
+ * if the command wasn't run with batch, and sets the exit status of the
+ * shell.
+ * input: the shell: struct shellState *
+ *        the parsed command: struct command *
+ */
+void runBatches(struct shellState *shell, struct command *command);
+
+#endif
@@ -5,19 +5,48 @@
  *
  *               Emulates a bash shell with the following functionality:
  *
- *               Inbuilt cd, status and exit commands
+ *               Inbuilt cd, status, exit, exec, timeout, jobs, wait,
+ *               kill, cached, dag, batch, history, alias, unalias,
+ *               return, jtop, every and at commands
+ *
+ *               Command lists joined by ;, && and || on one commandline.
+ *
+ *               for and while loops whose commands are parsed once.
+ *
+ *               Functions and aliases that are parsed once and run in the
+ *               shell's own process.
+ *
+ *               Commandlines from a script or pipe are parsed on a thread
+ *               while the last command runs.
  *
  *               The ability to put jobs in the background by putting & at 
  *               the end of a commandline.
  *
- *               Redirection <, > from/to input/output files.
+ *               Redirection <, >, >>, N<, N>, N>>, N>&M, &> and &>> from/to
+ *               input/output files and other file descriptors. Output sent
+ *               to several files, as in > a > b, is copied into each.
+ *
+ *               Here-documents <<WORD and here-strings <<< word.
  *
  *               Enforce foreground jobs exclusively using ^Z to enter and
  *               exit this mode.
  *
  *               Kill running jobs using ^C.
  *
- *               $$ expansion is supported.
+ *               $$ expansion and $(command) substitution are supported.
+ *
+ *               A time limit on foreground jobs, either per command with
+ *               timeout or for every job with the -t option.
+ *
+ *               Running a script file given on the commandline. Scripts
+ *               are compiled into a cache so later runs skip parsing.
+ *
+ *               The last command of a script or of -c is exec'd in place
+ *               of the shell rather than forked.
+ *
+ *               All state is held in struct shellState, so the shell is
+ *               built as a library that can run many sessions in one
+ *               process.
  *
  *  The book The Linux Programming Interface by Kerrisk was heavily 
  *  referenced in the development of the following code as well as the course
@@ -28,111 +57,883 @@
 
 #include "bashShell.h"
 
-/* Signal catcher for SIGTSTP. Sets a global atomic variable and prints a message
- * when activated.
+/* Initializes the state of the shell to read commandlines from stdin with a
+ * prompt.
  */
-static void catchSIGTSTP(int theSignal)
+void initializeShell(struct shellState *shell)
 {
-    char* messageEnter = "Entering foreground-only mode (& is now ignored)\n";
-    char* messageLeave = "Exiting foreground-only mode\n";
-    char* prompt = ": ";
+    /* Create and initialize the dynamic arrays of the job table */
+    initializeJobTable(&shell->jobs, ARRAY_CAPACITY_BG);
 
-    /* If the process is not in foreground only mode then put it in foreground
-    * only mode by setting canPutInBackground to FALSE and printing messageEnter.
+    /* If status is run before any foreground command is run then it should
+     * return exit status 0
      */
-    if (canPutInBackground == TRUE)  
-    {
-        write(STDOUT_FILENO, messageEnter, 49);
-        write(STDOUT_FILENO, prompt, 2);
-        canPutInBackground = FALSE;
-    }
-    /* If the process is in foreground only mode then take it out of foreground
-     * only mode by setting canPutInBackground to TRUE and printing messageLeave.
+    memset(shell->exitStatusStr,'\0', STATUS_LENGTH);
+    strcpy(shell->exitStatusStr,"exit value 0 \n");  /* sprintf is slow to first call */
+
+    /* https://stackoverflow.com/questions/2595503/determine-pid-of-terminated-process */
+    shell->parentPID = getpid();
+
+    shell->foregroundPID = UNDEFINED;
+    shell->jobDeadline = NO_TIMEOUT;
+
+    /* The shared slots are only mapped when the first background job is
+     * launched
      */
-    else if (canPutInBackground == FALSE)
-    {
-        write(STDOUT_FILENO, messageLeave, 29);
-        canPutInBackground = TRUE;
-        write(STDOUT_FILENO, prompt, 2); 
-    }  
-    
+    shell->jobSlotLimit = jobSlotLimit();
+    shell->input = stdin;
+    shell->prompt = true;
+    shell->parseAhead = true;
+    shell->exitRequested = false;
+    shell->lastStatus = 0;
+    shell->lastLine = false;
+    shell->tailCommand = false;
+    shell->foregroundOnly = FALSE;
+    shell->embedded = false;
+    shell->stdioFds[0] = -1;
+    shell->stdioFds[1] = -1;
+    shell->stdioFds[2] = -1;
+    initializeHistory(&shell->history);
+    initializeFunctions(&shell->functions);
+    initializeJobMonitor(&shell->monitor);
+    initializeSchedule(&shell->schedule);
+    initializeLauncher(&shell->launcher);
+    shell->lastBackgroundPid = 0;
 }
 
-int main(int argc, char *argv[])
+/* Reads commandlines from the shell's input and runs them until the user
+ * exits or, unless the input is a terminal, the input ends.
+ */
+void runShell(struct shellState *shell)
 {
-    char *buffer;  /* used to hold the string returned by getLine */
-
-    char bufferExpanded[MAX_COMMAND_LINE];
+    char *buffer = NULL;  /* used to hold the string returned by getLine */
 
-    size_t bufferSize;  /* set to 0 so getLine will read an arbitrary length */
+    size_t bufferSize = 0;  /* set to 0 so getLine will read an arbitrary length */
 
     ssize_t lineSize; /* length of the line returned by getLine */
 
-    /* resource: https://www.tutorialspoint.com/c_standard_library/c_function_strtok.htm*/
-    char *token; /* Use to hold tokens extracted from the commandline with strtok*/
+    /* The commandline run, which is the line read or the line of the
+     * history it refers to with !
+     */
+    char *line;
+    char historyExpanded[MAX_COMMAND_LINE];
+    int historyStatus;
+
+    /* When the input isn't a terminal there is no user to wait for, so the
+     * next commandlines are read and parsed on a thread while each command
+     * runs. A terminal is read one line at a time as the user types. The
+     * history needs each line added before the next is expanded, so it
+     * reads one line at a time too.
+     */
+    if (shell->parseAhead == true && shell->history.enabled == false
+        && !isatty(fileno(shell->input)) && runShellAhead(shell) == 0)
+    {
+        return;
+    }
 
-    /* Holds the commandline arguments that are passed to execvp */
-    char *args[MAX_NUM_ARGS]; 
+    /***** The shell itself.******
+    * When the user exits the shell this loop is broken out of.
+    * The reference for the general structure of the code for the shell is:
+    * The Linux Programming Interface by Kerrisk, Chapter 27 and pg 581
+    */
+    while (shell->exitRequested == false)
+    {
+        reapBackgroundJobs(shell);
+        runDueEntries(shell);
 
-    /* the size of the string pointed to by an element of the args pointer array */
-    int argSize; 
+        /* flush the output stream and print the commandline prompt */
+        fflush(stdout);
+        if (shell->prompt == true)
+        {
+            printf(": ");
+        }
 
-    int i, index=0; /* used for array element access */
+        /* Scheduled commands run while the shell waits for the next line */
+        waitForInput(shell);
 
-    /* holds the status after trying to expand $$ in the commandline string */
-    enum expandStatus expandstatus; 
+        /* Read in the commandline using getline and store in the variable buffer */
+        /*resource:  http://man7.org/linux/man-pages/man3/getline.3.html */
+        lineSize = getline(&buffer, &bufferSize, shell->input);
 
-    bool haveInput = false; /* true if user enters < */
-    bool haveOutput = false; /* true if user enters > */
-    bool inBackground = false; /* true if process is in the background */
+        if (lineSize < 0 )  /* getline returns -1 at the end of input */
+        {
+            /* At a terminal keep reading after ^D, otherwise the input has ended
+             * so exit as if the user entered "exit"
+             * https://www.tutorialspoint.com/c_standard_library/c_function_clearerr.htm
+             */
+            if (isatty(fileno(shell->input)))
+            {
+                clearerr(shell->input);
+            }
+            else
+            {
+                runScheduleToEnd(shell);
+                exitShell(shell);
+            }
+        }
+        else
+        {
+            /* The lines of a loop or function up to its end are run as
+             * one commandline
+             */
+            readBlockLines(shell->input, &buffer, &bufferSize, shell->prompt);
 
-    /* used to indicate if an arguement can't be run in the background */
-    bool noBackground = false;  
+            /* A commandline starting with ! is replaced by a line of the
+             * history
+             */
+            line = buffer;
+            historyStatus = expandHistory(&shell->history, buffer, historyExpanded, MAX_COMMAND_LINE);
+            if (historyStatus == -1)
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",1);
+                shell->lastStatus = 1;
+                continue;
+            }
+            if (historyStatus == 1)
+            {
+                line = historyExpanded;
+            }
 
-    int execvpReturn; /* return value from calling execvp() */
+            /* The last commandline of a script can exec its last command */
+            shell->lastLine = atEndOfInput(shell->input);
+            runCommandLine(shell, line);
+            shell->lastLine = false;
 
-    int terminationSignal= 0; /* the value is 0 or that of a sent signal */
+            /* The commandline is added once it has run, so history -s
+             * doesn't find itself
+             */
+            addHistory(&shell->history, line);
+        }
+    }
 
-    /* Arg to hold the termination/exit signal for a background process */
-    int terminationSignalBg= 0;  
+    /* free the buffer, which is used to store the commandline */
+    free(buffer);
+}
+
+/* Reaps any finished background jobs of the shell, printing their exit or
+ * termination status and removing them from the job table. Children that
+ * aren't the shell's jobs are left alone.
+ */
+void reapBackgroundJobs(struct shellState *shell)
+{
+    pid_t waitPidReturn; /* the return value from calling waitpid() */
 
     /* use to get process exit and termination information after using the waitpid() function */
     int childExitMethod = -5; 
 
-    /* stores process exit and termination information that is printed to stdout */
-    char exitStatusStr[STATUS_LENGTH]; 
+    /* Arg to hold the termination/exit signal for a background process */
+    int terminationSignalBg= 0;  
 
     /* For a background process: stores process exit and termination information that 
      *is printed to stdout 
      */
     char exitStatusStrBg[STATUS_LENGTH];
-    
-    pid_t spawnPid = -5; /* process number returned by calling fork() */
-    pid_t parentPID; /* process number of the bashShell program */
-    pid_t foregroundPID; /* process number of the foreground process */
 
-    pid_t waitPidReturn; /* the return value from calling waitpid() */
+    int i;
 
-    pid_t *pidReturn; /* A dynamic array holding all active background process PIDs */
+    /* Each job of the table is waited on by its PID with WNOHANG rather than
+     * waiting for any child with -1, so a program hosting several sessions
+     * never reaps another session's job. Without jobs no waitpid is made.
+     * Resources:
+     * The Linux Programming Interface by Kerrisk pg 556
+     * https://www.gnu.org/software/libc/manual/html_node/Process-Completion.html
+     */
+    for (i = 0; i < shell->jobs.capacity && shell->jobs.numJobs > 0; i++)
+    {
+        if (shell->jobs.pids[i] == BG_UNDEFINED)
+        {
+            continue;
+        }
 
-    int pidReturnCapacity = ARRAY_CAPACITY_BG; /* size of the pidReturn array */
+        waitPidReturn = waitpid(shell->jobs.pids[i], &childExitMethod, WNOHANG);
+        if (waitPidReturn > 0)
+        {
+            /* Get the termination or exit status and put in the char * exitStatusStrBg */
+            terminationStatus(childExitMethod, exitStatusStrBg, &terminationSignalBg);
+            /* Print the exit or termination status of the background process */
+            printf("background pid %d is done: %s\n", waitPidReturn, exitStatusStrBg);
+            /* Reset the job table element that held the background PID to
+             * BG_UNDEFINED and close its pidfd
+             */
+            removeJob(&shell->jobs, waitPidReturn);
+        }
+    }
+}
 
-    int numProcesses = 0; /* the number of currently active background processes*/
-    
-    /* the file name of the input file from which input is to be redirected from */
-    char fileNameIn[MAX_FILE_NAME]; 
+/* Kills any remaining background jobs and tells the shell to exit. */
+void exitShell(struct shellState *shell)
+{
+    /* The SIGTERM signal is sent through each job's pidfd, so a job that has
+     * already finished and had its PID reused by another process can't be hit.
+     */
+    signalAllJobs(&shell->jobs, SIGTERM);
+
+    shell->exitRequested = true;
+}
+
+/* Expands $$ in a commandline, splits it into a list of commands at ;, &&
+ * and || and runs each command whose connector allows it.
+ */
+void runCommandLine(struct shellState *shell, char *commandLine)
+{
+    char bufferExpanded[MAX_COMMAND_LINE_EXPANDED];
+
+    /* holds the status after trying to expand $$ in the commandline string */
+    enum expandStatus expandstatus; 
+
+    /* The commands of the commandline with the connector joining each */
+    struct commandList list;
+
+    int i;
+
+    /* Expand occurences of $$ in the commandline string */ 
+    expandstatus = expandString(commandLine, shell->parentPID, bufferExpanded);
+
+    /* If the commandline exceeds the maximum allowed length print a message and 
+     * bring the user back to the prompt.
+     */
+    if (expandstatus == commandLineTooLong )
+    {
+        printf("The command line has a maximum length of %d\n",MAX_COMMAND_LINE );
+        shell->lastStatus = 1;
+        return;
+    }
+
+    /* A comment line is never split up, so a ; in the comment does nothing */
+    if (classifyCommandLine(bufferExpanded) == commentLine)
+    {
+        return;
+    }
+
+    /* The whole commandline is split once, before any command runs */
+    if (splitCommandList(bufferExpanded, &list, true) == -1)
+    {
+        shell->lastStatus = LIST_SYNTAX_ERROR;
+        return;
+    }
+
+    /* A command after && or || is skipped depending on the exit status of the
+     * last command that ran, and skipping it leaves that status unchanged.
+     */
+    for (i = 0; i < list.count && shell->exitRequested == false; i++)
+    {
+        /* Nothing runs after the last command of the last commandline */
+        shell->tailCommand = (shell->lastLine == true && i == list.count - 1);
+
+        if (listCommandRuns(list.commands[i].connector, shell->lastStatus))
+        {
+            runListCommand(shell, list.commands[i].text);
+        }
+        else
+        {
+            skipListCommand(shell, list.commands[i].text);
+        }
+    }
+
+    shell->tailCommand = false;
+}
+
+/* Runs a single $$ expanded command of a list, either as an inbuilt command
+ * or by launching it as a foreground or background process, and sets the
+ * exit status of the shell.
+ */
+void runListCommand(struct shellState *shell, char commandText[])
+{
+    /* resource: https://www.tutorialspoint.com/c_standard_library/c_function_strtok.htm*/
+    char *token; /* Use to hold tokens extracted from the commandline with strtok_r*/
+    char *savePosition; /* where strtok_r continues from, so parsing is thread safe */
+
+    /* The parsed commandline that is launched as a process */
+    struct command command;
+
+    /* The outputs of the $(...) of the command */
+    struct substitutionList substitutions;
+
+    /* An inbuilt command's text with the outputs of its $(...) put back in */
+    char splicedText[MAX_COMMAND_LINE_EXPANDED];
+
+    enum lineType type;
+
+    int exitValue; /* the N of "exit N" */
+
+    initializeCommand(&command, shell->jobDeadline);
+    initializeSubstitutions(&substitutions);
+
+    /* Each $(...) is run before the command. Commands get the words of the
+     * outputs as arguments from parseArguments, while inbuilt commands read
+     * them from their text. A loop runs the $(...) of its words and of its
+     * commands itself, when they are used, and those of a function or alias
+     * run each time it is called.
+     */
+    type = classifyCommandLine(commandText);
+    if (hasSubstitution(commandText) && type != loopLine && type != functionLine && type != aliasLine)
+    {
+        if (runSubstitutions(shell, commandText, &substitutions) == -1)
+        {
+            sprintf(shell->exitStatusStr,"exit value %d",1);
+            shell->lastStatus = 1;
+            freeSubstitutions(&substitutions);
+            return;
+        }
+
+        command.substitutions = &substitutions;
+
+        if (type != externalLine && type != timeoutLine && type != execLine && type != batchLine)
+        {
+            if (spliceSubstitutions(&substitutions, commandText, splicedText, MAX_COMMAND_LINE_EXPANDED) == -1)
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",1);
+                shell->lastStatus = 1;
+                freeSubstitutions(&substitutions);
+                return;
+            }
+            commandText = splicedText;
+        }
+    }
+
+    switch (classifyCommandLine(commandText))
+    {
+        /* If the commandline starts with "timeout" then take the time limit off
+         * the front and run the rest of the commandline as the command. The
+         * commandline is only left alone here if the time limit isn't valid.
+         */
+        case timeoutLine:
+        {
+            if (stripTimeoutPrefix(commandText, &command.timeout, &command.killAfter) == -1)
+            {
+                printf("usage: timeout [-k DURATION] DURATION command\n");
+                sprintf(shell->exitStatusStr,"exit value %d",TIMEOUT_USAGE_ERROR);
+                shell->lastStatus = TIMEOUT_USAGE_ERROR;
+                break;
+            }
+
+            command.haveTimeout = true;
+
+            /* Time limits only apply to commands, so run an inbuilt command as usual */
+            if (classifyCommandLine(commandText) != externalLine)
+            {
+                runListCommand(shell, commandText);
+                break;
+            }
+
+            if (parseArguments(commandText, &command) == 0)
+            {
+                launchCommand(shell, &command);
+            }
+            else
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",1);
+                shell->lastStatus = 1;
+            }
+            break;
+        }
+        /*If the commandline is "exit" then clean up and exit from the program.
+         * As in bash "exit N" exits with N and "exit" with the status of the
+         * last command.
+         */
+        case exitLine:
+        {
+            if (sscanf(commandText + strlen("exit"), "%d", &exitValue) == 1)
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",exitValue);
+                shell->lastStatus = exitValue;
+            }
+            exitShell(shell);
+            break;
+        }
+        /* If the user enters a comment(starts with #) or nothing then do nothing */
+        case commentLine:
+        {
+            break;
+        }
+        /* If the user enters "cd" then change to the indicated directory or HOME*/
+        case cdLine:
+        {
+            /* Get the next argument on the commandline by splitting it into
+             * space delimited tokens.
+             */
+
+             /* First, ignore the word "cd" */
+            token = strtok_r(commandText, " \n", &savePosition); 
+
+            /* Then get the next token, if any */
+            token = strtok_r(NULL, " \n", &savePosition); /* get next token */
+
+            /* If there isn't a next token then move the user to their HOME directory */
+            if ( token == NULL)  /* if there isn't an arg provided to cd then move to HOME*/
+            {
+                /*resource: https://www.tutorialspoint.com/c_standard_library/c_function_getenv.htm */
+                /* resource: https://www.geeksforgeeks.org/chdir-in-c-language-with-examples/ */
+                token = getenv("HOME");
+            }
+
+            /* Move into the directory. A failed cd stops a following && command
+             * from running in the wrong directory.
+             */
+            if (token == NULL || chdir(token) == -1)
+            {
+                fprintf(stderr, "cd: %s: %s\n", (token == NULL) ? "HOME" : token,
+                        (token == NULL) ? "not set" : strerror(errno));
+                shell->lastStatus = 1;
+            }
+            else
+            {
+                shell->lastStatus = 0;
+            }
+            break;
+        }
+        /* List the background jobs with their job numbers, or with -l
+         * their state, CPU and memory. jtop refreshes the sample.
+         */
+        case jobsLine:
+        case monitorLine:
+        {
+            shell->lastStatus = monitorBuiltin(shell, commandText);
+            if (shell->lastStatus != 0)
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",shell->lastStatus);
+            }
+            break;
+        }
+        /* Schedule a command to run every INTERVAL or at a TIME, list the
+         * entries or cancel them
+         */
+        case scheduleLine:
+        {
+            shell->lastStatus = scheduleBuiltin(shell, commandText);
+            sprintf(shell->exitStatusStr,"exit value %d",shell->lastStatus);
+            break;
+        }
+        /* Wait for background jobs to finish */
+        case waitLine:
+        {
+            shell->lastStatus = waitBuiltin(&shell->jobs, commandText, shell->exitStatusStr);
+            break;
+        }
+        /* Send a signal to a background job by %n or to a PID */
+        case killLine:
+        {
+            shell->lastStatus = killBuiltin(&shell->jobs, commandText, shell->exitStatusStr);
+            break;
+        }
+        /* Run the command in place of the shell */
+        case execLine:
+        {
+            /* The rest of the commandline after "exec" is the command. A
+             * trailing & is ignored since there is no shell left to track
+             * the job.
+             */
+            if (parseArguments(commandText + strlen("exec"), &command) == -1)
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",1);
+                shell->lastStatus = 1;
+                break;
+            }
+
+            /* bash would redirect the shell itself, which isn't supported */
+            if (command.numArgs == 0 && command.redirections.count > 0)
+            {
+                printf("usage: exec command [arguments] [redirections]\n");
+                sprintf(shell->exitStatusStr,"exit value %d",EXEC_USAGE_ERROR);
+                shell->lastStatus = EXEC_USAGE_ERROR;
+                break;
+            }
+
+            command.inBackground = false;
+            command.replaceShell = true;
+            launchCommand(shell, &command);
+            break;
+        }
+        /* Restore the output of a command from the result cache, or run
+         * the command and store its output
+         */
+        case cachedLine:
+        {
+            cachedBuiltin(shell, commandText);
+            break;
+        }
+        /* Run a file of named commands in the order of their
+         * dependencies
+         */
+        case dagLine:
+        {
+            shell->lastStatus = dagBuiltin(shell, commandText);
+            sprintf(shell->exitStatusStr,"exit value %d",shell->lastStatus);
+            break;
+        }
+        /* Take the batch options off the front of the commandline and run
+         * the rest as the command, split into batches of its arguments
+         */
+        case batchLine:
+        {
+            if (stripBatchPrefix(commandText, &command.batch) == -1
+                || classifyCommandLine(commandText) != externalLine)
+            {
+                printf("usage: batch [-n N] [-P N] command [args]\n");
+                sprintf(shell->exitStatusStr,"exit value %d",BATCH_USAGE_ERROR);
+                shell->lastStatus = BATCH_USAGE_ERROR;
+                break;
+            }
+
+            /* Batches always run in the foreground */
+            if (parseArguments(commandText, &command) == 0)
+            {
+                command.inBackground = false;
+                launchCommand(shell, &command);
+            }
+            else
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",1);
+                shell->lastStatus = 1;
+            }
+            break;
+        }
+        /* List the history or search it */
+        case historyLine:
+        {
+            shell->lastStatus = historyBuiltin(&shell->history, commandText);
+            sprintf(shell->exitStatusStr,"exit value %d",shell->lastStatus);
+            break;
+        }
+        /* Run a for or while loop */
+        case loopLine:
+        {
+            loopBuiltin(shell, commandText);
+            break;
+        }
+        /* Define a function from NAME() { COMMANDS; } */
+        case functionLine:
+        {
+            functionBuiltin(shell, commandText);
+            break;
+        }
+        /* List, print or define aliases */
+        case aliasLine:
+        {
+            aliasBuiltin(shell, commandText);
+            break;
+        }
+        /* Remove aliases */
+        case unaliasLine:
+        {
+            unaliasBuiltin(shell, commandText);
+            break;
+        }
+        /* Leave the function that is running */
+        case returnLine:
+        {
+            returnBuiltin(shell, commandText);
+            break;
+        }
+        /* Print the latest status or terminating signal number, if the 
+         * user enters "status" on the commandline
+         */
+        case statusLine:
+        {
+           /* The latest status is stored in exitStatusStr */
+            printf("%s\n",shell->exitStatusStr);
+            shell->lastStatus = 0;
+            break;
+        }
+        default:
+        {
+            /* The tokenization and parsing of arguments occurs in the parseArguments
+             * function which additionaly parses and sets the appropriate variables
+             * if any of the arguements are redirections or &.
+             */
+            if (parseArguments(commandText, &command) == 0)
+            {
+                launchCommand(shell, &command);
+            }
+            else
+            {
+                sprintf(shell->exitStatusStr,"exit value %d",1);
+                shell->lastStatus = 1;
+            }
+        }
+    }
+
+    /* free the dynamic strings held by the command */
+    freeCommand(&command);
+    freeSubstitutions(&substitutions);
+}
+
+/* Parses a command of a list into a command that can be launched, without
+ * printing any errors, if it is a command or a timeout of a command.
+ */
+bool parseListCommand(char commandText[], struct command *command)
+{
+    enum lineType type = classifyCommandLine(commandText);
+
+    command->reportErrors = false;
 
-    /* The file descriptor returned from opening a file for reading */
-    int inFileDescriptor; 
+    /* A $(...) runs a command, so it waits until the command is run */
+    if (hasSubstitution(commandText))
+    {
+        return false;
+    }
+
+    if (type == timeoutLine)
+    {
+        if (stripTimeoutPrefix(commandText, &command->timeout, &command->killAfter) == -1
+            || classifyCommandLine(commandText) != externalLine)
+        {
+            return false;
+        }
+        command->haveTimeout = true;
+    }
+    else if (type != externalLine)
+    {
+        return false;
+    }
+
+    return parseArguments(commandText, command) == 0;
+}
+
+/* Reads and throws away the body of a here-document of a command that is
+ * skipped by && or ||, so its lines aren't run as commands.
+ */
+void skipListCommand(struct shellState *shell, char commandText[])
+{
+    struct command command;
+    int hereFileDescriptor;
 
-     /* The file name of the output file to which output is to be redirected to */
-    char fileNameOut[MAX_FILE_NAME];
+    initializeCommand(&command, NO_TIMEOUT);
 
-    /* The file descriptor returned from opening a file for writing */
-    int outFileDescriptor; 
+    if (parseListCommand(commandText, &command) == true && command.hereType == hereDocument)
+    {
+        hereFileDescriptor = createHereDocument(shell->input, command.hereWord, shell->parentPID);
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+    }
 
-    /* An absolute or relative path to a directory to move into with the cd command */
-    char cdDirName[MAX_DIR_NAME]; 
+    freeCommand(&command);
+}
+
+/* Returns which inbuilt command the $$ expanded commandline is, or
+ * externalLine if it is a command to launch as a process.
+ */
+enum lineType classifyCommandLine(char commandLine[])
+{
+    if (functionHeader(commandLine) > 0)
+    {
+        return functionLine;
+    }
+    if (strncmp(commandLine,"timeout", strlen("timeout")) == 0
+        && isspace((unsigned char)commandLine[strlen("timeout")]))
+    {
+        return timeoutLine;
+    }
+    if (strncmp(commandLine,"exit", strlen("exit"))== 0)
+    {
+        return exitLine;
+    }
+    if (strncmp(commandLine,"#", strlen("#"))== 0 || commandLine[0] == '\n' || commandLine[0] == '\0')
+    {
+        return commentLine;
+    }
+    if (strncmp(commandLine,"cd",strlen("cd")) == 0 )
+    {
+        return cdLine;
+    }
+    if (isBuiltin(commandLine, "jobs"))
+    {
+        return jobsLine;
+    }
+    if (isBuiltin(commandLine, "jtop"))
+    {
+        return monitorLine;
+    }
+    if (isBuiltin(commandLine, "every") || isBuiltin(commandLine, "at"))
+    {
+        return scheduleLine;
+    }
+    if (isBuiltin(commandLine, "wait"))
+    {
+        return waitLine;
+    }
+    if (isBuiltin(commandLine, "kill"))
+    {
+        return killLine;
+    }
+    if (strncmp(commandLine,"status", strlen("status")) == 0)
+    {
+        return statusLine;
+    }
+    if (isBuiltin(commandLine, "exec"))
+    {
+        return execLine;
+    }
+    if (isBuiltin(commandLine, "cached"))
+    {
+        return cachedLine;
+    }
+    if (isBuiltin(commandLine, "dag"))
+    {
+        return dagLine;
+    }
+    if (isBuiltin(commandLine, "batch"))
+    {
+        return batchLine;
+    }
+    if (isBuiltin(commandLine, "history"))
+    {
+        return historyLine;
+    }
+    if (isBuiltin(commandLine, "for") || isBuiltin(commandLine, "while"))
+    {
+        return loopLine;
+    }
+    if (isBuiltin(commandLine, "alias"))
+    {
+        return aliasLine;
+    }
+    if (isBuiltin(commandLine, "unalias"))
+    {
+        return unaliasLine;
+    }
+    if (isBuiltin(commandLine, "return"))
+    {
+        return returnLine;
+    }
+
+    return externalLine;
+}
+
+/* Redirects the stdin, stdout and stderr of a command that aren't already
+ * redirected to those of a session hosted by another program.
+ */
+int addSessionRedirections(struct shellState *shell, struct command *command)
+{
+    struct redirectionTable *table = &command->redirections;
+    struct redirection added[3];
+    int numOwn = table->count;  /* the redirections of the command itself */
+    int numAdded;
+    int fd;
+
+    for (fd = 0; fd < 3; fd++)
+    {
+        if (shell->stdioFds[fd] != -1 && !isRedirected(table, fd)
+            && addRedirection(table, fd, redirectDescriptor, NULL, shell->stdioFds[fd]) == -1)
+        {
+            fprintf(stderr, "A commandline has a maximum of %d redirections\n", MAX_REDIRECTIONS);
+            return -1;
+        }
+    }
+
+    /* The fds of the session are in place before the command's own
+     * redirections are applied, so a 1>&2 of the command copies the
+     * session's stderr
+     */
+    numAdded = table->count - numOwn;
+    memcpy(added, table->entries + numOwn, numAdded * sizeof(struct redirection));
+    memmove(table->entries + numAdded, table->entries, numOwn * sizeof(struct redirection));
+    memcpy(table->entries, added, numAdded * sizeof(struct redirection));
+
+    return 0;
+}
+
+/* Opens the redirections of a loop or function call and makes them the
+ * stdin, stdout and stderr of the shell's commands, saving those in use.
+ */
+int pushSessionRedirections(struct shellState *shell, struct redirectionTable *table, int savedFds[])
+{
+    struct redirection *entry;
+    int fds[3];
+    int i;
+
+    for (i = 0; i < table->count; i++)
+    {
+        entry = &table->entries[i];
+        if (entry->fd > 2 || (entry->type == redirectDuplicate && entry->sourceFd > 2))
+        {
+            printf("only 0 - 2 can be redirected for a loop or function\n");
+            return -1;
+        }
+    }
+
+    /* The commands write to the shell's stdio directly, with no thread of
+     * the shell in between to compress it
+     */
+    if (hasCompressedOutput(table))
+    {
+        printf(">z can't be used for a loop or function\n");
+        return -1;
+    }
+
+    if (openRedirections(table) == -1)
+    {
+        closeRedirections(table);
+        return -1;
+    }
+
+    memcpy(savedFds, shell->stdioFds, sizeof(fds));
+    memcpy(fds, shell->stdioFds, sizeof(fds));
+
+    /* Worked out in order as applyRedirections does, where -1 stands for
+     * the shell's own fd
+     */
+    for (i = 0; i < table->count; i++)
+    {
+        entry = &table->entries[i];
+
+        if (entry->type == redirectDuplicate)
+        {
+            fds[entry->fd] = (fds[entry->sourceFd] == -1) ? entry->sourceFd : fds[entry->sourceFd];
+        }
+        else
+        {
+            fds[entry->fd] = entry->sourceFd;
+        }
+
+        if (fds[entry->fd] == entry->fd)
+        {
+            fds[entry->fd] = -1;
+        }
+    }
+
+    memcpy(shell->stdioFds, fds, sizeof(fds));
+
+    return 0;
+}
+
+/* Gives the shell's commands back the stdin, stdout and stderr saved by
+ * pushSessionRedirections and closes the files it opened.
+ */
+void popSessionRedirections(struct shellState *shell, struct redirectionTable *table, int savedFds[])
+{
+    memcpy(shell->stdioFds, savedFds, sizeof(shell->stdioFds));
+    closeRedirections(table);
+}
+
+/* Forks and execs a parsed command, waiting for it if it is in the
+ * foreground or adding it to the job table if it is in the background.
+ */
+void launchCommand(struct shellState *shell, struct command *command)
+{
+    pid_t spawnPid = -5; /* process number returned by calling fork() */
+
+    int terminationSignal= 0; /* the value is 0 or that of a sent signal */
+
+    /* use to get process exit and termination information after using the waitpid() function */
+    int childExitMethod = -5; 
+
+    /* The memory file descriptor holding a here-document or here-string */
+    int hereFileDescriptor = -1;
+
+    /* The host-wide slot taken by a background job */
+    int slot = JOB_SLOT_UNLIMITED;
+
+    /* The copies into several files of a foreground job's output */
+    struct fanOut *fanOuts = NULL;
+
+    /* true if the foreground job was signaled for running past its time limit */
+    bool timedOut = false;
+
+    /* true if the launcher helper forked the job rather than the shell */
+    bool launched = false;
 
     /* Use below to temporarily delay the TSTP signal until the foreground process has completed.
     * Reference: The Linux Programming Interface by Kerrisk pg 410-411
@@ -140,445 +941,515 @@ int main(int argc, char *argv[])
     */
     sigset_t blockSet, prevMask;
 
-    /* Declare sigaction struct variables for handling the indicated signal
-     * Note that ignore_action variable is used for ignoring the signal
-     * that uses it.
+    /* A trailing & is ignored in foreground-only mode */
+    if (shell->foregroundOnly == TRUE)
+    {
+        command->inBackground = false;
+    }
+
+    /* An alias is expanded into the command it stands for, which is
+     * launched in its place
      */
-    struct sigaction SIGINTaction = {0};
-    struct sigaction ignore_action = {0};
-    struct sigaction SIGTSTPaction = {0};
-    struct sigaction default_action = {0};
+    if (launchAlias(shell, command))
+    {
+        return;
+    }
 
-    /*********** for SIGINT**********/
-    /* set ignore_action signal handler to ignore SIG_IGN */
-    ignore_action.sa_handler = SIG_IGN;
-    /* specify the action to be taken with a SIGINT signal */
-    sigaction(SIGINT, &ignore_action, NULL);  
-
-     
-     /*********** for SIGTSTP**********/
-    /* set the SIGTSTP signal handler to  catchSIGTSTP */ 
-    SIGTSTPaction.sa_handler = catchSIGTSTP;
-    /*Ensure if the signal delivered during an open, read, or write
-    * operation that these can restart rather than return a failure
-    */
-    SIGTSTPaction.sa_flags = SA_RESTART;
-    /* set to block all signals while the signal handler is executing */
-    sigfillset(&SIGTSTPaction.sa_mask);
-    /* specify the action to be taken with a SIGTSTP signal */
-    sigaction(SIGTSTP, &SIGTSTPaction, NULL);
+    /* Write a here-document or here-string into a sealed memory file
+     * before forking so the child can use it as stdin. The body of a
+     * here-document is read from the lines following the commandline.
+     */
+    if (command->hereType == hereDocument)
+    {
+        hereFileDescriptor = createHereDocument(shell->input, command->hereWord, shell->parentPID);
+    }
+    else if (command->hereType == hereString)
+    {
+        hereFileDescriptor = createHereString(command->hereWord);
+    }
 
+    /* A here-document or here-string replaces any other stdin. If the
+     * memory file couldn't be made then don't run the command.
+     */
+    if (command->hereType != noHere && (hereFileDescriptor == -1
+        || addRedirection(&command->redirections, 0, redirectDescriptor, NULL, hereFileDescriptor) == -1))
+    {
+        if (hereFileDescriptor != -1)
+        {
+            fprintf(stderr, "A commandline has a maximum of %d redirections\n", MAX_REDIRECTIONS);
+            close(hereFileDescriptor);
+        }
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
 
-    /**************** initialize program variables ***************/
-    
-    /* Create the pidReturn dynamic array */
-    pidReturn = getPidReturnArray(pidReturnCapacity);
+    /* A background process reads from and writes to /dev/null unless its
+     * input or output is redirected.
+     */
+    if (command->inBackground == true)
+    {
+        addBackgroundRedirections(&command->redirections);
+    }
+
+    /* A session hosted by another program gives its commands their own
+     * stdin, stdout and stderr
+     */
+    if (addSessionRedirections(shell, command) == -1)
+    {
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
 
-    /* initialize the pidReturn array */
-    initializeBgPidArray(pidReturn, pidReturnCapacity);
+    /* There is nothing to run if the commandline only held redirections */
+    if (command->numArgs == 0)
+    {
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+        shell->lastStatus = 0;
+        return;
+    }
 
-    /* If status is run before any foreground command is run then it should
-     * return exit status 0
+    /* The exec inbuilt command runs the command in place of the shell */
+    if (command->replaceShell == true)
+    {
+        replaceShell(shell, command);
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+        return;
+    }
+
+    /* A function runs its commands in the shell itself, with the here-document
+     * as their stdin
      */
-    memset(exitStatusStr,'\0', STATUS_LENGTH);
-    sprintf(exitStatusStr,"exit value %d \n",0);
+    if (launchFunction(shell, command))
+    {
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+        return;
+    }
 
-    /* https://stackoverflow.com/questions/2595503/determine-pid-of-terminated-process */
-    parentPID = getpid();
+    /* An argument list too long for execve is split into batches if the
+     * command was run with batch and is otherwise not run. A command run
+     * with batch is always split up as it asked.
+     */
+    if (command->batch.enabled == true || !argumentListFits(command->args, command->numArgs))
+    {
+        runBatches(shell, command);
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+        return;
+    }
 
+    /* The files of the redirections are opened by the shell before it
+     * forks, so a file that can't be opened cancels the command without
+     * spending a fork and the child only has to dup3 the fds it is given.
+     * An fd sent to several files is given a pipe that the shell copies
+     * into each of them.
+     */
+    if (openRedirections(&command->redirections) == -1
+        || openFanOuts(&command->redirections) == -1)
+    {
+        closeRedirections(&command->redirections);
+        if (hereFileDescriptor != -1)
+        {
+            close(hereFileDescriptor);
+        }
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
 
-    /***** The shell itself.******
-    * When the user exits the shell this loop is broken out of.
-    * The reference for the general structure of the code for the shell is:
-    * The Linux Programming Interface by Kerrisk, Chapter 27 and pg 581
-    */
-    while(true)
+    /* The last command the shell runs doesn't need a fork, since the shell
+     * would only wait for it and exit. It is exec'd in place of the shell
+     * unless there are background jobs to report, a time limit to enforce,
+     * scheduled commands still to run or output for the shell to copy to
+     * several files, and the shell's exit status becomes that of the
+     * command.
+     */
+    if (shell->tailCommand == true && command->inBackground == false
+        && command->haveTimeout == false && command->timeout == NO_TIMEOUT
+        && shell->jobs.numJobs == 0 && shell->schedule.count == 0
+        && command->redirections.fanOuts == NULL)
+    {
+        fflush(stdout);
+        execCommand(command);
+        exit(1);
+    }
+
+    /* A background job takes one of the slots shared by the shells of the
+     * host, waiting until one is free. ^C gives up on the job.
+     */
+    if (command->inBackground == true && shell->jobSlotLimit > 0)
+    {
+        slot = acquireJobSlot(shell->jobSlotLimit);
+        if (slot == JOB_SLOT_INTERRUPTED)
+        {
+            closeRedirections(&command->redirections);
+            if (hereFileDescriptor != -1)
+            {
+                close(hereFileDescriptor);
+            }
+            sprintf(shell->exitStatusStr,"exit value %d",WAIT_INTERRUPTED);
+            shell->lastStatus = WAIT_INTERRUPTED;
+            return;
+        }
+    }
+
+    /* With -L a foreground command is forked by the launcher helper, which
+     * costs the same however large the shell has grown. A command it can't
+     * take is forked by the shell.
+     */
+    launched = false;
+    if (shell->launcher.socket != -1 && command->inBackground == false
+        && command->timeout == NO_TIMEOUT)
+    {
+        spawnPid = launchWithHelper(&shell->launcher, command);
+        launched = (spawnPid > 0);
+    }
+
+    /* Fork off the current process */
+    if (launched == false)
     {
+        spawnPid = fork();
+    }
+
+    switch (spawnPid)
+    {
+        /* Fork was unsuccessful */
+        case -1:
+        {
+            perror("Error creating fork\n");
+            exit(1);
+        }
+        /* The child process */
+        case 0:
+        {
+            execCommand(command);
+            exit(1);
+        }
 
-            /* With the -1 argument to waitpid this means wait for any child as opposed
-             * to one with a specific PID. When a background process finishes this
-             * while loop will catch it and store the child PID in the return value
-             * waitPidReturn. Resources:
-             * The Linux Programming Interface by Kerrisk pg 556
-             * https://www.gnu.org/software/libc/manual/html_node/Process-Completion.html
-             * https://stackoverflow.com/questions/2595503/determine-pid-of-terminated-process
+        /* The parent process */
+        default:
+        {
+            /* The child has its own copies of the memory file and the
+             * redirected files
              */
-            while ( (waitPidReturn = waitpid(-1, &childExitMethod, WNOHANG)) > 0 )
-            { 
-                /* If the returned value of waitpid is not the last run foreground process */
-                if (waitPidReturn != foregroundPID)
-                {
-                    /* Get the termination or exit status and put in the char * exitStatusStrBg */
-                    terminationStatus(childExitMethod, exitStatusStrBg, &terminationSignalBg);
-                    /* Print the exit or termination status of the background process */
-                    printf("background pid %d is done: %s\n", waitPidReturn, exitStatusStrBg);
-                    --numProcesses;
-                    /* Reset the array element that held the background PID in the pidReturn
-                     * array to BG_UNDEFINED
-                     */
-                    resetPidArrayElement(pidReturn, waitPidReturn, pidReturnCapacity);
-                } 
-                
+            if (hereFileDescriptor != -1)
+            {
+                close(hereFileDescriptor);
             }
+            fanOuts = startFanOuts(&command->redirections, command->inBackground);
+            closeRedirections(&command->redirections);
+        
+            /* If the user entered & as the last character on the commandline then
+             * inBackground is true and it will be run as a background process
+             */
+            if (command->inBackground == true)
+            {
+                
+                /* Store each background spawnPid in the job table so it can later be
+                 * waited on, signaled, or killed if for example the user chooses to
+                 * exit. The job table is dynamic and doubles its capacity when full.
+                 * The job is added before anything can reap it, so its pidfd is
+                 * guaranteed to refer to it.
+                 */
+                addJob(&shell->jobs, spawnPid);
+                shell->lastBackgroundPid = spawnPid;
 
-        /* Re-initialize the following variables after the previous commandline has been
-        * executed.
-        */
-        fflush(stdout); /* flush the output stream */
-        printf(": ");  /* print the commandline prompt */
-        haveInput = false;
-        haveOutput = false;
-        inBackground = false;
-        lineSize = UNDEFINED;
-
-        /* Initialize the args array which holds the commandline arguments*/
-        initializeArgs(args, MAX_NUM_ARGS);
-
-        /* Read in the commandline using getline and store in the variable buffer */
-        /*resource:  http://man7.org/linux/man-pages/man3/getline.3.html */
-
-        buffer = NULL;      /* Must be set to NULL for arbitrary line length */
-        bufferSize = 0;     /* Must be set to 0 for arbitrary line length */
-
-        lineSize = getline(&buffer, &bufferSize, stdin);
+                /* The job holds the slot until it is reaped */
+                if (slot >= 0)
+                {
+                    assignJobSlot(slot, spawnPid);
+                }
 
-        if (lineSize < 0 )  /* Catches lineSize is UNDEFINED and getline return -1 */
-        {
-           /* https://www.tutorialspoint.com/c_standard_library/c_function_clearerr.htm */
-            clearerr(stdin);       
-        }   
-        else{
+                /* As in bash, starting a background job succeeds */
+                shell->lastStatus = 0;
 
-            /* Expand occurences of $$ in the commandline string, buffer */ 
-            expandstatus = expandString(buffer, parentPID, bufferExpanded);
+                /* Print the PID of the background process */
+                printf("background PID is %d\n", spawnPid);
 
-            /* If the commandline exceeds the maximum allowed length print a message and 
-             * bring the user back to the prompt.
-             */
-            if (expandstatus == commandLineTooLong )
-            {
-                printf("The command line has a maximum length of %d\n",MAX_COMMAND_LINE );
+                /* Time limits are only enforced while waiting on a foreground job */
+                if (command->haveTimeout == true)
+                {
+                    printf("timeout: ignored for background process %d\n", spawnPid);
+                }
                 
             }
-            /* If the commandline was successfully expanded then continue on to execute it */
-            else if (expandstatus == successful)
+            else
+            /* The process is run in the foreground */
             {
+                /* Temporarily delay the TSTP signal until the foreground process has completed.
+                 * Reference: The Linux Programming Interface by Kerrisk pg 410-411
+                 * prevMask holds the previous mask and blockset is defined below
+                 * to block SIGTSTP
+                 */
+                
+                sigemptyset(&blockSet);
+                sigaddset(&blockSet, SIGTSTP);
 
-                /*If the commandline is "exit" then clean up and exit from the program */
-                if (strncmp(bufferExpanded,"exit", strlen("exit"))== 0)
+                /* Start the temporary signal delay */
+                if (sigprocmask(SIG_BLOCK, &blockSet, &prevMask) == -1)
                 {
-                    /* free the buffer */
-                    if (buffer != NULL)
-                    {
-                        free(buffer); 
-                    }
-
-                    /* kill any remaining background jobs */
-                    for (i =0; i < pidReturnCapacity; i++)
-                    {
-                        /* Background job PIDs are stored in pidReturn, and when a job 
-                         * returns that element in the pidReturn array is set to 
-                         * BG_UNDEFINED which is an arbitrary negative number, so if
-                         * an element of pidReturn is > BG_UNDEFINED then there is a
-                         * background process with that pid running.
-                         */
-                        if (pidReturn[i] > BG_UNDEFINED )
-                        {
-                            /* send the SIGTERM signal to kill the active process */
-                            kill(pidReturn[i], SIGTERM);  
-                        }
-
-                    } 
-
-                    break;  /* break out of the while loop to exit the shell */
-                    
+                    perror("sigprocmask error\n");
+                    exit(1);
                 }
-                /* If the user enters a comment(starts with #) or nothing then do nothing */
-                else if (strncmp(bufferExpanded,"#", strlen("#"))== 0 || lineSize == 1)
+                /* The foreground PID */
+                shell->foregroundPID = spawnPid;
+
+                /* Wait for the process to run, blocking while the child process is
+                 * running. If the job has a time limit it is sent SIGTERM and then
+                 * SIGKILL when the limit is reached.
+                 */
+                if (launched == true)
                 {
-                    /* do nothing */
+                    waitForHelper(&shell->launcher, spawnPid, &childExitMethod);
                 }
-                /* If the user enters "cd" then change to the indicated directory or HOME*/
-                else if (strncmp(bufferExpanded,"cd",strlen("cd")) == 0 )
+                else
                 {
-                   
-                    /* Get the next argument on the commandline by splitting it into
-                     * space delimited tokens.
-                     */
-
-                     /* First, ignore the word "cd" */
-                    token = strtok(bufferExpanded," \n"); 
-
-                    /* Then get the next token, if any */
-                    token = strtok(NULL," \n"); /* get next token */
-
-                    /* If there isn't a next token then move the user to their HOME directory */
-                    if ( token == NULL)  /* if there isn't an arg provided to cd then move to HOME*/
-                    {
-                        /*resource: https://www.tutorialspoint.com/c_standard_library/c_function_getenv.htm */
-                        /* resource: https://www.geeksforgeeks.org/chdir-in-c-language-with-examples/ */
-                        chdir(getenv("HOME"));
-                    }
-                    else
-                    {
-                        /* If there is a next token then it represents the directory to move into,
-                         * so move into it.
-                         */
-                        chdir(token);
-                        
-                    }
-                    
+                    waitWithTimeout(spawnPid, &childExitMethod, command->timeout,
+                                    command->killAfter, &timedOut);
                 }
-                /* Print the latest status or terminating signal number, if the 
-                 * user enters "status" on the commandline
+
+                /* The files of a fan-out are complete before the next command */
+                joinFanOuts(fanOuts);
+                
+                /* Get the termination status and if the process recieved a 
+                 * termination signal then print the signal.
+                 */     
+                terminationSignal = 0;
+                /* Get's the termination and exit status and puts it in the string 
+                 * exitStatusStr
                  */
-                else if (strncmp(bufferExpanded,"status", strlen("status")) == 0)
+                shell->lastStatus = terminationStatus(childExitMethod, shell->exitStatusStr,
+                                                      &terminationSignal);
+
+                /* Report a timed out job distinctly from one that was signaled */
+                if (timedOut == true)
                 {
-                   /* The latest status is stored in exitStatusStr */
-                    printf("%s\n",exitStatusStr);
-                    
+                    reportTimeout(shell->exitStatusStr, command->timeout);
                 }
-                else
+
+                if (terminationSignal != 0 || timedOut == true)
                 {
+                    printf("%s\n", shell->exitStatusStr);
+                }
 
-                    /* Tokenize the expanded input buffer and put into an args array, the
-                     * variable index holds the index + 1 of the latest element in the args 
-                     * array and thereby indicates its size . The value of this variable is
-                     * later used to delete pointer references to dynamic strings in the
-                     * args array.
-                     */
-                    index = 0;
-
-                    /* The tokenization and parsing of arguments occurs in the parseArguments
-                     * function which additionaly parses and sets the appropriate variables
-                     * if any of the arguements equal <,>, &.
-                     */
-                    parseArguments(&index, bufferExpanded, args, &haveInput, &haveOutput,
-                                    &inBackground, fileNameIn, fileNameOut);
-
-                    /* Fork off the current process */
-                    spawnPid = fork();
-
-                    switch (spawnPid)
-                    {
-                        /* Fork was unsuccessful */
-                        case -1:
-                        {
-                            perror("Error creating fork\n");
-                            exit(1);
-                        }
-                        /* The child process */
-                        case 0:
-                        {     
-
-                            /* Redefine the signal handler parameters in the child */
-
-                            /* Resource: Office hours questions and chapters 26, 27 in
-                             * The Linux Programming Interface by Kerrisk
-                             */
-
-                            /*********** for SIGINT**********/
-                            /* The child sets the sigaction handler to the SIG_DFL 
-                             * which means to take the default action. This funtion 
-                             * overrides the parent's handling of this signal
-                             * which was to ignore it.
-                             */
-                            default_action.sa_handler = SIG_DFL;
-                            sigaction(SIGINT, &default_action, &ignore_action);
-                            
-                             /*********** for SIGTSTP**********/
-                            /* The child sets the sigaction handler to the ignore the
-                             * SIGTSTP signal which overrides the parent's handling of 
-                             * this function which was to call the catchSIGTSTP handler.
-                             */
-
-                            /* empty the set filled by the parent*/
-                            sigemptyset(&SIGTSTPaction.sa_mask);  
-                            sigaction(SIGTSTP, &ignore_action, &SIGTSTPaction);
-                        
-                            /* If the user entered < on the commandline then haveInput is 
-                             * true. Get the file descriptor so the file can later be
-                             * closed and set stdin to take its input from fileNameIn
-                             * via the function setInputStream
-                             */
-                            if ( haveInput == true)
-                            {
-                                inFileDescriptor = setInputStream(fileNameIn);
-                            }
-
-                            /* If the user entered > on the commandline then haveOutput is 
-                             * true. Get the file descriptor so the file can later be
-                             * closed and set stdout to take put its output to fileNameOut
-                             * via the function setOutputStream
-                             */
-                            if ( haveOutput == true)
-                            {
-                                outFileDescriptor = setOutputStream(fileNameOut);
-                            }
-
-                            /* From: https://linux.die.net/man/3/execvp
-                                The execvp(functions duplicate the actions of the shell in searching for an executable file if the specified
-                                filename does not contain a slash (/) character. The file is sought in the colon-separated list of directory 
-                                pathnames specified in the PATH environment variable. If this variable isn't defined, the path list 
-                                defaults to the current directory followed by the list of directories returned by confstr(_CS_PATH).
-                            */
-                            if (inBackground == true)
-                            {
-                                /* Ignore the SIGINT signal if process is in the background */
-                                /* specify the action to be taken with a SIGINT signal */
-                                sigaction(SIGINT, &ignore_action, &default_action);
-
-                                execvpReturn = execvp(args[0], args);
-
-                            /* If execvp returned an error then print a message and exit with a value of 1 */
-                                if (execvpReturn  == -1)
-                                {
-                                    printf("%s: no such file or directory\n", args[0]);
-                                    exit(1);
-                                }
-                            }
-                            else
-                            {
-                                execvpReturn = execvp(args[0], args);
-
-                                /* If execvp returned an error then print a message and exit with a value of 1 */
-                                if (execvpReturn  == -1)
-                                {
-                                    printf("%s: no such file or directory\n", args[0]);
-                                    exit(1);
-                                }
-                            }
-                            
-
-                            /* If the user entered < on the commandline then close the opened file */
-                            if ( haveInput == true)
-                            {
-                                close(inFileDescriptor);
-                            }
-                            
-                            /* If the user entered > on the commandline then close the opened file */
-                            if ( haveOutput == true)
-                            {
-                                close(outFileDescriptor);
-                            } 
-                            
-                        }
-
-                        /* The parent process */
-                        default:
-                        {
-                        
-                            /* If the user entered & as the last character on the commandline then
-                             * inBackground is true and it will be run as a background process
-                             */
-                            if (inBackground == true)
-                            {
-                                
-                                /* Print the PID of the background process */
-                                printf("background PID is %d\n", spawnPid);
-
-                                /* Wait for the background process to run. The Flag WNOHANG means
-                                 * don't block while the child process is running. When the childprocess
-                                 * has finished running waitPidReturn is equal to spawnPid
-                                 * Resource: The Linux Programming Interface by Kerrisk Chapter 26
-                                 */
-                                waitPidReturn = waitpid(spawnPid, &childExitMethod,WNOHANG);  
-
-                                /* Store each background spawnPid in the pidReturn Array so it can
-                                 * later be killed if for example the user chooses to exit. The pidReturn
-                                 * array is dynamic. If numProcesses (the number of background processes)
-                                 * is equal to the capacity of the array then double its capacity
-                                 */
-                                if (numProcesses == pidReturnCapacity)
-                                {
-                                    pidReturnCapacity = increasePidReturnArray(&pidReturn, pidReturnCapacity);
-                                }
-
-                                /* Store the background spawnPid in the pidReturn Array */
-                                pidReturn[numProcesses] = spawnPid;
-                                ++numProcesses;
-                                
-                            }
-                            else
-                            /* The process is run in the foreground */
-                            {
-                                /* Temporarily delay the TSTP signal until the foreground process has completed.
-                                 * Reference: The Linux Programming Interface by Kerrisk pg 410-411
-                                 * prevMask holds the previous mask and blockset is defined below
-                                 * to block SIGTSTP
-                                 */
-                                
-                                sigemptyset(&blockSet);
-                                sigaddset(&blockSet, SIGTSTP);
-
-                                /* Start the temporary signal delay */
-                                if (sigprocmask(SIG_BLOCK, &blockSet, &prevMask) == -1)
-                                {
-                                    perror("sigprocmask error\n");
-                                    exit(1);
-                                }
-                                /* The foreground PID */
-                                foregroundPID = spawnPid;
-
-                                /* Wait for the process to run. The 0 in the last argument to waitpid 
-                                 * means to block while the child process is running.
-                                 */
-                                waitPidReturn = waitpid(spawnPid, &childExitMethod,0);
-                                
-                                /* Get the termination status and if the process recieved a 
-                                 * termination signal then print the signal.
-                                 */     
-                                terminationSignal = 0;
-                                /* Get's the termination and exit status and puts it in the string 
-                                 * exitStatusStr
-                                 */
-                                terminationStatus(childExitMethod, exitStatusStr, &terminationSignal);
-                                if (terminationSignal != 0)
-                                {
-                                    printf("%s\n", exitStatusStr);
-                                }
-
-                                /* End the temporary signal delay. Note that this delays the signal rather
-                                 * than prevent it from occuring
-                                 */
-                                if (sigprocmask(SIG_SETMASK, &prevMask, NULL) == -1)
-                                {
-                                    perror("sigprocmask error\n");
-                                    exit(1);
-                                }
-                            
-                            }
-
-                        }
-                    }
+                /* End the temporary signal delay. Note that this delays the signal rather
+                 * than prevent it from occuring
+                 */
+                if (sigprocmask(SIG_SETMASK, &prevMask, NULL) == -1)
+                {
+                    perror("sigprocmask error\n");
+                    exit(1);
                 }
-            }
             
-        }   
+            }
+
+        }
+    }
+}
+
+/* Returns true if the input has no more commandlines. Only input that can
+ * be looked ahead in without waiting, a regular file or a string, is
+ * checked; other input is never at its end until it is read.
+ */
+bool atEndOfInput(FILE *input)
+{
+    struct stat inputStat;
+    int next;  /* the next character of the input, which is put back */
+
+    /* Looking ahead in a pipe or terminal would wait for the next line
+     * before running this one. A string given to -c has no descriptor.
+     */
+    if (fileno(input) != -1
+        && (fstat(fileno(input), &inputStat) == -1 || !S_ISREG(inputStat.st_mode)))
+    {
+        return false;
+    }
+
+    next = getc(input);
+    if (next == EOF)
+    {
+        return true;
+    }
+
+    ungetc(next, input);
+    return false;
+}
+
+/* Returns true if name can be exec'd, looking for it in PATH as execvp does
+ * if it doesn't hold a '/', and puts the path that was found in path.
+ */
+bool findExecutable(char *name, char path[])
+{
+    char *searchPath = getenv("PATH");
+    char *start;  /* the start of the next directory in PATH */
+    char *end;  /* the ':' or '\0' after the directory */
+    int length;
+
+    if (strchr(name, '/') != NULL)
+    {
+        return snprintf(path, PATH_MAX, "%s", name) < PATH_MAX && access(name, X_OK) == 0;
+    }
+
+    /* the path execvp searches when PATH isn't set */
+    if (searchPath == NULL)
+    {
+        searchPath = "/bin:/usr/bin";
+    }
 
-      
-        /* free any dynamic char * strings pointed to by the args array */
-        i= 0;
-        while (args[i] != NULL)
+    for (start = searchPath; ; start = end + 1)
+    {
+        end = strchrnul(start, ':');
+        length = end - start;
+
+        /* an empty directory in PATH means the current directory */
+        if (snprintf(path, PATH_MAX, "%.*s%s%s", length, start,
+                     (length > 0) ? "/" : "", name) < PATH_MAX
+            && access(path, X_OK) == 0)
         {
-            freeString(args[i]);
-            ++i;
+            return true;
         }
 
-        
-       /* If necessary free the buffer, which is used to store the commandline */
-        if (buffer != NULL)
+        if (*end == '\0')
         {
-            free(buffer); 
+            return false;
         }
-        
     }
+}
 
-    
-    /* pidReturn is a dynamic array which is freed before the program exits */
-    free(pidReturn);
+/* Runs the command in the current process with its redirections applied
+ * and the signal handling of a child. Only returns if it couldn't be run.
+ */
+void execCommand(struct command *command)
+{
+    /* Used to reset the signal handling set up by the shell */
+    struct sigaction ignore_action = {0};
+    struct sigaction default_action = {0};
 
-    return 0;
+    /* Redefine the signal handler parameters for the command */
+
+    /* Resource: Office hours questions and chapters 26, 27 in
+     * The Linux Programming Interface by Kerrisk
+     */
+
+    /*********** for SIGINT**********/
+    /* Set the sigaction handler to the SIG_DFL which means to take the
+     * default action. This overrides the shell's handling of this signal
+     * which was to ignore it, and which execvp would keep.
+     */
+    default_action.sa_handler = SIG_DFL;
+    sigaction(SIGINT, &default_action, NULL);
+
+    /*********** for SIGTSTP**********/
+    /* Set the sigaction handler to ignore the SIGTSTP signal which overrides
+     * the shell's handling of this signal which was to call the catchSIGTSTP
+     * handler.
+     */
+    ignore_action.sa_handler = SIG_IGN;
+    sigaction(SIGTSTP, &ignore_action, NULL);
+
+    /* Open the files of any redirections the user entered on the
+     * commandline and set the redirected fds to them. All other fds
+     * the shell has open are closed so they don't leak into the
+     * command, leaving it with fds 0 - 2 and the ones it redirected.
+     */
+    if (openRedirections(&command->redirections) == -1
+        || applyRedirections(&command->redirections) == -1)
+    {
+        return;
+    }
+
+    /* From: https://linux.die.net/man/3/execvp
+        The execvp(functions duplicate the actions of the shell in searching for an executable file if the specified
+        filename does not contain a slash (/) character. The file is sought in the colon-separated list of directory 
+        pathnames specified in the PATH environment variable. If this variable isn't defined, the path list 
+        defaults to the current directory followed by the list of directories returned by confstr(_CS_PATH).
+    */
+    if (command->inBackground == true)
+    {
+        /* Ignore the SIGINT signal if process is in the background */
+        /* specify the action to be taken with a SIGINT signal */
+        sigaction(SIGINT, &ignore_action, NULL);
+    }
+
+    execvp(command->args[0], command->args);
+
+    /* If execvp returned then it failed, so print a message */
+    printf("%s: no such file or directory\n", command->args[0]);
+}
+
+/* Execs a command in place of the shell. Nothing is changed and the shell
+ * goes on if the command can't be found, its files can't be opened or the
+ * shell is an embedded session, but if exec fails after its redirections
+ * are applied the shell exits.
+ */
+void replaceShell(struct shellState *shell, struct command *command)
+{
+    char path[PATH_MAX];  /* the path the command was found at */
+
+    /* In a session the process being replaced is the program hosting it */
+    if (shell->embedded == true)
+    {
+        fprintf(stderr, "exec: not supported in an embedded session\n");
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
+
+    /* A mistyped command doesn't end an interactive shell */
+    if (findExecutable(command->args[0], path) == false)
+    {
+        fprintf(stderr, "exec: %s: not found\n", command->args[0]);
+        sprintf(shell->exitStatusStr,"exit value %d",EXEC_NOT_FOUND);
+        shell->lastStatus = EXEC_NOT_FOUND;
+        return;
+    }
+
+    /* Nothing would be left to compress the output once the shell is
+     * replaced
+     */
+    if (hasCompressedOutput(&command->redirections))
+    {
+        fprintf(stderr, "exec: >z isn't supported, since the shell is replaced\n");
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
+
+    /* The files are opened before any of the shell's fds are changed, so the
+     * shell can go on if one can't be opened
+     */
+    if (openRedirections(&command->redirections) == -1)
+    {
+        closeRedirections(&command->redirections);
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
+
+    /* Output the shell has buffered would be lost by execvp. Any background
+     * jobs are left running, as in bash.
+     */
+    fflush(stdout);
+    execCommand(command);
+
+    /* The shell's fds have been replaced, so it can't go on */
+    exit(EXEC_FAILED);
 }
 
 /* Takes as input the commandline, the pid that results from $$ and expands all
@@ -596,7 +1467,7 @@ enum expandStatus expandString(char *str, pid_t pid, char *strExpanded)
 
     /* initialize pidStr[] and strExpanded[] */
    memset(pidStr,'\0', MAX_INT_LENGTH*sizeof(char));
-   memset(strExpanded,'\0', MAX_COMMAND_LINE*sizeof(char));
+   memset(strExpanded,'\0', MAX_COMMAND_LINE_EXPANDED*sizeof(char));
 
    strLength = strlen(str); /* get the length of the commandline str */
 
@@ -698,79 +1569,124 @@ void intToString(char str[],int number)
 
 }
 
-/* Takes the $$ expanded commandline and parses it into an args[] array to 
- * pass onto excvp and also gets the relevant stream data if <, >, & is found
- * in the commandline. In addition, if <, >, and/or & are found in the command
- * line appropriate flags are set.
+/* Takes the $$ expanded commandline and parses it into the args[] array of
+ * the command to pass onto excvp and also adds any redirections found in the
+ * commandline to its redirection table. In addition, if <<, <<< and/or & are
+ * found in the command line appropriate flags are set.
  */
-void parseArguments(int *index, char bufferExpanded[], char *args[], bool *haveInput, bool *haveOutput,
-                   bool *inBackground, char fileNameIn[], char fileNameOut[])
+int parseArguments(char bufferExpanded[], struct command *command)
 {
     char *token;  /* holds each string token from the commandline */
-    int  argSize; /* holds the size of token being examined */
+    char *savePosition;  /* where strtok_r continues from, so commands can be
+                          * parsed ahead on another thread */
+    enum redirectionStatus redirectionStatus; /* how a token was used as a redirection */
+    char *fileName;  /* a redirection file name that holds a $(...) */
+    int i;
     
     /* tokenize the input buffer and put into an args array */
-    token = strtok(bufferExpanded," \n");
+    token = strtok_r(bufferExpanded, " \n", &savePosition);
 
     while( token != NULL ) {
         
-        /* if find < then get the input filename and store it in "fileNameIn" */
-        if (token != NULL && strcmp(token, "<") == 0)
+        /* if find <<< then get the here-string word and store it in "hereWord" */
+        if (token != NULL && strcmp(token, "<<<") == 0)
         {
-            
-            /* read in the next token which should be the file name */
-            token = strtok(NULL, " \n");
-            
+            /* read in the next token which should be the here-string word */
+            token = strtok_r(NULL, " \n", &savePosition);
+
             if ( token != NULL)
             {
-        
-                memset(fileNameIn,'\0', MAX_FILE_NAME);
-                strcpy(fileNameIn, token);
-
-                /* boolean indicates to expect input from file */
-                *haveInput = true; 
+                memset(command->hereWord,'\0', MAX_FILE_NAME);
+                strcpy(command->hereWord, token);
 
-                token = strtok(NULL, " \n"); /* read in the next token */
+                /* indicates to take input from a here-string */
+                command->hereType = hereString;
 
+                token = strtok_r(NULL, " \n", &savePosition); /* read in the next token */
             }
             else
             {
-                fprintf(stderr, "Error getting input filename\n");
-                exit(3);
+                if (command->reportErrors == true)
+                {
+                    fprintf(stderr, "Error getting here-string word\n");
+                }
+                return -1;
             }
-            
         }
-         /* if find > then get the input filename and store it in "fileNameOut" */
-        if (token != NULL && strcmp(token, ">") == 0)
+        /* if find <<WORD or << WORD then store the delimiter WORD in "hereWord" */
+        if (token != NULL && strncmp(token, "<<", 2) == 0 && strcmp(token, "<<<") != 0)
         {
-            
-            /* read in the next token which should be the file name */
-            token = strtok(NULL, " \n");
-            
-            if ( token != NULL)
+            /* the delimiter is either attached to << or is the next token */
+            if (token[2] == '\0')
+            {
+                token = strtok_r(NULL, " \n", &savePosition);
+            }
+            else
             {
-                memset(fileNameOut,'\0', MAX_FILE_NAME);
-                strcpy(fileNameOut, token);
+                token += 2;
+            }
 
-                /* boolean indicates to expect to output file */
-                *haveOutput = true;
+            if ( token != NULL)
+            {
+                memset(command->hereWord,'\0', MAX_FILE_NAME);
+                strcpy(command->hereWord, token);
 
-                token = strtok(NULL, " \n"); /* read in the next token */
+                /* indicates to take input from a here-document */
+                command->hereType = hereDocument;
 
+                token = strtok_r(NULL, " \n", &savePosition); /* read in the next token */
             }
             else
             {
-                fprintf(stderr, "Error getting output filename\n");
-                exit(3);
-            
+                if (command->reportErrors == true)
+                {
+                    fprintf(stderr, "Error getting here-document delimiter\n");
+                }
+                return -1;
+            }
+        }
+        /* if find a redirection such as <, >, >>, 2>, 2>&1 or &> then add it to the
+         * redirection table, reading the file name from the next token if it isn't
+         * attached to the operator
+         */
+        if (token != NULL
+            && (redirectionStatus = parseRedirection(&command->redirections, token)) != notRedirection)
+        {
+            if (redirectionStatus == redirectionError)
+            {
+                if (command->reportErrors == true)
+                {
+                    fprintf(stderr, "A commandline has a maximum of %d redirections\n", MAX_REDIRECTIONS);
+                }
+                return -1;
+            }
+
+            if (redirectionStatus == redirectionNeedsFile)
+            {
+                /* read in the next token which should be the file name */
+                token = strtok_r(NULL, " \n", &savePosition);
+
+                if ( token == NULL)
+                {
+                    if (command->reportErrors == true)
+                    {
+                        fprintf(stderr, "Error getting redirection filename\n");
+                    }
+                    return -1;
+                }
+
+                addRedirectionFile(&command->redirections, token);
             }
 
+            token = strtok_r(NULL, " \n", &savePosition); /* read in the next token */
+
+            continue;
         }
         /* if the next token is "&" then process accordingly: */
         if (token != NULL && strcmp(token, "&") == 0 )
         {
             /* read in the next token */
-            token = strtok(NULL, " \n");
+            token = strtok_r(NULL, " \n", &savePosition);
 
             /* If the next token is not NULL the & is not at the end of the 
              * command line and hence is treated like a char, in which case
@@ -778,74 +1694,189 @@ void parseArguments(int *index, char bufferExpanded[], char *args[], bool *haveI
              */
             if (token != NULL )
             {
-                argSize = strlen("&");
-
-                /* have args[*index] point to a dynamic char[] of size argSize */
-                args[*index] = getEmptyString(argSize);
-
-                /* put the token in the array element */
-                strcpy(args[*index], "&"); 
-
-                *index += 1; /* increment the array index */
+                if (addArgument(command, "&") == -1)
+                {
+                    return -1;
+                }
             }
             /* If the next token is NULL the the & is at the end of the command
              * line and hence indicates the command is to be run in the background.
+             * In foreground-only mode launchCommand ignores this.
              */
-            else if (canPutInBackground == TRUE ) /* TRUE if not in foreground-only mode*/
+            else
             {
                 /* set boolean to indicate process is in the background */
-                *inBackground = true;
+                command->inBackground = true;
+            }
+            
+            
+        }
 
-                /* If input is not redirected from a file then set it to redirect
-                 * from /dev/null
-                 */
-                if (*haveInput == false)
+        /* if a token is anything except a redirection, <<, <<<, or & then put it in the
+         * args array that is sent to execvp(). Redirections are handled at the top of
+         * the loop.
+         */
+        if (token != NULL && !(strcmp(token, "&") == 0 || strncmp(token, "<<", 2) == 0
+                               || parseRedirection(NULL, token) != notRedirection ))
+        {
+            /* A token holding the output of a $(...) can be any number of
+             * arguments
+             */
+            if (command->substitutions != NULL && strchr(token, SUBSTITUTION_MARK) != NULL)
+            {
+                if (command->firstSubstitutedArg == -1)
                 {
-                    strcpy(fileNameIn, "/dev/null");
-                    *haveInput = true;  /* indicate that input is redirected */
+                    command->firstSubstitutedArg = command->numArgs;
                 }
 
-                /* If output is not redirected to a file then set it to redirect
-                 * to /dev/null
-                 */
-                if (*haveOutput == false )
+                if (addSubstitutedArguments(command, token) == -1)
                 {
-                    strcpy(fileNameOut, "/dev/null");
-                    *haveOutput = true; /* indicate that output is redirected */
-                }  
+                    return -1;
+                }
             }
-            
-            
+            else if (addArgument(command, token) == -1)
+            {
+                return -1;
+            }
+
+            token = strtok_r(NULL, " \n", &savePosition); /* get the next token */
         }
+    
+    }
 
-        /* if a token is anything except <,>, or & then put it in the args array that is
-         * sent to execvp()
-         */
-        if (token != NULL && !(strcmp(token, ">") == 0 || strcmp(token, "<") == 0 || strcmp(token, "&") == 0 ))
+    /* A redirection file name holding a $(...) is the one word it splits into */
+    if (command->substitutions != NULL)
+    {
+        for (i = 0; i < command->redirections.count; i++)
         {
-            argSize = strlen(token) + 1; /* add extra room for '\0' */
+            fileName = command->redirections.entries[i].fileName;
+            if (fileName != NULL && strchr(fileName, SUBSTITUTION_MARK) != NULL)
+            {
+                command->redirections.entries[i].fileName = substitutedWord(command->substitutions, fileName);
+                freeString(fileName);
+
+                if (command->redirections.entries[i].fileName == NULL)
+                {
+                    return -1;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
 
-             /* have args[*index] point to a dynamic char[] of size argSize */
-            args[*index] = getEmptyString(argSize);
+/* Copies the token into a dynamic string at the end of the command's args
+ * array. Returns -1 if the args array is full.
+ */
+int addArgument(struct command *command, char *token)
+{
+    int argSize; /* holds the size of token being added */
+    char **args;
 
-            strcpy(args[*index], token);
+    /* Keep room for the NULL that ends the args array. Only the words of a
+     * $(...) can fill the inline array, and launchCommand checks that the
+     * arguments fit in an execve or splits them into batches.
+     */
+    if (command->numArgs == command->argsCapacity - 1)
+    {
+        if (command->substitutions == NULL)
+        {
+            if (command->reportErrors == true)
+            {
+                fprintf(stderr, "A commandline has a maximum of %d arguments\n", MAX_NUM_ARGS - 1);
+            }
+            return -1;
+        }
 
-            *index += 1;    /* increment the array index */
+        args = malloc(command->argsCapacity * 2 * sizeof(char *));
+        if (args == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
 
-            token = strtok(NULL, " \n"); /* get the next token */
+        memcpy(args, command->args, command->argsCapacity * sizeof(char *));
+        initializeArgs(args + command->argsCapacity, command->argsCapacity);
+        if (command->args != command->inlineArgs)
+        {
+            free(command->args);
         }
-    
+
+        command->args = args;
+        command->argsCapacity *= 2;
+    }
+
+    argSize = strlen(token) + 1; /* add extra room for '\0' */
+
+     /* have args[numArgs] point to a dynamic char[] of size argSize */
+    command->args[command->numArgs] = getEmptyString(argSize);
+
+    strcpy(command->args[command->numArgs], token);
+
+    command->numArgs += 1;    /* increment the array index */
+
+    return 0;
+}
+
+/* Initializes a command to have no arguments, redirections or here-document
+ * and to run in the foreground with the given time limit.
+ */
+void initializeCommand(struct command *command, double timeout)
+{
+    /* Initialize the args array which holds the commandline arguments*/
+    initializeArgs(command->inlineArgs, MAX_NUM_ARGS);
+    command->args = command->inlineArgs;
+    command->argsCapacity = MAX_NUM_ARGS;
+    command->numArgs = 0;
+    command->firstSubstitutedArg = -1;
+    command->batch.enabled = false;
+
+    initializeRedirections(&command->redirections);
+    command->inBackground = false;
+    command->hereType = noHere;
+    command->timeout = timeout;
+    command->killAfter = TIMEOUT_KILL_AFTER;
+    command->haveTimeout = false;
+    command->replaceShell = false;
+    command->reportErrors = true;
+    command->substitutions = NULL;
+}
+
+/* Frees the dynamic strings held by a command's args array and redirection
+ * table.
+ */
+void freeCommand(struct command *command)
+{
+    int i;
+
+    /* free any dynamic char * strings pointed to by the args array */
+    for (i = 0; i < command->numArgs; i++)
+    {
+        freeString(command->args[i]);
+        command->args[i] = NULL;
+    }
+    command->numArgs = 0;
+
+    /* go back to the inline array if the args array grew */
+    if (command->args != command->inlineArgs)
+    {
+        free(command->args);
+        command->args = command->inlineArgs;
+        command->argsCapacity = MAX_NUM_ARGS;
     }
 
+    /* free the file names held by the redirection table */
+    freeRedirections(&command->redirections);
 }
 
 /* Takes in the status returned from waitpid (childExitMethod) and runs it
  * through WIFSIGNALED, WTERMSIG, WIFEXITED and/or WEXITSTATUS to get either an
  * exit or termination status and puts the result in the string argument.
  */
-void terminationStatus(int childExitMethod, char exitStatusStr[],int *terminationSignal)
+int terminationStatus(int childExitMethod, char exitStatusStr[],int *terminationSignal)
 {
-    int exitStatus;
+    int exitStatus = 0;
     
     /* initialize the input string */
     memset(exitStatusStr,'\0', STATUS_LENGTH);
@@ -857,6 +1888,9 @@ void terminationStatus(int childExitMethod, char exitStatusStr[],int *terminatio
     {
         *terminationSignal = WTERMSIG(childExitMethod);/* returns the signal number*/
         sprintf(exitStatusStr, "terminated by signal %d",*terminationSignal);
+
+        /* as in bash a signaled process has exit status 128 + the signal */
+        exitStatus = SIGNAL_STATUS_BASE + *terminationSignal;
     }
     /*Else, get the exit status and put it in the exitStatusStr string */
     else if (WIFEXITED(childExitMethod))
@@ -864,81 +1898,35 @@ void terminationStatus(int childExitMethod, char exitStatusStr[],int *terminatio
         exitStatus = WEXITSTATUS(childExitMethod); /* returns the exit value */
         sprintf(exitStatusStr,"exit value %d",exitStatus);
     }
+
+    return exitStatus;
 }
 
 
-/* Takes as input the name of a file from which the input stream stdin will
- * be diverted to, opens it, sets it to replace stdin and returns the file
- * descriptor obtained by opening the file for reading.
+/* Returns true if the commandline is the inbuilt command name, either on its
+ * own or followed by arguments.
  */
-int setInputStream(char *fileNameIn)
+bool isBuiltin(char commandLine[], char *name)
 {
-    int inFileDescriptor;  /* the file descriptor value returned by open() */
-    int dup2InReturn; /* the return value of dup2() */
-    char errorMessage[ERROR_MESSAGE_MAX];  /* used to hold an error message */
-
-    /* open a file for reading */
-    inFileDescriptor = open(fileNameIn, O_RDONLY);
-
-    /* if unsuccessful in opening file print an error message to stderr and exit*/
-    if (inFileDescriptor == -1)
-    {
-        memset(errorMessage,'\0', ERROR_MESSAGE_MAX);
-        sprintf(errorMessage, "cannot open %s for input\n", fileNameIn);
-        fprintf(stderr,errorMessage);
-        exit(1);
-    }
-
-    /* use dup2 to set stdin to the file opened above */
-    dup2InReturn = dup2(inFileDescriptor, 0);
-
-    /* if dup2 is unsuccessful set an error message and exit*/
-    if (dup2InReturn == -1 )
-    {
-        perror("dup2() unsuccessful\n");
-        exit(1);
-    }
+    int nameLength = strlen(name);
 
-    /* return the file descriptor */
-    return inFileDescriptor;
+    return strncmp(commandLine, name, nameLength) == 0
+           && (commandLine[nameLength] == '\0' || isspace((unsigned char)commandLine[nameLength]));
 }
 
-/* Takes as input the name of a file from which the output stream stdout will
- * be diverted to, opens it, sets it to replace stdout and returns the file
- * descriptor obtained by opening the file for writing.
+/* Puts "timed out after N seconds, " in front of the exit or termination
+ * status of a job that ran past its time limit.
  */
-int setOutputStream(char *fileNameOut)
+void reportTimeout(char exitStatusStr[], double timeout)
 {
-    int outFileDescriptor;  /* the file descriptor value returned by open() */
-    int dup2OutReturn;  /* the return value of dup2() */
-    char errorMessage[ERROR_MESSAGE_MAX]; /* used to hold an error message */
+    char statusStr[STATUS_LENGTH];  /* copy of the original status */
 
-    /* open a file for writing, where if the file does not exist it will be
-     * created and if it does it will be truncated.
+    /* the termination status is cut off rather than the prefix, though
+     * STATUS_LENGTH leaves room for both
      */
-    outFileDescriptor = open(fileNameOut, O_WRONLY | O_CREAT | O_TRUNC, 0644);
-
-    /* if unsuccessful in opening file print an error message to stderr and exit*/
-    if (outFileDescriptor == -1)
-    {
-        memset(errorMessage,'\0', ERROR_MESSAGE_MAX);
-        sprintf(errorMessage, "cannot open %s for output\n", fileNameOut);
-        fprintf(stderr,errorMessage);
-        exit(1);
-    }
-
-    /* use dup2 to set stdout to the file opened above */
-    dup2OutReturn = dup2(outFileDescriptor, 1);
-
-    /* if dup2 is unsuccessful set an error message and exit*/
-    if (dup2OutReturn == -1 )
-    {
-        perror("dup2() unsuccessful\n");
-        exit(1);
-    }
-
-    /* return the file descriptor */
-    return outFileDescriptor;
+    strcpy(statusStr, exitStatusStr);
+    snprintf(exitStatusStr, STATUS_LENGTH, "timed out after %g seconds, %.*s", timeout,
+             TERMINATION_STATUS_LENGTH - 1, statusStr);
 }
 
 /* Initialize each element of the args array used to hold the commandline
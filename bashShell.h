@@ -5,28 +5,86 @@
  * 
  *               Emulates a bash shell with the following functionality:
  *
- *               Inbuilt cd, status and exit commands
+ *               Inbuilt cd, status, exit, exec, timeout, jobs, wait,
+ *               kill, cached, dag, batch, history, alias, unalias,
+ *               return, jtop, every and at commands
+ *
+ *               Command lists joined by ;, && and || on one commandline.
+ *
+ *               for and while loops whose commands are parsed once.
+ *
+ *               Functions and aliases that are parsed once and run in the
+ *               shell's own process.
+ *
+ *               Commandlines from a script or pipe are parsed on a thread
+ *               while the last command runs.
  *
  *               The ability to put jobs in the background by putting & at 
  *               the end of a commandline.
  *
- *               Redirection <, > from/to input/output files.
+ *               Redirection <, >, >>, N<, N>, N>>, N>&M, &> and &>> from/to
+ *               input/output files and other file descriptors. Output sent
+ *               to several files, as in > a > b, is copied into each, and
+ *               output sent with >z is compressed into a gzip file.
+ *
+ *               Here-documents <<WORD and here-strings <<< word.
  *
  *               Enforce foreground jobs exclusively using ^Z to enter and
  *               exit this mode.
  *
  *               Kill running jobs using ^C.
  *
- *               $$ expansion is supported.
+ *               $$ expansion and $(command) substitution are supported.
+ *
+ *               A time limit on foreground jobs, either per command with
+ *               timeout or for every job with the -t option.
+ *
+ *               Running a script file given on the commandline. Scripts
+ *               are compiled into a cache so later runs skip parsing.
+ *
+ *               The last command of a script or of -c is exec'd in place
+ *               of the shell rather than forked.
+ *
+ *               With -L, foreground commands are forked by a helper
+ *               process forked at startup, so launches stay fast however
+ *               large the shell grows.
+ *
+ *               All state is held in struct shellState, so the shell is
+ *               built as a library that can run many sessions in one
+ *               process.
  *
  *  The book The Linux Programming Interface by Kerrisk was heavily 
  *  referenced in the development of the following code as well as the course
  *  lecture examples.
  *  Chapters referenced include: chapters 20 - 27
  *              
- ****************************************************************************/ 
+ ****************************************************************************/
+
+#ifndef BASH_SHELL_H
+#define BASH_SHELL_H 
 
 #include "pid_tDynArr.h"  /* manages and initializes dynamic arrays of pid_t type */
+#include "hereDoc.h"  /* builds here-documents and here-strings in memory files */
+#include "jobTimer.h"  /* runs foreground jobs with a time limit */
+#include "openRing.h"  /* opens several files with one io_uring submission */
+#include "redirection.h"  /* parses and applies <, >, >>, 2>&1 and &> redirections */
+#include "fanOut.h"  /* copies output sent to several files with tee and splice and gzips >z output */
+#include "jobControl.h"  /* tracks background jobs by PID and pidfd */
+#include "jobMonitor.h"  /* samples the CPU and memory of background jobs from /proc */
+#include "jobSlots.h"  /* limits the background jobs of every shell on the host */
+#include "jobSchedule.h"  /* runs commands every INTERVAL or at a TIME from a timer wheel */
+#include "launcher.h"  /* forks foreground commands from a helper forked at startup */
+#include "scriptCache.h"  /* compiles scripts into a cached intermediate representation */
+#include "commandList.h"  /* splits commandlines into lists joined by ;, && and || */
+#include "parseAhead.h"  /* parses commandlines on a thread ahead of running them */
+#include "resultCache.h"  /* stores the output files of cached commands */
+#include "jobDag.h"  /* runs files of commands in the order of their dependencies */
+#include "commandSubstitution.h"  /* runs $(command) and splits its output into arguments */
+#include "argumentBatch.h"  /* splits argument lists too long for execve into batches */
+#include "commandHistory.h"  /* keeps an indexed log of commandlines for history and ! */
+#include "commandLoop.h"  /* runs for and while loops from commands parsed once */
+#include "commandTemplate.h"  /* parses commands once and patches parameters into copies */
+#include "shellFunction.h"  /* keeps functions and aliases as parsed commands */
 #include <stdio.h>
 #include <stdlib.h> 
 #include <stdbool.h> /* emulates the boolean type */
@@ -34,8 +92,15 @@
 #include <signal.h>  /* for managing signals */
 #include <unistd.h>  /* use for fork, read/write primatives etc... */
 #include <sys/types.h>  /* includes pid_t type  */
+#include <sys/wait.h>  /* for waitpid and the W* status macros */
 #include <fcntl.h>  /* use for opening files to get descriptors */
 #include <errno.h>  /* use to get error information */
+#include <ctype.h>  /* for isspace */
+#include <limits.h>  /* for PATH_MAX */
+#include <sys/stat.h>  /* for fstat and S_ISREG */
+
+/* The version of the shell, which is part of the key of a compiled script */
+#define SHELL_VERSION "2.5"
 
 /* maximum length of the command line including 1 char for '\0'*/
 #define MAX_COMMAND_LINE 2048 + 1  
@@ -64,7 +129,16 @@
 #define MAX_INT_LENGTH 11
 
 /* Maximum length of an exit with, or terminated by message */
-#define STATUS_LENGTH 60
+#define TERMINATION_STATUS_LENGTH 60
+
+/* Maximum length of a status, which for a timed out job is the termination
+ * status after "timed out after %g seconds, ", at most 39 characters
+ */
+#define TIMEOUT_PREFIX_LENGTH 40
+#define STATUS_LENGTH (TIMEOUT_PREFIX_LENGTH + TERMINATION_STATUS_LENGTH)
+
+/* A process killed by a signal has exit status SIGNAL_STATUS_BASE + signal */
+#define SIGNAL_STATUS_BASE 128
 
 /* Maximum length of an error message used in file opening */
 #define ERROR_MESSAGE_MAX 80
@@ -79,14 +153,160 @@
  */
 enum expandStatus{ successful, commandLineTooLong};
 
-/* Used by a signal handler and so declare to be volatile and atomic to 
- * avoid potential compiler optimizations and non-atomic reads and writes
- * This variable is TRUE when the user presses ^Z and sets the shell into
- * foreground mode. Otherwise it is false.
- * Reference: Office hours and The Linux Programming Inteface by Kerrisk
- * pg 428
+/* Used to indicate if stdin comes from a here-document (<<WORD), a
+ * here-string (<<< word) or neither.
  */
-static volatile sig_atomic_t canPutInBackground = TRUE;
+enum hereType{ noHere, hereDocument, hereString};
+
+/* Used to indicate which inbuilt command a commandline is, or externalLine
+ * if it is a command that is launched as a process.
+ */
+enum lineType{ timeoutLine, exitLine, commentLine, cdLine, jobsLine, waitLine,
+               killLine, statusLine, execLine, cachedLine, dagLine,
+               batchLine, historyLine, loopLine, functionLine, aliasLine,
+               unaliasLine, returnLine, monitorLine, scheduleLine,
+               externalLine};
+
+/* The exit statuses of an exec without a command and of one whose command
+ * can't be found or run, as in bash
+ */
+#define EXEC_USAGE_ERROR 2
+#define EXEC_NOT_FOUND 127
+#define EXEC_FAILED 126
+
+/* A parsed commandline that is ready to be launched as a process */
+struct command
+{
+    /* Holds the commandline arguments that are passed to execvp. Each is a
+     * dynamic string and the array is ended by NULL. args points to
+     * inlineArgs until a $(...) adds more than MAX_NUM_ARGS - 1 arguments,
+     * then to a dynamic array that doubles when it is full.
+     */
+    char **args;
+    int numArgs;  /* the number of arguments in the args array */
+    int argsCapacity;  /* the size of the args array */
+    char *inlineArgs[MAX_NUM_ARGS];
+
+    /* The index of the first argument from a $(...), or -1 */
+    int firstSubstitutedArg;
+
+    /* How the command is split when run with the batch inbuilt command */
+    struct batchOptions batch;
+
+    /* The redirections of the commandline, such as < input_file or 2>&1 */
+    struct redirectionTable redirections;
+
+    bool inBackground; /* true if process is in the background */
+
+    /* indicates if stdin comes from a here-document or here-string, and holds
+     * the here-document delimiter or the here-string word
+     */
+    enum hereType hereType;
+    char hereWord[MAX_FILE_NAME];
+
+    /* The time limit of the job and the grace period before SIGKILL */
+    double timeout;
+    double killAfter;
+    bool haveTimeout;  /* true if the timeout inbuilt command set the time limit */
+
+    /* true if the command is exec'd in place of the shell rather than forked */
+    bool replaceShell;
+
+    /* false while a script is compiled, so parsing errors are only printed
+     * when the line is run
+     */
+    bool reportErrors;
+
+    /* The outputs of the $(...) of the command, or NULL if it has none */
+    struct substitutionList *substitutions;
+};
+
+/* The state of the shell that lasts from one commandline to the next */
+struct shellState
+{
+    pid_t parentPID; /* process number of the bashShell program */
+    pid_t foregroundPID; /* process number of the foreground process */
+
+    /* The table of active background processes, holding the PID and pidfd of each */
+    struct jobTable jobs;
+
+    /* stores process exit and termination information that is printed to stdout */
+    char exitStatusStr[STATUS_LENGTH]; 
+
+    /* The time limit in seconds given to every foreground job with -t */
+    double jobDeadline;
+
+    /* The number of background jobs the shells of the host may have
+     * running at once, or 0 if $BASHSHELL_JOB_SLOTS doesn't set a limit
+     */
+    int jobSlotLimit;
+
+    /* Commandlines and the bodies of here-documents are read from input */
+    FILE *input;
+    bool prompt;  /* true if a prompt is printed before reading each commandline */
+
+    /* true if commandlines that don't come from a terminal are parsed on a
+     * thread while the last command runs. Turned off with -S.
+     */
+    bool parseAhead;
+
+    bool exitRequested;  /* set to true when the shell is to exit */
+
+    /* The exit status of the last command run, which decides if a command
+     * after && or || runs
+     */
+    int lastStatus;
+
+    /* true while the commandline being run is the last of the input, as
+     * when nothing follows it in a script or it is the string given to -c
+     */
+    bool lastLine;
+
+    /* true while the command being run is the last the shell will run, so
+     * it can be exec'd in place of the shell
+     */
+    bool tailCommand;
+
+    /* Set by the SIGTSTP handler of the bashShell program and so declared
+     * volatile and atomic to avoid potential compiler optimizations and
+     * non-atomic reads and writes. This variable is TRUE when the user
+     * presses ^Z and sets the shell into foreground mode. Otherwise it is
+     * FALSE.
+     * Reference: Office hours and The Linux Programming Inteface by Kerrisk
+     * pg 428
+     */
+    volatile sig_atomic_t foregroundOnly;
+
+    /* true if the shell is a session hosted by another program, where exec
+     * would replace the host rather than the shell
+     */
+    bool embedded;
+
+    /* The fds commands are given as stdin, stdout and stderr unless they
+     * redirect them, or -1 to leave the shell's own
+     */
+    int stdioFds[3];
+
+    /* The commandlines of this and other sessions, kept when the shell is
+     * interactive or run with -H
+     */
+    struct commandHistory history;
+
+    /* The functions and aliases defined in the shell */
+    struct functionTable functions;
+
+    /* The /proc files of the background jobs, kept open by jobs -l and jtop */
+    struct jobMonitor monitor;
+
+    /* The commands scheduled by every and at */
+    struct jobSchedule schedule;
+
+    /* The PID of the last background job launched, or 0 */
+    pid_t lastBackgroundPid;
+
+    /* The helper that forks foreground commands with -L */
+    struct launcher launcher;
+};
 
 /* Takes as input the commandline, the pid that results from $$ and expands all
  * instances of $$ in the commandline then puts the result in the input char array
@@ -106,46 +326,192 @@ enum expandStatus expandString(char *str, pid_t pid, char *strExpanded);
  */
 void intToString(char str[],int number);
 
-/* Takes the $$ expanded commandline and parses it into an args[] array to 
- * pass onto excvp and also gets the relevant stream data if <, >, & is found
- * in the commandline. In addition, if <, >, and/or & are found in the command
- * line appropriate flags are set.
- * input: the starting index in the args array: int
- *        the $$ expanded commandline: char[]
- *        the args array that is to be passed to execvp: char[]
- *        a boolean that will be set to true if < is found: bool &
- *        a boolean that will be set to true if > is found: bool &
- *        a boolean that will be set to true if & is found: bool &  
- *        a char array that will hold the name of an input file if < is found: char[]   
- *        a char array that will hold the name of an input file if > is found: char[]              
- */
-void parseArguments(int *index, char bufferExpanded[], char *args[], bool *haveInput, bool *haveOutput,
-                   bool *inBackground, char fileNameIn[], char fileNameOut[]);
+/* Takes the $$ expanded commandline and parses it into the args[] array of
+ * the command to pass onto excvp and also adds any redirections found in the
+ * commandline to its redirection table. In addition, if <<, <<< and/or & are
+ * found in the command line appropriate flags are set.
+ * input: the $$ expanded commandline: char[]
+ *        the command to fill in: struct command *
+ * output: 0 if successful or -1 after printing an error if a redirection,
+ *         here-document or here-string is missing its word
+ */
+int parseArguments(char bufferExpanded[], struct command *command);
+
+/* Copies the token into a dynamic string at the end of the command's args
+ * array.
+ * input: the command: struct command *
+ *        the token: char *
+ * output: 0 if successful or -1 if the args array is full
+ */
+int addArgument(struct command *command, char *token);
+
+/* Initializes a command to have no arguments, redirections or here-document
+ * and to run in the foreground with the given time limit.
+ * input: the command: struct command *
+ *        the time limit in seconds or NO_TIMEOUT: double
+ */
+void initializeCommand(struct command *command, double timeout);
+
+/* Frees the dynamic strings held by a command's args array and redirection
+ * table.
+ * input: the command: struct command *
+ */
+void freeCommand(struct command *command);
+
+/* Initializes the state of the shell to read commandlines from stdin with a
+ * prompt.
+ * input: the shell: struct shellState *
+ */
+void initializeShell(struct shellState *shell);
+
+/* Reads commandlines from the shell's input and runs them until the user
+ * exits or, unless the input is a terminal, the input ends. Input that isn't
+ * a terminal is read with parse-ahead unless it is turned off.
+ * input: the shell: struct shellState *
+ */
+void runShell(struct shellState *shell);
+
+/* Reaps any finished background jobs of the shell, printing their exit or
+ * termination status and removing them from the job table. Children that
+ * aren't the shell's jobs are left alone.
+ * input: the shell: struct shellState *
+ */
+void reapBackgroundJobs(struct shellState *shell);
+
+/* Kills any remaining background jobs and tells the shell to exit.
+ * input: the shell: struct shellState *
+ */
+void exitShell(struct shellState *shell);
+
+/* Expands $$ in a commandline, splits it into a list of commands at ;, &&
+ * and || and runs each command whose connector allows it.
+ * input: the shell: struct shellState *
+ *        the commandline as read from the input: char *
+ */
+void runCommandLine(struct shellState *shell, char *commandLine);
+
+/* Runs a single $$ expanded command of a list, either as an inbuilt command
+ * or by launching it as a foreground or background process, and sets the
+ * exit status of the shell.
+ * input: the shell: struct shellState *
+ *        the $$ expanded command, which is split up by strtok: char[]
+ */
+void runListCommand(struct shellState *shell, char commandText[]);
+
+/* Parses a command of a list into a command that can be launched, without
+ * printing any errors, if it is a command or a timeout of a command.
+ * input: the $$ expanded command, which is split up by strtok_r: char[]
+ *        an initialized command to fill in: struct command *
+ * output: true if the command can be launched, or false if it is an inbuilt
+ *         command or doesn't parse, in which case it is run with
+ *         runListCommand
+ */
+bool parseListCommand(char commandText[], struct command *command);
+
+/* Reads and throws away the body of a here-document of a command that is
+ * skipped by && or ||, so its lines aren't run as commands.
+ * input: the shell: struct shellState *
+ *        the $$ expanded command: char[]
+ */
+void skipListCommand(struct shellState *shell, char commandText[]);
+
+/* Returns which inbuilt command the $$ expanded commandline is, or
+ * externalLine if it is a command to launch as a process.
+ * input: the $$ expanded commandline: char[]
+ * output: the type of commandline: enum lineType
+ */
+enum lineType classifyCommandLine(char commandLine[]);
+
+/* Forks and execs a parsed command, waiting for it if it is in the
+ * foreground or adding it to the job table if it is in the background.
+ * input: the shell: struct shellState *
+ *        the parsed command: struct command *
+ */
+void launchCommand(struct shellState *shell, struct command *command);
+
+/* Redirects the stdin, stdout and stderr of a command that aren't already
+ * redirected to those of a session hosted by another program.
+ * input: the shell: struct shellState *
+ *        the parsed command: struct command *
+ * output: 0 if successful or -1 after printing an error if the command
+ *         has too many redirections
+ */
+int addSessionRedirections(struct shellState *shell, struct command *command);
+
+/* Opens the redirections of a loop or function call and makes them the
+ * stdin, stdout and stderr of the shell's commands that don't redirect them
+ * themselves, saving those in use.
+ * input: the shell: struct shellState *
+ *        the redirections, whose files are kept open in it: struct redirectionTable *
+ *        an int[3] for the stdio fds in use: int[]
+ * output: 0 if successful or -1 after printing an error if an fd above 2
+ *         is redirected or a file can't be opened, in which case nothing
+ *         has to be popped
+ */
+int pushSessionRedirections(struct shellState *shell, struct redirectionTable *table, int savedFds[]);
+
+/* Gives the shell's commands back the stdin, stdout and stderr saved by
+ * pushSessionRedirections and closes the files it opened.
+ * input: the shell: struct shellState *
+ *        the redirections: struct redirectionTable *
+ *        the saved stdio fds: int[]
+ */
+void popSessionRedirections(struct shellState *shell, struct redirectionTable *table, int savedFds[]);
+
+/* Returns true if the input has no more commandlines. Only input that can
+ * be looked ahead in without waiting, a regular file or a string, is
+ * checked; other input is never at its end until it is read.
+ * input: the input of the shell: FILE *
+ */
+bool atEndOfInput(FILE *input);
+
+/* Returns true if name can be exec'd, looking for it in PATH as execvp does
+ * if it doesn't hold a '/', and puts the path that was found in path.
+ * input: the command name: char *
+ *        a char array of PATH_MAX for the path: char[]
+ */
+bool findExecutable(char *name, char path[]);
+
+/* Runs the command in the current process with its redirections applied
+ * and the signal handling of a child. Only returns if it couldn't be run.
+ * input: the parsed command, whose redirections are opened if they
+ *        haven't been: struct command *
+ */
+void execCommand(struct command *command);
+
+/* Execs a command in place of the shell. Nothing is changed and the shell
+ * goes on if the command can't be found, its files can't be opened or the
+ * shell is an embedded session, but if exec fails after its redirections
+ * are applied the shell exits.
+ * input: the shell: struct shellState *
+ *        the parsed command: struct command *
+ */
+void replaceShell(struct shellState *shell, struct command *command);
 
 /* Takes in the status returned from waitpid (childExitMethod) and runs it
  * through WIFSIGNALED, WTERMSIG, WIFEXITED and/or WEXITSTATUS to get either an
  * exit or termination status and puts the result in the string argument.
  * input: the status returned from waitpid: int
  *        a string to put the return status in: char[]
+ * output: the exit value, or 128 + the signal number if signaled, as used
+ *         by && and ||
  */
-void terminationStatus(int childExitMethod, char exitStatusStr[], int *terminationSignal);
+int terminationStatus(int childExitMethod, char exitStatusStr[], int *terminationSignal);
 
-
-/* Takes as input the name of a file from which the input stream stdin will
- * be diverted to, opens it, sets it to replace stdin and returns the file
- * descriptor obtained by opening the file for reading.
- * input: the file name: char[]
- * output: the file descriptor: int
+/* Returns true if the commandline is the inbuilt command name, either on its
+ * own or followed by arguments.
+ * input: the $$ expanded commandline: char[]
+ *        the name of the inbuilt command: char *
  */
-int setInputStream(char *fileNameIn);
+bool isBuiltin(char commandLine[], char *name);
 
-/* Takes as input the name of a file from which the output stream stdout will
- * be diverted to, opens it, sets it to replace stdout and returns the file
- * descriptor obtained by opening the file for writing.
- * input: the file name: char[]
- * output: the file descriptor: int
+/* Puts "timed out after N seconds, " in front of the exit or termination
+ * status of a job that ran past its time limit.
+ * input: the status returned by terminationStatus: char[]
+ *        the time limit in seconds: double
  */
-int setOutputStream(char *fileNameOut);
+void reportTimeout(char exitStatusStr[], double timeout);
+
 
 /* Initialize each element of the args array used to hold the commandline
  * arguments to pass to execvp. Each element is initialized to NULL.
@@ -164,5 +530,6 @@ char *getEmptyString(int size);
 /* Frees a dynamic char string and sets its pointer value to NULL.
  * input: the dynamic char array: char *
  */
-void freeString(char *);  
+void freeString(char *);
 
+#endif
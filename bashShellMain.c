@@ -0,0 +1,241 @@
+/***************************************************************************
+ * Name:         Selma Leathem
+ * Date:         10/18/2026
+ * Description:  The bashShell program, which sets up the signal handling of
+ *               an interactive shell, reads the commandline options and runs
+ *               the shell on the terminal, a script or the -c commandlines.
+ *
+ *               The shell itself is in the bashShell library, which can also
+ *               host shell sessions inside another program.
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 20 - 22
+ *  and Appendix B
+ *
+ ****************************************************************************/
+
+#include "bashShell.h"
+
+/* The shell run by this program, whose foreground-only mode is switched by
+ * ^Z. The signal handler can only reach it through a file scope pointer.
+ */
+static struct shellState *interactiveShell = NULL;
+
+/* Signal catcher for SIGTSTP. Switches the shell's atomic foreground-only
+ * flag and prints a message when activated.
+ */
+static void catchSIGTSTP(int theSignal)
+{
+    char* messageEnter = "Entering foreground-only mode (& is now ignored)\n";
+    char* messageLeave = "Exiting foreground-only mode\n";
+    char* prompt = ": ";
+
+    if (interactiveShell == NULL)
+    {
+        return;
+    }
+
+    /* If the shell is not in foreground only mode then put it in foreground
+     * only mode by setting foregroundOnly to TRUE and printing messageEnter.
+     */
+    if (interactiveShell->foregroundOnly == FALSE)
+    {
+        write(STDOUT_FILENO, messageEnter, 49);
+        write(STDOUT_FILENO, prompt, 2);
+        interactiveShell->foregroundOnly = TRUE;
+    }
+    /* If the shell is in foreground only mode then take it out of foreground
+     * only mode by setting foregroundOnly to FALSE and printing messageLeave.
+     */
+    else
+    {
+        write(STDOUT_FILENO, messageLeave, 29);
+        interactiveShell->foregroundOnly = FALSE;
+        write(STDOUT_FILENO, prompt, 2); 
+    }  
+    
+}
+
+int main(int argc, char *argv[])
+{
+    /* The state of the shell, including the job table and the latest status */
+    struct shellState shell;
+
+    /* The script file named on the commandline, if any */
+    char *scriptName = NULL;
+
+    /* The commandlines given with -c, if any */
+    char *commandString = NULL;
+    char *newline;  /* the first newline of the -c commandlines */
+
+    /* false if the -N option turns off the compiled script cache */
+    bool useScriptCache = true;
+
+    /* true if the -L option has foreground commands forked by a helper */
+    bool useLauncher = false;
+
+    int option; /* the commandline option returned by getopt() */
+
+    /* Declare sigaction struct variables for handling the indicated signal
+     * Note that ignore_action variable is used for ignoring the signal
+     * that uses it.
+     */
+    struct sigaction ignore_action = {0};
+    struct sigaction SIGTSTPaction = {0};
+
+    /*********** for SIGINT**********/
+    /* set ignore_action signal handler to ignore SIG_IGN */
+    ignore_action.sa_handler = SIG_IGN;
+    /* specify the action to be taken with a SIGINT signal */
+    sigaction(SIGINT, &ignore_action, NULL);  
+
+     
+     /*********** for SIGTSTP**********/
+    /* set the SIGTSTP signal handler to  catchSIGTSTP */ 
+    SIGTSTPaction.sa_handler = catchSIGTSTP;
+    /*Ensure if the signal delivered during an open, read, or write
+    * operation that these can restart rather than return a failure
+    */
+    SIGTSTPaction.sa_flags = SA_RESTART;
+    /* set to block all signals while the signal handler is executing */
+    sigfillset(&SIGTSTPaction.sa_mask);
+    /* specify the action to be taken with a SIGTSTP signal */
+    sigaction(SIGTSTP, &SIGTSTPaction, NULL);
+
+
+    /**************** initialize program variables ***************/
+    
+    initializeShell(&shell);
+    interactiveShell = &shell;
+
+    /**************** read the commandline options ***************/
+
+    /* -t DURATION sets a time limit on every foreground job, -N turns off
+     * the compiled script cache, -S turns off parse-ahead, -H keeps the
+     * history when the shell isn't interactive, -L forks foreground
+     * commands from a launcher helper and -c runs the given commandlines.
+     * An optional script file follows the options.
+     * Reference: The Linux Programming Interface by Kerrisk Appendix B
+     */
+    while ((option = getopt(argc, argv, "t:NSHLc:")) != -1)
+    {
+        if (option == 't' && (shell.jobDeadline = parseDuration(optarg)) >= 0)
+        {
+            continue;
+        }
+        if (option == 'N')
+        {
+            useScriptCache = false;
+            continue;
+        }
+        if (option == 'S')
+        {
+            shell.parseAhead = false;
+            continue;
+        }
+        if (option == 'H')
+        {
+            shell.history.enabled = true;
+            continue;
+        }
+        if (option == 'L')
+        {
+            useLauncher = true;
+            continue;
+        }
+        if (option == 'c')
+        {
+            commandString = optarg;
+            continue;
+        }
+        fprintf(stderr, "usage: %s [-t DURATION] [-N] [-S] [-H] [-L] [-c COMMANDS | script]\n", argv[0]);
+        exit(1);
+    }
+
+    /* The helper is forked before the history, caches and jobs grow the
+     * shell, and before any thread is started, so it stays small.
+     */
+    if (useLauncher == true)
+    {
+        startLauncher(&shell.launcher);
+    }
+
+    /* Commandlines given with -c are read from the string as if it were a
+     * script, so a here-document body can follow its commandline.
+     * Reference: https://man7.org/linux/man-pages/man3/fmemopen.3.html
+     */
+    if (commandString != NULL)
+    {
+        if (commandString[0] == '\0')
+        {
+            freeJobTable(&shell.jobs);
+            return 0;
+        }
+
+        shell.input = fmemopen(commandString, strlen(commandString), "r");
+        if (shell.input == NULL)
+        {
+            perror("fmemopen");
+            exit(1);
+        }
+        shell.prompt = false;
+
+        /* A single commandline has nothing to parse ahead of, so the
+         * producer thread would only add its start to the latency of the
+         * command.
+         */
+        newline = strchr(commandString, '\n');
+        if (newline == NULL || newline[1] == '\0')
+        {
+            shell.parseAhead = false;
+        }
+    }
+    /* Commandlines are read from the script, without a prompt, if one is given */
+    else if (optind < argc)
+    {
+        scriptName = argv[optind];
+        shell.input = fopen(scriptName, "r");
+        if (shell.input == NULL)
+        {
+            fprintf(stderr, "cannot open %s\n", scriptName);
+            exit(1);
+        }
+        shell.prompt = false;
+    }
+
+    /* As in bash, the history is kept when the user types the commandlines */
+    if (shell.input == stdin && isatty(STDIN_FILENO))
+    {
+        shell.history.enabled = true;
+    }
+
+    /* A script that was compiled on an earlier run is executed from its cache
+     * without expanding or parsing its commandlines again. With -H each line
+     * goes through the history, so it is read as usual.
+     */
+    if (scriptName == NULL || useScriptCache == false || shell.history.enabled == true
+        || runCachedScript(&shell, scriptName) == -1)
+    {
+        runShell(&shell);
+    }
+
+    if (shell.input != stdin)
+    {
+        fclose(shell.input);
+    }
+
+    /* The job table holds dynamic arrays which are freed before the program exits */
+    freeJobTable(&shell.jobs);
+    freeHistory(&shell.history);
+    freeFunctions(&shell.functions);
+    freeJobMonitor(&shell.monitor);
+    freeSchedule(&shell.schedule);
+    stopLauncher(&shell.launcher);
+
+    /* The output of background jobs sent to several files is finished */
+    waitForFanOuts();
+
+    /* The shell exits with the status of its last command, or the N of
+     * "exit N", as it would if the last command had been exec'd in its place
+     */
+    return shell.lastStatus & 0xff;
+}
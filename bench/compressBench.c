@@ -0,0 +1,255 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Benchmark of output compressed by the shell with >z,
+ *              against piping the output through a gzip process.
+ *
+ *              Writes a log of N megabytes and times cat writing it
+ *              compressed as bashShell -c "cat FILE >z out.gz" and as the
+ *              pipeline cat FILE | gzip > out.gz, set up here since the
+ *              shell has no pipes. Both compress at gzip's default level.
+ *              The wall time, the throughput of the uncompressed data and
+ *              the CPU time of every process of each way are reported,
+ *              with the sizes of the two files.
+ *
+ *              usage: compressBench [shell] [megabytes] [runs] [directory]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define DEFAULT_SHELL "./bashShell"
+#define DEFAULT_MEGABYTES 64
+#define DEFAULT_RUNS 5
+#define MAX_RUNS 100
+#define DEFAULT_DIRECTORY "/tmp"
+
+#define GZIP_PATH "/bin/gzip"
+#define CAT_PATH "/bin/cat"
+
+#define MAX_PATH 512
+#define MAX_COMMAND 2048
+
+/* The names of the source and the compressed output in the directory */
+static char sourcePath[MAX_PATH];
+static char outputPath[MAX_PATH];
+
+/* The time of a run */
+struct runTime
+{
+    double wall;
+    double cpu;  /* the user and system time of every process of the run */
+};
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Waits for a process and returns its user and system time in seconds */
+static double waitForCpu(pid_t pid)
+{
+    struct rusage usage;
+
+    wait4(pid, NULL, 0, &usage);
+
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6
+           + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+/* Forks and execs a program with stdin and stdout from the fds given, or
+ * the bench's own where they are -1, and returns its PID
+ */
+static pid_t spawn(char *argv[], int inputFd, int outputFd, int closeFd)
+{
+    pid_t pid;
+
+    pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        if (inputFd != -1)
+        {
+            dup2(inputFd, STDIN_FILENO);
+        }
+        if (outputFd != -1)
+        {
+            dup2(outputFd, STDOUT_FILENO);
+        }
+        if (closeFd != -1)
+        {
+            close(closeFd);
+        }
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+
+    return pid;
+}
+
+/* Returns the size of the output of the last run */
+static long outputSize(void)
+{
+    struct stat fileStat;
+
+    return (stat(outputPath, &fileStat) == 0) ? (long)fileStat.st_size : -1;
+}
+
+/* Times the shell running cat FILE >z out.gz. The shell's CPU time holds
+ * its compressing thread's.
+ */
+static struct runTime timeShell(char *shell, char *commandLine)
+{
+    char *argv[] = {shell, "-c", commandLine, NULL};
+    struct runTime run;
+    double start;
+
+    unlink(outputPath);
+    start = now();
+    run.cpu = waitForCpu(spawn(argv, -1, -1, -1));
+    run.wall = now() - start;
+
+    return run;
+}
+
+/* Times cat FILE | gzip > out.gz */
+static struct runTime timeGzipPipe(void)
+{
+    char *catArgv[] = {CAT_PATH, sourcePath, NULL};
+    char *gzipArgv[] = {GZIP_PATH, "-c", NULL};
+    struct runTime run;
+    int pipeFds[2];
+    int outputFd;
+    pid_t catPid;
+    pid_t gzipPid;
+    double start;
+
+    unlink(outputPath);
+    start = now();
+
+    outputFd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (outputFd == -1 || pipe(pipeFds) == -1)
+    {
+        perror(outputPath);
+        exit(1);
+    }
+
+    catPid = spawn(catArgv, -1, pipeFds[1], pipeFds[0]);
+    gzipPid = spawn(gzipArgv, pipeFds[0], outputFd, pipeFds[1]);
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+    close(outputFd);
+
+    run.cpu = waitForCpu(catPid) + waitForCpu(gzipPid);
+    run.wall = now() - start;
+
+    return run;
+}
+
+/* Compares the wall times of runs for qsort */
+static int compareRuns(const void *a, const void *b)
+{
+    double difference = ((const struct runTime *)a)->wall - ((const struct runTime *)b)->wall;
+
+    return (difference > 0) - (difference < 0);
+}
+
+/* Prints the median run and returns it */
+static struct runTime report(char *name, struct runTime runs[], int numRuns, int megabytes, long size)
+{
+    struct runTime median;
+
+    qsort(runs, numRuns, sizeof(struct runTime), compareRuns);
+    median = runs[numRuns / 2];
+
+    printf("%-24s median %7.3f s  %7.1f MB/s  cpu %7.3f s  %10ld bytes\n",
+           name, median.wall, megabytes / median.wall, median.cpu, size);
+
+    return median;
+}
+
+int main(int argc, char *argv[])
+{
+    char *shell = (argc > 1) ? argv[1] : DEFAULT_SHELL;
+    int megabytes = (argc > 2) ? atoi(argv[2]) : DEFAULT_MEGABYTES;
+    int numRuns = (argc > 3) ? atoi(argv[3]) : DEFAULT_RUNS;
+    char *directory = (argc > 4) ? argv[4] : DEFAULT_DIRECTORY;
+    char compressLine[MAX_COMMAND];
+    struct runTime shellRuns[MAX_RUNS];
+    struct runTime gzipRuns[MAX_RUNS];
+    struct runTime shellMedian, gzipMedian;
+    long shellSize = -1;
+    long gzipSize = -1;
+    long written = 0;
+    long line = 0;
+    FILE *stream;
+    int i;
+
+    if (megabytes <= 0 || numRuns <= 0 || numRuns > MAX_RUNS)
+    {
+        fprintf(stderr, "usage: %s [shell] [megabytes] [runs <= %d] [directory]\n", argv[0], MAX_RUNS);
+        return 1;
+    }
+
+    snprintf(sourcePath, MAX_PATH, "%s/compressBench.%d.log", directory, (int)getpid());
+    snprintf(outputPath, MAX_PATH, "%s/compressBench.%d.gz", directory, (int)getpid());
+
+    /* Lines like a job's log, which compress about as well as one does */
+    stream = fopen(sourcePath, "w");
+    if (stream == NULL)
+    {
+        perror(sourcePath);
+        return 1;
+    }
+    while (written < (long)megabytes << 20)
+    {
+        written += fprintf(stream, "2026-10-18 12:%02ld:%02ld.%03ld INFO worker-%ld processed item %ld in %ld ms\n",
+                           line / 60000 % 60, line / 1000 % 60, line % 1000, line % 16,
+                           line * 7919 % 1000003, line * 31 % 977);
+        line++;
+    }
+    fclose(stream);
+
+    snprintf(compressLine, MAX_COMMAND, "%s %s >z %s", CAT_PATH, sourcePath, outputPath);
+
+    /* The runs of each way are interleaved so the page cache and the disk
+     * treat them alike
+     */
+    for (i = 0; i < numRuns; i++)
+    {
+        shellRuns[i] = timeShell(shell, compressLine);
+        shellSize = outputSize();
+        gzipRuns[i] = timeGzipPipe();
+        gzipSize = outputSize();
+    }
+
+    printf("%d MB log compressed in %s, median of %d runs\n", megabytes, directory, numRuns);
+    shellMedian = report("shell >z out.gz", shellRuns, numRuns, megabytes, shellSize);
+    gzipMedian = report("cat | gzip > out.gz", gzipRuns, numRuns, megabytes, gzipSize);
+    printf(">z takes %.0f%% of the time and %.0f%% of the CPU of a gzip process\n",
+           100 * shellMedian.wall / gzipMedian.wall, 100 * shellMedian.cpu / gzipMedian.cpu);
+
+    unlink(outputPath);
+    unlink(sourcePath);
+
+    return 0;
+}
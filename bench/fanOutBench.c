@@ -0,0 +1,235 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Benchmark of output sent to several files, copied by the
+ *              shell with tee and splice, against piping the output
+ *              through a tee process.
+ *
+ *              Writes a file of N megabytes and times cat writing it to
+ *              three files as bashShell -c "cat FILE > a > b > c" and as
+ *              the pipeline cat FILE | tee a b > c, set up here since the
+ *              shell has no pipes. cat FILE > a alone, through the shell,
+ *              is the cost of writing one copy. The files are removed
+ *              before each run, so every run writes new files.
+ *
+ *              usage: fanOutBench [shell] [megabytes] [runs] [directory]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define DEFAULT_SHELL "./bashShell"
+#define DEFAULT_MEGABYTES 256
+#define DEFAULT_RUNS 5
+#define MAX_RUNS 100
+#define DEFAULT_DIRECTORY "/tmp"
+
+#define TEE_PATH "/usr/bin/tee"
+#define CAT_PATH "/bin/cat"
+
+#define MAX_PATH 512
+#define MAX_COMMAND 2048
+
+/* The names of the source and the three outputs in the directory */
+static char sourcePath[MAX_PATH];
+static char outputPaths[3][MAX_PATH];
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Removes the outputs of the last run */
+static void removeOutputs(void)
+{
+    int i;
+
+    for (i = 0; i < 3; i++)
+    {
+        unlink(outputPaths[i]);
+    }
+}
+
+/* Forks and execs a program with stdin and stdout from the fds given, or
+ * the bench's own where they are -1, and returns its PID
+ */
+static pid_t spawn(char *argv[], int inputFd, int outputFd, int closeFd)
+{
+    pid_t pid;
+
+    pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        if (inputFd != -1)
+        {
+            dup2(inputFd, STDIN_FILENO);
+        }
+        if (outputFd != -1)
+        {
+            dup2(outputFd, STDOUT_FILENO);
+        }
+        if (closeFd != -1)
+        {
+            close(closeFd);
+        }
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+
+    return pid;
+}
+
+/* Times the shell running a commandline */
+static double timeShell(char *shell, char *commandLine)
+{
+    char *argv[] = {shell, "-c", commandLine, NULL};
+    double start;
+
+    removeOutputs();
+    start = now();
+    waitpid(spawn(argv, -1, -1, -1), NULL, 0);
+
+    return now() - start;
+}
+
+/* Times cat FILE | tee a b > c */
+static double timeTeePipe(void)
+{
+    char *catArgv[] = {CAT_PATH, sourcePath, NULL};
+    char *teeArgv[] = {TEE_PATH, outputPaths[0], outputPaths[1], NULL};
+    int pipeFds[2];
+    int lastFd;
+    pid_t catPid;
+    pid_t teePid;
+    double start;
+
+    removeOutputs();
+    start = now();
+
+    lastFd = open(outputPaths[2], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (lastFd == -1 || pipe(pipeFds) == -1)
+    {
+        perror(outputPaths[2]);
+        exit(1);
+    }
+
+    catPid = spawn(catArgv, -1, pipeFds[1], pipeFds[0]);
+    teePid = spawn(teeArgv, pipeFds[0], lastFd, pipeFds[1]);
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+    close(lastFd);
+
+    waitpid(catPid, NULL, 0);
+    waitpid(teePid, NULL, 0);
+
+    return now() - start;
+}
+
+/* Compares doubles for qsort */
+static int compareTimes(const void *a, const void *b)
+{
+    double difference = *(const double *)a - *(const double *)b;
+
+    return (difference > 0) - (difference < 0);
+}
+
+/* Prints the median and best of the times and returns the median */
+static double report(char *name, double times[], int runs, int megabytes)
+{
+    qsort(times, runs, sizeof(double), compareTimes);
+
+    printf("%-28s median %8.3f s  best %8.3f s  %8.1f MB/s\n",
+           name, times[runs / 2], times[0], megabytes / times[runs / 2]);
+
+    return times[runs / 2];
+}
+
+int main(int argc, char *argv[])
+{
+    char *shell = (argc > 1) ? argv[1] : DEFAULT_SHELL;
+    int megabytes = (argc > 2) ? atoi(argv[2]) : DEFAULT_MEGABYTES;
+    int runs = (argc > 3) ? atoi(argv[3]) : DEFAULT_RUNS;
+    char *directory = (argc > 4) ? argv[4] : DEFAULT_DIRECTORY;
+    char fanOutLine[MAX_COMMAND];
+    char singleLine[MAX_COMMAND];
+    double fanOutTimes[MAX_RUNS];
+    double teeTimes[MAX_RUNS];
+    double singleTimes[MAX_RUNS];
+    double fanOut, tee;
+    char block[1 << 16];
+    FILE *stream;
+    int i;
+
+    if (megabytes <= 0 || runs <= 0 || runs > MAX_RUNS)
+    {
+        fprintf(stderr, "usage: %s [shell] [megabytes] [runs <= %d] [directory]\n", argv[0], MAX_RUNS);
+        return 1;
+    }
+
+    snprintf(sourcePath, MAX_PATH, "%s/fanOutBench.%d.in", directory, (int)getpid());
+    for (i = 0; i < 3; i++)
+    {
+        snprintf(outputPaths[i], MAX_PATH, "%s/fanOutBench.%d.out%d", directory, (int)getpid(), i);
+    }
+
+    /* Lines of text, as a command's output usually is */
+    stream = fopen(sourcePath, "w");
+    if (stream == NULL)
+    {
+        perror(sourcePath);
+        return 1;
+    }
+    for (i = 0; i < (int)sizeof(block); i++)
+    {
+        block[i] = (i % 64 == 63) ? '\n' : 'a' + i % 26;
+    }
+    for (i = 0; i < megabytes * 16; i++)
+    {
+        fwrite(block, 1, sizeof(block), stream);
+    }
+    fclose(stream);
+
+    snprintf(fanOutLine, MAX_COMMAND, "%s %s > %s > %s > %s", CAT_PATH, sourcePath,
+             outputPaths[0], outputPaths[1], outputPaths[2]);
+    snprintf(singleLine, MAX_COMMAND, "%s %s > %s", CAT_PATH, sourcePath, outputPaths[0]);
+
+    /* The runs of each way are interleaved so the page cache and the disk
+     * treat them alike
+     */
+    for (i = 0; i < runs; i++)
+    {
+        fanOutTimes[i] = timeShell(shell, fanOutLine);
+        teeTimes[i] = timeTeePipe();
+        singleTimes[i] = timeShell(shell, singleLine);
+    }
+
+    printf("%d MB written to 3 files in %s, median of %d runs\n", megabytes, directory, runs);
+    fanOut = report("shell > a > b > c", fanOutTimes, runs, megabytes);
+    tee = report("cat | tee a b > c", teeTimes, runs, megabytes);
+    report("shell > a (one copy)", singleTimes, runs, megabytes);
+    printf("tee and splice in the shell take %.0f%% of the time of a tee process\n",
+           100 * fanOut / tee);
+
+    removeOutputs();
+    unlink(sourcePath);
+
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Benchmark of launching a foreground command from a shell
+ *              with a small and a large heap, forked by the shell and by
+ *              the launcher helper.
+ *
+ *              Each case runs in a process of its own, which starts a
+ *              shell from the library, starts the helper if the case uses
+ *              it, then allocates and touches a heap of the given size as
+ *              a shell with a long history and large caches would have.
+ *              It then times runCommandLine running /bin/true, which
+ *              forks or goes through the helper, execs and waits, and
+ *              prints the median and best time of a launch.
+ *
+ *              usage: launcherBench [small MB] [large MB] [launches]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bashShell.h"
+
+#define DEFAULT_SMALL_MEGABYTES 10
+#define DEFAULT_LARGE_MEGABYTES 1024
+#define DEFAULT_LAUNCHES 200
+#define MAX_LAUNCHES 10000
+
+#define COMMAND_LINE "/bin/true"
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Compares doubles for qsort */
+static int compareTimes(const void *a, const void *b)
+{
+    double difference = *(const double *)a - *(const double *)b;
+
+    return (difference > 0) - (difference < 0);
+}
+
+/* Times the launches of one case in a child process, so each case starts
+ * from a fresh heap, and prints them
+ * output: the median time of a launch in seconds
+ */
+static double runCase(int megabytes, bool useLauncher, int launches)
+{
+    double times[2];
+    int pipeFds[2];
+    pid_t pid;
+
+    if (pipe(pipeFds) == -1)
+    {
+        perror("pipe");
+        exit(1);
+    }
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        struct shellState shell;
+        char commandLine[MAX_COMMAND_LINE];
+        double *launchTimes;
+        size_t size = (size_t)megabytes << 20;
+        char *heap;
+        double start;
+        int i;
+
+        close(pipeFds[0]);
+        initializeShell(&shell);
+        shell.prompt = false;
+        if (useLauncher && startLauncher(&shell.launcher) == -1)
+        {
+            _exit(1);
+        }
+
+        /* The heap is written so its pages are mapped, as a shell's tables
+         * are, and the fork has to copy their page tables
+         */
+        heap = malloc(size);
+        launchTimes = malloc(launches * sizeof(double));
+        if (heap == NULL || launchTimes == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            _exit(1);
+        }
+        memset(heap, 1, size);
+
+        for (i = 0; i < launches; i++)
+        {
+            strcpy(commandLine, COMMAND_LINE);
+            start = now();
+            runCommandLine(&shell, commandLine);
+            launchTimes[i] = now() - start;
+        }
+
+        qsort(launchTimes, launches, sizeof(double), compareTimes);
+        times[0] = launchTimes[launches / 2];
+        times[1] = launchTimes[0];
+        if (write(pipeFds[1], times, sizeof(times)) != sizeof(times))
+        {
+            _exit(1);
+        }
+
+        stopLauncher(&shell.launcher);
+        _exit(0);
+    }
+
+    close(pipeFds[1]);
+    if (read(pipeFds[0], times, sizeof(times)) != sizeof(times))
+    {
+        fprintf(stderr, "%d MB case failed\n", megabytes);
+        exit(1);
+    }
+    close(pipeFds[0]);
+    waitpid(pid, NULL, 0);
+
+    printf("%5d MB heap  %-16s median %8.1f us  best %8.1f us\n", megabytes,
+           useLauncher ? "launcher helper" : "shell fork", times[0] * 1e6, times[1] * 1e6);
+
+    return times[0];
+}
+
+int main(int argc, char *argv[])
+{
+    int small = (argc > 1) ? atoi(argv[1]) : DEFAULT_SMALL_MEGABYTES;
+    int large = (argc > 2) ? atoi(argv[2]) : DEFAULT_LARGE_MEGABYTES;
+    int launches = (argc > 3) ? atoi(argv[3]) : DEFAULT_LAUNCHES;
+    double smallFork, largeFork, smallHelper, largeHelper;
+
+    if (small <= 0 || large <= 0 || launches <= 0 || launches > MAX_LAUNCHES)
+    {
+        fprintf(stderr, "usage: %s [small MB] [large MB] [launches <= %d]\n", argv[0], MAX_LAUNCHES);
+        return 1;
+    }
+
+    printf("%s launched %d times from a shell with a %d MB and a %d MB heap\n",
+           COMMAND_LINE, launches, small, large);
+    smallFork = runCase(small, false, launches);
+    largeFork = runCase(large, false, launches);
+    smallHelper = runCase(small, true, launches);
+    largeHelper = runCase(large, true, launches);
+
+    printf("the %d MB heap makes a launch %.2fx slower with the shell's fork and %.2fx with the helper\n",
+           large, largeFork / smallFork, largeHelper / smallHelper);
+
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Benchmark of the per-iteration cost of a for loop against
+ *              the same commands written out line by line.
+ *
+ *              Writes a for loop over a file of N words, whose body is a
+ *              command with a dozen arguments and redirections, and a
+ *              script with the same command once per line for each word.
+ *              Times bashShell running the loop and running the unrolled
+ *              script with parse-ahead and without it (-S). The script
+ *              cache is turned off with -N so every line is parsed.
+ *
+ *              The command is a path that doesn't exist, so each child
+ *              exits as soon as execve fails and the time is mostly the
+ *              shell's own: the fork and, for the unrolled script, reading
+ *              and parsing the line. The loop runs with -S, since a loop
+ *              is a barrier that parse-ahead can't read past.
+ *
+ *              usage: loopBench [shell] [iterations] [runs]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define DEFAULT_SHELL "./bashShell"
+#define DEFAULT_ITERATIONS 2000
+#define DEFAULT_RUNS 5
+#define MAX_RUNS 100
+
+/* The command of each iteration, which fails at execve */
+#define COMMAND "/nonexistent/command"
+
+/* The arguments and redirections after the word in each command */
+#define COMMAND_TAIL "one two three four five six seven eight nine ten > /dev/null 2>&1"
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Runs the shell on the script with output to /dev/null and returns the
+ * wall time it took in seconds.
+ */
+static double timeShell(char *shell, char *option, char *script)
+{
+    double start = now();
+    pid_t pid;
+    int devNull;
+
+    pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        if (option != NULL)
+        {
+            execl(shell, shell, "-N", option, script, (char *)NULL);
+        }
+        else
+        {
+            execl(shell, shell, "-N", script, (char *)NULL);
+        }
+        perror(shell);
+        _exit(127);
+    }
+
+    waitpid(pid, NULL, 0);
+
+    return now() - start;
+}
+
+/* Compares doubles for qsort */
+static int compareTimes(const void *a, const void *b)
+{
+    double difference = *(const double *)a - *(const double *)b;
+
+    return (difference > 0) - (difference < 0);
+}
+
+/* Times the shell on a script and prints the median and best runs */
+static double report(char *name, char *shell, char *option, char *script, int iterations, int runs)
+{
+    double times[MAX_RUNS];
+    int i;
+
+    for (i = 0; i < runs; i++)
+    {
+        times[i] = timeShell(shell, option, script);
+    }
+
+    qsort(times, runs, sizeof(double), compareTimes);
+
+    printf("%-22s median %8.3f s  best %8.3f s  %7.1f us/iteration\n",
+           name, times[runs / 2], times[0], times[runs / 2] * 1e6 / iterations);
+
+    return times[runs / 2];
+}
+
+/* Makes a temporary file from the template and opens it for writing */
+static FILE *openTemporary(char name[])
+{
+    FILE *stream;
+    int fd;
+
+    fd = mkstemp(name);
+    if (fd == -1 || (stream = fdopen(fd, "w")) == NULL)
+    {
+        perror("mkstemp");
+        exit(1);
+    }
+
+    return stream;
+}
+
+int main(int argc, char *argv[])
+{
+    char *shell = (argc > 1) ? argv[1] : DEFAULT_SHELL;
+    int iterations = (argc > 2) ? atoi(argv[2]) : DEFAULT_ITERATIONS;
+    int runs = (argc > 3) ? atoi(argv[3]) : DEFAULT_RUNS;
+    char words[] = "/tmp/loopBenchWordsXXXXXX";
+    char loop[] = "/tmp/loopBenchLoopXXXXXX";
+    char unrolled[] = "/tmp/loopBenchUnrolledXXXXXX";
+    double serial, ahead, looped;
+    FILE *stream;
+    int i;
+
+    if (iterations <= 0 || runs <= 0 || runs > MAX_RUNS)
+    {
+        fprintf(stderr, "usage: %s [shell] [iterations] [runs <= %d]\n", argv[0], MAX_RUNS);
+        return 1;
+    }
+
+    /* The words are read with $(cat), since a commandline can't hold
+     * thousands of them
+     */
+    stream = openTemporary(words);
+    for (i = 0; i < iterations; i++)
+    {
+        fprintf(stream, "word%d\n", i);
+    }
+    fclose(stream);
+
+    stream = openTemporary(loop);
+    fprintf(stream, "for w in $(cat %s)\ndo\n    %s $w %s\ndone\nexit\n", words, COMMAND, COMMAND_TAIL);
+    fclose(stream);
+
+    stream = openTemporary(unrolled);
+    for (i = 0; i < iterations; i++)
+    {
+        fprintf(stream, "%s word%d %s\n", COMMAND, i, COMMAND_TAIL);
+    }
+    fprintf(stream, "exit\n");
+    fclose(stream);
+
+    printf("%d iterations of a command with %d arguments, median of %d runs\n",
+           iterations, 12, runs);
+    serial = report("unrolled serial (-S)", shell, "-S", unrolled, iterations, runs);
+    ahead = report("unrolled parse-ahead", shell, NULL, unrolled, iterations, runs);
+    looped = report("for loop (-S)", shell, "-S", loop, iterations, runs);
+    printf("loop saves %.1f us/iteration over serial and %.1f us/iteration over parse-ahead\n",
+           (serial - looped) * 1e6 / iterations, (ahead - looped) * 1e6 / iterations);
+
+    unlink(words);
+    unlink(loop);
+    unlink(unrolled);
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Microbenchmarks of the parser and job array primitives.
+ *
+ *              Times expandString, intToString, parseArguments,
+ *              pidArrayIndex and increasePidReturnArray over a corpus of
+ *              short and long lines, 0 - 1000 $$ occurrences, 1 - 511
+ *              arguments and job arrays of 10 to 1M entries. Each case is
+ *              repeated until it has run for at least MIN_SECONDS and the
+ *              time and number of allocations per operation are printed.
+ *
+ *              The benchmark is linked with --wrap=malloc, calloc and
+ *              realloc so every allocation the shell makes is counted.
+ *              Allocations made inside the C library are not.
+ *
+ *              usage: microBench [name filter]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bashShell.h"
+
+/* The least time each case runs for, so short operations are averaged */
+#define MIN_SECONDS 0.2
+
+/* The $$ of the benchmark, fixed so every run expands to the same length */
+#define BENCH_PID 4321
+
+/* The largest job array in the corpus */
+#define MAX_PID_ARRAY 1000000
+
+/* The number of allocations made through malloc, calloc and realloc */
+static unsigned long allocations = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *pointer, size_t size);
+
+/* The linker sends the shell's calls to malloc, calloc and realloc here */
+void *__wrap_malloc(size_t size)
+{
+    ++allocations;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size)
+{
+    ++allocations;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *pointer, size_t size)
+{
+    ++allocations;
+    return __real_realloc(pointer, size);
+}
+
+/* A commandline case of the corpus */
+struct lineCase
+{
+    char name[32];
+    char line[MAX_COMMAND_LINE_EXPANDED];
+};
+
+/* A job array case of the corpus */
+struct pidCase
+{
+    pid_t *pids;
+    int capacity;
+    pid_t target;  /* the element searched for */
+};
+
+/* Keeps the results of the operations so they aren't optimized away */
+static volatile long sink;
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Runs the operation with the argument, doubling the number of iterations
+ * until they take at least MIN_SECONDS, then prints the time and the
+ * allocations of one operation.
+ */
+static void runCase(char *filter, char *name, void (*operation)(void *), void *argument)
+{
+    unsigned long iterations = 1;
+    unsigned long startAllocations;
+    unsigned long i;
+    double start, elapsed;
+
+    if (filter != NULL && strstr(name, filter) == NULL)
+    {
+        return;
+    }
+
+    while (true)
+    {
+        startAllocations = allocations;
+        start = now();
+
+        for (i = 0; i < iterations; i++)
+        {
+            operation(argument);
+        }
+
+        elapsed = now() - start;
+        if (elapsed >= MIN_SECONDS)
+        {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    printf("%-40s %12.1f ns/op %10.2f allocs/op\n", name, elapsed * 1e9 / iterations,
+           (double)(allocations - startAllocations) / iterations);
+}
+
+static void benchExpandString(void *argument)
+{
+    struct lineCase *lineCase = argument;
+    char expanded[MAX_COMMAND_LINE_EXPANDED];
+
+    sink += expandString(lineCase->line, BENCH_PID, expanded);
+}
+
+static void benchIntToString(void *argument)
+{
+    char str[MAX_INT_LENGTH];
+
+    intToString(str, *(int *)argument);
+    sink += str[0];
+}
+
+/* Parses a copy of the line, since parseArguments splits it up, then frees
+ * the arguments as the shell does after each command
+ */
+static void benchParseArguments(void *argument)
+{
+    struct lineCase *lineCase = argument;
+    char line[MAX_COMMAND_LINE_EXPANDED];
+    struct command command;
+
+    strcpy(line, lineCase->line);
+    initializeCommand(&command, NO_TIMEOUT);
+    sink += parseArguments(line, &command);
+    sink += command.numArgs;
+    freeCommand(&command);
+}
+
+static void benchPidArrayIndex(void *argument)
+{
+    struct pidCase *pidCase = argument;
+
+    sink += pidArrayIndex(pidCase->pids, pidCase->target, pidCase->capacity);
+}
+
+/* Grows a job array from ARRAY_CAPACITY_BG to the case's capacity by
+ * doubling, as the job table does while jobs are added
+ */
+static void benchIncreasePidReturnArray(void *argument)
+{
+    struct pidCase *pidCase = argument;
+    int capacity = ARRAY_CAPACITY_BG;
+    pid_t *pids = getPidReturnArray(capacity);
+
+    initializeBgPidArray(pids, capacity);
+    while (capacity < pidCase->capacity)
+    {
+        capacity = increasePidReturnArray(&pids, capacity);
+    }
+
+    sink += pids[capacity - 1];
+    free(pids);
+}
+
+/* Fills the line with count copies of word, each followed by separator */
+static void repeatWord(char line[], char *word, char *separator, int count)
+{
+    int i;
+
+    line[0] = '\0';
+    for (i = 0; i < count; i++)
+    {
+        strcat(line, word);
+        strcat(line, separator);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    char *filter = (argc > 1) ? argv[1] : NULL;
+    int dollarCounts[] = {0, 1, 10, 100, 1000};
+    int argCounts[] = {1, 8, 64, 511};
+    int numbers[] = {0, 42, 12345, 2147483647};
+    int pidCapacities[] = {10, 1000, 100000, MAX_PID_ARRAY};
+    static struct lineCase lineCase;
+    struct pidCase pidCase;
+    char name[64];
+    pid_t *pids;
+    int i, j;
+
+    printf("each case runs for at least %.1f s\n", MIN_SECONDS);
+
+    /* expandString on short and long lines and lines full of $$ */
+    strcpy(lineCase.line, "ls -la /tmp > out.txt\n");
+    runCase(filter, "expandString short line", benchExpandString, &lineCase);
+
+    repeatWord(lineCase.line, "abcdefghi", " ", (MAX_COMMAND_LINE - 2) / 10);
+    runCase(filter, "expandString long line", benchExpandString, &lineCase);
+
+    for (i = 0; i < sizeof(dollarCounts) / sizeof(dollarCounts[0]); i++)
+    {
+        repeatWord(lineCase.line, "$$", "", dollarCounts[i]);
+        strcat(lineCase.line, "\n");
+        snprintf(name, sizeof(name), "expandString %d $$", dollarCounts[i]);
+        runCase(filter, name, benchExpandString, &lineCase);
+    }
+
+    for (i = 0; i < sizeof(numbers) / sizeof(numbers[0]); i++)
+    {
+        snprintf(name, sizeof(name), "intToString %d", numbers[i]);
+        runCase(filter, name, benchIntToString, &numbers[i]);
+    }
+
+    /* parseArguments with growing numbers of arguments, and redirections */
+    for (i = 0; i < sizeof(argCounts) / sizeof(argCounts[0]); i++)
+    {
+        repeatWord(lineCase.line, "ab", " ", argCounts[i]);
+        strcat(lineCase.line, "\n");
+        snprintf(name, sizeof(name), "parseArguments %d args", argCounts[i]);
+        runCase(filter, name, benchParseArguments, &lineCase);
+    }
+
+    strcpy(lineCase.line, "sort -r < in.txt > out.txt 2>&1 &\n");
+    runCase(filter, "parseArguments redirections", benchParseArguments, &lineCase);
+
+    /* pidArrayIndex finding the last job and a job that isn't there, and
+     * growing arrays to each size
+     */
+    for (i = 0; i < sizeof(pidCapacities) / sizeof(pidCapacities[0]); i++)
+    {
+        pids = getPidReturnArray(pidCapacities[i]);
+        for (j = 0; j < pidCapacities[i]; j++)
+        {
+            pids[j] = j + 1;
+        }
+
+        pidCase.pids = pids;
+        pidCase.capacity = pidCapacities[i];
+
+        pidCase.target = pidCapacities[i];
+        snprintf(name, sizeof(name), "pidArrayIndex %d last", pidCapacities[i]);
+        runCase(filter, name, benchPidArrayIndex, &pidCase);
+
+        pidCase.target = BG_UNDEFINED + 1;
+        snprintf(name, sizeof(name), "pidArrayIndex %d missing", pidCapacities[i]);
+        runCase(filter, name, benchPidArrayIndex, &pidCase);
+
+        snprintf(name, sizeof(name), "increasePidReturnArray to %d", pidCapacities[i]);
+        runCase(filter, name, benchIncreasePidReturnArray, &pidCase);
+
+        free(pids);
+    }
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Benchmark of parse-ahead on a script of many short commands.
+ *
+ *              Writes a script of short commands with redirections and $$
+ *              expansion and times bashShell running it line by line with
+ *              parse-ahead (the default) and without it (-S). The script
+ *              cache is turned off with -N so every line is parsed.
+ *
+ *              usage: parseAheadBench [shell] [commands] [runs]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define DEFAULT_SHELL "./bashShell"
+#define DEFAULT_COMMANDS 2000
+#define DEFAULT_RUNS 5
+#define MAX_RUNS 100
+
+/* The short commands the script cycles through */
+static const char *commands[] = {
+    "/bin/true",
+    "true a b c > /dev/null",
+    "echo $$ one two three > /dev/null",
+    "/bin/true 2>&1 < /dev/null",
+    "echo x$$x >> /dev/null && /bin/true",
+};
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Runs the shell on the script with output to /dev/null and returns the
+ * wall time it took in seconds.
+ */
+static double timeShell(char *shell, char *option, char *script)
+{
+    double start = now();
+    pid_t pid;
+    int devNull;
+
+    pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        if (option != NULL)
+        {
+            execl(shell, shell, "-N", option, script, (char *)NULL);
+        }
+        else
+        {
+            execl(shell, shell, "-N", script, (char *)NULL);
+        }
+        perror(shell);
+        _exit(127);
+    }
+
+    waitpid(pid, NULL, 0);
+
+    return now() - start;
+}
+
+/* Compares doubles for qsort */
+static int compareTimes(const void *a, const void *b)
+{
+    double difference = *(const double *)a - *(const double *)b;
+
+    return (difference > 0) - (difference < 0);
+}
+
+/* Times the shell in one mode and prints the median and best runs */
+static double report(char *name, char *shell, char *option, char *script, int numCommands, int runs)
+{
+    double times[MAX_RUNS];
+    int i;
+
+    for (i = 0; i < runs; i++)
+    {
+        times[i] = timeShell(shell, option, script);
+    }
+
+    qsort(times, runs, sizeof(double), compareTimes);
+
+    printf("%-12s median %8.3f s  best %8.3f s  %7.1f us/command\n",
+           name, times[runs / 2], times[0], times[runs / 2] * 1e6 / numCommands);
+
+    return times[runs / 2];
+}
+
+int main(int argc, char *argv[])
+{
+    char *shell = (argc > 1) ? argv[1] : DEFAULT_SHELL;
+    int numCommands = (argc > 2) ? atoi(argv[2]) : DEFAULT_COMMANDS;
+    int runs = (argc > 3) ? atoi(argv[3]) : DEFAULT_RUNS;
+    int numKinds = sizeof(commands) / sizeof(commands[0]);
+    char script[] = "/tmp/parseAheadBenchXXXXXX";
+    double serial, ahead;
+    FILE *stream;
+    int fd;
+    int i;
+
+    if (numCommands <= 0 || runs <= 0 || runs > MAX_RUNS)
+    {
+        fprintf(stderr, "usage: %s [shell] [commands] [runs <= %d]\n", argv[0], MAX_RUNS);
+        return 1;
+    }
+
+    fd = mkstemp(script);
+    if (fd == -1 || (stream = fdopen(fd, "w")) == NULL)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+
+    for (i = 0; i < numCommands; i++)
+    {
+        fprintf(stream, "%s\n", commands[i % numKinds]);
+    }
+    fprintf(stream, "exit\n");
+    fclose(stream);
+
+    printf("%d short commands, median of %d runs\n", numCommands, runs);
+    serial = report("serial (-S)", shell, "-S", script, numCommands, runs);
+    ahead = report("parse-ahead", shell, NULL, script, numCommands, runs);
+    printf("speedup %.2fx\n", serial / ahead);
+
+    unlink(script);
+
+    return 0;
+}
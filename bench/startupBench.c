@@ -0,0 +1,275 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Benchmark of the startup cost of the shell: the time from
+ *              exec'ing bashShell to it exec'ing its first command, and
+ *              the memory the shell holds by then.
+ *
+ *              The first command is this program run as a marker, which
+ *              prints the monotonic time it started and, if its parent is
+ *              the shell, the shell's VmRSS and VmHWM from /proc. The time
+ *              from before the fork to the marker's start is the latency.
+ *              Running the marker without a shell gives the cost of the
+ *              fork and exec alone, which is taken off.
+ *
+ *              The shell is run as tooling runs it: -c with the command
+ *              alone, which is exec'd in place of the shell, -c with the
+ *              command before exit, which is forked, and a one line script
+ *              with and without its cache.
+ *
+ *              usage: startupBench [shell] [runs]
+ *
+ **************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define DEFAULT_SHELL "./bashShell"
+#define DEFAULT_RUNS 200
+#define MAX_RUNS 100000
+
+/* The option that runs this program as the marker */
+#define MARK_OPTION "--mark"
+
+/* Returns the time in nanoseconds from the monotonic clock */
+static long long now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+/* Reads a field such as VmRSS in kB from /proc/PID/status, or 0 */
+static long statusField(pid_t pid, char *field)
+{
+    char path[64];
+    char line[256];
+    long value = 0;
+    FILE *status;
+
+    sprintf(path, "/proc/%d/status", (int)pid);
+    status = fopen(path, "r");
+    if (status == NULL)
+    {
+        return 0;
+    }
+
+    while (fgets(line, sizeof(line), status) != NULL)
+    {
+        if (strncmp(line, field, strlen(field)) == 0 && line[strlen(field)] == ':')
+        {
+            value = atol(line + strlen(field) + 1);
+            break;
+        }
+    }
+
+    fclose(status);
+
+    return value;
+}
+
+/* Runs as the first command: prints the time it started and the memory
+ * of the shell that ran it, unless the shell exec'd it or it was run by
+ * the benchmark itself
+ */
+static int mark(pid_t benchPid)
+{
+    long long start = now();
+    pid_t parent = getppid();
+    long rss = 0;
+    long peak = 0;
+
+    if (parent != benchPid)
+    {
+        rss = statusField(parent, "VmRSS");
+        peak = statusField(parent, "VmHWM");
+    }
+
+    printf("%lld %ld %ld\n", start, rss, peak);
+
+    return 0;
+}
+
+/* The results of running one way many times */
+struct result
+{
+    long long *latencies;  /* in nanoseconds */
+    long rss;  /* the shell's VmRSS and VmHWM in kB, from the last run */
+    long peak;
+};
+
+/* Runs the command with its stdout on a pipe and returns the latency the
+ * marker reports, filling in the memory it read
+ */
+static long long timeStartup(char *argv[], long *rss, long *peak)
+{
+    char output[128];
+    long long start;
+    long long started = 0;
+    ssize_t length;
+    int pipeFds[2];
+    pid_t pid;
+
+    if (pipe(pipeFds) == -1)
+    {
+        perror("pipe");
+        exit(1);
+    }
+
+    start = now();
+    pid = fork();
+    if (pid == -1)
+    {
+        perror("fork");
+        exit(1);
+    }
+
+    if (pid == 0)
+    {
+        dup2(pipeFds[1], STDOUT_FILENO);
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        execv(argv[0], argv);
+        perror(argv[0]);
+        _exit(127);
+    }
+
+    close(pipeFds[1]);
+    length = read(pipeFds[0], output, sizeof(output) - 1);
+    close(pipeFds[0]);
+    waitpid(pid, NULL, 0);
+
+    if (length <= 0)
+    {
+        fprintf(stderr, "%s printed nothing\n", argv[0]);
+        exit(1);
+    }
+
+    output[length] = '\0';
+    sscanf(output, "%lld %ld %ld", &started, rss, peak);
+
+    return started - start;
+}
+
+/* Compares latencies for qsort */
+static int compareLatencies(const void *a, const void *b)
+{
+    long long difference = *(const long long *)a - *(const long long *)b;
+
+    return (difference > 0) - (difference < 0);
+}
+
+/* Runs the command the number of times and prints the median and best
+ * latencies, less the baseline, with the shell's memory if it was read
+ */
+static long long report(char *name, char *argv[], int runs, long long baseline)
+{
+    long long *latencies;
+    long long median;
+    long rss = 0;
+    long peak = 0;
+    int i;
+
+    latencies = malloc(runs * sizeof(long long));
+    if (latencies == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < runs; i++)
+    {
+        latencies[i] = timeStartup(argv, &rss, &peak);
+    }
+
+    qsort(latencies, runs, sizeof(long long), compareLatencies);
+    median = latencies[runs / 2];
+
+    printf("%-28s median %7.1f us  best %7.1f us  shell %7.1f us", name,
+           median / 1e3, latencies[0] / 1e3, (median - baseline) / 1e3);
+    if (rss > 0)
+    {
+        printf("  RSS %ld kB  peak %ld kB", rss, peak);
+    }
+    printf("\n");
+
+    free(latencies);
+
+    return median;
+}
+
+int main(int argc, char *argv[])
+{
+    char *shell = (argc > 1) ? argv[1] : DEFAULT_SHELL;
+    int runs = (argc > 2) ? atoi(argv[2]) : DEFAULT_RUNS;
+    char self[PATH_MAX];
+    char benchPid[16];
+    char alone[PATH_MAX + 64];  /* the -c commandline of the marker alone */
+    char forked[PATH_MAX + 64];  /* the marker before exit, so it is forked */
+    char script[] = "/tmp/startupBenchXXXXXX";
+    char cacheName[sizeof(script) + 16];
+    char *direct[] = {self, MARK_OPTION, benchPid, NULL};
+    char *dashC[] = {shell, "-c", alone, NULL};
+    char *dashCForked[] = {shell, "-c", forked, NULL};
+    char *scriptCached[] = {shell, script, NULL};
+    char *scriptUncached[] = {shell, "-N", script, NULL};
+    long long baseline;
+    ssize_t length;
+    FILE *stream;
+    int fd;
+
+    if (argc > 2 && strcmp(argv[1], MARK_OPTION) == 0)
+    {
+        return mark(atoi(argv[2]));
+    }
+
+    if (runs <= 0 || runs > MAX_RUNS)
+    {
+        fprintf(stderr, "usage: %s [shell] [runs <= %d]\n", argv[0], MAX_RUNS);
+        return 1;
+    }
+
+    /* The marker is this program, run by its full path */
+    length = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (length <= 0)
+    {
+        perror("readlink");
+        return 1;
+    }
+    self[length] = '\0';
+    sprintf(benchPid, "%d", (int)getpid());
+
+    sprintf(alone, "%s %s %s", self, MARK_OPTION, benchPid);
+    sprintf(forked, "%s %s %s; exit", self, MARK_OPTION, benchPid);
+
+    fd = mkstemp(script);
+    if (fd == -1 || (stream = fdopen(fd, "w")) == NULL)
+    {
+        perror("mkstemp");
+        return 1;
+    }
+    fprintf(stream, "%s\nexit\n", alone);
+    fclose(stream);
+
+    printf("exec to first command exec, median of %d runs\n", runs);
+    baseline = report("fork and exec alone", direct, runs, 0);
+    report("-c command (exec'd)", dashC, runs, baseline);
+    report("-c 'command; exit' (forked)", dashCForked, runs, baseline);
+    report("script -N", scriptUncached, runs, baseline);
+    report("script, cached", scriptCached, runs, baseline);
+
+    /* The cache is written beside the script as .NAME.bshc */
+    sprintf(cacheName, "/tmp/.%s.bshc", script + strlen("/tmp/"));
+    unlink(cacheName);
+    unlink(script);
+
+    return 0;
+}
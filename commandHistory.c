@@ -0,0 +1,599 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the command history and the history inbuilt
+ *              command including:
+ *
+ *               appending each commandline to a log file shared by every
+ *               session, locked with flock
+ *               mapping the log and indexing the lines other sessions have
+ *               added since the last lookup
+ *               a radix trie of the lines for finding the latest line with
+ *               a prefix
+ *               searching back from the latest line for text anywhere in
+ *               a line
+ *               expanding !!, !N, !-N and !prefix
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 49 and 55
+ *
+ **************************************************************************/
+
+#include "commandHistory.h"
+#include "bashShell.h"
+
+/* Initializes the history without opening the log. */
+void initializeHistory(struct commandHistory *history)
+{
+    memset(history, 0, sizeof(struct commandHistory));
+    history->fd = -1;
+}
+
+/* Unmaps and closes the log and frees the index. */
+void freeHistory(struct commandHistory *history)
+{
+    bool enabled = history->enabled;
+
+    if (history->map != NULL)
+    {
+        munmap(history->map, history->mapSize);
+    }
+    if (history->fd != -1)
+    {
+        close(history->fd);
+    }
+
+    free(history->offsets);
+    free(history->lengths);
+    free(history->nodes);
+
+    initializeHistory(history);
+    history->enabled = enabled;
+}
+
+/* Opens the log the first time it is used. Returns -1 if there is no log,
+ * after which the history isn't kept.
+ */
+static int openHistory(struct commandHistory *history)
+{
+    char fileName[PATH_MAX];
+    char *name = getenv(HISTORY_FILE_VARIABLE);
+    char *home = getenv("HOME");
+
+    if (history->fd != -1)
+    {
+        return 0;
+    }
+
+    if (name != NULL && name[0] != '\0')
+    {
+        snprintf(fileName, PATH_MAX, "%s", name);
+    }
+    else if (home != NULL)
+    {
+        snprintf(fileName, PATH_MAX, "%s/%s", home, HISTORY_FILE_NAME);
+    }
+    else
+    {
+        history->enabled = false;
+        return -1;
+    }
+
+    history->fd = open(fileName, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (history->fd == -1)
+    {
+        fprintf(stderr, "history: cannot open %s: %s\n", fileName, strerror(errno));
+        history->enabled = false;
+        return -1;
+    }
+
+    /* the root of the trie has an empty label and no line yet */
+    history->nodes = malloc(sizeof(struct historyNode));
+    if (history->nodes == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+    history->nodes[0].labelOffset = 0;
+    history->nodes[0].labelLength = 0;
+    history->nodes[0].firstChild = HISTORY_NONE;
+    history->nodes[0].nextSibling = HISTORY_NONE;
+    history->nodes[0].latest = HISTORY_NONE;
+    history->numNodes = 1;
+    history->nodeCapacity = 1;
+
+    return 0;
+}
+
+/* Adds a node with the label to the trie, doubling the nodes when they are
+ * full, and returns its index.
+ */
+static uint32_t newNode(struct commandHistory *history, size_t labelOffset, uint32_t labelLength,
+                        uint32_t latest)
+{
+    struct historyNode *node;
+
+    if (history->numNodes == history->nodeCapacity)
+    {
+        history->nodeCapacity *= 2;
+        history->nodes = realloc(history->nodes, history->nodeCapacity * sizeof(struct historyNode));
+        if (history->nodes == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+    }
+
+    node = &history->nodes[history->numNodes];
+    node->labelOffset = labelOffset;
+    node->labelLength = labelLength;
+    node->firstChild = HISTORY_NONE;
+    node->nextSibling = HISTORY_NONE;
+    node->latest = latest;
+
+    return history->numNodes++;
+}
+
+/* Returns the child of the node whose label starts with the byte, or
+ * HISTORY_NONE
+ */
+static uint32_t findChild(struct commandHistory *history, uint32_t node, char byte)
+{
+    uint32_t child;
+
+    for (child = history->nodes[node].firstChild; child != HISTORY_NONE;
+         child = history->nodes[child].nextSibling)
+    {
+        if (history->map[history->nodes[child].labelOffset] == byte)
+        {
+            return child;
+        }
+    }
+
+    return HISTORY_NONE;
+}
+
+/* Adds a line of the log to the trie. Every node on its path is given it
+ * as the latest line, since lines are added in the order they were
+ * written.
+ */
+static void insertLine(struct commandHistory *history, uint32_t line)
+{
+    size_t offset = history->offsets[line];
+    uint32_t length = history->lengths[line];
+    char *text = history->map + offset;
+    uint32_t position = 0;
+    uint32_t node = 0;
+    uint32_t child, middle, sibling;
+    uint32_t common;
+    char *label;
+
+    history->nodes[0].latest = line;
+
+    while (position < length)
+    {
+        child = findChild(history, node, text[position]);
+
+        /* the rest of the line is a new leaf */
+        if (child == HISTORY_NONE)
+        {
+            child = newNode(history, offset + position, length - position, line);
+            history->nodes[child].nextSibling = history->nodes[node].firstChild;
+            history->nodes[node].firstChild = child;
+            return;
+        }
+
+        label = history->map + history->nodes[child].labelOffset;
+        for (common = 1; common < history->nodes[child].labelLength && position + common < length
+             && label[common] == text[position + common]; common++)
+        {
+        }
+
+        /* The line leaves the label part way along, so the label is split
+         * with a node for the shared part above the child
+         */
+        if (common < history->nodes[child].labelLength)
+        {
+            middle = newNode(history, history->nodes[child].labelOffset, common,
+                             history->nodes[child].latest);
+            history->nodes[middle].firstChild = child;
+            history->nodes[middle].nextSibling = history->nodes[child].nextSibling;
+            history->nodes[child].nextSibling = HISTORY_NONE;
+            history->nodes[child].labelOffset += common;
+            history->nodes[child].labelLength -= common;
+
+            /* put the new node in the child's place among its siblings */
+            if (history->nodes[node].firstChild == child)
+            {
+                history->nodes[node].firstChild = middle;
+            }
+            else
+            {
+                sibling = history->nodes[node].firstChild;
+                while (history->nodes[sibling].nextSibling != child)
+                {
+                    sibling = history->nodes[sibling].nextSibling;
+                }
+                history->nodes[sibling].nextSibling = middle;
+            }
+
+            child = middle;
+        }
+
+        history->nodes[child].latest = line;
+        node = child;
+        position += common;
+    }
+}
+
+/* Adds a line of the log to the index */
+static void addLine(struct commandHistory *history, size_t offset, uint32_t length)
+{
+    if (history->numLines == history->lineCapacity)
+    {
+        history->lineCapacity = (history->lineCapacity == 0) ? 1024 : history->lineCapacity * 2;
+        history->offsets = realloc(history->offsets, history->lineCapacity * sizeof(size_t));
+        history->lengths = realloc(history->lengths, history->lineCapacity * sizeof(uint32_t));
+        if (history->offsets == NULL || history->lengths == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+    }
+
+    history->offsets[history->numLines] = offset;
+    history->lengths[history->numLines] = length;
+    insertLine(history, history->numLines);
+    ++history->numLines;
+}
+
+/* Maps any lines added to the log since the last lookup, by this or any
+ * other session, and indexes them. Only whole lines are indexed, so a line
+ * still being written is picked up next time. Returns -1 if there is no
+ * log.
+ */
+static int refreshHistory(struct commandHistory *history)
+{
+    struct stat fileInfo;
+    char *map;
+    char *start, *end, *newline;
+
+    if (history->enabled == false || openHistory(history) == -1
+        || fstat(history->fd, &fileInfo) == -1)
+    {
+        return -1;
+    }
+
+    if ((size_t)fileInfo.st_size > history->mapSize)
+    {
+        if (history->map == NULL)
+        {
+            map = mmap(NULL, fileInfo.st_size, PROT_READ, MAP_SHARED, history->fd, 0);
+        }
+        else
+        {
+            map = mremap(history->map, history->mapSize, fileInfo.st_size, MREMAP_MAYMOVE);
+        }
+
+        if (map == MAP_FAILED)
+        {
+            perror("history: mmap");
+            return -1;
+        }
+
+        history->map = map;
+        history->mapSize = fileInfo.st_size;
+    }
+
+    start = history->map + history->indexedSize;
+    end = history->map + history->mapSize;
+
+    while (start < end && (newline = memchr(start, '\n', end - start)) != NULL)
+    {
+        if (newline > start)
+        {
+            addLine(history, start - history->map, newline - start);
+        }
+        start = newline + 1;
+    }
+
+    history->indexedSize = start - history->map;
+
+    return 0;
+}
+
+/* Appends a commandline to the log, unless it is blank. */
+void addHistory(struct commandHistory *history, char *line)
+{
+    struct stat fileInfo;
+    struct iovec parts[2];
+    char lastByte;
+    size_t length = strcspn(line, "\n");
+    size_t i;
+
+    for (i = 0; i < length && isspace((unsigned char)line[i]); i++)
+    {
+    }
+
+    if (history->enabled == false || i == length || openHistory(history) == -1)
+    {
+        return;
+    }
+
+    /* The lock keeps the lines of sessions from being written at once. A
+     * line cut short by a session that died is ended first so the next
+     * line starts on its own.
+     */
+    flock(history->fd, LOCK_EX);
+
+    if (fstat(history->fd, &fileInfo) == 0 && fileInfo.st_size > 0
+        && pread(history->fd, &lastByte, 1, fileInfo.st_size - 1) == 1 && lastByte != '\n')
+    {
+        write(history->fd, "\n", 1);
+    }
+
+    parts[0].iov_base = line;
+    parts[0].iov_len = length;
+    parts[1].iov_base = "\n";
+    parts[1].iov_len = 1;
+    if (writev(history->fd, parts, 2) == -1)
+    {
+        perror("history: write");
+    }
+
+    flock(history->fd, LOCK_UN);
+}
+
+/* Returns the index of the latest line that starts with the prefix. */
+uint32_t findHistoryPrefix(struct commandHistory *history, char *prefix, size_t length)
+{
+    uint32_t node = 0;
+    size_t position = 0;
+    size_t compare;
+    struct historyNode *child;
+
+    if (refreshHistory(history) == -1)
+    {
+        return HISTORY_NONE;
+    }
+
+    while (position < length)
+    {
+        node = findChild(history, node, prefix[position]);
+        if (node == HISTORY_NONE)
+        {
+            return HISTORY_NONE;
+        }
+
+        child = &history->nodes[node];
+        compare = (child->labelLength < length - position) ? child->labelLength : length - position;
+        if (memcmp(history->map + child->labelOffset, prefix + position, compare) != 0)
+        {
+            return HISTORY_NONE;
+        }
+
+        position += compare;
+    }
+
+    return history->nodes[node].latest;
+}
+
+/* Returns the index of the line holding the byte at the offset, with a
+ * binary search of the line offsets
+ */
+static uint32_t lineAtOffset(struct commandHistory *history, size_t offset)
+{
+    uint32_t low = 0;
+    uint32_t high = history->numLines;
+    uint32_t middle;
+
+    while (high - low > 1)
+    {
+        middle = low + (high - low) / 2;
+        if (history->offsets[middle] <= offset)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/* Returns the index of the latest line that holds the text anywhere. The
+ * log is searched a chunk at a time from the end, so a recent line is
+ * found without reading the rest.
+ */
+uint32_t searchHistory(struct commandHistory *history, char *text, size_t length)
+{
+    size_t end;
+    size_t start;
+    char *found;
+    char *last;
+
+    if (refreshHistory(history) == -1 || history->numLines == 0 || length == 0)
+    {
+        return HISTORY_NONE;
+    }
+
+    end = history->indexedSize;
+    while (end > 0)
+    {
+        start = (end > HISTORY_SEARCH_CHUNK) ? end - HISTORY_SEARCH_CHUNK : 0;
+
+        /* the latest match in the chunk, which may run past its start by
+         * the length of the text so a match across chunks isn't missed
+         */
+        last = NULL;
+        found = history->map + start;
+        while ((found = memmem(found, history->map + end - found, text, length)) != NULL)
+        {
+            last = found;
+            ++found;
+        }
+
+        if (last != NULL)
+        {
+            return lineAtOffset(history, last - history->map);
+        }
+
+        if (start == 0)
+        {
+            break;
+        }
+        end = start + length - 1;
+    }
+
+    return HISTORY_NONE;
+}
+
+/* Prints a line of the history with its number */
+static void printHistoryLine(struct commandHistory *history, uint32_t line)
+{
+    printf("%6u  %.*s\n", line + 1, (int)history->lengths[line], history->map + history->offsets[line]);
+}
+
+/* Expands !!, !N, !-N or !prefix at the start of a commandline. */
+int expandHistory(struct commandHistory *history, char *line, char expanded[], size_t size)
+{
+    char *event = line;
+    char *rest;
+    char *end;
+    long number;
+    uint32_t found = HISTORY_NONE;
+    int length;
+
+    while (*event == ' ' || *event == '\t')
+    {
+        ++event;
+    }
+
+    /* as in bash, ! followed by a blank, = or ( isn't expanded */
+    if (history->enabled == false || event[0] != '!' || event[1] == '\0'
+        || isspace((unsigned char)event[1]) || event[1] == '=' || event[1] == '(')
+    {
+        return 0;
+    }
+
+    if (event[1] == '!')
+    {
+        rest = event + 2;
+        if (refreshHistory(history) == 0 && history->numLines > 0)
+        {
+            found = history->numLines - 1;
+        }
+    }
+    else if (isdigit((unsigned char)event[1]) || (event[1] == '-' && isdigit((unsigned char)event[2])))
+    {
+        number = strtol(event + 1, &end, 10);
+        rest = end;
+        if (refreshHistory(history) == 0)
+        {
+            if (number > 0 && number <= history->numLines)
+            {
+                found = number - 1;
+            }
+            else if (number < 0 && -number <= history->numLines)
+            {
+                found = history->numLines + number;
+            }
+        }
+    }
+    else
+    {
+        rest = event + 1 + strcspn(event + 1, " \t\n");
+        found = findHistoryPrefix(history, event + 1, rest - event - 1);
+    }
+
+    if (found == HISTORY_NONE)
+    {
+        fprintf(stderr, "%.*s: event not found\n", (int)(rest - event), event);
+        return -1;
+    }
+
+    length = snprintf(expanded, size, "%.*s%.*s%s", (int)(event - line), line,
+                      (int)history->lengths[found], history->map + history->offsets[found], rest);
+    if (length < 0 || (size_t)length >= size)
+    {
+        printf("The command line has a maximum length of %d\n", MAX_COMMAND_LINE);
+        return -1;
+    }
+
+    /* bash prints the commandline it runs, before anything it prints */
+    printf("%s", expanded);
+    if (expanded[length - 1] != '\n')
+    {
+        printf("\n");
+    }
+    fflush(stdout);
+
+    return 1;
+}
+
+/* Runs "history [N]" or "history -s TEXT". */
+int historyBuiltin(struct commandHistory *history, char commandLine[])
+{
+    char *savePosition;
+    char *token;
+    char *text;
+    char *end;
+    long count;
+    uint32_t line;
+
+    if (refreshHistory(history) == -1)
+    {
+        printf("history: no history is kept\n");
+        return 1;
+    }
+
+    /* First, ignore the word "history" */
+    strtok_r(commandLine, " \t\n", &savePosition);
+    token = strtok_r(NULL, " \t\n", &savePosition);
+
+    if (token != NULL && strcmp(token, "-s") == 0)
+    {
+        /* the text is the rest of the commandline, spaces and all */
+        text = savePosition;
+        while (*text == ' ' || *text == '\t')
+        {
+            ++text;
+        }
+        text[strcspn(text, "\n")] = '\0';
+
+        if (text[0] == '\0')
+        {
+            printf("usage: history [N] | history -s TEXT\n");
+            return HISTORY_USAGE_ERROR;
+        }
+
+        line = searchHistory(history, text, strlen(text));
+        if (line == HISTORY_NONE)
+        {
+            return 1;
+        }
+
+        printHistoryLine(history, line);
+        return 0;
+    }
+
+    count = history->numLines;
+    if (token != NULL)
+    {
+        count = strtol(token, &end, 10);
+        if (*end != '\0' || count < 0 || strtok_r(NULL, " \t\n", &savePosition) != NULL)
+        {
+            printf("usage: history [N] | history -s TEXT\n");
+            return HISTORY_USAGE_ERROR;
+        }
+    }
+
+    line = (count < history->numLines) ? history->numLines - count : 0;
+    for (; line < history->numLines; line++)
+    {
+        printHistoryLine(history, line);
+    }
+
+    return 0;
+}
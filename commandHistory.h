@@ -0,0 +1,151 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the command history and the history inbuilt command
+ *              including:
+ *
+ *               appending each commandline to a log file shared by every
+ *               session, locked with flock so lines from concurrent
+ *               sessions are never mixed up
+ *               mapping the log and indexing the lines other sessions have
+ *               added since the last lookup, so their history is merged in
+ *               the order the lines were written
+ *               a radix trie of the lines, whose nodes hold the latest line
+ *               under them, so !prefix is found in the time it takes to
+ *               walk the prefix
+ *               searching back from the latest line for text anywhere in
+ *               a line
+ *               expanding !!, !N, !-N and !prefix at the start of a
+ *               commandline
+ *
+ *              The log is $BASHSHELL_HISTORY, or .bashShell_history in
+ *              $HOME. It is opened and indexed the first time it is used.
+ *              The labels of the trie point into the mapped log, so a line
+ *              is never copied.
+ *
+ **************************************************************************/
+
+#ifndef COMMAND_HISTORY_H
+#define COMMAND_HISTORY_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>      /* for PATH_MAX */
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>    /* for flock */
+#include <sys/mman.h>    /* for mapping the log */
+#include <sys/stat.h>
+#include <sys/uio.h>     /* for writing a line and its newline at once */
+
+/* The environment variable that can name the log */
+#define HISTORY_FILE_VARIABLE "BASHSHELL_HISTORY"
+
+/* The name of the log in $HOME */
+#define HISTORY_FILE_NAME ".bashShell_history"
+
+/* The exit status of history with options that aren't valid, as in bash */
+#define HISTORY_USAGE_ERROR 2
+
+/* No node or line */
+#define HISTORY_NONE UINT32_MAX
+
+/* The size of each piece of the log searched for text, going back from the
+ * end
+ */
+#define HISTORY_SEARCH_CHUNK (64 * 1024)
+
+/* A node of the radix trie. Its label is the text on the edge from its
+ * parent, held in the mapped log.
+ */
+struct historyNode
+{
+    size_t labelOffset;
+    uint32_t labelLength;
+    uint32_t firstChild;
+    uint32_t nextSibling;
+    uint32_t latest;  /* the index of the latest line starting with the
+                       * text from the root to here */
+};
+
+/* The history of the shell */
+struct commandHistory
+{
+    bool enabled;  /* true if commandlines are added and ! is expanded */
+
+    int fd;  /* the log, or -1 until it is first used */
+    char *map;  /* the mapping of the log, or NULL while it is empty */
+    size_t mapSize;
+    size_t indexedSize;  /* the bytes of whole lines that are indexed */
+
+    /* the offset into the log and the length of each line */
+    size_t *offsets;
+    uint32_t *lengths;
+    uint32_t numLines;
+    uint32_t lineCapacity;
+
+    /* the trie, whose root is node 0 */
+    struct historyNode *nodes;
+    uint32_t numNodes;
+    uint32_t nodeCapacity;
+};
+
+/* Initializes the history without opening the log.
+ * input: the history: struct commandHistory *
+ */
+void initializeHistory(struct commandHistory *history);
+
+/* Unmaps and closes the log and frees the index.
+ * input: the history: struct commandHistory *
+ */
+void freeHistory(struct commandHistory *history);
+
+/* Appends a commandline to the log, unless it is blank.
+ * input: the history: struct commandHistory *
+ *        the commandline: char *
+ */
+void addHistory(struct commandHistory *history, char *line);
+
+/* Returns the index of the latest line that starts with the prefix, or
+ * HISTORY_NONE.
+ * input: the history: struct commandHistory *
+ *        the prefix: char *
+ *        the length of the prefix: size_t
+ */
+uint32_t findHistoryPrefix(struct commandHistory *history, char *prefix, size_t length);
+
+/* Returns the index of the latest line that holds the text anywhere, or
+ * HISTORY_NONE.
+ * input: the history: struct commandHistory *
+ *        the text: char *
+ *        the length of the text: size_t
+ */
+uint32_t searchHistory(struct commandHistory *history, char *text, size_t length);
+
+/* Expands !!, !N, !-N or !prefix at the start of a commandline into the
+ * line it refers to followed by the rest of the commandline, and prints
+ * the new commandline as bash does.
+ * input: the history: struct commandHistory *
+ *        the commandline: char *
+ *        a char array for the new commandline: char[]
+ *        the size of the array: size_t
+ * output: 1 if the commandline was expanded, 0 if it has nothing to expand
+ *         or -1 after printing an error if the line isn't found or is too
+ *         long
+ */
+int expandHistory(struct commandHistory *history, char *line, char expanded[], size_t size);
+
+/* Runs "history [N]", which lists the last N lines or every line, or
+ * "history -s TEXT", which prints the latest line holding TEXT.
+ * input: the history: struct commandHistory *
+ *        the $$ expanded commandline: char[]
+ * output: the exit status of the history command
+ */
+int historyBuiltin(struct commandHistory *history, char commandLine[]);
+
+#endif
@@ -0,0 +1,412 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the functions for splitting a commandline into a
+ *              command list including:
+ *
+ *               splitting a commandline at ;, && and || in a single pass
+ *               checking that && and || are between two commands
+ *               deciding if a command of the list runs from the exit
+ *               status of the command before it
+ *               keeping a for or while loop or a function definition
+ *               together as one command
+ *               joining the lines of a loop or function up to its end
+ *
+ **************************************************************************/
+
+#include "commandList.h"
+
+/* Returns true if the text holds nothing but whitespace */
+static bool isBlank(char *text)
+{
+    while (*text != '\0')
+    {
+        if (!isspace((unsigned char)*text))
+        {
+            return false;
+        }
+        ++text;
+    }
+
+    return true;
+}
+
+/* Returns the text past any leading whitespace, so inbuilt commands are
+ * recognized after a connector as in "cd .. && status"
+ */
+static char *skipBlanks(char *text)
+{
+    while (*text != '\0' && *text != '\n' && isspace((unsigned char)*text))
+    {
+        ++text;
+    }
+
+    return text;
+}
+
+/* Returns true if the text starts with the word, followed by whitespace,
+ * a connector or the end of the text
+ */
+static bool startsWithWord(char *text, char *word)
+{
+    int length = strlen(word);
+
+    return strncmp(text, word, length) == 0
+           && (text[length] == '\0' || isspace((unsigned char)text[length])
+               || text[length] == ';' || text[length] == '&' || text[length] == '|');
+}
+
+/* Returns the length of the "NAME()" or "NAME ()" that starts a function
+ * definition at the start of the text, or 0 if there isn't one.
+ */
+int functionHeader(char *text)
+{
+    char *position = text;
+
+    if (!isalpha((unsigned char)*position) && *position != '_')
+    {
+        return 0;
+    }
+
+    while (isalnum((unsigned char)*position) || *position == '_')
+    {
+        ++position;
+    }
+
+    position = skipBlanks(position);
+    if (*position != '(')
+    {
+        return 0;
+    }
+
+    position = skipBlanks(position + 1);
+    if (*position != ')')
+    {
+        return 0;
+    }
+
+    return position + 1 - text;
+}
+
+/* Returns how the command starting at text changes the number of open
+ * blocks: 1 if it starts a for or while loop or a function definition, -1
+ * if it is the done of a loop or the } of a function and otherwise 0. A
+ * block can start straight after the do of a loop or the { of a function.
+ */
+static int blockChange(char *text)
+{
+    int header;
+
+    text = skipBlanks(text);
+
+    if (startsWithWord(text, "do"))
+    {
+        return blockChange(text + strlen("do"));
+    }
+    if (startsWithWord(text, "for") || startsWithWord(text, "while"))
+    {
+        return 1;
+    }
+    if (startsWithWord(text, "done") || startsWithWord(text, "}"))
+    {
+        return -1;
+    }
+
+    header = functionHeader(text);
+    if (header > 0)
+    {
+        text = skipBlanks(text + header);
+        if (*text == '{')
+        {
+            return 1 + blockChange(text + 1);
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+/* Splits the commandline into a list of commands by ending each command
+ * with '\0' in place of the ;, && or || that follows it.
+ */
+int splitCommandList(char commandLine[], struct commandList *list, bool reportErrors)
+{
+    char *position = commandLine;  /* the current position in the commandline */
+    enum connector connector = connectLine;  /* joins the command being read */
+    enum connector next;  /* the connector found at position */
+    char *operator;  /* the text of the connector, for error messages */
+    int depth = 0;  /* the number of parentheses open inside a $( */
+    int blocks;  /* the number of loops and function definitions open */
+
+    list->count = 0;
+    list->commands[0].text = skipBlanks(commandLine);
+    list->commands[0].connector = connectLine;
+    blocks = blockChange(commandLine);
+
+    while (*position != '\0')
+    {
+        /* A ;, && or || inside $(...) belongs to the inner commandline */
+        if (position[0] == '$' && position[1] == '(')
+        {
+            ++depth;
+            position += 2;
+            continue;
+        }
+        if (depth > 0)
+        {
+            if (*position == '(')
+            {
+                ++depth;
+            }
+            else if (*position == ')')
+            {
+                --depth;
+            }
+            ++position;
+            continue;
+        }
+
+        if (*position == ';')
+        {
+            next = connectSequence;
+            operator = ";";
+        }
+        else if (position[0] == '&' && position[1] == '&')
+        {
+            next = connectAnd;
+            operator = "&&";
+        }
+        else if (position[0] == '|' && position[1] == '|')
+        {
+            next = connectOr;
+            operator = "||";
+        }
+        else
+        {
+            ++position;
+            continue;
+        }
+
+        /* The commands of a loop up to its done, or of a function up to its
+         * }, are one command of the list, which is split up when it is run
+         */
+        if (blocks > 0)
+        {
+            position += strlen(operator);
+            blocks += blockChange(position);
+            continue;
+        }
+
+        /* end the current command where the connector starts */
+        *position = '\0';
+        position += strlen(operator);
+
+        /* every connector has a command before it */
+        if (isBlank(list->commands[list->count].text))
+        {
+            if (reportErrors == true)
+            {
+                printf("syntax error near unexpected token `%s'\n", operator);
+            }
+            return -1;
+        }
+
+        if (list->count + 1 == MAX_LIST_COMMANDS)
+        {
+            if (reportErrors == true)
+            {
+                printf("A commandline has a maximum of %d commands\n", MAX_LIST_COMMANDS);
+            }
+            return -1;
+        }
+
+        ++list->count;
+        list->commands[list->count].text = skipBlanks(position);
+        list->commands[list->count].connector = next;
+        connector = next;
+        blocks = blockChange(position);
+    }
+
+    /* && and || need a command after them, but a trailing ; does not */
+    if (isBlank(list->commands[list->count].text))
+    {
+        if (connector == connectAnd || connector == connectOr)
+        {
+            if (reportErrors == true)
+            {
+                printf("syntax error: unexpected end of commandline after `%s'\n",
+                       (connector == connectAnd) ? "&&" : "||");
+            }
+            return -1;
+        }
+
+        /* a blank first command is kept so it is run as an empty commandline */
+        if (list->count > 0)
+        {
+            return 0;
+        }
+    }
+
+    ++list->count;
+
+    return 0;
+}
+
+/* Returns the number of loops and function definitions still open at the
+ * end of the commandline, without changing it.
+ */
+int openBlocks(char commandLine[])
+{
+    char *position = commandLine;
+    int depth = 0;  /* the number of parentheses open inside a $( */
+    int blocks = blockChange(commandLine);
+
+    while (*position != '\0')
+    {
+        /* a block inside $(...) is closed inside it */
+        if (position[0] == '$' && position[1] == '(')
+        {
+            ++depth;
+            position += 2;
+            continue;
+        }
+        if (depth > 0)
+        {
+            if (*position == '(')
+            {
+                ++depth;
+            }
+            else if (*position == ')')
+            {
+                --depth;
+            }
+            ++position;
+            continue;
+        }
+
+        if (*position == ';')
+        {
+            position += 1;
+        }
+        else if ((position[0] == '&' && position[1] == '&') || (position[0] == '|' && position[1] == '|'))
+        {
+            position += 2;
+        }
+        else
+        {
+            ++position;
+            continue;
+        }
+
+        blocks += blockChange(position);
+    }
+
+    return blocks;
+}
+
+/* Returns true if the commandline of the given length ends with a ;, && or
+ * ||, the word do, a { or the () of a function, after which the next line
+ * is joined with a space rather than a ;
+ */
+static bool endsOpen(char *line, size_t length)
+{
+    if (length >= 1 && (line[length - 1] == ';' || line[length - 1] == '{'))
+    {
+        return true;
+    }
+    if (length < 2)
+    {
+        return false;
+    }
+    if (strncmp(line + length - 2, "&&", 2) == 0 || strncmp(line + length - 2, "||", 2) == 0
+        || strncmp(line + length - 2, "()", 2) == 0)
+    {
+        return true;
+    }
+
+    return strncmp(line + length - 2, "do", 2) == 0
+           && (length == 2 || isspace((unsigned char)line[length - 3]) || line[length - 3] == ';');
+}
+
+/* Joins the lines after a commandline that leaves a loop or function open
+ * onto the end of it, up to the line that closes it.
+ */
+int readBlockLines(FILE *input, char **line, size_t *capacity, bool prompt)
+{
+    char *next = NULL;  /* the line returned by getline */
+    size_t nextCapacity = 0;
+    ssize_t nextSize;
+    char *separator;
+    char *joined;
+    size_t length;
+    int result = 0;
+
+    while (result == 0 && openBlocks(*line) > 0)
+    {
+        if (prompt == true)
+        {
+            printf(BLOCK_PROMPT);
+            fflush(stdout);
+        }
+
+        nextSize = getline(&next, &nextCapacity, input);
+        if (nextSize < 0)
+        {
+            result = -1;
+            continue;
+        }
+
+        /* a comment would take the rest of the block with it */
+        if (isBlank(next) || *skipBlanks(next) == '#')
+        {
+            continue;
+        }
+
+        /* The newline and any whitespace before it are dropped. A line that
+         * already ends with a connector, do, { or () is joined with a space.
+         */
+        length = strlen(*line);
+        while (length > 0 && isspace((unsigned char)(*line)[length - 1]))
+        {
+            --length;
+        }
+
+        separator = endsOpen(*line, length) ? " " : "; ";
+
+        if (length + strlen(separator) + nextSize + 1 > *capacity)
+        {
+            joined = realloc(*line, length + strlen(separator) + nextSize + 1);
+            if (joined == NULL)
+            {
+                fprintf(stderr, "Malloc not successful\n");
+                exit(1);
+            }
+            *line = joined;
+            *capacity = length + strlen(separator) + nextSize + 1;
+        }
+
+        strcpy(*line + length, separator);
+        strcpy(*line + length + strlen(separator), next);
+    }
+
+    free(next);
+
+    return result;
+}
+
+/* Returns true if a command joined by the connector runs after a command
+ * that finished with the exit status.
+ */
+bool listCommandRuns(enum connector connector, int lastStatus)
+{
+    if (connector == connectAnd)
+    {
+        return lastStatus == 0;
+    }
+    if (connector == connectOr)
+    {
+        return lastStatus != 0;
+    }
+
+    return true;
+}
@@ -0,0 +1,110 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines command lists and the functions for splitting a
+ *              commandline into one including:
+ *
+ *               splitting a commandline at ;, && and || in a single pass
+ *               checking that && and || are between two commands
+ *               deciding if a command of the list runs from the exit
+ *               status of the command before it
+ *               keeping a for or while loop or a function definition
+ *               together as one command
+ *               joining the lines of a loop or function up to its end
+ *
+ *              As in bash, "a && b || c" runs b only if a succeeds and c
+ *              only if the last command that ran failed. The ;, && and ||
+ *              between "for" or "while" and its "done", or between the
+ *              "NAME() {" of a function and its "}", are left for the loop
+ *              or function to split.
+ *
+ **************************************************************************/
+
+#ifndef COMMAND_LIST_H
+#define COMMAND_LIST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <sys/types.h>  /* for ssize_t */
+
+/* Maximum number of commands in a list on a single commandline */
+#define MAX_LIST_COMMANDS 256
+
+/* The exit status of a commandline with a list syntax error, as in bash */
+#define LIST_SYNTAX_ERROR 2
+
+/* The prompt printed before each line of a loop or function read from a
+ * terminal
+ */
+#define BLOCK_PROMPT "> "
+
+/* How a command is joined to the one before it:
+ * connectLine      the first command of a commandline
+ * connectSequence  ; always runs the command
+ * connectAnd       && runs the command if the last exit status was 0
+ * connectOr        || runs the command if the last exit status wasn't 0
+ */
+enum connector{ connectLine, connectSequence, connectAnd, connectOr};
+
+/* A single command of a list, which points into the split commandline */
+struct listCommand
+{
+    char *text;
+    enum connector connector;
+};
+
+/* The commands of a commandline in the order they are run */
+struct commandList
+{
+    struct listCommand commands[MAX_LIST_COMMANDS];
+    int count;
+};
+
+/* Splits the commandline into a list of commands by ending each command
+ * with '\0' in place of the ;, && or || that follows it. A ; at the end of
+ * the commandline is allowed, but && and || must be between two commands.
+ * input: the commandline: char[]
+ *        the list to fill in: struct commandList *
+ *        false if errors are not printed, as when compiling a script: bool
+ * output: 0 if successful or -1 if the list is not valid
+ */
+int splitCommandList(char commandLine[], struct commandList *list, bool reportErrors);
+
+/* Returns the length of the "NAME()" or "NAME ()" that starts a function
+ * definition at the start of the text.
+ * input: the text: char *
+ * output: the length, or 0 if the text doesn't start a definition
+ */
+int functionHeader(char *text);
+
+/* Returns the number of loops and function definitions the commandline
+ * starts that it doesn't end with a done or }, so the lines up to their
+ * end can be joined on.
+ * input: the commandline: char[]
+ * output: the number of open blocks, which is 0 or less if none are open
+ */
+int openBlocks(char commandLine[]);
+
+/* Joins the lines after a commandline that leaves a loop or function open
+ * onto the end of it, up to the line that closes it, with ; in place of
+ * each newline. Blank lines and comments are left out.
+ * input: the input: FILE *
+ *        the commandline as returned by getline, which is grown: char **
+ *        the capacity of the commandline: size_t *
+ *        true if a prompt is printed before each line: bool
+ * output: 0 if successful or -1 if the input ended first, in which case
+ *         the block is left open and is reported when it is run
+ */
+int readBlockLines(FILE *input, char **line, size_t *capacity, bool prompt);
+
+/* Returns true if a command joined by the connector runs after a command
+ * that finished with the exit status.
+ * input: the connector of the command: enum connector
+ *        the exit status of the last command run: int
+ */
+bool listCommandRuns(enum connector connector, int lastStatus);
+
+#endif
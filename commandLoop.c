@@ -0,0 +1,315 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the for and while loops including:
+ *
+ *               splitting a loop into its words or condition and its body
+ *               parsing each command of the body once into a template
+ *               running each iteration from the templates, so an
+ *               iteration is never tokenized or parsed again
+ *
+ **************************************************************************/
+
+#include "commandLoop.h"
+#include "bashShell.h"  /* for parsing, launching and running commands */
+
+/* Returns true if the text holds nothing but whitespace */
+static bool isBlankText(char *text)
+{
+    while (*text != '\0')
+    {
+        if (!isspace((unsigned char)*text))
+        {
+            return false;
+        }
+        ++text;
+    }
+
+    return true;
+}
+
+/* Returns the text past any leading whitespace */
+static char *skipSpaces(char *text)
+{
+    while (*text != '\0' && isspace((unsigned char)*text))
+    {
+        ++text;
+    }
+
+    return text;
+}
+
+/* Returns true if the character can be part of a variable name */
+static bool isNameCharacter(char character)
+{
+    return isalnum((unsigned char)character) || character == '_';
+}
+
+/* Compiles the commands of a list that make up the condition or body of a
+ * loop, looking for the loop variable. Returns -1 if a command can't be in
+ * a loop.
+ */
+static int compileLoopCommands(struct shellState *shell, struct commandLoop *loop,
+                               struct listCommand listCommands[], int count,
+                               struct templateList *commands)
+{
+    struct templateParameters parameters;
+
+    variableParameters(&parameters, loop->variable, NULL);
+
+    return compileTemplates(shell, listCommands, count, &parameters, commands);
+}
+
+/* Reads "NAME in WORDS" into the variable and words of a for loop. Returns
+ * -1 if it isn't in that form.
+ */
+static int parseForWords(char *text, struct commandLoop *loop)
+{
+    char *name = skipSpaces(text);
+    size_t length = 0;
+
+    if (!isalpha((unsigned char)name[0]) && name[0] != '_')
+    {
+        return -1;
+    }
+
+    while (isNameCharacter(name[length]))
+    {
+        ++length;
+    }
+
+    if (length >= MAX_VARIABLE_NAME || !isspace((unsigned char)name[length]))
+    {
+        return -1;
+    }
+
+    memcpy(loop->variable, name, length);
+    loop->variable[length] = '\0';
+
+    text = skipSpaces(name + length);
+    if (!isBuiltin(text, "in"))
+    {
+        return -1;
+    }
+
+    loop->words = text + strlen("in");
+
+    return 0;
+}
+
+/* Splits a loop into its words or condition and its body and compiles the
+ * commands. Returns -1 after printing an error if it doesn't parse.
+ */
+static int parseLoop(struct shellState *shell, char commandText[], struct commandLoop *loop)
+{
+    struct commandList list;
+    char *keyword;
+    char *last;
+    int doIndex;  /* the index of the command that starts with do */
+
+    loop->kind = isBuiltin(commandText, "for") ? forLoop : whileLoop;
+    loop->variable[0] = '\0';
+    loop->words = NULL;
+    loop->redirections = NULL;
+    loop->condition.commands = NULL;
+    loop->condition.count = 0;
+    loop->body.commands = NULL;
+    loop->body.count = 0;
+
+    keyword = (loop->kind == forLoop) ? "for" : "while";
+
+    /* The loop is split like a commandline. A nested loop stays one
+     * command of the body.
+     */
+    if (splitCommandList(commandText + strlen(keyword), &list, true) == -1)
+    {
+        return -1;
+    }
+
+    last = list.commands[list.count - 1].text;
+    if (list.count < 3 || !isBuiltin(last, "done"))
+    {
+        printf("syntax error: %s loop without done\n", keyword);
+        return -1;
+    }
+
+    if (!isBlankText(last + strlen("done")))
+    {
+        loop->redirections = last + strlen("done");
+    }
+
+    for (doIndex = 1; doIndex < list.count - 1; doIndex++)
+    {
+        if (isBuiltin(list.commands[doIndex].text, "do"))
+        {
+            break;
+        }
+    }
+
+    if (doIndex == list.count - 1 || list.commands[doIndex].connector != connectSequence)
+    {
+        printf("syntax error: %s loop without do\n", keyword);
+        return -1;
+    }
+
+    if (loop->kind == forLoop)
+    {
+        if (doIndex != 1 || parseForWords(list.commands[0].text, loop) == -1)
+        {
+            printf("usage: for NAME in WORDS; do COMMANDS; done\n");
+            return -1;
+        }
+    }
+    else if (compileLoopCommands(shell, loop, list.commands, doIndex, &loop->condition) == -1)
+    {
+        return -1;
+    }
+
+    /* The body starts with the rest of the command after do and ends
+     * before done
+     */
+    list.commands[doIndex].text = skipSpaces(list.commands[doIndex].text + strlen("do"));
+
+    return compileLoopCommands(shell, loop, list.commands + doIndex, list.count - 1 - doIndex,
+                               &loop->body);
+}
+
+/* Parses the redirections after the done of a loop and makes them the
+ * stdin, stdout and stderr of the commands of the loop. Returns -1 after
+ * printing an error if they can't be used.
+ */
+static int redirectLoop(struct shellState *shell, char *text, struct command *command, int savedFds[])
+{
+    if (parseArguments(text, command) == -1 || command->numArgs > 0
+        || command->hereType != noHere || command->inBackground == true)
+    {
+        printf("syntax error: only redirections can follow done\n");
+        return -1;
+    }
+
+    return pushSessionRedirections(shell, &command->redirections, savedFds);
+}
+
+/* Frees the compiled commands of a loop */
+static void freeLoop(struct commandLoop *loop)
+{
+    freeTemplates(&loop->condition);
+    freeTemplates(&loop->body);
+}
+
+/* Runs a for or while loop and sets the exit status of the shell to that of
+ * the last command of the body that ran, or 0 if none did.
+ */
+void loopBuiltin(struct shellState *shell, char commandText[])
+{
+    struct commandLoop loop;
+    struct command words;  /* the words of a for loop, as arguments */
+    struct substitutionList substitutions;  /* the outputs of $(...) in the words */
+    struct command redirections;  /* the redirections after done */
+    struct templateParameters parameters;  /* the value of the variable */
+    int savedFds[3];  /* the stdio fds of the shell's commands outside the loop */
+    char *token;
+    char *savePosition;
+    int bodyStatus = 0;  /* the status of the last command of the body */
+    bool running = true;
+    int i;
+
+    if (parseLoop(shell, commandText, &loop) == -1)
+    {
+        freeLoop(&loop);
+        sprintf(shell->exitStatusStr,"exit value %d",LOOP_SYNTAX_ERROR);
+        shell->lastStatus = LOOP_SYNTAX_ERROR;
+        return;
+    }
+
+    /* A command of a loop can run again, so it is never exec'd in place of
+     * the shell
+     */
+    shell->tailCommand = false;
+
+    initializeCommand(&redirections, NO_TIMEOUT);
+    if (loop.redirections != NULL && redirectLoop(shell, loop.redirections, &redirections, savedFds) == -1)
+    {
+        freeCommand(&redirections);
+        freeLoop(&loop);
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        return;
+    }
+
+    if (loop.kind == forLoop)
+    {
+        /* The words are split once, before the first iteration. With the
+         * outputs of $(...) there can be any number of them.
+         */
+        initializeCommand(&words, NO_TIMEOUT);
+        initializeSubstitutions(&substitutions);
+        words.substitutions = &substitutions;
+
+        if (hasSubstitution(loop.words) && runSubstitutions(shell, loop.words, &substitutions) == -1)
+        {
+            sprintf(shell->exitStatusStr,"exit value %d",1);
+            shell->lastStatus = 1;
+            bodyStatus = 1;
+            running = false;
+        }
+
+        token = strtok_r(loop.words, " \n", &savePosition);
+        while (running == true && token != NULL)
+        {
+            if (strchr(token, SUBSTITUTION_MARK) != NULL)
+            {
+                addSubstitutedArguments(&words, token);
+            }
+            else
+            {
+                addArgument(&words, token);
+            }
+            token = strtok_r(NULL, " \n", &savePosition);
+        }
+
+        for (i = 0; running == true && i < words.numArgs; i++)
+        {
+            variableParameters(&parameters, loop.variable, words.args[i]);
+            running = runTemplates(shell, &loop.body, &parameters);
+            bodyStatus = shell->lastStatus;
+        }
+
+        freeCommand(&words);
+        freeSubstitutions(&substitutions);
+    }
+    else
+    {
+        variableParameters(&parameters, "", NULL);
+
+        while (running == true)
+        {
+            running = runTemplates(shell, &loop.condition, &parameters);
+            if (running == false || shell->lastStatus != 0)
+            {
+                break;
+            }
+
+            running = runTemplates(shell, &loop.body, &parameters);
+            bodyStatus = shell->lastStatus;
+        }
+    }
+
+    freeLoop(&loop);
+
+    if (loop.redirections != NULL)
+    {
+        popSessionRedirections(shell, &redirections.redirections, savedFds);
+    }
+    freeCommand(&redirections);
+
+    /* A loop stopped by ^C keeps the status of the command that was killed.
+     * Otherwise the status of a while condition that failed, or of the
+     * last command before a loop with no iterations, is replaced.
+     */
+    if (shell->lastStatus != SIGNAL_STATUS_BASE + SIGINT && shell->lastStatus != bodyStatus)
+    {
+        sprintf(shell->exitStatusStr,"exit value %d",bodyStatus);
+        shell->lastStatus = bodyStatus;
+    }
+}
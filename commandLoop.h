@@ -0,0 +1,65 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the for and while loops including:
+ *
+ *               splitting a loop into its words or condition and its body
+ *               parsing each command of the body once into a template
+ *               running each iteration by patching the value of the
+ *               variable into a copy of each template and launching it
+ *
+ *              "for NAME in WORDS; do COMMANDS; done" runs the commands
+ *              once for each word with $NAME or ${NAME} replaced by it.
+ *              The words can come from a $(...), which runs once before
+ *              the loop. "while COMMANDS; do COMMANDS; done" runs the body
+ *              for as long as the condition succeeds. The ;, && and || of
+ *              the body work as on a commandline. Inbuilt commands, nested
+ *              loops and commands with a $(...) are run from their text
+ *              each iteration. A loop stops if one of its commands is
+ *              killed by ^C. Redirections of 0 - 2 after done apply to
+ *              every command of the loop that doesn't redirect them
+ *              itself, but not to the output of inbuilt commands.
+ *
+ **************************************************************************/
+
+#ifndef COMMAND_LOOP_H
+#define COMMAND_LOOP_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <signal.h>              /* for SIGINT */
+#include "commandList.h"         /* for splitting the loop */
+#include "commandSubstitution.h" /* for the outputs of $(...) in the words */
+#include "commandTemplate.h"     /* for the commands of the loop, parsed once */
+
+/* The exit status of a loop that doesn't parse, as in bash */
+#define LOOP_SYNTAX_ERROR 2
+
+/* Used to indicate the kind of loop */
+enum loopKind{ forLoop, whileLoop};
+
+struct shellState;
+
+/* A loop split into its parts, with its commands parsed */
+struct commandLoop
+{
+    enum loopKind kind;
+    char variable[MAX_VARIABLE_NAME];  /* the name of the variable of a for loop */
+    char *words;  /* the text of the words of a for loop */
+    char *redirections;  /* the redirections after done, or NULL */
+
+    struct templateList condition;  /* the condition of a while loop */
+    struct templateList body;
+};
+
+/* Runs a for or while loop and sets the exit status of the shell to that of
+ * the last command of the body that ran, or 0 if none did.
+ * input: the shell: struct shellState *
+ *        the $$ expanded loop, which is split up: char[]
+ */
+void loopBuiltin(struct shellState *shell, char commandText[]);
+
+#endif
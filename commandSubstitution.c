@@ -0,0 +1,436 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements command substitution, $(command), including:
+ *
+ *               finding each $(...) of a command, counting nested
+ *               parentheses
+ *               running the inner commandline in a forked copy of the
+ *               shell with its stdout on a pipe
+ *               reading the output in large chunks into an arena that
+ *               grows by remapping its pages
+ *               word splitting the output into the arguments of the outer
+ *               command
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 44 and 49
+ *
+ **************************************************************************/
+
+#include "commandSubstitution.h"
+#include "bashShell.h"  /* for running the inner commandline and addArgument */
+
+/* A word being put together from the text and outputs of a token. It grows
+ * by doubling so a long word is copied a constant number of times.
+ */
+struct wordBuffer
+{
+    char *text;
+    size_t length;
+    size_t capacity;
+};
+
+/* Called with each word of a token, returning -1 to stop */
+typedef int (*wordHandler)(void *context, char *word);
+
+/* Initializes an empty list, without mapping the arena. */
+void initializeSubstitutions(struct substitutionList *list)
+{
+    list->arena = NULL;
+    list->used = 0;
+    list->capacity = 0;
+    list->count = 0;
+}
+
+/* Unmaps the arena of the list. */
+void freeSubstitutions(struct substitutionList *list)
+{
+    if (list->arena != NULL)
+    {
+        munmap(list->arena, list->capacity);
+    }
+
+    initializeSubstitutions(list);
+}
+
+/* Returns true if the command text holds a $( */
+bool hasSubstitution(char *text)
+{
+    return strstr(text, "$(") != NULL;
+}
+
+/* Makes sure the arena has at least SUBSTITUTION_READ_SIZE bytes free. The
+ * arena doubles with mremap, which moves the pages rather than copying
+ * them, so reading an output is linear in its size.
+ */
+static void reserveArena(struct substitutionList *list)
+{
+    size_t capacity;
+    char *arena;
+
+    if (list->capacity - list->used >= SUBSTITUTION_READ_SIZE)
+    {
+        return;
+    }
+
+    if (list->arena == NULL)
+    {
+        capacity = SUBSTITUTION_ARENA_SIZE;
+        arena = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    else
+    {
+        capacity = list->capacity * 2;
+        arena = mremap(list->arena, list->capacity, capacity, MREMAP_MAYMOVE);
+    }
+
+    if (arena == MAP_FAILED)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    list->arena = arena;
+    list->capacity = capacity;
+}
+
+/* Runs the inner commandline in a forked copy of the shell, which exits
+ * with the status of its last command, and reads its stdout into the arena.
+ */
+static void runSubstitution(struct shellState *shell, char innerText[], struct substitutionList *list)
+{
+    struct substitution *item = &list->items[list->count++];
+    int pipeFds[2];
+    pid_t spawnPid;
+    ssize_t bytesRead;
+    int childExitMethod;
+
+    item->offset = list->used;
+    item->length = 0;
+
+    if (pipe2(pipeFds, O_CLOEXEC) == -1)
+    {
+        perror("Error creating pipe");
+        return;
+    }
+
+    /* Fewer, larger reads for commands with a lot of output. Only a hint,
+     * so a failure is ignored.
+     */
+    fcntl(pipeFds[1], F_SETPIPE_SZ, SUBSTITUTION_PIPE_SIZE);
+
+    /* the child would write out anything left in the buffer again */
+    fflush(stdout);
+
+    spawnPid = fork();
+    if (spawnPid == -1)
+    {
+        perror("Error creating fork\n");
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        return;
+    }
+
+    if (spawnPid == 0)
+    {
+        /* The copy of the shell writes to the pipe, including in a session
+         * with its own stdout, and has none of the shell's jobs or its
+         * launcher helper. It is on its last line, so its last command is
+         * exec'd in its place.
+         */
+        close(pipeFds[0]);
+        if (pipeFds[1] != STDOUT_FILENO)
+        {
+            dup2(pipeFds[1], STDOUT_FILENO);
+            close(pipeFds[1]);
+        }
+
+        shell->stdioFds[STDOUT_FILENO] = -1;
+        initializeJobTable(&shell->jobs, ARRAY_CAPACITY_BG);
+        releaseLauncher(&shell->launcher);
+        shell->prompt = false;
+        shell->lastLine = true;
+
+        runCommandLine(shell, innerText);
+
+        /* _exit leaves the exit handlers of a program hosting the shell to
+         * the program itself
+         */
+        fflush(stdout);
+        _exit(shell->lastStatus);
+    }
+
+    close(pipeFds[1]);
+
+    /* Read straight into the free end of the arena */
+    do
+    {
+        reserveArena(list);
+        bytesRead = read(pipeFds[0], list->arena + list->used, list->capacity - list->used);
+
+        if (bytesRead > 0)
+        {
+            list->used += bytesRead;
+            item->length += bytesRead;
+        }
+    } while (bytesRead > 0 || (bytesRead == -1 && errno == EINTR));
+
+    close(pipeFds[0]);
+
+    while (waitpid(spawnPid, &childExitMethod, 0) == -1 && errno == EINTR)
+    {
+    }
+}
+
+/* Runs each $(...) of a command from left to right, stores its output and
+ * replaces it in the command text with a mark.
+ */
+int runSubstitutions(struct shellState *shell, char commandText[], struct substitutionList *list)
+{
+    char innerText[MAX_COMMAND_LINE_EXPANDED];
+    char *start = commandText;
+    char *end;
+    int depth;
+
+    while ((start = strstr(start, "$(")) != NULL)
+    {
+        /* find the ) that closes the $(, past any nested (...) */
+        depth = 1;
+        for (end = start + 2; *end != '\0'; end++)
+        {
+            if (*end == '(')
+            {
+                ++depth;
+            }
+            else if (*end == ')' && --depth == 0)
+            {
+                break;
+            }
+        }
+
+        if (*end == '\0')
+        {
+            printf("syntax error: missing ) after $(\n");
+            return -1;
+        }
+
+        if (list->count == MAX_SUBSTITUTIONS)
+        {
+            printf("A command has a maximum of %d command substitutions\n", MAX_SUBSTITUTIONS);
+            return -1;
+        }
+
+        memcpy(innerText, start + 2, end - start - 2);
+        innerText[end - start - 2] = '\0';
+
+        /* $() is at least three bytes, enough for the mark and its index */
+        start[0] = SUBSTITUTION_MARK;
+        start[1] = '0' + list->count / 10;
+        start[2] = '0' + list->count % 10;
+        memset(start + 3, SUBSTITUTION_FILL, end - start - 2);
+
+        runSubstitution(shell, innerText, list);
+
+        start = end + 1;
+    }
+
+    return 0;
+}
+
+/* Adds a byte to the word, doubling it when it is full */
+static void appendToWord(struct wordBuffer *word, char byte)
+{
+    if (word->length + 1 >= word->capacity)
+    {
+        word->capacity = (word->capacity == 0) ? 64 : word->capacity * 2;
+        word->text = realloc(word->text, word->capacity);
+        if (word->text == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+    }
+
+    word->text[word->length++] = byte;
+}
+
+/* Passes a finished word to the handler and starts the next one */
+static int endWord(struct wordBuffer *word, wordHandler handler, void *context)
+{
+    word->text[word->length] = '\0';
+    word->length = 0;
+
+    return handler(context, word->text);
+}
+
+/* Splits a token into words. The text of the token is kept together and
+ * each output is split at whitespace, so a word can hold text from both.
+ * Returns -1 if the handler stops.
+ */
+static int splitToken(struct substitutionList *list, char *token, wordHandler handler, void *context)
+{
+    struct wordBuffer word = {NULL, 0, 0};
+    struct substitution *item;
+    bool inWord = false;
+    int result = 0;
+    char *output;
+    size_t i;
+    int index;
+
+    while (*token != '\0' && result == 0)
+    {
+        if (*token != SUBSTITUTION_MARK)
+        {
+            appendToWord(&word, *token++);
+            inWord = true;
+            continue;
+        }
+
+        index = (token[1] - '0') * 10 + (token[2] - '0');
+        token += 3;
+        while (*token == SUBSTITUTION_FILL)
+        {
+            ++token;
+        }
+
+        item = &list->items[index];
+        output = list->arena + item->offset;
+
+        for (i = 0; i < item->length && result == 0; i++)
+        {
+            if (isspace((unsigned char)output[i]))
+            {
+                if (inWord == true)
+                {
+                    result = endWord(&word, handler, context);
+                    inWord = false;
+                }
+            }
+            /* as in bash, null bytes of an output are dropped */
+            else if (output[i] != '\0')
+            {
+                appendToWord(&word, output[i]);
+                inWord = true;
+            }
+        }
+    }
+
+    if (inWord == true && result == 0)
+    {
+        result = endWord(&word, handler, context);
+    }
+
+    free(word.text);
+    return result;
+}
+
+static int addWordArgument(void *context, char *word)
+{
+    return addArgument(context, word);
+}
+
+/* Word splits a token holding marks and adds each word as an argument of
+ * the command.
+ */
+int addSubstitutedArguments(struct command *command, char *token)
+{
+    return splitToken(command->substitutions, token, addWordArgument, command);
+}
+
+/* Keeps the first word and counts the words */
+struct singleWord
+{
+    char *word;
+    int count;
+};
+
+static int keepSingleWord(void *context, char *word)
+{
+    struct singleWord *single = context;
+
+    if (single->count++ == 0)
+    {
+        single->word = getEmptyString(strlen(word) + 1);
+        strcpy(single->word, word);
+    }
+
+    return 0;
+}
+
+/* Replaces a token holding marks with the single word it splits into. */
+char *substitutedWord(struct substitutionList *list, char *token)
+{
+    struct singleWord single = {NULL, 0};
+
+    splitToken(list, token, keepSingleWord, &single);
+
+    if (single.count != 1)
+    {
+        fprintf(stderr, "$(...): ambiguous redirect\n");
+        free(single.word);
+        return NULL;
+    }
+
+    return single.word;
+}
+
+/* Copies a command text with each mark replaced by its output, with each
+ * run of whitespace in the output made a single space.
+ */
+int spliceSubstitutions(struct substitutionList *list, char *text, char spliced[], size_t size)
+{
+    struct substitution *item;
+    size_t length = 0;
+    bool lastSpace = false;
+    bool tooLong = false;
+    char *output;
+    size_t i;
+    int index;
+
+    while (*text != '\0' && length < size - 1)
+    {
+        if (*text != SUBSTITUTION_MARK)
+        {
+            spliced[length++] = *text++;
+            continue;
+        }
+
+        index = (text[1] - '0') * 10 + (text[2] - '0');
+        text += 3;
+        while (*text == SUBSTITUTION_FILL)
+        {
+            ++text;
+        }
+
+        item = &list->items[index];
+        output = list->arena + item->offset;
+
+        for (i = 0; i < item->length && length < size - 1; i++)
+        {
+            if (isspace((unsigned char)output[i]) || output[i] == '\0')
+            {
+                if (lastSpace == false)
+                {
+                    spliced[length++] = ' ';
+                }
+                lastSpace = true;
+            }
+            else
+            {
+                spliced[length++] = output[i];
+                lastSpace = false;
+            }
+        }
+        tooLong = (i < item->length);
+        lastSpace = false;
+    }
+
+    spliced[length] = '\0';
+
+    if (*text != '\0' || tooLong == true)
+    {
+        printf("The command line has a maximum length of %d\n", MAX_COMMAND_LINE);
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines command substitution, $(command), and the functions
+ *              for it including:
+ *
+ *               finding each $(...) of a command, counting nested
+ *               parentheses
+ *               running the inner commandline in a forked copy of the
+ *               shell with its stdout on a pipe
+ *               reading the output in large chunks into an arena that
+ *               grows by remapping its pages, so outputs of many megabytes
+ *               are never copied as they grow
+ *               word splitting the output into the arguments of the outer
+ *               command
+ *
+ *              Each $(...) is run before the command it is in, from left to
+ *              right, and is replaced in the command text by a mark holding
+ *              its index. The parser turns a token with marks into
+ *              arguments by splitting the outputs at whitespace, so text
+ *              before or after a $(...) joins its first or last word as in
+ *              bash. The output is never parsed again, so a < or > in it is
+ *              an argument and not a redirection.
+ *
+ **************************************************************************/
+
+#ifndef COMMAND_SUBSTITUTION_H
+#define COMMAND_SUBSTITUTION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>    /* for the arena of outputs */
+#include <sys/types.h>
+#include <sys/wait.h>
+
+/* The mark that replaces $( in a command and is followed by two digits of
+ * the index of the substitution. The rest of the $(...) is filled with
+ * SUBSTITUTION_FILL. Neither byte can be typed on a commandline.
+ */
+#define SUBSTITUTION_MARK '\001'
+#define SUBSTITUTION_FILL '\002'
+
+/* Maximum number of $(...) in a single command, so an index fits in the
+ * two digits after a mark
+ */
+#define MAX_SUBSTITUTIONS 64
+
+/* The first size of the arena and the least room left in it before each
+ * read of an output
+ */
+#define SUBSTITUTION_ARENA_SIZE (256 * 1024)
+#define SUBSTITUTION_READ_SIZE (64 * 1024)
+
+/* The size asked for the pipe of an output, so the inner command can write
+ * more before it waits for the shell to read
+ */
+#define SUBSTITUTION_PIPE_SIZE (1024 * 1024)
+
+/* The output of a $(...), as an offset into the arena since the arena
+ * moves when it grows
+ */
+struct substitution
+{
+    size_t offset;
+    size_t length;
+};
+
+/* The outputs of the $(...) of a command, one after the other in an arena
+ * of mapped pages
+ */
+struct substitutionList
+{
+    char *arena;  /* NULL until the first output is read */
+    size_t used;
+    size_t capacity;
+
+    struct substitution items[MAX_SUBSTITUTIONS];
+    int count;
+};
+
+struct shellState;
+struct command;
+
+/* Initializes an empty list, without mapping the arena.
+ * input: the list: struct substitutionList *
+ */
+void initializeSubstitutions(struct substitutionList *list);
+
+/* Unmaps the arena of the list.
+ * input: the list: struct substitutionList *
+ */
+void freeSubstitutions(struct substitutionList *list);
+
+/* Returns true if the command text holds a $(
+ * input: the command text: char *
+ */
+bool hasSubstitution(char *text);
+
+/* Runs each $(...) of a command from left to right, stores its output and
+ * replaces it in the command text with a mark.
+ * input: the shell, forked to run each inner commandline: struct shellState *
+ *        the $$ expanded command text, changed in place: char[]
+ *        the list to store the outputs in: struct substitutionList *
+ * output: 0 if successful or -1 after printing an error if a $( has no )
+ *         or there are too many
+ */
+int runSubstitutions(struct shellState *shell, char commandText[], struct substitutionList *list);
+
+/* Word splits a token holding marks and adds each word as an argument of
+ * the command.
+ * input: the command, whose substitutions are the list: struct command *
+ *        the token: char *
+ * output: 0 if successful or -1 if the args array is full
+ */
+int addSubstitutedArguments(struct command *command, char *token);
+
+/* Replaces a token holding marks, such as a redirection file name, with
+ * the single word it splits into.
+ * input: the list of outputs: struct substitutionList *
+ *        the token: char *
+ * output: the word as a dynamic string or NULL after printing an error if
+ *         the token isn't exactly one word
+ */
+char *substitutedWord(struct substitutionList *list, char *token);
+
+/* Copies a command text with each mark replaced by the words of its
+ * output separated by spaces, for inbuilt commands that read their
+ * arguments from the text.
+ * input: the list of outputs: struct substitutionList *
+ *        the command text with marks: char *
+ *        the buffer for the new text: char[]
+ *        the size of the buffer: size_t
+ * output: 0 if successful or -1 after printing an error if it doesn't fit
+ */
+int spliceSubstitutions(struct substitutionList *list, char *text, char spliced[], size_t size);
+
+#endif
@@ -0,0 +1,580 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements command templates including:
+ *
+ *               finding the variable or positional parameters in text
+ *               parsing each command of a list once into a template
+ *               patching the parameters into a copy of a template, with an
+ *               argument holding $@ becoming one argument per parameter
+ *               running a list of templates as a commandline would run
+ *
+ **************************************************************************/
+
+#include "commandTemplate.h"
+#include "bashShell.h"  /* for parsing, launching and running commands */
+
+/* Returns true if the character can be part of a variable name */
+static bool isNameCharacter(char character)
+{
+    return isalnum((unsigned char)character) || character == '_';
+}
+
+/* Sets the parameters to a variable and its value. */
+void variableParameters(struct templateParameters *parameters, char *name, char *value)
+{
+    parameters->name = name;
+    parameters->value = value;
+    parameters->positional = NULL;
+    parameters->numPositional = 0;
+    parameters->count[0] = '\0';
+}
+
+/* Sets the parameters to positional parameters. */
+void positionalParameters(struct templateParameters *parameters, char *values[], int numValues)
+{
+    parameters->name = NULL;
+    parameters->value = NULL;
+    parameters->positional = values;
+    parameters->numPositional = numValues;
+    sprintf(parameters->count, "%d", numValues);
+}
+
+/* Returns the length of the parameter at the start of the text, or 0 if
+ * there isn't one, and points value at its value. all is set to true for
+ * $@ and $*, which have no single value.
+ */
+static size_t parameterReference(char *text, struct templateParameters *parameters,
+                                 char **value, bool *all)
+{
+    size_t length;
+    char *end;
+    long index;
+
+    *value = NULL;
+    *all = false;
+
+    if (text[0] != '$')
+    {
+        return 0;
+    }
+
+    /* $NAME or ${NAME}, where an empty name is no parameters at all */
+    if (parameters->name != NULL)
+    {
+        length = strlen(parameters->name);
+        if (length == 0)
+        {
+            return 0;
+        }
+        *value = parameters->value;
+
+        if (text[1] == '{' && strncmp(text + 2, parameters->name, length) == 0 && text[2 + length] == '}')
+        {
+            return length + 3;
+        }
+        if (strncmp(text + 1, parameters->name, length) == 0 && !isNameCharacter(text[1 + length]))
+        {
+            return length + 1;
+        }
+        return 0;
+    }
+
+    /* $@, $*, $#, $1 - $9 or ${N} */
+    if (text[1] == '@' || text[1] == '*')
+    {
+        *all = true;
+        return 2;
+    }
+    if (text[1] == '#')
+    {
+        *value = parameters->count;
+        return 2;
+    }
+
+    if (text[1] >= '1' && text[1] <= '9')
+    {
+        index = text[1] - '0';
+        length = 2;
+    }
+    else if (text[1] == '{' && isdigit((unsigned char)text[2]))
+    {
+        index = strtol(text + 2, &end, 10);
+        if (*end != '}' || index == 0)
+        {
+            return 0;
+        }
+        length = end + 1 - text;
+    }
+    else
+    {
+        return 0;
+    }
+
+    /* a parameter that wasn't given is empty */
+    *value = (index <= parameters->numPositional) ? parameters->positional[index - 1] : "";
+
+    return length;
+}
+
+/* Returns true if the text holds a parameter */
+static bool holdsParameters(char *text, struct templateParameters *parameters)
+{
+    char *value;
+    bool all;
+
+    for (; *text != '\0'; text++)
+    {
+        if (parameterReference(text, parameters, &value, &all) > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Adds the text to the result at length, returning -1 if it doesn't fit */
+static int appendText(char substituted[], size_t *length, size_t size, char *text)
+{
+    size_t textLength = strlen(text);
+
+    if (*length + textLength >= size)
+    {
+        return -1;
+    }
+
+    memcpy(substituted + *length, text, textLength);
+    *length += textLength;
+
+    return 0;
+}
+
+/* Replaces each parameter in the text with its value. */
+int substituteParameters(char *text, struct templateParameters *parameters, char substituted[], size_t size)
+{
+    size_t length = 0;
+    size_t reference;
+    char *value;
+    bool all;
+    int i;
+
+    while (*text != '\0')
+    {
+        reference = parameterReference(text, parameters, &value, &all);
+        if (reference == 0)
+        {
+            if (length + 1 >= size)
+            {
+                return -1;
+            }
+            substituted[length++] = *text++;
+            continue;
+        }
+
+        if (all == true)
+        {
+            for (i = 0; i < parameters->numPositional; i++)
+            {
+                if ((i > 0 && appendText(substituted, &length, size, " ") == -1)
+                    || appendText(substituted, &length, size, parameters->positional[i]) == -1)
+                {
+                    return -1;
+                }
+            }
+        }
+        else if (appendText(substituted, &length, size, value) == -1)
+        {
+            return -1;
+        }
+
+        text += reference;
+    }
+
+    substituted[length] = '\0';
+
+    return 0;
+}
+
+/* Parses a command of a list once into a template if it can be launched,
+ * and notes which of its arguments and file names hold a parameter.
+ * Returns -1 after printing an error if the command has a here-document.
+ */
+static int compileTemplate(struct shellState *shell, struct templateCommand *templateCommand,
+                           char *text, enum connector connector, struct templateParameters *parameters)
+{
+    char commandCopy[MAX_COMMAND_LINE_EXPANDED];  /* parseListCommand splits up the command */
+    struct command *command;
+    int i;
+
+    templateCommand->text = text;
+    templateCommand->connector = connector;
+    templateCommand->template = NULL;
+    templateCommand->parameterArgs = NULL;
+    templateCommand->numParameterArgs = 0;
+    templateCommand->parameterRedirections = NULL;
+    templateCommand->numParameterRedirections = 0;
+    templateCommand->parameterHereWord = false;
+    templateCommand->hasParameters = holdsParameters(text, parameters);
+
+    command = malloc(sizeof(struct command));
+    if (command == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    strcpy(commandCopy, text);
+    initializeCommand(command, shell->jobDeadline);
+
+    if (parseListCommand(commandCopy, command) == false)
+    {
+        freeCommand(command);
+        free(command);
+        return 0;
+    }
+
+    if (command->hereType == hereDocument)
+    {
+        printf("syntax error: a loop or function can't hold a here-document\n");
+        freeCommand(command);
+        free(command);
+        return -1;
+    }
+
+    command->reportErrors = true;
+    templateCommand->template = command;
+
+    if (templateCommand->hasParameters == false)
+    {
+        return 0;
+    }
+
+    /* one more than needed, so nothing is allocated with a size of 0 */
+    templateCommand->parameterArgs = malloc((command->numArgs + 1) * sizeof(int));
+    templateCommand->parameterRedirections = malloc((command->redirections.count + 1) * sizeof(int));
+    if (templateCommand->parameterArgs == NULL || templateCommand->parameterRedirections == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < command->numArgs; i++)
+    {
+        if (holdsParameters(command->args[i], parameters))
+        {
+            templateCommand->parameterArgs[templateCommand->numParameterArgs++] = i;
+        }
+    }
+
+    for (i = 0; i < command->redirections.count; i++)
+    {
+        if (command->redirections.entries[i].fileName != NULL
+            && holdsParameters(command->redirections.entries[i].fileName, parameters))
+        {
+            templateCommand->parameterRedirections[templateCommand->numParameterRedirections++] = i;
+        }
+    }
+
+    templateCommand->parameterHereWord = (command->hereType == hereString
+                                          && holdsParameters(command->hereWord, parameters));
+
+    return 0;
+}
+
+/* Parses the commands of a list into templates, leaving out comments. */
+int compileTemplates(struct shellState *shell, struct listCommand listCommands[], int count,
+                     struct templateParameters *parameters, struct templateList *list)
+{
+    enum connector connector;
+    int i;
+
+    list->count = 0;
+    list->commands = malloc((count + 1) * sizeof(struct templateCommand));
+    if (list->commands == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (classifyCommandLine(listCommands[i].text) == commentLine)
+        {
+            continue;
+        }
+
+        connector = (list->count == 0) ? connectLine : listCommands[i].connector;
+
+        if (compileTemplate(shell, &list->commands[list->count], listCommands[i].text,
+                            connector, parameters) == -1)
+        {
+            return -1;
+        }
+        ++list->count;
+    }
+
+    return 0;
+}
+
+/* Frees the templates of a list. */
+void freeTemplates(struct templateList *list)
+{
+    int i;
+
+    for (i = 0; i < list->count; i++)
+    {
+        if (list->commands[i].template != NULL)
+        {
+            freeCommand(list->commands[i].template);
+            free(list->commands[i].template);
+        }
+        free(list->commands[i].parameterArgs);
+        free(list->commands[i].parameterRedirections);
+    }
+
+    free(list->commands);
+    list->commands = NULL;
+    list->count = 0;
+}
+
+/* Adds a copy of the text as an argument of the copy of a template that is
+ * freed with it. Returns -1 if the args array is full.
+ */
+static int addOwnedArgument(struct command *command, char *text, bool owned[])
+{
+    if (command->numArgs == MAX_NUM_ARGS - 1)
+    {
+        fprintf(stderr, "A commandline has a maximum of %d arguments\n", MAX_NUM_ARGS - 1);
+        return -1;
+    }
+
+    command->args[command->numArgs] = getEmptyString(strlen(text) + 1);
+    strcpy(command->args[command->numArgs], text);
+    owned[command->numArgs] = true;
+    ++command->numArgs;
+
+    return 0;
+}
+
+/* Adds the arguments that an argument holding parameters becomes. The text
+ * before the first $@ or $* joins the first parameter and the text after
+ * it the last, so "-I$@" with a and b gives -Ia and b, and with no
+ * parameters the $@ is dropped. Returns -1 if they don't fit.
+ */
+static int expandArgument(char *argument, struct templateParameters *parameters,
+                          struct command *command, bool owned[])
+{
+    char text[MAX_COMMAND_LINE_EXPANDED];
+    char prefix[MAX_COMMAND_LINE_EXPANDED];
+    char suffix[MAX_COMMAND_LINE_EXPANDED];
+    char piece[MAX_COMMAND_LINE_EXPANDED];
+    size_t reference = 0;
+    char *position;
+    char *value;
+    bool all = false;
+    int i;
+
+    strcpy(text, argument);
+
+    for (position = text; *position != '\0'; position++)
+    {
+        reference = parameterReference(position, parameters, &value, &all);
+        if (all == true)
+        {
+            break;
+        }
+    }
+
+    if (all == false)
+    {
+        if (substituteParameters(text, parameters, piece, MAX_COMMAND_LINE_EXPANDED) == -1)
+        {
+            return -1;
+        }
+        return addOwnedArgument(command, piece, owned);
+    }
+
+    *position = '\0';
+    if (substituteParameters(text, parameters, prefix, MAX_COMMAND_LINE_EXPANDED) == -1
+        || substituteParameters(position + reference, parameters, suffix, MAX_COMMAND_LINE_EXPANDED) == -1)
+    {
+        return -1;
+    }
+
+    if (parameters->numPositional == 0)
+    {
+        if (prefix[0] == '\0' && suffix[0] == '\0')
+        {
+            return 0;
+        }
+        if (snprintf(piece, MAX_COMMAND_LINE_EXPANDED, "%s%s", prefix, suffix) >= MAX_COMMAND_LINE_EXPANDED)
+        {
+            return -1;
+        }
+        return addOwnedArgument(command, piece, owned);
+    }
+
+    for (i = 0; i < parameters->numPositional; i++)
+    {
+        if (snprintf(piece, MAX_COMMAND_LINE_EXPANDED, "%s%s%s", (i == 0) ? prefix : "",
+                     parameters->positional[i],
+                     (i == parameters->numPositional - 1) ? suffix : "") >= MAX_COMMAND_LINE_EXPANDED
+            || addOwnedArgument(command, piece, owned) == -1)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* Makes a copy of the template with the parameters patched into the
+ * arguments, file names and here-string word that hold them. owned marks
+ * the arguments made for the copy. Returns -1 after printing an error if
+ * one is too long, and the copy still has to be released.
+ */
+static int instantiateTemplate(struct templateCommand *templateCommand, struct templateParameters *parameters,
+                               struct command *command, bool owned[])
+{
+    struct command *template = templateCommand->template;
+    char substituted[MAX_COMMAND_LINE_EXPANDED];
+    struct redirection *redirection;
+    int next = 0;  /* the next of the parameterArgs */
+    int result = 0;
+    int i;
+
+    *command = *template;
+    command->args = command->inlineArgs;
+    command->numArgs = 0;
+
+    for (i = 0; i < template->numArgs && result == 0; i++)
+    {
+        if (next < templateCommand->numParameterArgs && templateCommand->parameterArgs[next] == i)
+        {
+            ++next;
+            result = expandArgument(template->args[i], parameters, command, owned);
+        }
+        else if (command->numArgs == MAX_NUM_ARGS - 1)
+        {
+            fprintf(stderr, "A commandline has a maximum of %d arguments\n", MAX_NUM_ARGS - 1);
+            result = -1;
+        }
+        else
+        {
+            owned[command->numArgs] = false;
+            command->args[command->numArgs++] = template->args[i];
+        }
+    }
+    command->args[command->numArgs] = NULL;
+
+    if (result == -1)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < templateCommand->numParameterRedirections; i++)
+    {
+        redirection = &command->redirections.entries[templateCommand->parameterRedirections[i]];
+
+        if (substituteParameters(redirection->fileName, parameters, substituted, MAX_COMMAND_LINE_EXPANDED) == -1)
+        {
+            return -1;
+        }
+
+        redirection->fileName = getEmptyString(strlen(substituted) + 1);
+        strcpy(redirection->fileName, substituted);
+    }
+
+    if (templateCommand->parameterHereWord == true
+        && substituteParameters(template->hereWord, parameters, command->hereWord, MAX_FILE_NAME) == -1)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Frees what was made for the copy of a template: the patched arguments
+ * and file names and any redirections launchCommand added.
+ */
+static void releaseTemplate(struct templateCommand *templateCommand, struct command *command, bool owned[])
+{
+    struct command *template = templateCommand->template;
+    char *fileName;
+    int i;
+
+    for (i = 0; i < command->numArgs; i++)
+    {
+        if (owned[i] == true)
+        {
+            freeString(command->args[i]);
+        }
+    }
+
+    for (i = 0; i < command->redirections.count; i++)
+    {
+        fileName = command->redirections.entries[i].fileName;
+        if (fileName != NULL && (i >= template->redirections.count
+                                 || fileName != template->redirections.entries[i].fileName))
+        {
+            freeString(fileName);
+        }
+    }
+}
+
+/* Runs the commands of a list once with the values of the parameters. */
+bool runTemplates(struct shellState *shell, struct templateList *list, struct templateParameters *parameters)
+{
+    char commandText[MAX_COMMAND_LINE_EXPANDED];  /* runListCommand splits up the text */
+    struct templateCommand *templateCommand;
+    struct command command;
+    bool owned[MAX_NUM_ARGS];  /* the arguments made for the copy */
+    int result;
+    int i;
+
+    for (i = 0; i < list->count && shell->exitRequested == false && shell->functions.returning == false; i++)
+    {
+        templateCommand = &list->commands[i];
+
+        /* as in runCommandLine, a skipped command leaves the status alone */
+        if (!listCommandRuns(templateCommand->connector, shell->lastStatus))
+        {
+            continue;
+        }
+
+        if (templateCommand->template != NULL)
+        {
+            result = instantiateTemplate(templateCommand, parameters, &command, owned);
+            if (result == 0)
+            {
+                launchCommand(shell, &command);
+            }
+            releaseTemplate(templateCommand, &command, owned);
+        }
+        else
+        {
+            result = substituteParameters(templateCommand->text, parameters,
+                                          commandText, MAX_COMMAND_LINE_EXPANDED);
+            if (result == 0)
+            {
+                runListCommand(shell, commandText);
+            }
+        }
+
+        if (result == -1)
+        {
+            printf("The command line has a maximum length of %d\n", MAX_COMMAND_LINE_EXPANDED);
+            sprintf(shell->exitStatusStr,"exit value %d",1);
+            shell->lastStatus = 1;
+        }
+
+        /* ^C stops a loop as well as the command, as in bash */
+        if (shell->lastStatus == SIGNAL_STATUS_BASE + SIGINT)
+        {
+            return false;
+        }
+    }
+
+    return shell->exitRequested == false && shell->functions.returning == false;
+}
@@ -0,0 +1,143 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines command templates, the commands of a loop or
+ *              function parsed once, including:
+ *
+ *               parsing each command of a list once into a template, with
+ *               the arguments and file names that hold a parameter noted
+ *               substituting the variable of a for loop or the positional
+ *               parameters of a function into text
+ *               running a list of templates by patching the parameters
+ *               into a copy of each template and launching it, so a
+ *               command is never tokenized or parsed again
+ *
+ *              The parameters are either a named variable, as $NAME or
+ *              ${NAME}, or the positional parameters $1 - $9 and ${N},
+ *              $# for how many there are and $@ or $* for all of them. An
+ *              argument holding $@ or $* becomes one argument for each
+ *              parameter, as in bash. Inbuilt commands, loops and commands
+ *              with a $(...) are run from their text, with the parameters
+ *              substituted.
+ *
+ *              A copy of a template shares its argument strings and file
+ *              names, and only those holding a parameter are made for the
+ *              copy and freed after it.
+ *
+ **************************************************************************/
+
+#ifndef COMMAND_TEMPLATE_H
+#define COMMAND_TEMPLATE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <signal.h>       /* for SIGINT */
+#include "commandList.h"  /* for the connectors of a list */
+
+/* Maximum length of the name of a variable including '\0' */
+#define MAX_VARIABLE_NAME 64
+
+struct shellState;
+struct command;
+
+/* The values patched into templates: the variable of a for loop, or the
+ * positional parameters of a function
+ */
+struct templateParameters
+{
+    char *name;  /* the name of the variable, or NULL for positional parameters */
+    char *value;
+
+    char **positional;  /* $1 onwards */
+    int numPositional;
+    char count[12];  /* $#, as text */
+};
+
+/* A command of a list parsed once */
+struct templateCommand
+{
+    char *text;  /* the $$ expanded text of the command */
+    enum connector connector;
+
+    /* The command parsed once, or NULL if it is run from its text by
+     * runListCommand. Its args and file names are shared with every copy
+     * except those holding a parameter.
+     */
+    struct command *template;
+
+    /* The indices of the template's arguments and redirections that hold a
+     * parameter and are patched in each copy
+     */
+    int *parameterArgs;
+    int numParameterArgs;
+    int *parameterRedirections;
+    int numParameterRedirections;
+    bool parameterHereWord;  /* true if the here-string word holds one */
+
+    bool hasParameters;  /* true if the text holds a parameter */
+};
+
+/* The commands of a loop's condition or body or of a function */
+struct templateList
+{
+    struct templateCommand *commands;
+    int count;
+};
+
+/* Sets the parameters to a variable and its value.
+ * input: the parameters: struct templateParameters *
+ *        the name of the variable, or "" for no parameters: char *
+ *        the value, or NULL while compiling: char *
+ */
+void variableParameters(struct templateParameters *parameters, char *name, char *value);
+
+/* Sets the parameters to positional parameters.
+ * input: the parameters: struct templateParameters *
+ *        the values of $1 onwards, or NULL while compiling: char *[]
+ *        the number of values: int
+ */
+void positionalParameters(struct templateParameters *parameters, char *values[], int numValues);
+
+/* Replaces each parameter in the text with its value, with $@ and $*
+ * replaced by every positional parameter separated by spaces.
+ * input: the text: char *
+ *        the parameters: struct templateParameters *
+ *        a char array for the result: char[]
+ *        the size of the array: size_t
+ * output: 0 if successful or -1 if the result doesn't fit
+ */
+int substituteParameters(char *text, struct templateParameters *parameters, char substituted[], size_t size);
+
+/* Parses the commands of a list into templates, leaving out comments. The
+ * first command always runs. The templates point into the text of the
+ * list, which must last as long as they do.
+ * input: the shell: struct shellState *
+ *        the commands of the list: struct listCommand[]
+ *        the number of commands: int
+ *        the parameters looked for, whose values aren't used:
+ *        struct templateParameters *
+ *        the list of templates to fill in: struct templateList *
+ * output: 0 if successful or -1 after printing an error if a command has
+ *         a here-document, whose body would be read again each time
+ */
+int compileTemplates(struct shellState *shell, struct listCommand listCommands[], int count,
+                     struct templateParameters *parameters, struct templateList *list);
+
+/* Frees the templates of a list.
+ * input: the list of templates: struct templateList *
+ */
+void freeTemplates(struct templateList *list);
+
+/* Runs the commands of a list once with the values of the parameters.
+ * input: the shell: struct shellState *
+ *        the list of templates: struct templateList *
+ *        the parameters: struct templateParameters *
+ * output: false if a command was killed by ^C, the shell is to exit or a
+ *         function returned, which stops a loop, otherwise true
+ */
+bool runTemplates(struct shellState *shell, struct templateList *list, struct templateParameters *parameters);
+
+#endif
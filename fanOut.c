@@ -0,0 +1,558 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the fan-out of an fd redirected to several files
+ *              including:
+ *
+ *               finding the fds of a redirection table with more than one
+ *               output file, as in cmd > a > b or cmd > a >> b
+ *               giving the command a pipe in place of those files
+ *               copying the pipe into every file on a thread of the shell
+ *               with tee and splice, so the data stays in the kernel and
+ *               no tee process is needed
+ *               compressing the output into a file given with >z as a
+ *               gzip stream with zlib
+ *
+ *  Reference: man pages tee(2), splice(2) and pipe(7), The Linux
+ *  Programming Interface by Kerrisk chapters 29 and 44 and the zlib manual
+ *
+ **************************************************************************/
+
+#include "fanOut.h"
+#include "bashShell.h"  /* for the redirection table of a command */
+
+/* The number of background commands' copies still running, which the
+ * shell waits for before it exits
+ */
+static int numDetached = 0;
+static pthread_mutex_t detachedMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t detachedEnded = PTHREAD_COND_INITIALIZER;
+
+/* A file a fan-out copies into while its thread runs */
+struct fanOutTarget
+{
+    int fileFd;
+    char *fileName;
+    int copy[2];  /* the pipe the chunk is tee'd into, or -1 for the last file */
+    bool useWrite;  /* true once splice has refused the file */
+    bool failed;  /* true once the file couldn't be written */
+
+    /* A file given with >z is written through the stream as gzip, from
+     * the output buffer
+     */
+    bool compressed;
+    z_stream stream;
+    unsigned char *output;
+};
+
+/* Returns true if the entry is an output file of the fd */
+static bool isOutputFile(struct redirection *entry, int fd)
+{
+    return entry->fd == fd && (entry->type == redirectOutput || entry->type == redirectAppend
+                               || entry->type == redirectCompressed)
+           && entry->sourceFd != NOT_OPENED;
+}
+
+/* Frees a fan-out, closing the files and pipe ends it still holds */
+static void freeFanOut(struct fanOut *fanOut)
+{
+    int i;
+
+    for (i = 0; i < fanOut->numFiles; i++)
+    {
+        close(fanOut->fileFds[i]);
+        free(fanOut->fileNames[i]);
+    }
+    if (fanOut->readFd != -1)
+    {
+        close(fanOut->readFd);
+    }
+    if (fanOut->writeFd != -1)
+    {
+        close(fanOut->writeFd);
+    }
+
+    free(fanOut);
+}
+
+/* Replaces the output files of every fd of an opened table that has more
+ * than one, or a compressed one, with a pipe, moving the files to a
+ * fan-out.
+ */
+int openFanOuts(struct redirectionTable *table)
+{
+    struct fanOut *fanOut;
+    struct redirection *entry;
+    int pipeFds[2];
+    int numFiles;
+    int numCompressed;
+    int last;
+    int fd;
+    int i;
+
+    for (fd = 0; fd <= MAX_REDIRECT_FD; fd++)
+    {
+        numFiles = 0;
+        numCompressed = 0;
+        last = -1;
+        for (i = 0; i < table->count; i++)
+        {
+            if (table->entries[i].fd == fd)
+            {
+                last = i;
+                if (isOutputFile(&table->entries[i], fd))
+                {
+                    ++numFiles;
+                    numCompressed += (table->entries[i].type == redirectCompressed);
+                }
+            }
+        }
+
+        /* A single file is only given a pipe if the shell compresses it */
+        if ((numFiles < 2 && numCompressed == 0) || !isOutputFile(&table->entries[last], fd))
+        {
+            continue;
+        }
+
+        /* Close-on-exec, so only the command's copy of the write end,
+         * made by dup3, survives into it
+         */
+        if (pipe2(pipeFds, O_CLOEXEC) == -1)
+        {
+            perror("pipe2() unsuccessful");
+            return -1;
+        }
+        fcntl(pipeFds[1], F_SETPIPE_SZ, FAN_OUT_PIPE_SIZE);
+
+        fanOut = malloc(sizeof(struct fanOut));
+        if (fanOut == NULL)
+        {
+            fprintf(stderr,"Malloc not successful\n");
+            exit(1);
+        }
+        fanOut->fd = fd;
+        fanOut->readFd = pipeFds[0];
+        fanOut->writeFd = pipeFds[1];
+        fanOut->numFiles = 0;
+
+        for (i = 0; i < table->count; i++)
+        {
+            entry = &table->entries[i];
+            if (!isOutputFile(entry, fd))
+            {
+                continue;
+            }
+
+            fanOut->fileNames[fanOut->numFiles] = malloc(strlen(entry->fileName) + 1);
+            if (fanOut->fileNames[fanOut->numFiles] == NULL)
+            {
+                fprintf(stderr,"Malloc not successful\n");
+                exit(1);
+            }
+            strcpy(fanOut->fileNames[fanOut->numFiles], entry->fileName);
+            fanOut->fileFds[fanOut->numFiles] = entry->sourceFd;
+            fanOut->compressed[fanOut->numFiles] = (entry->type == redirectCompressed);
+            ++fanOut->numFiles;
+
+            /* the write end isn't owned by the table, so it isn't closed
+             * with the files
+             */
+            entry->type = redirectDescriptor;
+            entry->sourceFd = fanOut->writeFd;
+        }
+
+        fanOut->next = table->fanOuts;
+        table->fanOuts = fanOut;
+    }
+
+    return 0;
+}
+
+/* Writes data to a target's file, marking the target as failed if it
+ * can't be written
+ */
+static void writeData(struct fanOutTarget *target, char *data, size_t length)
+{
+    ssize_t written;
+    size_t offset;
+
+    for (offset = 0; target->failed == false && offset < length; offset += written)
+    {
+        written = write(target->fileFd, data + offset, length - offset);
+        if (written == -1)
+        {
+            fprintf(stderr, "%s: %s\n", target->fileName, strerror(errno));
+            target->failed = true;
+        }
+    }
+}
+
+/* Starts the gzip stream of a file given with >z. The output buffer is the
+ * size of the read buffer, so most chunks are compressed in one call.
+ * Reference: https://zlib.net/manual.html deflateInit2
+ */
+static void startCompression(struct fanOutTarget *target)
+{
+    int result;
+
+    /* compressed data is always written from a buffer */
+    target->useWrite = true;
+
+    target->stream.zalloc = Z_NULL;
+    target->stream.zfree = Z_NULL;
+    target->stream.opaque = Z_NULL;
+    result = deflateInit2(&target->stream, FAN_OUT_COMPRESSION_LEVEL, Z_DEFLATED,
+                          FAN_OUT_GZIP_WINDOW_BITS, FAN_OUT_MEMORY_LEVEL, Z_DEFAULT_STRATEGY);
+    if (result != Z_OK)
+    {
+        fprintf(stderr, "%s: %s\n", target->fileName, zError(result));
+        target->compressed = false;
+        target->failed = true;
+        return;
+    }
+
+    target->output = malloc(FAN_OUT_BUFFER_SIZE);
+    if (target->output == NULL)
+    {
+        fprintf(stderr,"Malloc not successful\n");
+        exit(1);
+    }
+}
+
+/* Compresses data into a target's file. Z_FINISH ends the stream, writing
+ * what deflate holds back and the gzip trailer, and frees it.
+ */
+static void compressData(struct fanOutTarget *target, char *data, size_t length, int flush)
+{
+    int result;
+
+    target->stream.next_in = (unsigned char *)data;
+    target->stream.avail_in = length;
+
+    /* deflate is called until it leaves space in the buffer, when it has
+     * taken all the input and, with Z_FINISH, written everything out
+     */
+    do
+    {
+        target->stream.next_out = target->output;
+        target->stream.avail_out = FAN_OUT_BUFFER_SIZE;
+        result = deflate(&target->stream, flush);
+        writeData(target, (char *)target->output, FAN_OUT_BUFFER_SIZE - target->stream.avail_out);
+    } while (target->stream.avail_out == 0 && result != Z_STREAM_ERROR);
+
+    if (flush == Z_FINISH)
+    {
+        deflateEnd(&target->stream);
+        free(target->output);
+        target->output = NULL;
+        target->compressed = false;
+    }
+}
+
+/* Moves what is in a pipe, up to a limit, into a target, waiting if the
+ * pipe is empty. It is spliced unless the file has refused splice, when it
+ * is written from a buffer. A target that has failed has it read and
+ * dropped, so the command is never left blocked on a full pipe.
+ * output: the bytes taken from the pipe, 0 once the pipe has ended or -1
+ */
+static ssize_t drainAvailable(int pipeFd, struct fanOutTarget *target, size_t limit, char **buffer)
+{
+    ssize_t moved;
+
+    if (target->failed == false && target->useWrite == false)
+    {
+        moved = splice(pipeFd, NULL, target->fileFd, NULL, limit, SPLICE_F_MOVE);
+        if (moved != -1)
+        {
+            return moved;
+        }
+
+        /* files opened with >> and some devices can't be spliced into */
+        if (errno == EINVAL)
+        {
+            target->useWrite = true;
+        }
+        else
+        {
+            fprintf(stderr, "%s: %s\n", target->fileName, strerror(errno));
+            target->failed = true;
+        }
+    }
+
+    /* a buffer is only made for a file that needs one */
+    if (*buffer == NULL)
+    {
+        *buffer = malloc(FAN_OUT_BUFFER_SIZE);
+        if (*buffer == NULL)
+        {
+            fprintf(stderr,"Malloc not successful\n");
+            exit(1);
+        }
+    }
+
+    moved = read(pipeFd, *buffer, (limit < FAN_OUT_BUFFER_SIZE) ? limit : FAN_OUT_BUFFER_SIZE);
+
+    if (moved > 0 && target->compressed == true && target->failed == false)
+    {
+        compressData(target, *buffer, moved, Z_NO_FLUSH);
+    }
+    else if (moved > 0)
+    {
+        writeData(target, *buffer, moved);
+    }
+
+    return moved;
+}
+
+/* Moves a whole chunk that is in a pipe into a target.
+ * output: 0 if successful or -1 if the pipe ended early
+ */
+static int drainChunk(int pipeFd, struct fanOutTarget *target, size_t length, char **buffer)
+{
+    ssize_t moved;
+
+    while (length > 0)
+    {
+        moved = drainAvailable(pipeFd, target, length, buffer);
+        if (moved <= 0)
+        {
+            return -1;
+        }
+        length -= moved;
+    }
+
+    return 0;
+}
+
+/* The thread of a fan-out. Each chunk in the command's pipe is tee'd into
+ * the pipe of every file but the last and spliced from there into the
+ * file, then spliced into the last file, which takes it out of the pipe.
+ * The copy pipes are the size of the command's pipe and empty before each
+ * tee, so each takes the whole chunk the first one took.
+ */
+static void *copyFanOut(void *argument)
+{
+    struct fanOut *fanOut = argument;
+    struct fanOutTarget targets[MAX_REDIRECTIONS];
+    struct fanOutTarget *lastTarget;
+    char *buffer = NULL;
+    ssize_t chunk = 1;
+    ssize_t copied;
+    int pipeSize;
+    int i;
+
+    pipeSize = fcntl(fanOut->readFd, F_GETPIPE_SZ);
+
+    for (i = 0; i < fanOut->numFiles; i++)
+    {
+        targets[i].fileFd = fanOut->fileFds[i];
+        targets[i].fileName = fanOut->fileNames[i];
+        targets[i].copy[0] = -1;
+        targets[i].copy[1] = -1;
+        targets[i].useWrite = false;
+        targets[i].failed = false;
+        targets[i].compressed = fanOut->compressed[i];
+        targets[i].output = NULL;
+        if (targets[i].compressed == true)
+        {
+            startCompression(&targets[i]);
+        }
+
+        if (i < fanOut->numFiles - 1)
+        {
+            if (pipe2(targets[i].copy, O_CLOEXEC) == -1)
+            {
+                perror("pipe2() unsuccessful");
+                targets[i].failed = true;
+            }
+            else
+            {
+                fcntl(targets[i].copy[1], F_SETPIPE_SZ, pipeSize);
+            }
+        }
+    }
+    lastTarget = &targets[fanOut->numFiles - 1];
+
+    /* tee waits for the command to write and returns 0 once every copy of
+     * the write end is closed and the pipe is empty
+     */
+    while (chunk > 0)
+    {
+        chunk = -1;
+        for (i = 0; i < fanOut->numFiles - 1 && chunk != 0; i++)
+        {
+            if (targets[i].failed == true)
+            {
+                continue;
+            }
+
+            copied = tee(fanOut->readFd, targets[i].copy[1], (chunk == -1) ? pipeSize : chunk, 0);
+            if (copied == -1 || (chunk != -1 && copied != chunk))
+            {
+                fprintf(stderr, "%s: %s\n", targets[i].fileName,
+                        (copied == -1) ? strerror(errno) : "output only partly copied");
+                targets[i].failed = true;
+                continue;
+            }
+
+            chunk = copied;
+            if (chunk > 0)
+            {
+                drainChunk(targets[i].copy[0], &targets[i], chunk, &buffer);
+            }
+        }
+
+        /* With no copy taken, as when every other file has failed, the last
+         * file takes whatever the command has written so far
+         */
+        if (chunk == -1)
+        {
+            chunk = drainAvailable(fanOut->readFd, lastTarget, pipeSize, &buffer);
+        }
+        else if (chunk > 0 && drainChunk(fanOut->readFd, lastTarget, chunk, &buffer) == -1)
+        {
+            chunk = 0;
+        }
+    }
+
+    /* Each compressed file is ended, even one that failed, so its stream
+     * is freed
+     */
+    for (i = 0; i < fanOut->numFiles; i++)
+    {
+        if (targets[i].compressed == true)
+        {
+            compressData(&targets[i], NULL, 0, Z_FINISH);
+        }
+    }
+
+    for (i = 0; i < fanOut->numFiles - 1; i++)
+    {
+        if (targets[i].copy[0] != -1)
+        {
+            close(targets[i].copy[0]);
+            close(targets[i].copy[1]);
+        }
+    }
+    free(buffer);
+
+    /* nothing joins the thread of a background command, so it frees its
+     * own fan-out
+     */
+    if (fanOut->detached == true)
+    {
+        freeFanOut(fanOut);
+
+        pthread_mutex_lock(&detachedMutex);
+        --numDetached;
+        pthread_cond_broadcast(&detachedEnded);
+        pthread_mutex_unlock(&detachedMutex);
+    }
+
+    return NULL;
+}
+
+/* Starts copying the fan-outs of a table after the command has been
+ * forked.
+ */
+struct fanOut *startFanOuts(struct redirectionTable *table, bool inBackground)
+{
+    struct fanOut *fanOuts = table->fanOuts;
+    struct fanOut *fanOut;
+    struct fanOut *next;
+    sigset_t allSignals;
+    sigset_t previousMask;
+    pthread_attr_t attributes;
+
+    table->fanOuts = NULL;
+
+    /* The threads block every signal, so the shell's handlers run on its
+     * own thread and a file that is a pipe with no reader fails with EPIPE
+     * rather than killing the shell
+     */
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousMask);
+
+    pthread_attr_init(&attributes);
+    if (inBackground == true)
+    {
+        pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    }
+
+    for (fanOut = fanOuts; fanOut != NULL; fanOut = next)
+    {
+        next = fanOut->next;
+        close(fanOut->writeFd);
+        fanOut->writeFd = -1;
+        fanOut->detached = inBackground;
+
+        if (inBackground == true)
+        {
+            pthread_mutex_lock(&detachedMutex);
+            ++numDetached;
+            pthread_mutex_unlock(&detachedMutex);
+        }
+
+        if (pthread_create(&fanOut->thread, &attributes, copyFanOut, fanOut) != 0)
+        {
+            fprintf(stderr, "Error creating fan-out thread\n");
+            close(fanOut->readFd);
+            fanOut->readFd = -1;
+            if (inBackground == true)
+            {
+                freeFanOut(fanOut);
+
+                pthread_mutex_lock(&detachedMutex);
+                --numDetached;
+                pthread_mutex_unlock(&detachedMutex);
+            }
+        }
+    }
+
+    pthread_attr_destroy(&attributes);
+    pthread_sigmask(SIG_SETMASK, &previousMask, NULL);
+
+    /* a background command's fan-outs belong to their threads */
+    return (inBackground == true) ? NULL : fanOuts;
+}
+
+/* Waits for the copies of a foreground command to finish and frees them. */
+void joinFanOuts(struct fanOut *fanOuts)
+{
+    struct fanOut *next;
+
+    while (fanOuts != NULL)
+    {
+        next = fanOuts->next;
+        if (fanOuts->readFd != -1)
+        {
+            pthread_join(fanOuts->thread, NULL);
+        }
+        freeFanOut(fanOuts);
+        fanOuts = next;
+    }
+}
+
+/* Waits for the copies of background commands to finish. */
+void waitForFanOuts(void)
+{
+    pthread_mutex_lock(&detachedMutex);
+    while (numDetached > 0)
+    {
+        pthread_cond_wait(&detachedEnded, &detachedMutex);
+    }
+    pthread_mutex_unlock(&detachedMutex);
+}
+
+/* Closes and frees fan-outs that were never started. */
+void closeFanOuts(struct redirectionTable *table)
+{
+    struct fanOut *next;
+
+    while (table->fanOuts != NULL)
+    {
+        next = table->fanOuts->next;
+        freeFanOut(table->fanOuts);
+        table->fanOuts = next;
+    }
+}
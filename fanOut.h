@@ -0,0 +1,125 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the fan-out of an fd redirected to several files
+ *              or to a compressed file including:
+ *
+ *               finding the fds of a redirection table with more than one
+ *               output file, as in cmd > a > b or cmd > a >> b, or with a
+ *               file to compress, as in cmd >z a.gz
+ *               giving the command a pipe in place of those files
+ *               copying the pipe into every file on a thread of the shell
+ *               with tee and splice, so the data stays in the kernel and
+ *               no tee process is needed
+ *               compressing the output into a >z file on that thread with
+ *               zlib, so the file is written once, as gzip, without a gzip
+ *               process
+ *
+ *              Each chunk the command writes is duplicated with tee into
+ *              a pipe of its own for every file but the last and spliced
+ *              from there into the file, then spliced from the command's
+ *              pipe into the last file, which consumes it. A file that
+ *              can't be spliced into, such as one opened with >> or a
+ *              terminal, is written from a buffer instead, and a >z file
+ *              is compressed from the buffer as a gzip stream.
+ *
+ *              A foreground command's files are complete when the shell
+ *              goes on to the next command. A background command's thread
+ *              finishes by itself once the command and anything it started
+ *              have closed the pipe, and the shell waits for it before it
+ *              exits. A file that can't be written is
+ *              reported and dropped while the others go on being written.
+ *
+ *  Reference: man pages tee(2), splice(2) and pipe(7) and the zlib manual
+ *
+ **************************************************************************/
+
+#ifndef FAN_OUT_H
+#define FAN_OUT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>        /* for tee, splice and F_SETPIPE_SZ */
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+#include <zlib.h>         /* for the gzip stream of a >z file */
+#include "redirection.h"  /* for the redirection table */
+
+/* The size the pipe of a fan-out is made, so a chunk of output costs the
+ * fewest system calls. Left at the default if the user isn't allowed it.
+ */
+#define FAN_OUT_PIPE_SIZE (1 << 20)
+
+/* The size of the buffer a file that can't be spliced into is written from */
+#define FAN_OUT_BUFFER_SIZE (1 << 16)
+
+/* The level a >z file is compressed at, gzip's default of 6 */
+#define FAN_OUT_COMPRESSION_LEVEL Z_DEFAULT_COMPRESSION
+
+/* A window of 2^15 bytes, with 16 added so deflate writes a gzip header
+ * and trailer rather than a zlib one, and deflate's default memory level
+ */
+#define FAN_OUT_GZIP_WINDOW_BITS (15 + 16)
+#define FAN_OUT_MEMORY_LEVEL 8
+
+/* An fd of a command redirected to several files */
+struct fanOut
+{
+    int fd;  /* the fd of the command that is fanned out */
+    int readFd;  /* the read end of the pipe the command writes to */
+    int writeFd;  /* the write end, closed by the shell once it has forked */
+
+    /* The files, in commandline order, which the fan-out owns */
+    int fileFds[MAX_REDIRECTIONS];
+    char *fileNames[MAX_REDIRECTIONS];
+    bool compressed[MAX_REDIRECTIONS];  /* true for a file given with >z */
+    int numFiles;
+
+    pthread_t thread;
+    bool detached;  /* true if the thread frees the fan-out when it ends */
+    struct fanOut *next;
+};
+
+/* Replaces the output files of every fd of an opened table that has more
+ * than one, or a compressed one, with a pipe, moving the files to a
+ * fan-out. The fd's entries
+ * become the pipe's write end, so a 2>&1 copies the pipe as it would a
+ * file. An fd whose last redirection isn't an output file is left alone.
+ * input: the table, after openRedirections: struct redirectionTable *
+ * output: 0 if successful or -1 after printing an error, when the table's
+ *         fan-outs are released by closeRedirections
+ */
+int openFanOuts(struct redirectionTable *table);
+
+/* Starts copying the fan-outs of a table after the command has been
+ * forked, closing the shell's write ends so the copies end when the
+ * command does. The table no longer holds the fan-outs.
+ * input: the table: struct redirectionTable *
+ *        true if the command runs in the background, when nothing waits
+ *        for the copies: bool
+ * output: the fan-outs to pass to joinFanOuts, or NULL for a background
+ *         command
+ */
+struct fanOut *startFanOuts(struct redirectionTable *table, bool inBackground);
+
+/* Waits for the copies of a foreground command to finish and frees them.
+ * input: the fan-outs returned by startFanOuts: struct fanOut *
+ */
+void joinFanOuts(struct fanOut *fanOuts);
+
+/* Waits for the copies of background commands to finish, as before the
+ * shell exits, so no file is left short.
+ */
+void waitForFanOuts(void);
+
+/* Closes and frees fan-outs that were never started, as when the command
+ * isn't run after all.
+ * input: the table: struct redirectionTable *
+ */
+void closeFanOuts(struct redirectionTable *table);
+
+#endif
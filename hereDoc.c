@@ -0,0 +1,246 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements functions for building here-documents (<<WORD)
+ *              and here-strings (<<< word) including:
+ *
+ *               reading a here-document body up to its delimiter line
+ *               writing the body into an anonymous memory file
+ *               sealing the memory file so it can't be modified
+ *
+ *  Reference: man pages memfd_create(2) and fcntl(2) (File Sealing)
+ *
+ **************************************************************************/
+
+#include "hereDoc.h"
+#include "bashShell.h"  /* for expandString and the commandline limits */
+
+/* Returns true if a commandline has a here-document operator. Operators
+ * are whole tokens, or the start of one, as parseArguments splits them.
+ */
+bool hasHereDocument(char *text)
+{
+    char *position;
+
+    for (position = text; *position != '\0'; position++)
+    {
+        if ((position == text || isspace((unsigned char)position[-1]))
+            && strncmp(position, "<<", 2) == 0 && position[2] != '<')
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Writes all of the bytes in buffer to the file descriptor, retrying on
+ * partial writes. Returns 0 on success and -1 on error.
+ */
+static int writeAll(int fileDescriptor, char *buffer, size_t size)
+{
+    ssize_t written;
+
+    while (size > 0)
+    {
+        written = write(fileDescriptor, buffer, size);
+
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+
+        buffer += written;
+        size -= written;
+    }
+
+    return 0;
+}
+
+/* Creates an empty memory file that allows sealing. Returns its file
+ * descriptor or -1 on error.
+ */
+static int openMemoryFile(char *name)
+{
+    int memFileDescriptor;
+
+    /* MFD_CLOEXEC so only the dup2'd copy of stdin survives execvp */
+    memFileDescriptor = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+
+    if (memFileDescriptor == -1)
+    {
+        perror("memfd_create() unsuccessful");
+    }
+
+    return memFileDescriptor;
+}
+
+/* Seals the memory file against any further changes and rewinds it to the
+ * start. Closes the file and returns -1 on error, otherwise returns the file
+ * descriptor.
+ */
+static int sealMemoryFile(int memFileDescriptor)
+{
+    if (fcntl(memFileDescriptor, F_ADD_SEALS,
+              F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1
+        || lseek(memFileDescriptor, 0, SEEK_SET) == -1)
+    {
+        perror("sealing here-document unsuccessful");
+        close(memFileDescriptor);
+        return -1;
+    }
+
+    return memFileDescriptor;
+}
+
+/* Reads lines from the input stream up to a line equal to the delimiter,
+ * expands $$ in each line and writes them into a sealed memory file whose
+ * offset is rewound to the start so it can be used as stdin.
+ */
+int createHereDocument(FILE *stream, char *delimiter, pid_t pid)
+{
+    char *line = NULL;  /* the line returned by getline */
+    size_t lineCapacity = 0;
+    ssize_t lineSize;
+    char lineExpanded[MAX_COMMAND_LINE_EXPANDED];
+
+    /* lines are batched here so each line doesn't cost a write() */
+    char *batch;
+    size_t batchSize = 0;
+    size_t expandedSize;
+
+    int memFileDescriptor;
+    int error = 0;
+    bool foundDelimiter = false;
+
+    memFileDescriptor = openMemoryFile("here-document");
+    if (memFileDescriptor == -1)
+    {
+        return -1;
+    }
+
+    batch = getEmptyString(HERE_BUFFER_SIZE);
+
+    while (error == 0)
+    {
+        if (isatty(fileno(stream)))
+        {
+            printf(HERE_PROMPT);
+            fflush(stdout);
+        }
+
+        lineSize = getline(&line, &lineCapacity, stream);
+        if (lineSize < 0)
+        {
+            break;
+        }
+
+        /* compare the line without its newline against the delimiter */
+        if (lineSize > 0 && line[lineSize - 1] == '\n')
+        {
+            line[lineSize - 1] = '\0';
+        }
+        if (strcmp(line, delimiter) == 0)
+        {
+            foundDelimiter = true;
+            break;
+        }
+
+        if (expandString(line, pid, lineExpanded) == commandLineTooLong)
+        {
+            fprintf(stderr, "here-document lines have a maximum length of %d\n",
+                    MAX_COMMAND_LINE);
+            error = -1;
+            break;
+        }
+
+        expandedSize = strlen(lineExpanded);
+
+        /* flush the batch to the memory file when the line won't fit */
+        if (batchSize + expandedSize + 1 > HERE_BUFFER_SIZE)
+        {
+            error = writeAll(memFileDescriptor, batch, batchSize);
+            batchSize = 0;
+        }
+
+        memcpy(batch + batchSize, lineExpanded, expandedSize);
+        batchSize += expandedSize;
+        batch[batchSize++] = '\n';
+    }
+
+    /* like bash, a missing delimiter still runs the command */
+    if (foundDelimiter == false && error == 0)
+    {
+        clearerr(stream);
+        fprintf(stderr, "here-document delimited by end-of-file (wanted `%s')\n",
+                delimiter);
+    }
+
+    if (error == 0)
+    {
+        error = writeAll(memFileDescriptor, batch, batchSize);
+    }
+
+    free(batch);
+    free(line);
+
+    if (error != 0)
+    {
+        close(memFileDescriptor);
+        return -1;
+    }
+
+    return sealMemoryFile(memFileDescriptor);
+}
+
+/* Writes the body of a here-document or here-string, which has already had
+ * $$ expanded, into a sealed memory file whose offset is rewound to the start
+ * so it can be used as stdin.
+ */
+int createHereBody(char *body, size_t bodySize)
+{
+    int memFileDescriptor;
+
+    memFileDescriptor = openMemoryFile("here-document");
+    if (memFileDescriptor == -1)
+    {
+        return -1;
+    }
+
+    if (writeAll(memFileDescriptor, body, bodySize) == -1)
+    {
+        perror("writing here-document unsuccessful");
+        close(memFileDescriptor);
+        return -1;
+    }
+
+    return sealMemoryFile(memFileDescriptor);
+}
+
+/* Writes the word followed by a newline into a sealed memory file whose
+ * offset is rewound to the start so it can be used as stdin.
+ */
+int createHereString(char *word)
+{
+    int memFileDescriptor;
+
+    memFileDescriptor = openMemoryFile("here-string");
+    if (memFileDescriptor == -1)
+    {
+        return -1;
+    }
+
+    if (writeAll(memFileDescriptor, word, strlen(word)) == -1
+        || writeAll(memFileDescriptor, "\n", 1) == -1)
+    {
+        perror("writing here-string unsuccessful");
+        close(memFileDescriptor);
+        return -1;
+    }
+
+    return sealMemoryFile(memFileDescriptor);
+}
@@ -0,0 +1,69 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines functions for building here-documents (<<WORD) and
+ *              here-strings (<<< word) including:
+ *
+ *               reading a here-document body up to its delimiter line
+ *               writing the body into an anonymous memory file
+ *               sealing the memory file so it can't be modified
+ *
+ *              The memory file comes from memfd_create() and so nothing is
+ *              written to disk or tmpfs, and since the whole body is written
+ *              before the child is forked there is no pipe to fill up.
+ *
+ **************************************************************************/
+
+#ifndef HERE_DOC_H
+#define HERE_DOC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>      /* for isspace */
+#include <unistd.h>
+#include <fcntl.h>      /* for the file sealing F_ADD_SEALS flags */
+#include <sys/mman.h>   /* for memfd_create() */
+#include <sys/types.h>  /* includes pid_t type */
+
+/* Size of the buffer used to batch writes into the memory file */
+#define HERE_BUFFER_SIZE 65536
+
+/* Prompt printed while reading the lines of a here-document */
+#define HERE_PROMPT "> "
+
+/* Returns true if a commandline has a here-document operator, <<WORD or
+ * << WORD, so the lines after it in the input are its body. A <<< here-
+ * string has no body.
+ * input: the commandline: char *
+ */
+bool hasHereDocument(char *text);
+
+/* Reads lines from the input stream up to a line equal to the delimiter,
+ * expands $$ in each line and writes them into a sealed memory file whose
+ * offset is rewound to the start so it can be used as stdin.
+ * input: the stream the commandline came from: FILE *
+ *        the delimiter that ends the here-document: char *
+ *        the pid used in $$ expansion: pid_t
+ * output: the file descriptor of the memory file or -1 on error
+ */
+int createHereDocument(FILE *stream, char *delimiter, pid_t pid);
+
+/* Writes the body of a here-document or here-string, which has already had
+ * $$ expanded, into a sealed memory file whose offset is rewound to the start
+ * so it can be used as stdin.
+ * input: the body: char *
+ *        the number of bytes in the body: size_t
+ * output: the file descriptor of the memory file or -1 on error
+ */
+int createHereBody(char *body, size_t bodySize);
+
+/* Writes the word followed by a newline into a sealed memory file whose
+ * offset is rewound to the start so it can be used as stdin.
+ * input: the here-string word: char *
+ * output: the file descriptor of the memory file or -1 on error
+ */
+int createHereString(char *word);
+
+#endif
@@ -0,0 +1,505 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the functions for managing the background job
+ *              table including:
+ *
+ *               adding and removing background jobs
+ *               looking up a job from %n or a PID
+ *               signaling jobs through their pidfds
+ *               waiting for one or all jobs to finish
+ *               the jobs, wait and kill inbuilt commands
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 20, 26
+ *  and man pages pidfd_open(2), pidfd_send_signal(2) and poll(2)
+ *
+ **************************************************************************/
+
+#include "jobControl.h"
+#include "bashShell.h"  /* for terminationStatus and STATUS_LENGTH */
+
+/* A signal name that can be given to kill as -NAME or -SIGNAME */
+struct signalName
+{
+    char *name;
+    int number;
+};
+
+static struct signalName signalNames[] = {
+    {"HUP", SIGHUP}, {"INT", SIGINT}, {"QUIT", SIGQUIT}, {"KILL", SIGKILL},
+    {"USR1", SIGUSR1}, {"USR2", SIGUSR2}, {"TERM", SIGTERM}, {"CONT", SIGCONT},
+    {"STOP", SIGSTOP}, {"TSTP", SIGTSTP}, {NULL, 0}
+};
+
+/* Set by catchSIGINTDuringWait when ^C is pressed during a wait */
+static volatile sig_atomic_t waitInterrupted = FALSE;
+
+/* Signal catcher for SIGINT while waiting on jobs. Being caught without
+ * SA_RESTART makes poll() return so ^C ends the wait.
+ */
+static void catchSIGINTDuringWait(int theSignal)
+{
+    waitInterrupted = TRUE;
+}
+
+/* Initializes an empty job table, whose arrays are made by addJob. */
+void initializeJobTable(struct jobTable *jobs, int capacity)
+{
+    jobs->pids = NULL;
+    jobs->pidfds = NULL;
+    jobs->capacity = 0;
+    jobs->initialCapacity = capacity;
+    jobs->numJobs = 0;
+}
+
+/* Creates the arrays of the job table when the first job is added */
+static void createJobArrays(struct jobTable *jobs)
+{
+    int i;
+
+    jobs->capacity = jobs->initialCapacity;
+
+    jobs->pids = getPidReturnArray(jobs->capacity);
+    initializeBgPidArray(jobs->pids, jobs->capacity);
+
+    jobs->pidfds = (int *)malloc(jobs->capacity * sizeof(int));
+    if (jobs->pidfds == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        jobs->pidfds[i] = NO_PIDFD;
+    }
+}
+
+/* Closes any pidfds and frees the arrays of the job table. */
+void freeJobTable(struct jobTable *jobs)
+{
+    int i;
+
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        if (jobs->pidfds[i] != NO_PIDFD)
+        {
+            close(jobs->pidfds[i]);
+        }
+    }
+
+    free(jobs->pids);
+    free(jobs->pidfds);
+}
+
+/* Adds a background job to the first free element, doubling the table if
+ * it is full, and opens a pidfd for it.
+ */
+int addJob(struct jobTable *jobs, pid_t pid)
+{
+    int index;
+    int i;
+    int oldCapacity;
+
+    if (jobs->pids == NULL)
+    {
+        createJobArrays(jobs);
+    }
+    oldCapacity = jobs->capacity;
+
+    /* reuse the first element freed by a finished job */
+    index = pidArrayIndex(jobs->pids, BG_UNDEFINED, jobs->capacity);
+
+    if (index == -1)
+    {
+        index = oldCapacity;
+        jobs->capacity = increasePidReturnArray(&jobs->pids, oldCapacity);
+
+        jobs->pidfds = (int *)realloc(jobs->pidfds, jobs->capacity * sizeof(int));
+        if (jobs->pidfds == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+
+        for (i = oldCapacity; i < jobs->capacity; i++)
+        {
+            jobs->pidfds[i] = NO_PIDFD;
+        }
+    }
+
+    jobs->pids[index] = pid;
+
+    /* The job can't have been reaped yet so the pidfd refers to it. Without
+     * pidfd support the job is signaled by PID instead.
+     */
+    jobs->pidfds[index] = pidfdOpen(pid);
+
+    ++jobs->numJobs;
+
+    return index + 1;
+}
+
+/* Removes a job that has been reaped and closes its pidfd. */
+void removeJob(struct jobTable *jobs, pid_t pid)
+{
+    int index = pidArrayIndex(jobs->pids, pid, jobs->capacity);
+
+    if (index == -1)
+    {
+        return;
+    }
+
+    if (jobs->pidfds[index] != NO_PIDFD)
+    {
+        close(jobs->pidfds[index]);
+        jobs->pidfds[index] = NO_PIDFD;
+    }
+
+    resetPidArrayElement(jobs->pids, pid, jobs->capacity);
+    --jobs->numJobs;
+
+    /* let the shells of the host use the job's slot */
+    releaseJobSlot(pid);
+}
+
+/* Returns the index of the job given by %n or a PID, or -1 if it isn't a
+ * running job.
+ */
+int jobIndexFromSpec(struct jobTable *jobs, char *spec)
+{
+    char *end;  /* set by strtol to the first char after the number */
+    long number;
+
+    number = strtol((spec[0] == '%') ? spec + 1 : spec, &end, 10);
+
+    if (*end != '\0' || number <= 0)
+    {
+        return -1;
+    }
+
+    if (spec[0] == '%')
+    {
+        if (number > jobs->capacity || jobs->pids[number - 1] == BG_UNDEFINED)
+        {
+            return -1;
+        }
+        return number - 1;
+    }
+
+    return pidArrayIndex(jobs->pids, (pid_t)number, jobs->capacity);
+}
+
+/* Sends a signal to a job through its pidfd. */
+int signalJob(struct jobTable *jobs, int index, int theSignal)
+{
+    if (jobs->pidfds[index] != NO_PIDFD)
+    {
+        return pidfdSendSignal(jobs->pidfds[index], theSignal);
+    }
+
+    return kill(jobs->pids[index], theSignal);
+}
+
+/* Sends a signal to every running job. */
+void signalAllJobs(struct jobTable *jobs, int theSignal)
+{
+    int i;
+
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        /* Background job PIDs are stored in pids, and when a job returns that
+         * element is set to BG_UNDEFINED which is an arbitrary negative number.
+         */
+        if (jobs->pids[i] > BG_UNDEFINED)
+        {
+            signalJob(jobs, i, theSignal);
+        }
+    }
+}
+
+/* Blocks until the job, or any job if index is ANY_JOB, finishes then reaps
+ * it. ^C interrupts the wait.
+ */
+pid_t waitForJob(struct jobTable *jobs, int index, int *childExitMethod)
+{
+    struct pollfd *pollFds;
+    int *pollIndex;  /* the job index of each element of pollFds */
+    int numPollFds = 0;
+    int i;
+    pid_t waitPidReturn = -1;
+    bool havePidfds = true;
+    struct sigaction SIGINTaction = {0};
+    struct sigaction prevAction;
+
+    if (jobs->numJobs == 0)
+    {
+        return -1;
+    }
+
+    pollFds = (struct pollfd *)malloc(jobs->capacity * sizeof(struct pollfd));
+    pollIndex = (int *)malloc(jobs->capacity * sizeof(int));
+    if (pollFds == NULL || pollIndex == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    /* a pidfd becomes readable when its process terminates */
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        if (jobs->pids[i] != BG_UNDEFINED && (index == ANY_JOB || index == i))
+        {
+            if (jobs->pidfds[i] == NO_PIDFD)
+            {
+                havePidfds = false;
+            }
+            pollFds[numPollFds].fd = jobs->pidfds[i];
+            pollFds[numPollFds].events = POLLIN;
+            pollIndex[numPollFds] = i;
+            ++numPollFds;
+        }
+    }
+
+    /* let ^C interrupt the wait rather than be ignored */
+    waitInterrupted = FALSE;
+    SIGINTaction.sa_handler = catchSIGINTDuringWait;
+    sigaction(SIGINT, &SIGINTaction, &prevAction);
+
+    if (havePidfds == false)
+    {
+        /* without pidfds the only way to wait is by PID */
+        waitPidReturn = waitpid((index == ANY_JOB) ? -1 : jobs->pids[index], childExitMethod, 0);
+    }
+    else
+    {
+        while (waitPidReturn == -1)
+        {
+            if (poll(pollFds, numPollFds, -1) == -1)
+            {
+                /* ^C ends the wait, other signals such as ^Z don't */
+                if (errno == EINTR && waitInterrupted == FALSE)
+                {
+                    continue;
+                }
+                break;
+            }
+
+            for (i = 0; i < numPollFds; i++)
+            {
+                if (pollFds[i].revents & POLLIN)
+                {
+                    waitPidReturn = waitpid(jobs->pids[pollIndex[i]], childExitMethod, 0);
+                    break;
+                }
+            }
+        }
+    }
+
+    sigaction(SIGINT, &prevAction, NULL);
+
+    free(pollFds);
+    free(pollIndex);
+
+    return waitPidReturn;
+}
+
+/* Lists the job number and PID of every running job. */
+void jobsBuiltin(struct jobTable *jobs)
+{
+    int i;
+
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        if (jobs->pids[i] != BG_UNDEFINED)
+        {
+            printf("[%d] %d\n", i + 1, jobs->pids[i]);
+        }
+    }
+}
+
+/* Reaps the job with waitForJob, prints its exit or termination status like
+ * a finished background job and removes it from the table. Returns the exit
+ * status of the job or -1 if the wait was interrupted.
+ */
+static int waitAndReport(struct jobTable *jobs, int index, char exitStatusStr[])
+{
+    int childExitMethod;
+    int terminationSignal = 0;
+    int exitValue;
+    pid_t waitPidReturn;
+
+    waitPidReturn = waitForJob(jobs, index, &childExitMethod);
+
+    if (waitPidReturn <= 0)
+    {
+        return -1;
+    }
+
+    exitValue = terminationStatus(childExitMethod, exitStatusStr, &terminationSignal);
+    printf("background pid %d is done: %s\n", waitPidReturn, exitStatusStr);
+    removeJob(jobs, waitPidReturn);
+
+    return exitValue;
+}
+
+/* Runs "wait [-n] [%n|pid ...]". Without arguments waits for every job,
+ * with -n waits for the next job to finish, otherwise waits for the given
+ * jobs. Puts the status of the last job waited on in exitStatusStr.
+ */
+int waitBuiltin(struct jobTable *jobs, char commandLine[], char exitStatusStr[])
+{
+    char *token;
+    char *savePosition;  /* used by strtok_r */
+    int index;
+    int exitValue = 0;  /* wait with nothing to wait on succeeds */
+    bool haveSpec = false;
+
+    sprintf(exitStatusStr, "exit value %d", exitValue);
+
+    /* First, ignore the word "wait" */
+    token = strtok_r(commandLine, " \n", &savePosition);
+
+    while ((token = strtok_r(NULL, " \n", &savePosition)) != NULL)
+    {
+        if (strcmp(token, "-n") == 0)
+        {
+            exitValue = waitAndReport(jobs, ANY_JOB, exitStatusStr);
+            return (exitValue == -1) ? WAIT_INTERRUPTED : exitValue;
+        }
+
+        haveSpec = true;
+        index = jobIndexFromSpec(jobs, token);
+
+        if (index == -1)
+        {
+            printf("wait: %s: no such job\n", token);
+            exitValue = 127;
+            sprintf(exitStatusStr, "exit value %d", exitValue);
+        }
+        else if ((exitValue = waitAndReport(jobs, index, exitStatusStr)) == -1)
+        {
+            return WAIT_INTERRUPTED;
+        }
+    }
+
+    /* without job specs wait until every job has finished */
+    while (haveSpec == false && jobs->numJobs > 0)
+    {
+        if ((exitValue = waitAndReport(jobs, ANY_JOB, exitStatusStr)) == -1)
+        {
+            return WAIT_INTERRUPTED;
+        }
+    }
+
+    return exitValue;
+}
+
+/* Converts -NUMBER, -NAME or -SIGNAME to a signal number, or returns -1 if
+ * it isn't a signal.
+ */
+static int signalFromOption(char *option)
+{
+    char *end;
+    long number;
+    int i;
+
+    ++option;  /* skip the '-' */
+
+    number = strtol(option, &end, 10);
+    if (end != option && *end == '\0' && number > 0 && number < NSIG)
+    {
+        return (int)number;
+    }
+
+    if (strncmp(option, "SIG", 3) == 0)
+    {
+        option += 3;
+    }
+
+    for (i = 0; signalNames[i].name != NULL; i++)
+    {
+        if (strcmp(option, signalNames[i].name) == 0)
+        {
+            return signalNames[i].number;
+        }
+    }
+
+    return -1;
+}
+
+/* Runs "kill [-SIGNAL] %n|pid ...". Jobs are signaled through their pidfds,
+ * other PIDs with kill(). The signal defaults to SIGTERM.
+ */
+int killBuiltin(struct jobTable *jobs, char commandLine[], char exitStatusStr[])
+{
+    char *token;
+    char *savePosition;  /* used by strtok_r */
+    char *end;
+    int theSignal = SIGTERM;
+    int index;
+    long pid;
+    int killReturn;
+    int exitValue = 0;
+    bool haveTarget = false;
+
+    /* First, ignore the word "kill" */
+    token = strtok_r(commandLine, " \n", &savePosition);
+
+    while ((token = strtok_r(NULL, " \n", &savePosition)) != NULL)
+    {
+        if (token[0] == '-' && haveTarget == false)
+        {
+            theSignal = signalFromOption(token);
+            if (theSignal == -1)
+            {
+                printf("kill: %s: invalid signal\n", token);
+                sprintf(exitStatusStr, "exit value %d", 1);
+                return 1;
+            }
+            continue;
+        }
+
+        haveTarget = true;
+        index = jobIndexFromSpec(jobs, token);
+
+        /* a job is signaled through its pidfd so a reused PID is never hit */
+        if (index != -1)
+        {
+            killReturn = signalJob(jobs, index, theSignal);
+        }
+        else if (token[0] == '%')
+        {
+            printf("kill: %s: no such job\n", token);
+            exitValue = 1;
+            continue;
+        }
+        else
+        {
+            pid = strtol(token, &end, 10);
+            if (*end != '\0' || end == token)
+            {
+                printf("kill: %s: arguments must be process or job IDs\n", token);
+                exitValue = 1;
+                continue;
+            }
+            killReturn = kill((pid_t)pid, theSignal);
+        }
+
+        if (killReturn == -1)
+        {
+            printf("kill: %s: %s\n", token, strerror(errno));
+            exitValue = 1;
+        }
+    }
+
+    if (haveTarget == false)
+    {
+        printf("usage: kill [-SIGNAL] %%n|pid ...\n");
+        exitValue = 1;
+    }
+
+    sprintf(exitStatusStr, "exit value %d", exitValue);
+
+    return exitValue;
+}
@@ -0,0 +1,139 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the background job table and functions for managing
+ *              it including:
+ *
+ *               adding and removing background jobs
+ *               looking up a job from %n or a PID
+ *               signaling jobs through their pidfds
+ *               waiting for one or all jobs to finish
+ *               the jobs, wait and kill inbuilt commands
+ *
+ *              Each job holds a pidfd as well as its PID, so a job that has
+ *              already been reaped can never be confused with a new process
+ *              that reused its PID.
+ *
+ **************************************************************************/
+
+#ifndef JOB_CONTROL_H
+#define JOB_CONTROL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>          /* for waiting on several pidfds at once */
+#include <unistd.h>
+#include <sys/types.h>     /* includes pid_t type */
+#include <sys/wait.h>
+#include "pid_tDynArr.h"   /* manages and initializes dynamic arrays of pid_t type */
+#include "pidfd.h"         /* for pidfdOpen and pidfdSendSignal */
+
+/* Use to indicate a job that has no pidfd */
+#define NO_PIDFD -1
+
+/* Use to indicate that any job may be waited on */
+#define ANY_JOB -1
+
+/* The exit status of wait when ^C interrupts it, as for a job killed by SIGINT */
+#define WAIT_INTERRUPTED 130
+
+/* The background jobs. A job's number is its index + 1, so %1 is the job
+ * in element 0. Free elements of pids are BG_UNDEFINED.
+ */
+struct jobTable
+{
+    pid_t *pids;  /* the PID of each job */
+    int *pidfds;  /* the pidfd of each job or NO_PIDFD */
+    int capacity;  /* the size of the pids and pidfds arrays, 0 until the
+                    * first job is added */
+    int initialCapacity;  /* the size the arrays are made with */
+    int numJobs;  /* the number of running jobs */
+};
+
+/* Initializes an empty job table. Its arrays aren't made until the first
+ * job is added, so a shell that never runs a background job never
+ * allocates them.
+ * input: the table: struct jobTable *
+ *        the initial capacity: int
+ */
+void initializeJobTable(struct jobTable *jobs, int capacity);
+
+/* Closes any pidfds and frees the arrays of the job table.
+ * input: the table: struct jobTable *
+ */
+void freeJobTable(struct jobTable *jobs);
+
+/* Adds a background job to the first free element, doubling the table if
+ * it is full, and opens a pidfd for it.
+ * input: the table: struct jobTable *
+ *        the PID of the job: pid_t
+ * output: the job number
+ */
+int addJob(struct jobTable *jobs, pid_t pid);
+
+/* Removes a job that has been reaped, closes its pidfd and gives back its
+ * host-wide job slot if it has one.
+ * input: the table: struct jobTable *
+ *        the PID of the job: pid_t
+ */
+void removeJob(struct jobTable *jobs, pid_t pid);
+
+/* Returns the index of the job given by %n or a PID, or -1 if it isn't a
+ * running job.
+ * input: the table: struct jobTable *
+ *        the job spec: char *
+ */
+int jobIndexFromSpec(struct jobTable *jobs, char *spec);
+
+/* Sends a signal to a job through its pidfd.
+ * input: the table: struct jobTable *
+ *        the index of the job: int
+ *        the signal number: int
+ * output: 0 if successful or -1 on error
+ */
+int signalJob(struct jobTable *jobs, int index, int theSignal);
+
+/* Sends a signal to every running job.
+ * input: the table: struct jobTable *
+ *        the signal number: int
+ */
+void signalAllJobs(struct jobTable *jobs, int theSignal);
+
+/* Blocks until the job, or any job if index is ANY_JOB, finishes then reaps
+ * it. ^C interrupts the wait.
+ * input: the table: struct jobTable *
+ *        the index of the job or ANY_JOB: int
+ *        set to the status returned from waitpid: int &
+ * output: the PID of the finished job or -1 if interrupted or no jobs
+ */
+pid_t waitForJob(struct jobTable *jobs, int index, int *childExitMethod);
+
+/* Lists the job number and PID of every running job.
+ * input: the table: struct jobTable *
+ */
+void jobsBuiltin(struct jobTable *jobs);
+
+/* Runs "wait [-n] [%n|pid ...]". Without arguments waits for every job,
+ * with -n waits for the next job to finish, otherwise waits for the given
+ * jobs. Puts the status of the last job waited on in exitStatusStr.
+ * input: the table: struct jobTable *
+ *        the $$ expanded commandline: char[]
+ *        the status string of the shell: char[]
+ * output: the exit status of the last job waited on, or WAIT_INTERRUPTED
+ */
+int waitBuiltin(struct jobTable *jobs, char commandLine[], char exitStatusStr[]);
+
+/* Runs "kill [-SIGNAL] %n|pid ...". Jobs are signaled through their pidfds,
+ * other PIDs with kill(). The signal defaults to SIGTERM.
+ * input: the table: struct jobTable *
+ *        the $$ expanded commandline: char[]
+ *        the status string of the shell: char[]
+ * output: 0 if every job was signaled, otherwise 1
+ */
+int killBuiltin(struct jobTable *jobs, char commandLine[], char exitStatusStr[]);
+
+#endif
@@ -0,0 +1,741 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the dependency graph of named commands run by the
+ *              dag inbuilt command and the functions for running it
+ *              including:
+ *
+ *               reading a file of named commands and their after:
+ *               dependencies
+ *               checking every dependency exists and there are no cycles
+ *               launching each command as soon as every command it depends
+ *               on has exited successfully, up to a limit at once
+ *               skipping the commands that depend on one that failed
+ *               reporting the time of each command and the critical path
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 24 - 26
+ *  and 63
+ *
+ **************************************************************************/
+
+#include "jobDag.h"
+#include "bashShell.h"  /* for parsing and executing the commands */
+
+/* Returns the time in seconds from the monotonic clock */
+static double now(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Makes a dynamic copy of a string */
+static char *copyString(char *str)
+{
+    char *copy = getEmptyString(strlen(str) + 1);
+
+    strcpy(copy, str);
+    return copy;
+}
+
+/* Returns the index of the command with the name or -1 */
+static int findNode(struct jobDag *dag, char *name)
+{
+    int i;
+
+    for (i = 0; i < dag->numNodes; i++)
+    {
+        if (strcmp(dag->nodes[i].name, name) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* Adds an index to a dynamic array of indexes */
+static void addIndex(int **indexes, int *count, int index)
+{
+    *indexes = realloc(*indexes, (*count + 1) * sizeof(int));
+    if (*indexes == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    (*indexes)[(*count)++] = index;
+}
+
+/* Adds a command with the name, dependencies and command text to the graph */
+static struct dagNode *addNode(struct jobDag *dag, char *name, char *dependencyText,
+                               char *commandText, int lineNumber)
+{
+    struct dagNode *node;
+
+    if (dag->numNodes == dag->capacity)
+    {
+        dag->capacity = (dag->capacity == 0) ? 16 : dag->capacity * 2;
+        dag->nodes = realloc(dag->nodes, dag->capacity * sizeof(struct dagNode));
+        if (dag->nodes == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+    }
+
+    node = &dag->nodes[dag->numNodes++];
+    memset(node, 0, sizeof(struct dagNode));
+
+    snprintf(node->name, DAG_NAME_LENGTH, "%s", name);
+    node->commandText = copyString(commandText);
+    node->dependencyText = (dependencyText != NULL) ? copyString(dependencyText) : NULL;
+    node->lineNumber = lineNumber;
+    node->state = nodeWaiting;
+    node->pidfd = NO_PIDFD;
+    node->pathPrevious = -1;
+
+    return node;
+}
+
+/* Splits a line of a dag file into its name, dependencies and command.
+ * Returns 0 if successful, 1 for a blank or comment line or -1 after
+ * printing an error.
+ */
+static int parseDagLine(char *line, char *fileName, int lineNumber, char **name,
+                        char **dependencyText, char **commandText)
+{
+    char *colon;
+    char *savePosition;
+    char *word;
+
+    line[strcspn(line, "\n")] = '\0';
+    while (isspace((unsigned char)*line))
+    {
+        ++line;
+    }
+
+    if (line[0] == '\0' || line[0] == '#')
+    {
+        return 1;
+    }
+
+    colon = strchr(line, ':');
+    if (colon == NULL)
+    {
+        fprintf(stderr, "dag: %s:%d: expected NAME: command\n", fileName, lineNumber);
+        return -1;
+    }
+    *colon = '\0';
+    *commandText = colon + 1;
+    *dependencyText = NULL;
+
+    /* the part before the first ':' is the name and, if there are
+     * dependencies, the word "after"
+     */
+    *name = strtok_r(line, " \t", &savePosition);
+    word = strtok_r(NULL, " \t", &savePosition);
+
+    if (*name == NULL || strlen(*name) >= DAG_NAME_LENGTH
+        || (word != NULL && (strcmp(word, "after") != 0 || strtok_r(NULL, " \t", &savePosition) != NULL)))
+    {
+        fprintf(stderr, "dag: %s:%d: expected NAME: or NAME after: before the command\n",
+                fileName, lineNumber);
+        return -1;
+    }
+
+    if (word != NULL)
+    {
+        colon = strchr(*commandText, ':');
+        if (colon == NULL)
+        {
+            fprintf(stderr, "dag: %s:%d: expected ':' after the dependencies\n", fileName, lineNumber);
+            return -1;
+        }
+        *colon = '\0';
+        *dependencyText = *commandText;
+        *commandText = colon + 1;
+    }
+
+    while (isspace((unsigned char)**commandText))
+    {
+        ++(*commandText);
+    }
+
+    if (**commandText == '\0')
+    {
+        fprintf(stderr, "dag: %s:%d: %s has no command\n", fileName, lineNumber, *name);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Looks up the dependencies of every command by name. Returns 0 if
+ * successful or -1 after printing an error.
+ */
+static int resolveDependencies(struct jobDag *dag, char *fileName)
+{
+    struct dagNode *node;
+    char *savePosition;
+    char *name;
+    int dependency;
+    int i;
+
+    for (i = 0; i < dag->numNodes; i++)
+    {
+        node = &dag->nodes[i];
+        if (node->dependencyText == NULL)
+        {
+            continue;
+        }
+
+        for (name = strtok_r(node->dependencyText, " \t", &savePosition); name != NULL;
+             name = strtok_r(NULL, " \t", &savePosition))
+        {
+            dependency = findNode(dag, name);
+            if (dependency == -1 || dependency == i)
+            {
+                fprintf(stderr, "dag: %s:%d: %s %s %s\n", fileName, node->lineNumber, node->name,
+                        (dependency == -1) ? "depends on unknown" : "depends on itself", name);
+                return -1;
+            }
+
+            addIndex(&node->dependencies, &node->numDependencies, dependency);
+            addIndex(&dag->nodes[dependency].dependents, &dag->nodes[dependency].numDependents, i);
+        }
+
+        node->waitingOn = node->numDependencies;
+    }
+
+    return 0;
+}
+
+/* Checks there is no cycle by removing the commands that depend on nothing
+ * that is left, as in Kahn's topological sort. Returns 0 if there is no
+ * cycle or -1 after printing an error.
+ */
+static int checkForCycles(struct jobDag *dag)
+{
+    int *waitingOn = malloc((dag->numNodes + 1) * sizeof(int));
+    int *queue = malloc((dag->numNodes + 1) * sizeof(int));
+    int head = 0;
+    int tail = 0;
+    int node, dependent;
+    int i;
+
+    if (waitingOn == NULL || queue == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < dag->numNodes; i++)
+    {
+        waitingOn[i] = dag->nodes[i].numDependencies;
+        if (waitingOn[i] == 0)
+        {
+            queue[tail++] = i;
+        }
+    }
+
+    while (head < tail)
+    {
+        node = queue[head++];
+        for (i = 0; i < dag->nodes[node].numDependents; i++)
+        {
+            dependent = dag->nodes[node].dependents[i];
+            if (--waitingOn[dependent] == 0)
+            {
+                queue[tail++] = dependent;
+            }
+        }
+    }
+
+    /* any command left over is on or after a cycle */
+    for (i = 0; tail < dag->numNodes && i < dag->numNodes; i++)
+    {
+        if (waitingOn[i] > 0)
+        {
+            fprintf(stderr, "dag: dependency cycle through %s\n", dag->nodes[i].name);
+            break;
+        }
+    }
+
+    free(waitingOn);
+    free(queue);
+
+    return (tail == dag->numNodes) ? 0 : -1;
+}
+
+/* Reads a dag file, resolves the dependencies of each command and checks
+ * there are no cycles.
+ */
+int readJobDag(char *fileName, struct jobDag *dag)
+{
+    FILE *file;
+    char *line = NULL;
+    size_t lineCapacity = 0;
+    char *name, *dependencyText, *commandText;
+    int lineNumber = 0;
+    int result = 0;
+    int parsed;
+
+    dag->nodes = NULL;
+    dag->numNodes = 0;
+    dag->capacity = 0;
+
+    file = fopen(fileName, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "dag: cannot open %s: %s\n", fileName, strerror(errno));
+        return -1;
+    }
+
+    while (result == 0 && getline(&line, &lineCapacity, file) >= 0)
+    {
+        ++lineNumber;
+
+        parsed = parseDagLine(line, fileName, lineNumber, &name, &dependencyText, &commandText);
+        if (parsed == -1)
+        {
+            result = -1;
+        }
+        else if (parsed == 0 && findNode(dag, name) != -1)
+        {
+            fprintf(stderr, "dag: %s:%d: %s is defined twice\n", fileName, lineNumber, name);
+            result = -1;
+        }
+        else if (parsed == 0)
+        {
+            addNode(dag, name, dependencyText, commandText, lineNumber);
+        }
+    }
+
+    free(line);
+    fclose(file);
+
+    if (result == 0 && (resolveDependencies(dag, fileName) == -1 || checkForCycles(dag) == -1))
+    {
+        result = -1;
+    }
+
+    return result;
+}
+
+/* Frees the commands of the graph. */
+void freeJobDag(struct jobDag *dag)
+{
+    int i;
+
+    for (i = 0; i < dag->numNodes; i++)
+    {
+        free(dag->nodes[i].commandText);
+        free(dag->nodes[i].dependencyText);
+        free(dag->nodes[i].dependencies);
+        free(dag->nodes[i].dependents);
+    }
+
+    free(dag->nodes);
+    dag->nodes = NULL;
+    dag->numNodes = 0;
+    dag->capacity = 0;
+}
+
+/* Expands, parses and forks a command of the graph. Returns 0 if it was
+ * launched or -1 after printing an error if it couldn't be.
+ */
+static int launchNode(struct shellState *shell, struct dagNode *node)
+{
+    char bufferExpanded[MAX_COMMAND_LINE_EXPANDED];
+    struct command command;
+    pid_t spawnPid;
+    int result = 0;
+
+    initializeCommand(&command, NO_TIMEOUT);
+
+    if (expandString(node->commandText, shell->parentPID, bufferExpanded) == commandLineTooLong)
+    {
+        fprintf(stderr, "dag: the command of %s has a maximum length of %d\n", node->name,
+                MAX_COMMAND_LINE);
+        result = -1;
+    }
+    else if (parseArguments(bufferExpanded, &command) == -1)
+    {
+        result = -1;
+    }
+    else if (command.numArgs == 0 || command.hereType != noHere)
+    {
+        fprintf(stderr, "dag: %s needs a command without a here-document\n", node->name);
+        result = -1;
+    }
+    else if (addSessionRedirections(shell, &command) == -1)
+    {
+        result = -1;
+    }
+    /* The files are opened before the fork, as launchCommand does, so an
+     * fd sent to several files, or with >z, can be given a pipe that the
+     * shell copies into them
+     */
+    else if (openRedirections(&command.redirections) == -1
+             || openFanOuts(&command.redirections) == -1)
+    {
+        closeRedirections(&command.redirections);
+        result = -1;
+    }
+
+    if (result == 0)
+    {
+        /* Every command of the graph runs at once with the others, so a
+         * trailing & does nothing
+         */
+        command.inBackground = false;
+
+        /* the child would write out anything left in the buffer again */
+        fflush(stdout);
+
+        spawnPid = fork();
+        if (spawnPid == -1)
+        {
+            perror("Error creating fork\n");
+            result = -1;
+        }
+        else if (spawnPid == 0)
+        {
+            execCommand(&command);
+            exit(1);
+        }
+        else
+        {
+            node->pid = spawnPid;
+            node->pidfd = pidfdOpen(spawnPid);
+            node->state = nodeRunning;
+
+            /* the copies are joined when the command is reaped, so the
+             * files are complete before the commands after it start
+             */
+            node->fanOuts = startFanOuts(&command.redirections, false);
+        }
+
+        closeRedirections(&command.redirections);
+    }
+
+    freeCommand(&command);
+    return result;
+}
+
+/* Marks every command that depends on a failed command, directly or not,
+ * as skipped. Returns the number skipped.
+ */
+static int skipDependents(struct jobDag *dag, int failed)
+{
+    struct dagNode *node = &dag->nodes[failed];
+    struct dagNode *dependent;
+    int numSkipped = 0;
+    int i;
+
+    for (i = 0; i < node->numDependents; i++)
+    {
+        dependent = &dag->nodes[node->dependents[i]];
+        if (dependent->state == nodeWaiting)
+        {
+            dependent->state = nodeSkipped;
+            printf("dag: %s skipped since %s failed\n", dependent->name, node->name);
+            numSkipped += 1 + skipDependents(dag, node->dependents[i]);
+        }
+    }
+
+    return numSkipped;
+}
+
+/* Records a command that finished, prints its time and status and makes
+ * ready the commands waiting only on it. Returns the number of commands
+ * skipped because it failed.
+ */
+static int finishNode(struct jobDag *dag, int index, int exitStatus, char exitStatusStr[],
+                      double elapsed, int *readyQueue, int *readyTail)
+{
+    struct dagNode *node = &dag->nodes[index];
+    struct dagNode *dependent;
+    int i;
+
+    node->duration = elapsed - node->start;
+    node->state = (exitStatus == 0) ? nodeSucceeded : nodeFailed;
+
+    /* The longest chain ending here is the longest chain ending at one of
+     * its dependencies, which have all finished, plus its own time
+     */
+    node->pathTime = node->duration;
+    for (i = 0; i < node->numDependencies; i++)
+    {
+        if (dag->nodes[node->dependencies[i]].pathTime + node->duration > node->pathTime)
+        {
+            node->pathTime = dag->nodes[node->dependencies[i]].pathTime + node->duration;
+            node->pathPrevious = node->dependencies[i];
+        }
+    }
+
+    printf("dag: %s started at %.3fs, took %.3fs: %s\n", node->name, node->start,
+           node->duration, exitStatusStr);
+
+    if (node->state == nodeFailed)
+    {
+        return skipDependents(dag, index);
+    }
+
+    for (i = 0; i < node->numDependents; i++)
+    {
+        dependent = &dag->nodes[node->dependents[i]];
+        if (--dependent->waitingOn == 0 && dependent->state == nodeWaiting)
+        {
+            dependent->state = nodeReady;
+            readyQueue[(*readyTail)++] = node->dependents[i];
+        }
+    }
+
+    return 0;
+}
+
+/* Prints the longest chain of commands that ran, which is the least time
+ * the graph could take with no limit on how many run at once.
+ */
+static void printCriticalPath(struct jobDag *dag)
+{
+    int last = -1;
+    int *chain;
+    int length = 0;
+    int i;
+
+    for (i = 0; i < dag->numNodes; i++)
+    {
+        if ((dag->nodes[i].state == nodeSucceeded || dag->nodes[i].state == nodeFailed)
+            && (last == -1 || dag->nodes[i].pathTime > dag->nodes[last].pathTime))
+        {
+            last = i;
+        }
+    }
+
+    if (last == -1)
+    {
+        return;
+    }
+
+    chain = malloc(dag->numNodes * sizeof(int));
+    if (chain == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = last; i != -1; i = dag->nodes[i].pathPrevious)
+    {
+        chain[length++] = i;
+    }
+
+    printf("dag: critical path %.3fs:", dag->nodes[last].pathTime);
+    for (i = length - 1; i >= 0; i--)
+    {
+        printf(" %s%s", dag->nodes[chain[i]].name, (i > 0) ? " ->" : "\n");
+    }
+
+    free(chain);
+}
+
+/* Runs the commands of the graph, each as soon as the commands it depends
+ * on have succeeded and with at most maxRunning at once.
+ */
+int runJobDag(struct shellState *shell, struct jobDag *dag, int maxRunning)
+{
+    struct pollfd *pollFds;
+    int *pollIndex;  /* the command of each pollfd */
+    int *readyQueue;
+    int readyHead = 0;
+    int readyTail = 0;
+    int numRunning = 0;
+    int numFinished = 0;  /* succeeded or failed */
+    int numFailed = 0;
+    int numSkipped = 0;
+    int numPollFds;
+    bool havePidfds;
+    int childExitMethod;
+    int terminationSignal = 0;
+    int exitStatus;
+    char exitStatusStr[STATUS_LENGTH];
+    double startTime = now();
+    struct dagNode *node;
+    int i;
+
+    pollFds = malloc((dag->numNodes + 1) * sizeof(struct pollfd));
+    pollIndex = malloc((dag->numNodes + 1) * sizeof(int));
+    readyQueue = malloc((dag->numNodes + 1) * sizeof(int));
+    if (pollFds == NULL || pollIndex == NULL || readyQueue == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    /* the commands that depend on nothing are ready in file order */
+    for (i = 0; i < dag->numNodes; i++)
+    {
+        if (dag->nodes[i].numDependencies == 0)
+        {
+            dag->nodes[i].state = nodeReady;
+            readyQueue[readyTail++] = i;
+        }
+    }
+
+    while (numFinished + numSkipped < dag->numNodes)
+    {
+        /* Launch ready commands while there is room */
+        while (numRunning < maxRunning && readyHead < readyTail)
+        {
+            i = readyQueue[readyHead++];
+            dag->nodes[i].start = now() - startTime;
+
+            if (launchNode(shell, &dag->nodes[i]) == 0)
+            {
+                ++numRunning;
+            }
+            else
+            {
+                sprintf(exitStatusStr, "exit value %d", 1);
+                ++numFailed;
+                ++numFinished;
+                numSkipped += finishNode(dag, i, 1, exitStatusStr, now() - startTime,
+                                         readyQueue, &readyTail);
+            }
+        }
+
+        if (numRunning == 0)
+        {
+            /* nothing is running or ready, so the rest were skipped */
+            break;
+        }
+
+        /* A pidfd becomes readable when its command exits. Without pidfds
+         * the running commands are checked every DAG_POLL_FALLBACK ms.
+         */
+        numPollFds = 0;
+        havePidfds = true;
+        for (i = 0; i < dag->numNodes; i++)
+        {
+            if (dag->nodes[i].state == nodeRunning)
+            {
+                if (dag->nodes[i].pidfd == NO_PIDFD)
+                {
+                    havePidfds = false;
+                    continue;
+                }
+                pollFds[numPollFds].fd = dag->nodes[i].pidfd;
+                pollFds[numPollFds].events = POLLIN;
+                pollFds[numPollFds].revents = 0;
+                pollIndex[numPollFds] = i;
+                ++numPollFds;
+            }
+        }
+
+        if (poll(pollFds, numPollFds, havePidfds ? -1 : DAG_POLL_FALLBACK) == -1 && errno != EINTR)
+        {
+            perror("poll() unsuccessful");
+        }
+
+        /* Reap every command that has exited */
+        for (i = 0; i < dag->numNodes; i++)
+        {
+            node = &dag->nodes[i];
+            if (node->state != nodeRunning || waitpid(node->pid, &childExitMethod, WNOHANG) <= 0)
+            {
+                continue;
+            }
+
+            if (node->pidfd != NO_PIDFD)
+            {
+                close(node->pidfd);
+                node->pidfd = NO_PIDFD;
+            }
+            joinFanOuts(node->fanOuts);
+            node->fanOuts = NULL;
+
+            exitStatus = terminationStatus(childExitMethod, exitStatusStr, &terminationSignal);
+            --numRunning;
+            ++numFinished;
+            if (exitStatus != 0)
+            {
+                ++numFailed;
+            }
+            numSkipped += finishNode(dag, i, exitStatus, exitStatusStr, now() - startTime,
+                                     readyQueue, &readyTail);
+        }
+    }
+
+    printf("dag: %d of %d succeeded, %d failed, %d skipped in %.3fs\n",
+           dag->numNodes - numFailed - numSkipped, dag->numNodes, numFailed, numSkipped,
+           now() - startTime);
+    printCriticalPath(dag);
+
+    free(pollFds);
+    free(pollIndex);
+    free(readyQueue);
+
+    return (numFailed == 0 && numSkipped == 0) ? 0 : 1;
+}
+
+/* Runs "dag [-j N] FILE". */
+int dagBuiltin(struct shellState *shell, char commandLine[])
+{
+    struct jobDag dag;
+    char *savePosition;
+    char *token;
+    char *fileName = NULL;
+    char *end;
+    long maxRunning = sysconf(_SC_NPROCESSORS_ONLN);
+    int exitStatus;
+
+    /* First, ignore the word "dag" */
+    strtok_r(commandLine, " \t\n", &savePosition);
+
+    while ((token = strtok_r(NULL, " \t\n", &savePosition)) != NULL)
+    {
+        if (strcmp(token, "-j") == 0 && fileName == NULL)
+        {
+            token = strtok_r(NULL, " \t\n", &savePosition);
+            if (token == NULL || (maxRunning = strtol(token, &end, 10)) <= 0 || *end != '\0')
+            {
+                fileName = NULL;
+                break;
+            }
+        }
+        else if (fileName == NULL)
+        {
+            fileName = token;
+        }
+        else
+        {
+            fileName = NULL;
+            break;
+        }
+    }
+
+    if (fileName == NULL)
+    {
+        printf("usage: dag [-j N] FILE\n");
+        return DAG_USAGE_ERROR;
+    }
+
+    if (maxRunning <= 0)
+    {
+        maxRunning = 1;
+    }
+
+    if (readJobDag(fileName, &dag) == -1)
+    {
+        freeJobDag(&dag);
+        return DAG_USAGE_ERROR;
+    }
+
+    exitStatus = runJobDag(shell, &dag, maxRunning);
+    freeJobDag(&dag);
+
+    return exitStatus;
+}
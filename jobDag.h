@@ -0,0 +1,133 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the dependency graph of named commands run by the
+ *              dag inbuilt command and the functions for running it
+ *              including:
+ *
+ *               reading a file of named commands and their after:
+ *               dependencies
+ *               checking every dependency exists and there are no cycles
+ *               launching each command as soon as every command it depends
+ *               on has exited successfully, up to a limit at once
+ *               skipping the commands that depend on one that failed
+ *               reporting the time of each command and the critical path
+ *
+ *              Each line of a dag file is one of:
+ *
+ *               NAME: command [args] [redirections]
+ *               NAME after: DEPENDENCY [DEPENDENCY ...]: command ...
+ *
+ *              Blank lines and lines starting with # are ignored and $$ is
+ *              expanded in the commands.
+ *
+ **************************************************************************/
+
+#ifndef JOB_DAG_H
+#define JOB_DAG_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <poll.h>        /* for waiting on the pidfds of running commands */
+#include <time.h>        /* for timing the commands */
+#include <unistd.h>
+#include <sys/types.h>   /* includes pid_t type */
+#include <sys/wait.h>
+
+/* Maximum length of the name of a command in a dag file including '\0' */
+#define DAG_NAME_LENGTH 64
+
+/* The poll interval in milliseconds when a command has no pidfd */
+#define DAG_POLL_FALLBACK 10
+
+/* The exit status of dag when its file isn't valid, as in bash */
+#define DAG_USAGE_ERROR 2
+
+/* The state of a command of the graph:
+ * nodeWaiting    a command it depends on hasn't finished
+ * nodeReady      every command it depends on succeeded
+ * nodeRunning    launched and not yet reaped
+ * nodeSucceeded  exited with 0
+ * nodeFailed     exited with anything else or couldn't be launched
+ * nodeSkipped    never run since a command it depends on failed
+ */
+enum dagNodeState{ nodeWaiting, nodeReady, nodeRunning, nodeSucceeded, nodeFailed,
+                   nodeSkipped};
+
+/* A named command of the graph */
+struct dagNode
+{
+    char name[DAG_NAME_LENGTH];
+    char *commandText;  /* dynamic string of the command */
+    char *dependencyText;  /* dynamic string of the names after after:, or NULL */
+    int lineNumber;
+
+    /* the indexes of the commands it depends on and that depend on it */
+    int *dependencies;
+    int numDependencies;
+    int *dependents;
+    int numDependents;
+
+    int waitingOn;  /* the number of dependencies that haven't succeeded */
+    enum dagNodeState state;
+
+    pid_t pid;
+    int pidfd;  /* NO_PIDFD if it couldn't be opened */
+    struct fanOut *fanOuts;  /* the copies of output sent to several files */
+    double start;  /* seconds from the start of the run */
+    double duration;
+
+    /* the length of the longest chain of commands that ends with this one
+     * and the command before it on that chain, or -1
+     */
+    double pathTime;
+    int pathPrevious;
+};
+
+struct fanOut;
+
+/* The commands of a dag file */
+struct jobDag
+{
+    struct dagNode *nodes;
+    int numNodes;
+    int capacity;
+};
+
+struct shellState;
+
+/* Reads a dag file, resolves the dependencies of each command and checks
+ * there are no cycles.
+ * input: the name of the file: char *
+ *        an empty graph to fill in: struct jobDag *
+ * output: 0 if successful or -1 after printing an error
+ */
+int readJobDag(char *fileName, struct jobDag *dag);
+
+/* Frees the commands of the graph.
+ * input: the graph: struct jobDag *
+ */
+void freeJobDag(struct jobDag *dag);
+
+/* Runs the commands of the graph, each as soon as the commands it depends
+ * on have succeeded and with at most maxRunning at once, then prints the
+ * critical path.
+ * input: the shell, for $$ and the stdio of its commands: struct shellState *
+ *        the graph: struct jobDag *
+ *        the most commands to run at once: int
+ * output: 0 if every command succeeded, otherwise 1
+ */
+int runJobDag(struct shellState *shell, struct jobDag *dag, int maxRunning);
+
+/* Runs "dag [-j N] FILE". N defaults to the number of online CPUs.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ * output: the exit status of the dag command
+ */
+int dagBuiltin(struct shellState *shell, char commandLine[]);
+
+#endif
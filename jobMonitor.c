@@ -0,0 +1,445 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the live monitor of the background jobs including:
+ *
+ *               sampling the state, CPU time and start time of each job
+ *               from /proc/PID/stat and its memory from /proc/PID/statm
+ *               keeping both files of each job open and reading them with
+ *               pread, so a sample costs two system calls a job
+ *               the jobs -l inbuilt command, which prints one sample
+ *               the jtop inbuilt command, which refreshes the sample at an
+ *               interval until ^C or every job has finished
+ *
+ *  Reference: man page proc(5) and The Linux Programming Interface by
+ *  Kerrisk chapters 12 and 36
+ *
+ **************************************************************************/
+
+#include "jobMonitor.h"
+#include "bashShell.h"  /* for the shell state and reapBackgroundJobs */
+
+/* Set by catchSIGINTDuringMonitor when ^C is pressed during jtop */
+static volatile sig_atomic_t monitorInterrupted = FALSE;
+
+/* Signal catcher for SIGINT while jtop sleeps. Being caught without
+ * SA_RESTART makes clock_nanosleep return so ^C ends jtop.
+ */
+static void catchSIGINTDuringMonitor(int theSignal)
+{
+    monitorInterrupted = TRUE;
+}
+
+/* Returns the seconds since boot, which is the clock the start times of
+ * processes in /proc are measured on
+ */
+static double bootTime(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_BOOTTIME, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+/* Closes the files of an entry, as when its job has finished */
+static void closeEntry(struct monitorEntry *entry)
+{
+    if (entry->statFd != -1)
+    {
+        close(entry->statFd);
+    }
+    if (entry->statmFd != -1)
+    {
+        close(entry->statmFd);
+    }
+
+    entry->pid = BG_UNDEFINED;
+    entry->statFd = -1;
+    entry->statmFd = -1;
+    entry->lastTicks = 0;
+    entry->lastTime = 0;
+}
+
+/* Initializes a monitor with nothing open. */
+void initializeJobMonitor(struct jobMonitor *monitor)
+{
+    monitor->entries = NULL;
+    monitor->capacity = 0;
+    monitor->frame = NULL;
+    monitor->frameCapacity = 0;
+}
+
+/* Closes the files the monitor holds open and frees it. */
+void freeJobMonitor(struct jobMonitor *monitor)
+{
+    int i;
+
+    for (i = 0; i < monitor->capacity; i++)
+    {
+        closeEntry(&monitor->entries[i]);
+    }
+
+    free(monitor->entries);
+    free(monitor->frame);
+    initializeJobMonitor(monitor);
+}
+
+/* Grows the entries to the capacity of the job table, which only grows */
+static void growEntries(struct jobMonitor *monitor, int capacity)
+{
+    struct monitorEntry *entries;
+    int i;
+
+    if (capacity <= monitor->capacity)
+    {
+        return;
+    }
+
+    entries = realloc(monitor->entries, capacity * sizeof(struct monitorEntry));
+    if (entries == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = monitor->capacity; i < capacity; i++)
+    {
+        entries[i].statFd = -1;
+        entries[i].statmFd = -1;
+        closeEntry(&entries[i]);
+    }
+
+    monitor->entries = entries;
+    monitor->capacity = capacity;
+}
+
+/* Makes room in the frame for another line after the length used */
+static void reserveLine(struct jobMonitor *monitor, size_t length)
+{
+    size_t capacity = (monitor->frameCapacity > 0) ? monitor->frameCapacity : 4096;
+    char *frame;
+
+    while (length + MONITOR_LINE_MAX > capacity)
+    {
+        capacity *= 2;
+    }
+
+    if (capacity != monitor->frameCapacity)
+    {
+        frame = realloc(monitor->frame, capacity);
+        if (frame == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+        monitor->frame = frame;
+        monitor->frameCapacity = capacity;
+    }
+}
+
+/* Reads a /proc file of the process from its start into the buffer,
+ * opening it the first time. The fd is kept for the next sample unless it
+ * is past the limit given, so thousands of jobs can't use up the fds the
+ * shell needs to run commands. Returns the length read or -1.
+ */
+static ssize_t readProcFile(int *fd, pid_t pid, char *name, char buffer[], int maxCachedFd)
+{
+    char path[64];
+    ssize_t length;
+    int newFd;
+
+    if (*fd == -1)
+    {
+        snprintf(path, sizeof(path), "/proc/%d/%s", (int)pid, name);
+        newFd = open(path, O_RDONLY | O_CLOEXEC);
+        if (newFd == -1)
+        {
+            return -1;
+        }
+
+        if (newFd >= maxCachedFd)
+        {
+            length = pread(newFd, buffer, PROC_BUFFER_SIZE - 1, 0);
+            close(newFd);
+            if (length >= 0)
+            {
+                buffer[length] = '\0';
+            }
+            return length;
+        }
+
+        *fd = newFd;
+    }
+
+    /* reading from offset 0 gives a fresh copy of the file each time */
+    length = pread(*fd, buffer, PROC_BUFFER_SIZE - 1, 0);
+    if (length >= 0)
+    {
+        buffer[length] = '\0';
+    }
+
+    return length;
+}
+
+/* Formats seconds as ps does: MM:SS, HH:MM:SS or D-HH:MM:SS */
+static void formatElapsed(double seconds, char elapsed[], size_t size)
+{
+    long total = (seconds > 0) ? (long)seconds : 0;
+    long days = total / 86400;
+    long hours = (total / 3600) % 24;
+    long minutes = (total / 60) % 60;
+
+    if (days > 0)
+    {
+        snprintf(elapsed, size, "%ld-%02ld:%02ld:%02ld", days, hours, minutes, total % 60);
+    }
+    else if (hours > 0)
+    {
+        snprintf(elapsed, size, "%02ld:%02ld:%02ld", hours, minutes, total % 60);
+    }
+    else
+    {
+        snprintf(elapsed, size, "%02ld:%02ld", minutes, total % 60);
+    }
+}
+
+/* Samples one job into a line of the frame and returns the new length */
+static size_t sampleJob(struct jobMonitor *monitor, struct monitorEntry *entry, int jobNumber,
+                        double now, int maxCachedFd, size_t length)
+{
+    static long ticksPerSecond = 0;
+    static long pageKb = 0;
+    char buffer[PROC_BUFFER_SIZE];
+    char elapsed[32];
+    char *fields;
+    char state = '?';
+    unsigned long userTicks = 0;
+    unsigned long systemTicks = 0;
+    unsigned long long startTicks = 0;
+    unsigned long long ticks;
+    unsigned long pages = 0;
+    unsigned long residentPages = 0;
+    unsigned long sharedPages = 0;
+    double cpu = 0;
+    double start;
+
+    if (ticksPerSecond == 0)
+    {
+        ticksPerSecond = sysconf(_SC_CLK_TCK);
+        pageKb = sysconf(_SC_PAGESIZE) / 1024;
+    }
+
+    /* The command name in stat is in parentheses and may hold spaces, so
+     * the fields are read from after the last ')': state is field 3,
+     * utime and stime 14 and 15 and starttime 22.
+     */
+    if (readProcFile(&entry->statFd, entry->pid, "stat", buffer, maxCachedFd) <= 0
+        || (fields = strrchr(buffer, ')')) == NULL
+        || sscanf(fields + 2, "%c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu "
+                  "%*d %*d %*d %*d %*d %*d %llu", &state, &userTicks, &systemTicks,
+                  &startTicks) != 4)
+    {
+        length += snprintf(monitor->frame + length, MONITOR_LINE_MAX, "[%d]\t%7d ?\n",
+                           jobNumber, (int)entry->pid);
+        return length;
+    }
+
+    /* statm holds the size, resident and shared memory in pages */
+    if (readProcFile(&entry->statmFd, entry->pid, "statm", buffer, maxCachedFd) > 0)
+    {
+        sscanf(buffer, "%lu %lu %lu", &pages, &residentPages, &sharedPages);
+    }
+
+    ticks = (unsigned long long)userTicks + systemTicks;
+    start = (double)startTicks / ticksPerSecond;
+
+    /* The CPU used since the last sample, or since the job started */
+    if (entry->lastTime > 0 && now > entry->lastTime)
+    {
+        cpu = 100.0 * (ticks - entry->lastTicks) / ticksPerSecond / (now - entry->lastTime);
+    }
+    else if (now > start)
+    {
+        cpu = 100.0 * ticks / ticksPerSecond / (now - start);
+    }
+
+    entry->lastTicks = ticks;
+    entry->lastTime = now;
+
+    formatElapsed(now - start, elapsed, sizeof(elapsed));
+
+    length += snprintf(monitor->frame + length, MONITOR_LINE_MAX,
+                       "[%d]\t%7d %c %6.1f %10lu %10lu %11s\n", jobNumber, (int)entry->pid,
+                       state, cpu, residentPages * pageKb, sharedPages * pageKb, elapsed);
+
+    return length;
+}
+
+/* Samples every job in the table and writes the frame at once */
+static void sampleJobs(struct jobMonitor *monitor, struct jobTable *jobs)
+{
+    struct monitorEntry *entry;
+    struct rlimit fdLimit;
+    size_t length = 0;
+    double now = bootTime();
+    int maxCachedFd = INT_MAX;
+    int i;
+
+    /* Half the fds the shell may open can be kept for /proc files */
+    if (getrlimit(RLIMIT_NOFILE, &fdLimit) == 0 && fdLimit.rlim_cur != RLIM_INFINITY
+        && fdLimit.rlim_cur / 2 < INT_MAX)
+    {
+        maxCachedFd = fdLimit.rlim_cur / 2;
+    }
+
+    growEntries(monitor, jobs->capacity);
+
+    reserveLine(monitor, length);
+    length += snprintf(monitor->frame + length, MONITOR_LINE_MAX, "JOB\t    PID S   CPU%%"
+                       "     RSS kB     SHR kB     ELAPSED\n");
+
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        entry = &monitor->entries[i];
+
+        /* the files of a job that has finished are closed, and a new job
+         * in its element gets files of its own
+         */
+        if (entry->pid != jobs->pids[i])
+        {
+            closeEntry(entry);
+            entry->pid = jobs->pids[i];
+        }
+
+        if (entry->pid == BG_UNDEFINED)
+        {
+            continue;
+        }
+
+        reserveLine(monitor, length);
+        length = sampleJob(monitor, entry, i + 1, now, maxCachedFd, length);
+    }
+
+    fwrite(monitor->frame, 1, length, stdout);
+    fflush(stdout);
+}
+
+/* Refreshes the sample of the jobs every interval seconds, count times or
+ * until ^C or every job has finished. A count of 0 has no limit.
+ */
+static void refreshJobs(struct shellState *shell, double interval, long count)
+{
+    struct sigaction SIGINTaction = {0};
+    struct sigaction prevAction;
+    struct timespec deadline;
+    long numSamples = 0;
+
+    /* let ^C end jtop rather than be ignored */
+    monitorInterrupted = FALSE;
+    SIGINTaction.sa_handler = catchSIGINTDuringMonitor;
+    sigaction(SIGINT, &SIGINTaction, &prevAction);
+
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+
+    while (monitorInterrupted == FALSE && (count == 0 || numSamples < count))
+    {
+        /* jobs that finished since the last sample are reported first */
+        reapBackgroundJobs(shell);
+        if (shell->jobs.numJobs == 0)
+        {
+            break;
+        }
+
+        if (numSamples > 0)
+        {
+            printf("\n");
+        }
+        sampleJobs(&shell->monitor, &shell->jobs);
+        ++numSamples;
+
+        if (count != 0 && numSamples == count)
+        {
+            break;
+        }
+
+        /* Sleeping until an absolute time keeps the interval steady
+         * however long sampling took and is simply restarted after a
+         * signal other than ^C
+         */
+        deadline.tv_sec += (time_t)interval;
+        deadline.tv_nsec += (long)((interval - (time_t)interval) * 1e9);
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_nsec -= 1000000000L;
+            ++deadline.tv_sec;
+        }
+
+        while (monitorInterrupted == FALSE
+               && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+        {
+            continue;
+        }
+    }
+
+    sigaction(SIGINT, &prevAction, NULL);
+}
+
+/* Runs "jobs [-l]" or "jtop [-n COUNT] [INTERVAL]". */
+int monitorBuiltin(struct shellState *shell, char commandText[])
+{
+    char commandCopy[MAX_COMMAND_LINE_EXPANDED];  /* strtok_r splits up the command */
+    char *savePosition;
+    char *token;
+    char *end;
+    bool isJobs;
+    bool longFormat = false;
+    double interval = MONITOR_DEFAULT_INTERVAL;
+    long count = 0;
+
+    strcpy(commandCopy, commandText);
+    token = strtok_r(commandCopy, " \t\n", &savePosition);
+    isJobs = (strcmp(token, "jobs") == 0);
+
+    while ((token = strtok_r(NULL, " \t\n", &savePosition)) != NULL)
+    {
+        if (isJobs == true && strcmp(token, "-l") == 0)
+        {
+            longFormat = true;
+        }
+        else if (isJobs == false && strcmp(token, "-n") == 0
+                 && (token = strtok_r(NULL, " \t\n", &savePosition)) != NULL
+                 && (count = strtol(token, &end, 10)) > 0 && *end == '\0')
+        {
+            continue;
+        }
+        else if (isJobs == false && (interval = strtod(token, &end)) >= MONITOR_MIN_INTERVAL
+                 && *end == '\0')
+        {
+            continue;
+        }
+        else
+        {
+            printf("usage: jobs [-l] | jtop [-n COUNT] [INTERVAL]\n");
+            fflush(stdout);
+            return MONITOR_USAGE_ERROR;
+        }
+    }
+
+    if (isJobs == true && longFormat == false)
+    {
+        jobsBuiltin(&shell->jobs);
+    }
+    else if (isJobs == true)
+    {
+        if (shell->jobs.numJobs > 0)
+        {
+            sampleJobs(&shell->monitor, &shell->jobs);
+        }
+    }
+    else
+    {
+        refreshJobs(shell, interval, count);
+    }
+
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the live monitor of the background jobs including:
+ *
+ *               sampling the state, CPU time and start time of each job
+ *               from /proc/PID/stat and its memory from /proc/PID/statm
+ *               keeping both files of each job open and reading them with
+ *               pread, so a sample costs two system calls a job
+ *               the jobs -l inbuilt command, which prints one sample
+ *               the jtop inbuilt command, which refreshes the sample at an
+ *               interval until ^C or every job has finished
+ *
+ *              Each sample is built in a buffer and written at once, so
+ *              its cost grows only with the reads of each job.
+ *
+ *              CPU% is the share of one CPU the job used since the last
+ *              sample, or since it started for the first one. A /proc file
+ *              of a process that has been reaped reads as ESRCH rather than
+ *              as the file of a process that reused its PID.
+ *
+ *  Reference: man page proc(5) for /proc/PID/stat and /proc/PID/statm
+ *
+ **************************************************************************/
+
+#ifndef JOB_MONITOR_H
+#define JOB_MONITOR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/resource.h>  /* for the limit on open fds */
+#include "jobControl.h"  /* for the job table being sampled */
+
+/* The seconds between refreshes of jtop when none is given */
+#define MONITOR_DEFAULT_INTERVAL 1.0
+
+/* The shortest interval jtop refreshes at */
+#define MONITOR_MIN_INTERVAL 0.01
+
+/* The size of the buffer each /proc file is read into. A stat line is at
+ * most about 350 bytes even with a 64 byte command name.
+ */
+#define PROC_BUFFER_SIZE 512
+
+/* The most bytes one line of a sample takes */
+#define MONITOR_LINE_MAX 128
+
+/* The exit status of jobs -l or jtop given options they don't have */
+#define MONITOR_USAGE_ERROR 2
+
+struct shellState;
+
+/* The cached /proc files and the last sample of the job in one element of
+ * the job table
+ */
+struct monitorEntry
+{
+    pid_t pid;  /* the job the files are open for, or BG_UNDEFINED */
+    int statFd;  /* /proc/PID/stat, or -1 if it isn't open */
+    int statmFd;  /* /proc/PID/statm, or -1 if it isn't open */
+    unsigned long long lastTicks;  /* user + system CPU time at the last sample */
+    double lastTime;  /* the boot time of the last sample, 0 before the first */
+};
+
+/* The monitor of a shell's jobs, whose entries parallel the job table */
+struct jobMonitor
+{
+    struct monitorEntry *entries;  /* NULL until the first sample */
+    int capacity;
+
+    /* The text of a sample, which is written with one call */
+    char *frame;
+    size_t frameCapacity;
+};
+
+/* Initializes a monitor with nothing open.
+ * input: the monitor: struct jobMonitor *
+ */
+void initializeJobMonitor(struct jobMonitor *monitor);
+
+/* Closes the files the monitor holds open and frees it.
+ * input: the monitor: struct jobMonitor *
+ */
+void freeJobMonitor(struct jobMonitor *monitor);
+
+/* Runs "jobs [-l]" or "jtop [-n COUNT] [INTERVAL]". jobs lists the job
+ * number and PID of each job, and with -l samples them once. jtop samples
+ * them every INTERVAL seconds, COUNT times or until ^C or every job has
+ * finished, reporting jobs that finish between samples.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ * output: the exit status of the command
+ */
+int monitorBuiltin(struct shellState *shell, char commandText[]);
+
+#endif
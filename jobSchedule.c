@@ -0,0 +1,956 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the scheduler of periodic and one-off jobs
+ *              including:
+ *
+ *               the every and at inbuilt commands, which schedule a
+ *               command to run every INTERVAL or at a TIME
+ *               a hierarchical timer wheel of the scheduled entries
+ *               one timerfd, armed for the next entry that is due, that
+ *               the shell waits on along with its input
+ *               launching each run of a command through launchCommand as
+ *               a background job
+ *               skipping a run while the last run of the command is
+ *               still going, or with -q queueing one run until it ends
+ *
+ *  Reference: Varghese and Lauck, "Hashed and Hierarchical Timing Wheels"
+ *  (1987), man pages timerfd_create(2) and poll(2) and The Linux
+ *  Programming Interface by Kerrisk chapter 23
+ *
+ **************************************************************************/
+
+#include "jobSchedule.h"
+#include "bashShell.h"  /* for the shell state, launching commands and reaping jobs */
+
+/* The nanoseconds of a tick of the wheel */
+#define TICK_NS (WHEEL_TICK_MS * 1000000LL)
+
+/* The ticks a level of the wheel turns through before its slot index
+ * comes back to 0
+ */
+#define LEVEL_SPAN(level) (1LL << (WHEEL_BITS * ((level) + 1)))
+
+/* The milliseconds between checks of a queued run's job that has no pidfd */
+#define QUEUE_POLL_MS 100
+
+/* Set by catchSIGINTDuringSchedule when ^C is pressed while the shell runs
+ * the schedule after its input has ended
+ */
+static volatile sig_atomic_t scheduleInterrupted = FALSE;
+
+/* Signal catcher for SIGINT while the shell runs the schedule to its end.
+ * Being caught without SA_RESTART makes poll return so ^C ends the wait.
+ */
+static void catchSIGINTDuringSchedule(int theSignal)
+{
+    scheduleInterrupted = TRUE;
+}
+
+/* Returns the monotonic time in nanoseconds */
+static long long monotonicNs(void)
+{
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec * 1000000000LL + time.tv_nsec;
+}
+
+/* Returns the tick of the wheel the clock has reached */
+static long long currentTick(struct jobSchedule *schedule)
+{
+    return (monotonicNs() - schedule->origin) / TICK_NS;
+}
+
+/* Returns the ticks a number of seconds takes, rounded up to at least one */
+static long long secondsToTicks(double seconds)
+{
+    long long ticks;
+
+    ticks = (long long)(seconds * 1000 / WHEEL_TICK_MS);
+    if (ticks * WHEEL_TICK_MS < seconds * 1000)
+    {
+        ++ticks;
+    }
+
+    return ticks < 1 ? 1 : ticks;
+}
+
+/* Initializes an empty schedule. */
+void initializeSchedule(struct jobSchedule *schedule)
+{
+    memset(schedule->slots, 0, sizeof(schedule->slots));
+    memset(schedule->levelCounts, 0, sizeof(schedule->levelCounts));
+    schedule->now = 0;
+    schedule->origin = 0;
+    schedule->timerFd = -1;
+    schedule->queue = NULL;
+    schedule->numQueued = 0;
+    schedule->first = NULL;
+    schedule->last = NULL;
+    schedule->count = 0;
+    schedule->nextId = 1;
+}
+
+/* Puts an entry into the wheel at its due tick. The level is the lowest
+ * whose turn from now reaches the tick, and the slot is the tick's digit
+ * at that level, so the entry is moved down a level each time the slot
+ * comes round until it reaches level 0 at its tick. A due tick before now
+ * is run at now. An entry further away than the top level reaches waits
+ * in the top level's last slot before now and is put back when it comes
+ * round.
+ */
+static void insertEntry(struct jobSchedule *schedule, struct scheduleEntry *entry)
+{
+    long long target;
+    long long delta;
+    int level = 0;
+
+    if (entry->due < schedule->now)
+    {
+        entry->due = schedule->now;
+    }
+
+    target = entry->due;
+    delta = target - schedule->now;
+
+    while (level < WHEEL_LEVELS - 1 && delta >= LEVEL_SPAN(level))
+    {
+        ++level;
+    }
+    if (delta >= LEVEL_SPAN(WHEEL_LEVELS - 1))
+    {
+        target = schedule->now + LEVEL_SPAN(WHEEL_LEVELS - 1) - 1;
+    }
+
+    entry->level = level;
+    entry->slot = (target >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1);
+
+    entry->previous = NULL;
+    entry->next = schedule->slots[level][entry->slot];
+    if (entry->next != NULL)
+    {
+        entry->next->previous = entry;
+    }
+    schedule->slots[level][entry->slot] = entry;
+    ++schedule->levelCounts[level];
+}
+
+/* Takes an entry out of the slot of the wheel it is in */
+static void unlinkEntry(struct jobSchedule *schedule, struct scheduleEntry *entry)
+{
+    if (entry->level == -1)
+    {
+        return;
+    }
+
+    if (entry->previous != NULL)
+    {
+        entry->previous->next = entry->next;
+    }
+    else
+    {
+        schedule->slots[entry->level][entry->slot] = entry->next;
+    }
+    if (entry->next != NULL)
+    {
+        entry->next->previous = entry->previous;
+    }
+
+    --schedule->levelCounts[entry->level];
+    entry->level = -1;
+    entry->previous = NULL;
+    entry->next = NULL;
+}
+
+/* Moves the entries of a slot of a level above 0 down to the levels their
+ * due ticks now fall in
+ */
+static void cascadeSlot(struct jobSchedule *schedule, int level, int slot)
+{
+    struct scheduleEntry *entry;
+    struct scheduleEntry *next;
+
+    entry = schedule->slots[level][slot];
+    schedule->slots[level][slot] = NULL;
+
+    while (entry != NULL)
+    {
+        next = entry->next;
+        --schedule->levelCounts[level];
+        entry->level = -1;
+        insertEntry(schedule, entry);
+        entry = next;
+    }
+}
+
+/* Turns the wheel up to a tick, collecting the entries that expire into a
+ * list joined by their next pointers. Runs of empty level 0 slots are
+ * skipped to the end of level 0's turn, so turning the wheel costs the
+ * slots that hold entries and one step a turn rather than one step a tick.
+ */
+static struct scheduleEntry *advanceWheel(struct jobSchedule *schedule, long long target)
+{
+    struct scheduleEntry *expired = NULL;
+    struct scheduleEntry *entry;
+    struct scheduleEntry *next;
+    long long turnEnd;
+    int level;
+    int slot;
+
+    while (schedule->now < target)
+    {
+        if (schedule->levelCounts[0] == 0)
+        {
+            turnEnd = schedule->now | (WHEEL_SLOTS - 1);
+            if (turnEnd >= target)
+            {
+                schedule->now = target;
+                break;
+            }
+            schedule->now = turnEnd;
+        }
+        ++schedule->now;
+
+        /* When a level's slot index comes back to 0 the slot of the level
+         * above that comes round is moved down, before level 0's slot is
+         * taken so entries moved into it expire on this tick
+         */
+        for (level = 1; level < WHEEL_LEVELS; level++)
+        {
+            if ((schedule->now & (LEVEL_SPAN(level - 1) - 1)) != 0)
+            {
+                break;
+            }
+            cascadeSlot(schedule, level, (schedule->now >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+        }
+
+        slot = schedule->now & (WHEEL_SLOTS - 1);
+        entry = schedule->slots[0][slot];
+        schedule->slots[0][slot] = NULL;
+        while (entry != NULL)
+        {
+            next = entry->next;
+            --schedule->levelCounts[0];
+            entry->level = -1;
+            entry->previous = NULL;
+            entry->next = expired;
+            expired = entry;
+            entry = next;
+        }
+    }
+
+    return expired;
+}
+
+/* Arms the timerfd for the next tick that has to be looked at: the first
+ * level 0 slot after now that holds an entry, or if level 0 is empty the
+ * end of its turn when a higher level's slot is moved down. The timer is
+ * disarmed when nothing is scheduled.
+ */
+static void armTimer(struct jobSchedule *schedule)
+{
+    struct itimerspec timer = {{0, 0}, {0, 0}};
+    long long next = -1;
+    long long ns;
+    long long tick;
+    int level;
+
+    if (schedule->timerFd == -1)
+    {
+        return;
+    }
+
+    if (schedule->levelCounts[0] > 0)
+    {
+        for (tick = schedule->now + 1; tick <= schedule->now + WHEEL_SLOTS; tick++)
+        {
+            if (schedule->slots[0][tick & (WHEEL_SLOTS - 1)] != NULL)
+            {
+                next = tick;
+                break;
+            }
+        }
+    }
+    else
+    {
+        for (level = 1; level < WHEEL_LEVELS; level++)
+        {
+            if (schedule->levelCounts[level] > 0)
+            {
+                next = (schedule->now | (WHEEL_SLOTS - 1)) + 1;
+                break;
+            }
+        }
+    }
+
+    if (next != -1)
+    {
+        ns = schedule->origin + next * TICK_NS;
+        timer.it_value.tv_sec = ns / 1000000000LL;
+        timer.it_value.tv_nsec = ns % 1000000000LL;
+    }
+
+    timerfd_settime(schedule->timerFd, TFD_TIMER_ABSTIME, &timer, NULL);
+}
+
+/* Adds an entry to the list of every entry and to the wheel */
+static void addEntry(struct jobSchedule *schedule, struct scheduleEntry *entry)
+{
+    entry->id = schedule->nextId++;
+    entry->previousEntry = schedule->last;
+    entry->nextEntry = NULL;
+    if (schedule->last != NULL)
+    {
+        schedule->last->nextEntry = entry;
+    }
+    else
+    {
+        schedule->first = entry;
+    }
+    schedule->last = entry;
+    ++schedule->count;
+
+    insertEntry(schedule, entry);
+}
+
+/* Takes an entry out of the wheel, the queue and the list of entries and
+ * frees it
+ */
+static void removeEntry(struct jobSchedule *schedule, struct scheduleEntry *entry)
+{
+    struct scheduleEntry **link;
+
+    unlinkEntry(schedule, entry);
+
+    if (entry->queued == true)
+    {
+        link = &schedule->queue;
+        while (*link != entry)
+        {
+            link = &(*link)->nextQueued;
+        }
+        *link = entry->nextQueued;
+        --schedule->numQueued;
+    }
+
+    if (entry->previousEntry != NULL)
+    {
+        entry->previousEntry->nextEntry = entry->nextEntry;
+    }
+    else
+    {
+        schedule->first = entry->nextEntry;
+    }
+    if (entry->nextEntry != NULL)
+    {
+        entry->nextEntry->previousEntry = entry->previousEntry;
+    }
+    else
+    {
+        schedule->last = entry->previousEntry;
+    }
+    --schedule->count;
+
+    freeTemplates(&entry->command);
+    free(entry->text);
+    free(entry);
+}
+
+/* Cancels every entry and closes the timerfd. */
+void freeSchedule(struct jobSchedule *schedule)
+{
+    while (schedule->first != NULL)
+    {
+        removeEntry(schedule, schedule->first);
+    }
+
+    if (schedule->timerFd != -1)
+    {
+        close(schedule->timerFd);
+        schedule->timerFd = -1;
+    }
+}
+
+/* Returns true if the job of an entry's last run hasn't been reaped */
+static bool entryRunning(struct shellState *shell, struct scheduleEntry *entry)
+{
+    return entry->running != 0
+           && pidArrayIndex(shell->jobs.pids, entry->running, shell->jobs.capacity) != -1;
+}
+
+/* Launches a run of an entry's command as a background job. The status of
+ * the commands the user runs isn't changed by the runs of the schedule.
+ */
+static void launchEntry(struct shellState *shell, struct scheduleEntry *entry)
+{
+    struct templateParameters parameters;
+    char exitStatusStr[STATUS_LENGTH];
+    int lastStatus;
+
+    strcpy(exitStatusStr, shell->exitStatusStr);
+    lastStatus = shell->lastStatus;
+
+    variableParameters(&parameters, "", NULL);
+    shell->lastBackgroundPid = 0;
+    runTemplates(shell, &entry->command, &parameters);
+    entry->running = shell->lastBackgroundPid;
+    ++entry->numRuns;
+
+    strcpy(shell->exitStatusStr, exitStatusStr);
+    shell->lastStatus = lastStatus;
+}
+
+/* Runs an entry that has come due, unless its last run is still going, in
+ * which case the run is skipped or, with -q, queued if no run is queued yet
+ */
+static int runEntry(struct shellState *shell, struct scheduleEntry *entry)
+{
+    struct jobSchedule *schedule = &shell->schedule;
+
+    if (entryRunning(shell, entry) == false)
+    {
+        launchEntry(shell, entry);
+        return 1;
+    }
+
+    if (entry->policy == overlapQueue && entry->queued == false)
+    {
+        entry->queued = true;
+        entry->nextQueued = schedule->queue;
+        schedule->queue = entry;
+        ++schedule->numQueued;
+    }
+    else
+    {
+        ++entry->numSkipped;
+    }
+
+    return 0;
+}
+
+/* Runs the entries that are due and any queued runs whose last run has
+ * ended, without waiting.
+ */
+int runDueEntries(struct shellState *shell)
+{
+    struct jobSchedule *schedule = &shell->schedule;
+    struct scheduleEntry *expired;
+    struct scheduleEntry *entry;
+    struct scheduleEntry **link;
+    uint64_t expirations;
+    long long missed;
+    int numJobs;
+    int numRun = 0;
+
+    if (schedule->count == 0)
+    {
+        return 0;
+    }
+
+    /* The timer is only read to clear it, since the wheel goes by the clock */
+    while (read(schedule->timerFd, &expirations, sizeof(expirations)) > 0)
+    {
+        continue;
+    }
+
+    expired = advanceWheel(schedule, currentTick(schedule));
+
+    /* Runs only overlap jobs that haven't been reaped, so the jobs that
+     * have finished are reaped first
+     */
+    if (expired != NULL || schedule->queue != NULL)
+    {
+        numJobs = shell->jobs.numJobs;
+        reapBackgroundJobs(shell);
+        numRun += numJobs - shell->jobs.numJobs;
+    }
+
+    link = &schedule->queue;
+    while (*link != NULL)
+    {
+        entry = *link;
+        if (entryRunning(shell, entry) == false)
+        {
+            *link = entry->nextQueued;
+            entry->queued = false;
+            --schedule->numQueued;
+            launchEntry(shell, entry);
+            ++numRun;
+        }
+        else
+        {
+            link = &entry->nextQueued;
+        }
+    }
+
+    while (expired != NULL)
+    {
+        entry = expired;
+        expired = entry->next;
+        entry->next = NULL;
+
+        numRun += runEntry(shell, entry);
+
+        if (entry->kind == scheduleAt)
+        {
+            removeEntry(schedule, entry);
+            continue;
+        }
+
+        /* The next run is a whole number of intervals on, and runs missed
+         * while the shell was busy are counted as skipped
+         */
+        entry->due += entry->interval;
+        if (entry->due <= schedule->now)
+        {
+            missed = (schedule->now - entry->due) / entry->interval + 1;
+            entry->numSkipped += missed;
+            entry->due += missed * entry->interval;
+        }
+        insertEntry(schedule, entry);
+    }
+
+    armTimer(schedule);
+    return numRun;
+}
+
+/* Fills in the fds a wait for the schedule polls: the timerfd and the
+ * pidfd of the job each queued run waits on. A job without a pidfd is
+ * checked every QUEUE_POLL_MS instead.
+ * output: the number of fds
+ */
+static int schedulePollFds(struct shellState *shell, struct pollfd pollFds[], int *timeout)
+{
+    struct scheduleEntry *entry;
+    int numFds = 0;
+    int index;
+
+    *timeout = -1;
+
+    pollFds[numFds].fd = shell->schedule.timerFd;
+    pollFds[numFds].events = POLLIN;
+    ++numFds;
+
+    for (entry = shell->schedule.queue; entry != NULL; entry = entry->nextQueued)
+    {
+        index = pidArrayIndex(shell->jobs.pids, entry->running, shell->jobs.capacity);
+        if (index != -1 && shell->jobs.pidfds[index] != NO_PIDFD)
+        {
+            pollFds[numFds].fd = shell->jobs.pidfds[index];
+            pollFds[numFds].events = POLLIN;
+            ++numFds;
+        }
+        else
+        {
+            *timeout = QUEUE_POLL_MS;
+        }
+    }
+
+    return numFds;
+}
+
+/* Waits until the input has a commandline to read, running entries as
+ * they come due.
+ */
+void waitForInput(struct shellState *shell)
+{
+    struct jobSchedule *schedule = &shell->schedule;
+    struct pollfd *pollFds;
+    int inputFd;
+    int numFds;
+    int timeout;
+
+    inputFd = fileno(shell->input);
+
+    /* A memory file has no fd to poll and is always ready */
+    if (schedule->count == 0 || inputFd == -1)
+    {
+        return;
+    }
+
+    while (schedule->count > 0 || schedule->queue != NULL)
+    {
+        /* A line stdio has already read from the fd needs no wait */
+        if (shell->input->_IO_read_ptr < shell->input->_IO_read_end)
+        {
+            return;
+        }
+
+        /* What the runs printed pushed the prompt up, so it is printed again */
+        if (runDueEntries(shell) > 0 && shell->prompt == true)
+        {
+            printf(": ");
+        }
+        fflush(stdout);
+
+        pollFds = malloc((schedule->numQueued + 2) * sizeof(struct pollfd));
+        if (pollFds == NULL)
+        {
+            fprintf(stderr,"Malloc not successful\n");
+            exit(1);
+        }
+        pollFds[0].fd = inputFd;
+        pollFds[0].events = POLLIN;
+        numFds = 1 + schedulePollFds(shell, &pollFds[1], &timeout);
+
+        /* A signal such as SIGCHLD just goes round again */
+        if (poll(pollFds, numFds, timeout) > 0 && pollFds[0].revents != 0)
+        {
+            free(pollFds);
+            return;
+        }
+        free(pollFds);
+    }
+}
+
+/* Runs the entries as they come due until none are left or ^C. The jobs
+ * of the last runs are then waited for, since the shell would kill them as
+ * it exits.
+ */
+void runScheduleToEnd(struct shellState *shell)
+{
+    struct jobSchedule *schedule = &shell->schedule;
+    struct sigaction SIGINTaction = {0};
+    struct sigaction prevAction;
+    struct pollfd *pollFds;
+    char waitCommand[] = "wait";
+    char exitStatusStr[STATUS_LENGTH];
+    int numFds;
+    int timeout;
+
+    /* A shell that never scheduled anything exits as it always has */
+    if (schedule->nextId == 1)
+    {
+        return;
+    }
+
+    /* let ^C end the schedule rather than be ignored */
+    scheduleInterrupted = FALSE;
+    SIGINTaction.sa_handler = catchSIGINTDuringSchedule;
+    sigaction(SIGINT, &SIGINTaction, &prevAction);
+
+    while (scheduleInterrupted == FALSE && shell->exitRequested == false
+           && (schedule->count > 0 || schedule->queue != NULL))
+    {
+        runDueEntries(shell);
+        fflush(stdout);
+        if (schedule->count == 0)
+        {
+            break;
+        }
+
+        pollFds = malloc((schedule->numQueued + 1) * sizeof(struct pollfd));
+        if (pollFds == NULL)
+        {
+            fprintf(stderr,"Malloc not successful\n");
+            exit(1);
+        }
+        numFds = schedulePollFds(shell, pollFds, &timeout);
+        poll(pollFds, numFds, timeout);
+        free(pollFds);
+    }
+
+    sigaction(SIGINT, &prevAction, NULL);
+
+    if (scheduleInterrupted == FALSE && shell->jobs.numJobs > 0)
+    {
+        strcpy(exitStatusStr, shell->exitStatusStr);
+        waitBuiltin(&shell->jobs, waitCommand, shell->exitStatusStr);
+        strcpy(shell->exitStatusStr, exitStatusStr);
+    }
+}
+
+/* Prints the scheduled entries with when each next runs */
+static void listEntries(struct jobSchedule *schedule)
+{
+    struct scheduleEntry *entry;
+    double nextIn;
+
+    for (entry = schedule->first; entry != NULL; entry = entry->nextEntry)
+    {
+        nextIn = (schedule->origin + entry->due * TICK_NS - monotonicNs()) / 1e9;
+        if (nextIn < 0)
+        {
+            nextIn = 0;
+        }
+
+        if (entry->kind == scheduleEvery)
+        {
+            printf("[%d] every %gs%s: %s next in %.2fs, %ld runs, %ld skipped\n",
+                   entry->id, entry->interval * WHEEL_TICK_MS / 1000.0,
+                   entry->policy == overlapQueue ? " -q" : "", entry->text, nextIn,
+                   entry->numRuns, entry->numSkipped);
+        }
+        else
+        {
+            printf("[%d] at: %s in %.2fs\n", entry->id, entry->text, nextIn);
+        }
+    }
+    fflush(stdout);
+}
+
+/* Cancels the entry with an id, or every entry for "all".
+ * output: 0 if successful or 1 if there is no such entry
+ */
+static int cancelEntries(struct jobSchedule *schedule, char *idText)
+{
+    struct scheduleEntry *entry;
+    char *end;
+    long id;
+
+    if (strcmp(idText, "all") == 0)
+    {
+        while (schedule->first != NULL)
+        {
+            removeEntry(schedule, schedule->first);
+        }
+        armTimer(schedule);
+        return 0;
+    }
+
+    id = strtol(idText, &end, 10);
+    for (entry = schedule->first; entry != NULL && *end == '\0'; entry = entry->nextEntry)
+    {
+        if (entry->id == id)
+        {
+            removeEntry(schedule, entry);
+            armTimer(schedule);
+            return 0;
+        }
+    }
+
+    printf("every: %s: no such entry\n", idText);
+    fflush(stdout);
+    return 1;
+}
+
+/* Returns the seconds until the next time of day given as HH:MM[:SS] in
+ * local time, which is tomorrow if it has passed today, or -1 if the time
+ * isn't valid
+ */
+static double secondsUntil(char *timeText)
+{
+    struct tm local;
+    time_t now;
+    time_t target;
+    int hour;
+    int minute;
+    int second = 0;
+    int length = 0;
+
+    if ((sscanf(timeText, "%d:%d%n", &hour, &minute, &length) != 2
+         || (timeText[length] != '\0'
+             && sscanf(timeText, "%d:%d:%d%n", &hour, &minute, &second, &length) != 3))
+        || timeText[length] != '\0'
+        || hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59)
+    {
+        return -1;
+    }
+
+    now = time(NULL);
+    localtime_r(&now, &local);
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    local.tm_sec = second;
+    local.tm_isdst = -1;
+    target = mktime(&local);
+    if (target <= now)
+    {
+        ++local.tm_mday;
+        local.tm_isdst = -1;
+        target = mktime(&local);
+    }
+
+    return difftime(target, now);
+}
+
+/* Returns the next word of a commandline, ending it with '\0', and moves
+ * the position past it, or returns NULL at the end of the line
+ */
+static char *nextWord(char **position)
+{
+    char *word;
+
+    *position += strspn(*position, " \t\n");
+    if (**position == '\0')
+    {
+        return NULL;
+    }
+
+    word = *position;
+    *position += strcspn(*position, " \t\n");
+    if (**position != '\0')
+    {
+        **position = '\0';
+        ++*position;
+    }
+
+    return word;
+}
+
+/* Runs "every [-q] INTERVAL command [args]", "at TIME command [args]",
+ * "every" or "at" alone, or "every -d ID|all".
+ */
+int scheduleBuiltin(struct shellState *shell, char commandText[])
+{
+    struct jobSchedule *schedule = &shell->schedule;
+    char commandCopy[MAX_COMMAND_LINE_EXPANDED];  /* the words are ended in place */
+    struct scheduleEntry *entry;
+    struct commandList list;
+    struct templateParameters parameters;
+    char *position = commandCopy;
+    char *word;
+    char *command;
+    size_t length;
+    double seconds;
+    bool isEvery;
+    enum overlapPolicy policy = overlapSkip;
+
+    strcpy(commandCopy, commandText);
+    isEvery = (strcmp(nextWord(&position), "every") == 0);
+
+    word = nextWord(&position);
+    if (word == NULL)
+    {
+        listEntries(schedule);
+        return 0;
+    }
+
+    if (isEvery == true && strcmp(word, "-d") == 0)
+    {
+        word = nextWord(&position);
+        if (word == NULL || nextWord(&position) != NULL)
+        {
+            printf("usage: every -d ID|all\n");
+            fflush(stdout);
+            return SCHEDULE_USAGE_ERROR;
+        }
+        return cancelEntries(schedule, word);
+    }
+
+    if (isEvery == true && strcmp(word, "-q") == 0)
+    {
+        policy = overlapQueue;
+        word = nextWord(&position);
+    }
+
+    if (word == NULL)
+    {
+        seconds = -1;
+    }
+    else if (isEvery == true)
+    {
+        seconds = parseDuration(word);
+    }
+    else if (word[0] == '+')
+    {
+        seconds = parseDuration(word + 1);
+    }
+    else
+    {
+        seconds = secondsUntil(word);
+    }
+
+    /* The command is the rest of the line, run in the background */
+    command = position + strspn(position, " \t\n");
+    length = strlen(command);
+    while (length > 0 && (command[length - 1] == ' ' || command[length - 1] == '\t'
+                          || command[length - 1] == '\n'))
+    {
+        command[--length] = '\0';
+    }
+
+    if (seconds < 0 || (isEvery == true && seconds == 0) || length == 0)
+    {
+        printf("usage: every [-q] INTERVAL command | at +DURATION|HH:MM[:SS] command"
+               " | every -d ID|all\n"
+               "entries run between commandlines, so one that comes due during a foreground"
+               " command runs once it ends and the runs it missed are counted as skipped\n");
+        fflush(stdout);
+        return SCHEDULE_USAGE_ERROR;
+    }
+
+    /* Inbuilt commands would run in the shell itself at any moment, so
+     * only commands that are launched as jobs can be scheduled
+     */
+    if (classifyCommandLine(command) != externalLine)
+    {
+        printf("%s: only commands launched as jobs can be scheduled\n", isEvery ? "every" : "at");
+        fflush(stdout);
+        return 1;
+    }
+
+    entry = malloc(sizeof(struct scheduleEntry));
+    if (entry == NULL)
+    {
+        fprintf(stderr,"Malloc not successful\n");
+        exit(1);
+    }
+    entry->text = malloc(length + 3);
+    if (entry->text == NULL)
+    {
+        fprintf(stderr,"Malloc not successful\n");
+        exit(1);
+    }
+    sprintf(entry->text, "%s%s", command, command[length - 1] == '&' ? "" : " &");
+
+    /* The command is parsed once here rather than at every run */
+    entry->command.commands = NULL;
+    entry->command.count = 0;
+    list.count = 0;
+    variableParameters(&parameters, "", NULL);
+    if (splitCommandList(entry->text, &list, true) == -1 || list.count != 1
+        || compileTemplates(shell, list.commands, list.count, &parameters, &entry->command) == -1)
+    {
+        if (list.count > 1)
+        {
+            printf("%s: only one command can be scheduled\n", isEvery ? "every" : "at");
+            fflush(stdout);
+        }
+        freeTemplates(&entry->command);
+        free(entry->text);
+        free(entry);
+        return 1;
+    }
+
+    /* The wheel and its timer are set up with the first entry */
+    if (schedule->timerFd == -1)
+    {
+        schedule->timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (schedule->timerFd == -1)
+        {
+            perror("timerfd_create");
+            freeTemplates(&entry->command);
+            free(entry->text);
+            free(entry);
+            return 1;
+        }
+    }
+    if (schedule->count == 0)
+    {
+        schedule->origin = monotonicNs();
+        schedule->now = 0;
+    }
+
+    entry->kind = isEvery ? scheduleEvery : scheduleAt;
+    entry->policy = policy;
+    entry->interval = isEvery ? secondsToTicks(seconds) : 0;
+    entry->level = -1;
+    entry->running = 0;
+    entry->queued = false;
+    entry->nextQueued = NULL;
+    entry->numRuns = 0;
+    entry->numSkipped = 0;
+
+    /* An every entry runs at once and then each interval, like the loop
+     * it replaces, and an at entry runs at its time
+     */
+    entry->due = currentTick(schedule) + (isEvery ? 1 : secondsToTicks(seconds));
+    addEntry(schedule, entry);
+    armTimer(schedule);
+
+    printf("[%d] %s\n", entry->id, entry->text);
+    fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,169 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the scheduler of periodic and one-off jobs including:
+ *
+ *               the every and at inbuilt commands, which schedule a
+ *               command to run every INTERVAL or at a TIME
+ *               a hierarchical timer wheel of the scheduled entries
+ *               one timerfd, armed for the next entry that is due, that
+ *               the shell waits on along with its input
+ *               launching each run of a command through launchCommand as
+ *               a background job
+ *               skipping a run while the last run of the command is
+ *               still going, or with -q queueing one run until it ends
+ *
+ *              The wheel has WHEEL_LEVELS levels of WHEEL_SLOTS slots. A
+ *              slot of level 0 is one tick of WHEEL_TICK_MS and a slot of
+ *              each level above spans a whole turn of the level below.
+ *              Scheduling, cancelling and expiring an entry take constant
+ *              time, and an entry is moved down a level at most once per
+ *              level, so thousands of entries cost little more than one.
+ *
+ *              The runs of every entry are kept on a fixed grid from when
+ *              it was scheduled, so they don't drift however long each
+ *              launch takes, and runs missed while the shell was busy with
+ *              a foreground job are skipped rather than run together.
+ *
+ *              Entries run while the shell waits at its prompt or between
+ *              commandlines, not while a foreground command runs. An entry
+ *              that comes due during one runs once when it ends, and its
+ *              runs in between are counted as skipped, as listed by every.
+ *              When a script or -c ends with entries still scheduled, the
+ *              shell goes on running them until they are done or ^C.
+ *
+ *  Reference: Varghese and Lauck, "Hashed and Hierarchical Timing Wheels"
+ *  (1987) and man page timerfd_create(2)
+ *
+ **************************************************************************/
+
+#ifndef JOB_SCHEDULE_H
+#define JOB_SCHEDULE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "commandTemplate.h"  /* for the command of an entry, parsed once */
+
+/* The length of a tick of the wheel, which is how precisely entries run */
+#define WHEEL_TICK_MS 10
+
+/* The number of levels of the wheel and the slots of each. With 64 slots
+ * of 10ms the levels span 0.64s, 41s, 44m and 1.9 days; an entry further
+ * away waits in the top level and is moved down when it comes round.
+ */
+#define WHEEL_LEVELS 4
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+
+/* The exit status of every or at given a commandline they can't schedule */
+#define SCHEDULE_USAGE_ERROR 2
+
+struct shellState;
+
+/* What an entry does after it runs */
+enum scheduleKind{ scheduleEvery, scheduleAt};
+
+/* What happens when an every entry comes due while its last run is still
+ * going: the run is skipped, or one run is queued until the last ends
+ */
+enum overlapPolicy{ overlapSkip, overlapQueue};
+
+/* A scheduled command */
+struct scheduleEntry
+{
+    int id;
+    enum scheduleKind kind;
+    enum overlapPolicy policy;
+
+    char *text;  /* the command as it was given, which the template points into */
+    struct templateList command;
+
+    long long interval;  /* the ticks between runs of an every entry */
+    long long due;  /* the tick the entry next runs at */
+    int level;  /* the level of the wheel the entry is in, or -1 */
+    int slot;  /* the slot of that level */
+
+    pid_t running;  /* the job of the last run, or 0 */
+    bool queued;  /* true if a run waits for the last one to end */
+    long numRuns;
+    long numSkipped;
+
+    /* The entries of the same slot of the wheel */
+    struct scheduleEntry *previous;
+    struct scheduleEntry *next;
+
+    /* The next entry with a run queued */
+    struct scheduleEntry *nextQueued;
+
+    /* Every entry, in the order they were scheduled */
+    struct scheduleEntry *previousEntry;
+    struct scheduleEntry *nextEntry;
+};
+
+/* The scheduled entries of a shell */
+struct jobSchedule
+{
+    struct scheduleEntry *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    int levelCounts[WHEEL_LEVELS];  /* the number of entries in each level */
+    long long now;  /* the last tick the wheel has run up to */
+    long long origin;  /* the monotonic time of tick 0 in nanoseconds */
+
+    int timerFd;  /* -1 until the first entry is scheduled */
+
+    struct scheduleEntry *queue;  /* entries with a run queued */
+    int numQueued;
+    struct scheduleEntry *first;  /* every entry, in order */
+    struct scheduleEntry *last;
+    int count;
+    int nextId;
+};
+
+/* Initializes an empty schedule. The timerfd isn't made until the first
+ * entry is scheduled.
+ * input: the schedule: struct jobSchedule *
+ */
+void initializeSchedule(struct jobSchedule *schedule);
+
+/* Cancels every entry and closes the timerfd.
+ * input: the schedule: struct jobSchedule *
+ */
+void freeSchedule(struct jobSchedule *schedule);
+
+/* Runs "every [-q] INTERVAL command [args]", "at TIME command [args]",
+ * "every" or "at" alone, which list the entries, or "every -d ID|all",
+ * which cancels entries. TIME is +DURATION or HH:MM[:SS] in local time.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ * output: the exit status of the command
+ */
+int scheduleBuiltin(struct shellState *shell, char commandText[]);
+
+/* Runs the entries that are due and any queued runs whose last run has
+ * ended, without waiting. Does nothing if nothing is scheduled.
+ * input: the shell: struct shellState *
+ * output: the number of runs launched and jobs reported as finished
+ */
+int runDueEntries(struct shellState *shell);
+
+/* Waits until the input has a commandline to read, running entries as
+ * they come due. Returns at once if nothing is scheduled.
+ * input: the shell: struct shellState *
+ */
+void waitForInput(struct shellState *shell);
+
+/* Runs the entries as they come due until none are left or ^C, as when
+ * the input has ended.
+ * input: the shell: struct shellState *
+ */
+void runScheduleToEnd(struct shellState *shell);
+
+#endif
@@ -0,0 +1,415 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the limit on background jobs shared by every
+ *              shell of a user on the host including:
+ *
+ *               a table of job slots in a POSIX shared memory segment,
+ *               guarded by a robust process-shared mutex
+ *               taking a slot before a background job is forked, waiting
+ *               while the host's slots are all in use
+ *               giving the slot back when the job is reaped
+ *               reclaiming the slots of jobs that ended without being
+ *               reaped by their shell, as when the shell crashed
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 30, 53
+ *  and 54 and man page pthread_mutexattr_setrobust(3)
+ *
+ **************************************************************************/
+
+#include "jobSlots.h"
+#include "bashShell.h"
+
+/* The table this process has mapped, or NULL until the first background
+ * job. A forked shell shares its parent's mapping, which is what it wants.
+ */
+static struct jobSlotTable *table = NULL;
+static bool unavailable = false;  /* true once the table couldn't be used */
+
+/* Guards mapping the table between the threads of embedded sessions */
+static pthread_mutex_t attachMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Set by catchSIGINTDuringSlotWait when ^C is pressed while waiting */
+static volatile sig_atomic_t slotWaitInterrupted = FALSE;
+
+/* Signal catcher for SIGINT while waiting for a slot */
+static void catchSIGINTDuringSlotWait(int theSignal)
+{
+    slotWaitInterrupted = TRUE;
+}
+
+/* Reads the limit from the environment. */
+int jobSlotLimit(void)
+{
+    char *value = getenv(JOB_SLOTS_VARIABLE);
+    char *end;  /* set by strtol to the first char after the number */
+    long limit;
+
+    if (value == NULL || value[0] == '\0')
+    {
+        return 0;
+    }
+
+    if (strcmp(value, JOB_SLOTS_CORES) == 0)
+    {
+        limit = sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    else
+    {
+        limit = strtol(value, &end, 10);
+        if (*end != '\0' || limit < 0)
+        {
+            fprintf(stderr, "%s: not a number of jobs: %s\n", JOB_SLOTS_VARIABLE, value);
+            return 0;
+        }
+    }
+
+    return (limit > MAX_JOB_SLOTS) ? MAX_JOB_SLOTS : (int)limit;
+}
+
+/* Returns the start time of a process in clock ticks since boot from field
+ * 22 of /proc/PID/stat, or 0 if there is no such process or it has ended
+ * and is only waiting to be reaped. A job that has ended no longer needs
+ * its slot, and a shell waiting for a slot may be the one that would reap
+ * it.
+ */
+static unsigned long long runningStartTime(pid_t pid)
+{
+    char path[64];
+    char buffer[PROC_BUFFER_SIZE];
+    char *fields;
+    unsigned long long start = 0;
+    char state;
+    ssize_t length;
+    int fd;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return 0;
+    }
+
+    length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0)
+    {
+        return 0;
+    }
+    buffer[length] = '\0';
+
+    /* the command name in parentheses may hold spaces */
+    fields = strrchr(buffer, ')');
+    if (fields == NULL || sscanf(fields + 2, "%c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u "
+                                 "%*u %*u %*d %*d %*d %*d %*d %*d %llu", &state, &start) != 2
+        || state == 'Z' || state == 'X')
+    {
+        return 0;
+    }
+
+    return start;
+}
+
+/* Prints why the limit can't be used, once, and turns it off */
+static int tableUnavailable(char *reason)
+{
+    fprintf(stderr, "%s: can't share job slots, %s: %s\n", JOB_SLOTS_VARIABLE, reason,
+            strerror(errno));
+    unavailable = true;
+    return -1;
+}
+
+/* Maps the table, creating it if this is the first shell to use it. A shell
+ * that finds the segment waits until its creator has set it up.
+ */
+static int attachTable(void)
+{
+    char name[64];
+    struct stat status;
+    struct jobSlotTable *mapped;
+    pthread_mutexattr_t mutexAttributes;
+    pthread_condattr_t conditionAttributes;
+    bool created = true;
+    int tries;
+    int fd;
+
+    if (table != NULL)
+    {
+        return 0;
+    }
+    if (unavailable == true)
+    {
+        return -1;
+    }
+
+    snprintf(name, sizeof(name), JOB_SLOTS_NAME, (int)getuid());
+
+    /* O_EXCL decides which shell sets the table up */
+    fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+    if (fd == -1 && errno == EEXIST)
+    {
+        created = false;
+        fd = shm_open(name, O_RDWR | O_CLOEXEC, 0600);
+    }
+    if (fd == -1)
+    {
+        return tableUnavailable("shm_open");
+    }
+
+    /* a new segment reads as zeros, so every slot starts free */
+    if (created == true && ftruncate(fd, sizeof(struct jobSlotTable)) == -1)
+    {
+        close(fd);
+        shm_unlink(name);
+        return tableUnavailable("ftruncate");
+    }
+
+    for (tries = 0; created == false && tries < JOB_SLOTS_READY_TRIES; tries++)
+    {
+        if (fstat(fd, &status) == 0 && status.st_size >= (off_t)sizeof(struct jobSlotTable))
+        {
+            break;
+        }
+        usleep(1000);
+    }
+
+    mapped = mmap(NULL, sizeof(struct jobSlotTable), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return tableUnavailable("mmap");
+    }
+
+    if (created == true)
+    {
+        pthread_mutexattr_init(&mutexAttributes);
+        pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+        pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+        pthread_mutex_init(&mapped->mutex, &mutexAttributes);
+        pthread_mutexattr_destroy(&mutexAttributes);
+
+        /* the waits time out on the monotonic clock */
+        pthread_condattr_init(&conditionAttributes);
+        pthread_condattr_setpshared(&conditionAttributes, PTHREAD_PROCESS_SHARED);
+        pthread_condattr_setclock(&conditionAttributes, CLOCK_MONOTONIC);
+        pthread_cond_init(&mapped->freed, &conditionAttributes);
+        pthread_condattr_destroy(&conditionAttributes);
+
+        atomic_store(&mapped->ready, JOB_SLOTS_MAGIC);
+    }
+    else
+    {
+        for (tries = 0; atomic_load(&mapped->ready) != JOB_SLOTS_MAGIC; tries++)
+        {
+            if (tries == JOB_SLOTS_READY_TRIES)
+            {
+                munmap(mapped, sizeof(struct jobSlotTable));
+                errno = ETIMEDOUT;
+                return tableUnavailable("the table was never set up");
+            }
+            usleep(1000);
+        }
+    }
+
+    table = mapped;
+
+    return 0;
+}
+
+/* Locks the table. If the shell that held the lock died, the lock is made
+ * usable again: a slot it was changing is at worst left taken, and is
+ * reclaimed once its shell is found to be gone.
+ */
+static void lockTable(void)
+{
+    if (pthread_mutex_lock(&table->mutex) == EOWNERDEAD)
+    {
+        pthread_mutex_consistent(&table->mutex);
+    }
+}
+
+/* Returns true if the job of a taken slot, or its shell if the job hasn't
+ * been forked yet, is still running
+ */
+static bool slotInUse(struct jobSlot *slot)
+{
+    unsigned long long start;
+
+    if (slot->job != 0)
+    {
+        start = runningStartTime(slot->job);
+        return start != 0 && start == slot->jobStart;
+    }
+
+    start = runningStartTime(slot->shell);
+    return start != 0 && start == slot->shellStart;
+}
+
+/* Takes the first free slot if fewer than limit are taken, first freeing
+ * the slots of jobs that have ended if the limit has been reached. Returns
+ * the index of the slot or -1. The table must be locked.
+ */
+static int takeFreeSlot(int limit, pid_t shell, unsigned long long shellStart)
+{
+    int numTaken = 0;
+    int freeSlot = -1;
+    int i;
+
+    for (i = 0; i < MAX_JOB_SLOTS; i++)
+    {
+        if (table->slots[i].shell != 0)
+        {
+            ++numTaken;
+        }
+        else if (freeSlot == -1)
+        {
+            freeSlot = i;
+        }
+    }
+
+    /* Only a full table is checked for slots nobody gave back, since that
+     * reads a /proc file for every slot
+     */
+    if (numTaken >= limit)
+    {
+        for (i = 0; i < MAX_JOB_SLOTS; i++)
+        {
+            if (table->slots[i].shell != 0 && slotInUse(&table->slots[i]) == false)
+            {
+                memset(&table->slots[i], 0, sizeof(struct jobSlot));
+                --numTaken;
+                if (freeSlot == -1 || i < freeSlot)
+                {
+                    freeSlot = i;
+                }
+            }
+        }
+    }
+
+    if (numTaken >= limit || freeSlot == -1)
+    {
+        return -1;
+    }
+
+    table->slots[freeSlot].shell = shell;
+    table->slots[freeSlot].shellStart = shellStart;
+    table->slots[freeSlot].job = 0;
+    table->slots[freeSlot].jobStart = 0;
+
+    return freeSlot;
+}
+
+/* Takes a slot for a background job about to be forked. */
+int acquireJobSlot(int limit)
+{
+    static pid_t startedPid = 0;  /* the shell whose start time is known */
+    static unsigned long long shellStart = 0;
+    struct sigaction SIGINTaction = {0};
+    struct sigaction prevAction;
+    struct timespec deadline;
+    pid_t shell = getpid();
+    int slot;
+    int attached;
+
+    pthread_mutex_lock(&attachMutex);
+    attached = attachTable();
+    pthread_mutex_unlock(&attachMutex);
+
+    if (attached == -1)
+    {
+        return JOB_SLOT_UNLIMITED;
+    }
+
+    /* a forked shell has a start time of its own */
+    if (startedPid != shell)
+    {
+        shellStart = runningStartTime(shell);
+        startedPid = shell;
+    }
+
+    /* let ^C give up waiting rather than be ignored */
+    slotWaitInterrupted = FALSE;
+    SIGINTaction.sa_handler = catchSIGINTDuringSlotWait;
+    sigaction(SIGINT, &SIGINTaction, &prevAction);
+
+    lockTable();
+
+    /* A slot given back wakes the waiting shells. A shell that died
+     * can't, so the wait times out to check for its slots.
+     */
+    while ((slot = takeFreeSlot(limit, shell, shellStart)) == -1
+           && slotWaitInterrupted == FALSE)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_nsec += JOB_SLOTS_POLL_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_nsec -= 1000000000L;
+            ++deadline.tv_sec;
+        }
+
+        if (pthread_cond_timedwait(&table->freed, &table->mutex, &deadline) == EOWNERDEAD)
+        {
+            pthread_mutex_consistent(&table->mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&table->mutex);
+    sigaction(SIGINT, &prevAction, NULL);
+
+    return (slot == -1) ? JOB_SLOT_INTERRUPTED : slot;
+}
+
+/* Records the job forked with the slot. */
+void assignJobSlot(int slot, pid_t job)
+{
+    /* the job can't have been reaped yet, so its /proc file is there */
+    unsigned long long jobStart = runningStartTime(job);
+
+    /* a job that has already ended doesn't need the slot */
+    if (jobStart == 0)
+    {
+        cancelJobSlot(slot);
+        return;
+    }
+
+    lockTable();
+    table->slots[slot].job = job;
+    table->slots[slot].jobStart = jobStart;
+    pthread_mutex_unlock(&table->mutex);
+}
+
+/* Gives back a slot that no job was forked with. */
+void cancelJobSlot(int slot)
+{
+    lockTable();
+    memset(&table->slots[slot], 0, sizeof(struct jobSlot));
+    pthread_cond_broadcast(&table->freed);
+    pthread_mutex_unlock(&table->mutex);
+}
+
+/* Gives back the slot of a job of this shell that has been reaped. */
+void releaseJobSlot(pid_t job)
+{
+    pid_t shell;
+    int i;
+
+    if (table == NULL)
+    {
+        return;
+    }
+
+    shell = getpid();
+
+    lockTable();
+    for (i = 0; i < MAX_JOB_SLOTS; i++)
+    {
+        if (table->slots[i].job == job && table->slots[i].shell == shell)
+        {
+            memset(&table->slots[i], 0, sizeof(struct jobSlot));
+            pthread_cond_broadcast(&table->freed);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&table->mutex);
+}
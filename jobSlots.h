@@ -0,0 +1,138 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the limit on background jobs shared by every shell
+ *              of a user on the host including:
+ *
+ *               a table of job slots in a POSIX shared memory segment,
+ *               guarded by a robust process-shared mutex
+ *               taking a slot before a background job is forked, waiting
+ *               while the host's slots are all in use
+ *               giving the slot back when the job is reaped
+ *               reclaiming the slots of jobs that ended without being
+ *               reaped by their shell, as when the shell crashed
+ *
+ *              The limit is opt in: it is only used when the environment
+ *              variable BASHSHELL_JOB_SLOTS is set to the number of jobs a
+ *              shell may have running between all the shells of the host,
+ *              or to "cores" for the number of online CPUs. Shells given
+ *              different limits share the same slots and each waits at its
+ *              own limit.
+ *
+ *              A slot names the job's PID and start time, so a slot is
+ *              held while its job runs even if its shell has died and is
+ *              never confused with a process that reused the PID. A job
+ *              that has ended but hasn't been reaped yet gives its slot up
+ *              to a shell that finds the slots full. A shell that dies
+ *              while it holds the mutex leaves it to the next shell as
+ *              EOWNERDEAD rather than locked forever.
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 30, 53
+ *  and 54 and man page pthread_mutexattr_setrobust(3)
+ *
+ **************************************************************************/
+
+#ifndef JOB_SLOTS_H
+#define JOB_SLOTS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <sys/mman.h>   /* for shm_open and mapping the table */
+#include <sys/stat.h>
+#include <sys/types.h>
+
+/* The environment variable that turns the limit on */
+#define JOB_SLOTS_VARIABLE "BASHSHELL_JOB_SLOTS"
+
+/* The value of JOB_SLOTS_VARIABLE that means one job per online CPU */
+#define JOB_SLOTS_CORES "cores"
+
+/* The name of the shared memory segment, with the user's uid after it so
+ * each user has slots of their own
+ */
+#define JOB_SLOTS_NAME "/bashShell-jobSlots-%d"
+
+/* The most slots the table holds, and so the highest limit */
+#define MAX_JOB_SLOTS 1024
+
+/* Marks a table whose mutex and condition are ready to use */
+#define JOB_SLOTS_MAGIC 0x6a6f6273
+
+/* How many times a shell checks for a table another shell is still
+ * creating, a millisecond apart, before it gives up on the limit
+ */
+#define JOB_SLOTS_READY_TRIES 1000
+
+/* The milliseconds a waiting shell sleeps before it checks again for the
+ * slots of jobs that ended without being given back
+ */
+#define JOB_SLOTS_POLL_MS 100
+
+/* Returned by acquireJobSlot when ^C interrupts the wait, and when the
+ * shared memory can't be used so the job runs without a slot
+ */
+#define JOB_SLOT_INTERRUPTED -1
+#define JOB_SLOT_UNLIMITED -2
+
+/* A slot of the table. A free slot has a shell of 0, and a slot taken
+ * before the fork has a job of 0 until the job's PID is known.
+ */
+struct jobSlot
+{
+    pid_t shell;
+    unsigned long long shellStart;  /* the start time of the shell in clock ticks */
+    pid_t job;
+    unsigned long long jobStart;  /* the start time of the job in clock ticks */
+};
+
+/* The table in shared memory */
+struct jobSlotTable
+{
+    atomic_uint ready;  /* JOB_SLOTS_MAGIC once the table is set up */
+    pthread_mutex_t mutex;  /* robust and process-shared */
+    pthread_cond_t freed;  /* signaled when a slot is given back */
+    struct jobSlot slots[MAX_JOB_SLOTS];
+};
+
+/* Reads the limit from the environment.
+ * output: the number of jobs allowed between the shells of the host, or 0
+ *         if there is no limit
+ */
+int jobSlotLimit(void);
+
+/* Takes a slot for a background job about to be forked, waiting while the
+ * host has as many jobs as the limit. ^C interrupts the wait.
+ * input: the limit: int
+ * output: the index of the slot, JOB_SLOT_INTERRUPTED or JOB_SLOT_UNLIMITED
+ *         after printing why if the shared memory can't be used
+ */
+int acquireJobSlot(int limit);
+
+/* Records the job forked with the slot, which holds the slot from then on.
+ * input: the index of the slot: int
+ *        the PID of the job: pid_t
+ */
+void assignJobSlot(int slot, pid_t job);
+
+/* Gives back a slot that no job was forked with.
+ * input: the index of the slot: int
+ */
+void cancelJobSlot(int slot);
+
+/* Gives back the slot of a job of this shell that has been reaped. Does
+ * nothing if the job has no slot.
+ * input: the PID of the job: pid_t
+ */
+void releaseJobSlot(pid_t job);
+
+#endif
@@ -0,0 +1,259 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements functions for running foreground jobs with a
+ *              time limit including:
+ *
+ *               parsing a duration such as 30, 2.5s, 10m or 1h
+ *               removing a "timeout [-k DURATION] DURATION" prefix from
+ *               the commandline
+ *               waiting on a child with a deadline, escalating from
+ *               SIGTERM to SIGKILL
+ *
+ *  Reference: man pages timerfd_create(2), pidfd_open(2) and poll(2)
+ *
+ **************************************************************************/
+
+#include "jobTimer.h"
+
+/* Converts a duration with an optional s, m, h or d suffix into seconds. */
+double parseDuration(char *durationStr)
+{
+    char *end;  /* set by strtod to the first char after the number */
+    double seconds;
+
+    errno = 0;
+    seconds = strtod(durationStr, &end);
+
+    if (errno != 0 || end == durationStr || seconds < 0)
+    {
+        return -1;
+    }
+
+    /* apply the unit suffix, if any */
+    switch (*end)
+    {
+        case '\0':
+        case 's':
+            break;
+        case 'm':
+            seconds *= 60;
+            break;
+        case 'h':
+            seconds *= 60 * 60;
+            break;
+        case 'd':
+            seconds *= 60 * 60 * 24;
+            break;
+        default:
+            return -1;
+    }
+
+    /* nothing may follow the suffix */
+    if (*end != '\0' && *(end + 1) != '\0')
+    {
+        return -1;
+    }
+
+    return seconds;
+}
+
+/* Copies the next space delimited word at *cursor into word and moves the
+ * cursor past it. Returns -1 if there isn't a word or it is too long.
+ */
+static int nextWord(char **cursor, char word[])
+{
+    int length = 0;
+
+    while (isspace((unsigned char)**cursor))
+    {
+        ++*cursor;
+    }
+
+    while (**cursor != '\0' && !isspace((unsigned char)**cursor))
+    {
+        if (length == TIMEOUT_WORD_LENGTH - 1)
+        {
+            return -1;
+        }
+        word[length++] = **cursor;
+        ++*cursor;
+    }
+    word[length] = '\0';
+
+    return (length == 0) ? -1 : 0;
+}
+
+/* Removes "timeout [-k KILLDURATION] DURATION " from the start of the
+ * commandline, leaving just the command to be run.
+ */
+int stripTimeoutPrefix(char commandLine[], double *timeout, double *killAfter)
+{
+    char word[TIMEOUT_WORD_LENGTH];
+    char *cursor = commandLine;
+
+    /* skip the word "timeout" */
+    if (nextWord(&cursor, word) == -1 || nextWord(&cursor, word) == -1)
+    {
+        return -1;
+    }
+
+    /* read the optional kill duration */
+    if (strcmp(word, "-k") == 0)
+    {
+        if (nextWord(&cursor, word) == -1 || (*killAfter = parseDuration(word)) < 0
+            || nextWord(&cursor, word) == -1)
+        {
+            return -1;
+        }
+    }
+
+    /* a zero duration means no time limit, as with timeout(1) */
+    if ((*timeout = parseDuration(word)) < 0)
+    {
+        return -1;
+    }
+
+    while (isspace((unsigned char)*cursor))
+    {
+        ++cursor;
+    }
+
+    /* there must be a command to run */
+    if (*cursor == '\0')
+    {
+        return -1;
+    }
+
+    /* shift the command to the start of the commandline */
+    memmove(commandLine, cursor, strlen(cursor) + 1);
+
+    return 0;
+}
+
+/* Arms the timer to expire once after the given number of seconds. */
+static int armTimer(int timerFileDescriptor, double seconds)
+{
+    struct itimerspec expiry = {0};
+
+    expiry.it_value.tv_sec = (time_t)seconds;
+    expiry.it_value.tv_nsec = (long)((seconds - (time_t)seconds) * 1e9);
+
+    /* a zero it_value disarms the timer so make it at least 1ns */
+    if (expiry.it_value.tv_sec == 0 && expiry.it_value.tv_nsec == 0)
+    {
+        expiry.it_value.tv_nsec = 1;
+    }
+
+    return timerfd_settime(timerFileDescriptor, 0, &expiry, NULL);
+}
+
+/* Waits for the child to finish. If it is still running after timeout
+ * seconds it is sent SIGTERM and then, killAfter seconds later, SIGKILL.
+ */
+pid_t waitWithTimeout(pid_t pid, int *childExitMethod, double timeout,
+                      double killAfter, bool *timedOut)
+{
+    struct pollfd pollFds[2];
+    int numPollFds = 1;
+    int pidfd;
+    int timerFileDescriptor;
+    int pollTimeout = -1;  /* block until the timer or the child is ready */
+    int signalToSend = SIGTERM;
+    uint64_t expirations;
+    pid_t waitPidReturn;
+
+    *timedOut = false;
+
+    if (timeout <= NO_TIMEOUT)
+    {
+        return waitpid(pid, childExitMethod, 0);
+    }
+
+    timerFileDescriptor = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timerFileDescriptor == -1 || armTimer(timerFileDescriptor, timeout) == -1)
+    {
+        perror("timerfd unsuccessful, waiting without a time limit");
+        if (timerFileDescriptor != -1)
+        {
+            close(timerFileDescriptor);
+        }
+        return waitpid(pid, childExitMethod, 0);
+    }
+
+    pollFds[0].fd = timerFileDescriptor;
+    pollFds[0].events = POLLIN;
+
+    /* Without pidfd support fall back to checking on the child periodically */
+    pidfd = pidfdOpen(pid);
+    if (pidfd != -1)
+    {
+        pollFds[1].fd = pidfd;
+        pollFds[1].events = POLLIN;
+        numPollFds = 2;
+    }
+    else
+    {
+        pollTimeout = TIMEOUT_POLL_FALLBACK;
+    }
+
+    while (true)
+    {
+        if (numPollFds == 1)
+        {
+            waitPidReturn = waitpid(pid, childExitMethod, WNOHANG);
+            if (waitPidReturn != 0)
+            {
+                break;
+            }
+        }
+
+        if (poll(pollFds, numPollFds, pollTimeout) == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("poll() unsuccessful");
+            waitPidReturn = waitpid(pid, childExitMethod, 0);
+            break;
+        }
+
+        /* the pidfd is readable once the child has terminated */
+        if (numPollFds == 2 && (pollFds[1].revents & POLLIN))
+        {
+            waitPidReturn = waitpid(pid, childExitMethod, 0);
+            break;
+        }
+
+        if (pollFds[0].revents & POLLIN)
+        {
+            read(timerFileDescriptor, &expirations, sizeof(expirations));
+
+            if (pidfd != -1)
+            {
+                pidfdSendSignal(pidfd, signalToSend);
+            }
+            else
+            {
+                kill(pid, signalToSend);
+            }
+            *timedOut = true;
+
+            /* give the child killAfter seconds to exit before SIGKILL */
+            if (signalToSend == SIGTERM)
+            {
+                signalToSend = SIGKILL;
+                armTimer(timerFileDescriptor, killAfter);
+            }
+        }
+    }
+
+    close(timerFileDescriptor);
+    if (pidfd != -1)
+    {
+        close(pidfd);
+    }
+
+    return waitPidReturn;
+}
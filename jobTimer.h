@@ -0,0 +1,79 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines functions for running foreground jobs with a time
+ *              limit including:
+ *
+ *               parsing a duration such as 30, 2.5s, 10m or 1h
+ *               removing a "timeout [-k DURATION] DURATION" prefix from
+ *               the commandline
+ *               waiting on a child with a deadline, escalating from
+ *               SIGTERM to SIGKILL
+ *
+ *              The deadline is a timerfd polled together with a pidfd for
+ *              the child, so no helper timeout(1) process is forked.
+ *
+ **************************************************************************/
+
+#ifndef JOB_TIMER_H
+#define JOB_TIMER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdint.h>      /* for the uint64_t timer expiration count */
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <poll.h>          /* for waiting on the timer and the child together */
+#include <unistd.h>
+#include <sys/types.h>     /* includes pid_t type */
+#include <sys/wait.h>
+#include <sys/timerfd.h>   /* for timerfd_create and timerfd_settime */
+#include "pidfd.h"         /* for pidfdOpen and pidfdSendSignal */
+
+/* Use to indicate that a job has no time limit */
+#define NO_TIMEOUT 0.0
+
+/* Seconds between sending SIGTERM and SIGKILL to a timed out job */
+#define TIMEOUT_KILL_AFTER 5.0
+
+/* Exit value reported when the timeout builtin is used incorrectly */
+#define TIMEOUT_USAGE_ERROR 125
+
+/* Maximum length of a single word in the timeout prefix */
+#define TIMEOUT_WORD_LENGTH 32
+
+/* Milliseconds between checks on the child when pidfds aren't supported */
+#define TIMEOUT_POLL_FALLBACK 10
+
+/* Converts a duration with an optional s, m, h or d suffix into seconds.
+ * input: the duration: char *
+ * output: the number of seconds or -1 if the duration isn't valid
+ */
+double parseDuration(char *durationStr);
+
+/* Removes "timeout [-k KILLDURATION] DURATION " from the start of the
+ * commandline, leaving just the command to be run.
+ * input: the $$ expanded commandline starting with "timeout": char[]
+ *        set to the DURATION in seconds: double &
+ *        set to the KILLDURATION in seconds if -k is given: double &
+ * output: 0 if successful or -1 if the prefix isn't valid
+ */
+int stripTimeoutPrefix(char commandLine[], double *timeout, double *killAfter);
+
+/* Waits for the child to finish. If it is still running after timeout
+ * seconds it is sent SIGTERM and then, killAfter seconds later, SIGKILL.
+ * A timeout of NO_TIMEOUT waits without a time limit.
+ * input: the child process id: pid_t
+ *        the status returned from waitpid: int &
+ *        the time limit in seconds: double
+ *        the seconds between SIGTERM and SIGKILL: double
+ *        set to true if the child was signaled for timing out: bool &
+ * output: the return value of waitpid()
+ */
+pid_t waitWithTimeout(pid_t pid, int *childExitMethod, double timeout,
+                      double killAfter, bool *timedOut);
+
+#endif
@@ -0,0 +1,583 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the launcher helper, which forks and execs
+ *              foreground commands for the shell, including:
+ *
+ *               forking the helper at startup with a socketpair to it
+ *               building a request of the args, the environment if it has
+ *               changed and the redirections, and sending it with fds 0 -
+ *               2, the working directory and the redirected files
+ *               the helper's loop, which forks each command, sets up its
+ *               fds, directory and signals in the child and execs it,
+ *               then sends back its PID and its wait status
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 24, 57
+ *  and 61.13.3 and man pages unix(7) and cmsg(3)
+ *
+ **************************************************************************/
+
+#include "launcher.h"
+#include "bashShell.h"  /* for execCommand and struct command */
+
+extern char **environ;
+
+/* The space for the fds of a message */
+#define LAUNCH_CONTROL_SIZE CMSG_SPACE(sizeof(int) * LAUNCH_MAX_FDS)
+
+/* Copies strings into a message one after another, each ended by '\0'
+ * output: the offset after the last string, or -1 if they don't fit
+ */
+static int appendStrings(char *message, int offset, char **strings, int count)
+{
+    size_t length;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        length = strlen(strings[i]) + 1;
+        if (length > (size_t)(LAUNCH_MESSAGE_SIZE - offset))
+        {
+            return -1;
+        }
+        memcpy(message + offset, strings[i], length);
+        offset += length;
+    }
+
+    return offset;
+}
+
+/* Points an array at the strings of a message, which are ended by '\0'
+ * output: the array, ended by NULL
+ */
+static char **splitStrings(char *strings, int length)
+{
+    char **array;
+    int count = 0;
+    int i;
+
+    for (i = 0; i < length; i++)
+    {
+        count += (strings[i] == '\0');
+    }
+
+    array = malloc((count + 1) * sizeof(char *));
+    if (array == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        array[i] = strings;
+        strings += strlen(strings) + 1;
+    }
+    array[i] = NULL;
+
+    return array;
+}
+
+/* Counts the strings of an array ended by NULL */
+static int countStrings(char **strings)
+{
+    int count = 0;
+
+    while (strings[count] != NULL)
+    {
+        count++;
+    }
+
+    return count;
+}
+
+/* Returns true if the environment isn't the one the helper was forked
+ * with. setenv and putenv replace the pointer of a variable they change,
+ * so comparing the pointers finds any change.
+ */
+static bool environmentChanged(struct launcher *launcher)
+{
+    int i;
+
+    if (environ != launcher->environment)
+    {
+        return true;
+    }
+
+    for (i = 0; i < launcher->environmentCount; i++)
+    {
+        if (environ[i] != launcher->environmentCopy[i])
+        {
+            return true;
+        }
+    }
+
+    return environ[i] != NULL;
+}
+
+/* Sends a reply to the shell. If the shell has gone the helper exits. */
+static void sendReply(int socketFd, pid_t pid, int status, bool exited)
+{
+    struct launchReply reply = {0};
+
+    reply.pid = pid;
+    reply.status = status;
+    reply.exited = exited;
+
+    if (send(socketFd, &reply, sizeof(reply), MSG_NOSIGNAL) == -1)
+    {
+        _exit(0);
+    }
+}
+
+/* Runs a request in the child the helper forked for it. Only returns if
+ * the command couldn't be run.
+ */
+static void runRequest(char *message, int fds[], int numFds)
+{
+    struct launchRequest *request = (struct launchRequest *)message;
+    struct launchRedirection *sent;
+    struct redirection *entry;
+    struct command command;
+    char *strings = message + sizeof(struct launchRequest);
+    int i;
+
+    initializeCommand(&command, NO_TIMEOUT);
+    command.inBackground = request->inBackground;
+
+    /* The args and the environment point into the message */
+    command.args = splitStrings(strings, request->argsLength);
+    command.numArgs = request->numArgs;
+    if (request->environmentLength > 0)
+    {
+        environ = splitStrings(strings + request->argsLength, request->environmentLength);
+    }
+
+    /* The command starts with the shell's fds 0 - 2 and directory as they
+     * are now, rather than as they were when the helper was forked
+     */
+    for (i = 0; i < 3; i++)
+    {
+        if (fds[i] != i && dup2(fds[i], i) == -1)
+        {
+            perror("dup2");
+            return;
+        }
+    }
+    if (fchdir(fds[3]) == -1)
+    {
+        perror("fchdir");
+        return;
+    }
+
+    /* The files were opened by the shell, so the redirections only have
+     * to be applied
+     */
+    for (i = 0; i < request->numRedirections; i++)
+    {
+        sent = &request->redirections[i];
+        entry = &command.redirections.entries[i];
+
+        entry->fd = sent->fd;
+        entry->type = sent->type;
+        entry->fileName = NULL;
+        if (sent->type == redirectDuplicate)
+        {
+            entry->sourceFd = sent->source;
+        }
+        else if (sent->source < numFds)
+        {
+            entry->sourceFd = fds[sent->source];
+        }
+        else
+        {
+            return;
+        }
+    }
+    command.redirections.count = request->numRedirections;
+
+    execCommand(&command);
+}
+
+/* Receives a request and its fds
+ * output: the number of fds, or -1 if the shell has closed the socket
+ */
+static int receiveRequest(int socketFd, char *message, int fds[])
+{
+    union
+    {
+        char buffer[LAUNCH_CONTROL_SIZE];
+        struct cmsghdr align;
+    } control;
+    struct msghdr header = {0};
+    struct cmsghdr *controlHeader;
+    struct iovec vector;
+    ssize_t length;
+    int numFds = 0;
+
+    vector.iov_base = message;
+    vector.iov_len = LAUNCH_MESSAGE_SIZE;
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+    header.msg_control = control.buffer;
+    header.msg_controllen = sizeof(control.buffer);
+
+    do
+    {
+        length = recvmsg(socketFd, &header, MSG_CMSG_CLOEXEC);
+    } while (length == -1 && errno == EINTR);
+
+    if (length <= 0)
+    {
+        return -1;
+    }
+
+    for (controlHeader = CMSG_FIRSTHDR(&header); controlHeader != NULL;
+         controlHeader = CMSG_NXTHDR(&header, controlHeader))
+    {
+        if (controlHeader->cmsg_level == SOL_SOCKET && controlHeader->cmsg_type == SCM_RIGHTS)
+        {
+            numFds = (controlHeader->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            memcpy(fds, CMSG_DATA(controlHeader), numFds * sizeof(int));
+        }
+    }
+
+    /* A request cut short can't be run */
+    if ((size_t)length < sizeof(struct launchRequest) || (header.msg_flags & MSG_TRUNC))
+    {
+        while (numFds > 0)
+        {
+            numFds--;
+            close(fds[numFds]);
+        }
+    }
+
+    return numFds;
+}
+
+/* The helper's loop, which launches each request and waits for it before
+ * taking the next, since the shell waits for its foreground commands.
+ * Never returns.
+ */
+static void runHelper(int socketFd)
+{
+    struct sigaction ignoreAction = {0};
+    struct sigaction defaultAction = {0};
+    char *message;
+    int fds[LAUNCH_MAX_FDS];
+    int numFds;
+    int status;
+    pid_t spawnPid;
+    int i;
+
+    /* ^C and ^Z are for the command and the shell, and the helper waits
+     * for its children itself
+     */
+    ignoreAction.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &ignoreAction, NULL);
+    sigaction(SIGTSTP, &ignoreAction, NULL);
+    defaultAction.sa_handler = SIG_DFL;
+    sigaction(SIGCHLD, &defaultAction, NULL);
+
+    message = malloc(LAUNCH_MESSAGE_SIZE);
+    if (message == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        _exit(1);
+    }
+
+    while ((numFds = receiveRequest(socketFd, message, fds)) != -1)
+    {
+        spawnPid = -1;
+        status = EINVAL;
+
+        if (numFds >= LAUNCH_BASE_FDS && (spawnPid = fork()) == -1)
+        {
+            status = errno;
+        }
+
+        if (spawnPid == 0)
+        {
+            runRequest(message, fds, numFds);
+            exit(1);
+        }
+
+        /* The child has its own copies of the fds */
+        for (i = 0; i < numFds; i++)
+        {
+            close(fds[i]);
+        }
+
+        sendReply(socketFd, spawnPid, status, false);
+        if (spawnPid == -1)
+        {
+            continue;
+        }
+
+        while (waitpid(spawnPid, &status, 0) == -1 && errno == EINTR)
+        {
+        }
+        sendReply(socketFd, spawnPid, status, true);
+    }
+
+    _exit(0);
+}
+
+/* Initializes a launcher that isn't running */
+void initializeLauncher(struct launcher *launcher)
+{
+    launcher->socket = -1;
+    launcher->pid = -1;
+    launcher->environment = NULL;
+    launcher->environmentCopy = NULL;
+    launcher->environmentCount = 0;
+    launcher->message = NULL;
+}
+
+/* Forks the helper with a socketpair to it. SOCK_SEQPACKET keeps each
+ * request a message of its own, so a request is read whole or not at all.
+ */
+int startLauncher(struct launcher *launcher)
+{
+    int socketFds[2];
+    pid_t spawnPid;
+
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, socketFds) == -1)
+    {
+        perror("socketpair");
+        return -1;
+    }
+
+    /* the helper would write out anything left in the buffers again */
+    fflush(stdout);
+    fflush(stderr);
+
+    spawnPid = fork();
+    if (spawnPid == -1)
+    {
+        perror("Error creating fork\n");
+        close(socketFds[0]);
+        close(socketFds[1]);
+        return -1;
+    }
+
+    if (spawnPid == 0)
+    {
+        close(socketFds[0]);
+        runHelper(socketFds[1]);
+    }
+
+    close(socketFds[1]);
+    launcher->socket = socketFds[0];
+    launcher->pid = spawnPid;
+
+    launcher->message = malloc(LAUNCH_MESSAGE_SIZE);
+    launcher->environmentCount = countStrings(environ);
+    launcher->environmentCopy = malloc((launcher->environmentCount + 1) * sizeof(char *));
+    if (launcher->message == NULL || launcher->environmentCopy == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+    memcpy(launcher->environmentCopy, environ, (launcher->environmentCount + 1) * sizeof(char *));
+    launcher->environment = environ;
+
+    return 0;
+}
+
+/* Closes the socket and frees the launcher, leaving the helper running */
+void releaseLauncher(struct launcher *launcher)
+{
+    if (launcher->socket != -1)
+    {
+        close(launcher->socket);
+    }
+
+    free(launcher->message);
+    free(launcher->environmentCopy);
+    initializeLauncher(launcher);
+}
+
+/* Closes the socket, which the helper reads as the end of its requests,
+ * and waits for it to exit
+ */
+void stopLauncher(struct launcher *launcher)
+{
+    pid_t helperPid = launcher->pid;
+
+    releaseLauncher(launcher);
+
+    if (helperPid > 0)
+    {
+        while (waitpid(helperPid, NULL, 0) == -1 && errno == EINTR)
+        {
+        }
+    }
+}
+
+/* Receives a reply of the helper
+ * output: 0 if successful or -1 if the helper has gone
+ */
+static int receiveReply(struct launcher *launcher, struct launchReply *reply)
+{
+    ssize_t length;
+
+    do
+    {
+        length = recv(launcher->socket, reply, sizeof(*reply), 0);
+    } while (length == -1 && errno == EINTR);
+
+    if (length != sizeof(*reply))
+    {
+        fprintf(stderr, "launcher: helper has exited, forking commands in the shell\n");
+        stopLauncher(launcher);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Builds a request for the command and sends it with its fds, then reads
+ * back the PID the helper forked
+ */
+pid_t launchWithHelper(struct launcher *launcher, struct command *command)
+{
+    struct launchRequest *request;
+    struct redirection *entry;
+    struct launchReply reply;
+    union
+    {
+        char buffer[LAUNCH_CONTROL_SIZE];
+        struct cmsghdr align;
+    } control;
+    struct msghdr header = {0};
+    struct cmsghdr *controlHeader;
+    struct iovec vector;
+    int fds[LAUNCH_MAX_FDS];
+    int numFds;
+    int offset;
+    int start;
+    ssize_t sent;
+    int i;
+
+    if (launcher->socket == -1)
+    {
+        return -1;
+    }
+
+    request = (struct launchRequest *)launcher->message;
+    memset(request, 0, sizeof(*request));
+    request->numArgs = command->numArgs;
+    request->inBackground = command->inBackground;
+
+    /* The args, then the environment if the helper doesn't have it */
+    offset = appendStrings(launcher->message, sizeof(*request), command->args, command->numArgs);
+    if (offset == -1)
+    {
+        return -1;
+    }
+    request->argsLength = offset - sizeof(*request);
+
+    if (environmentChanged(launcher))
+    {
+        start = offset;
+        offset = appendStrings(launcher->message, offset, environ, countStrings(environ));
+        if (offset == -1)
+        {
+            return -1;
+        }
+        request->environmentLength = offset - start;
+    }
+
+    /* fds 0 - 2 and the directory, then each opened file of the table */
+    for (numFds = 0; numFds < 3; numFds++)
+    {
+        fds[numFds] = numFds;
+    }
+    fds[numFds] = open(".", O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (fds[numFds] == -1)
+    {
+        return -1;
+    }
+    numFds++;
+
+    request->numRedirections = command->redirections.count;
+    for (i = 0; i < command->redirections.count; i++)
+    {
+        entry = &command->redirections.entries[i];
+        request->redirections[i].fd = entry->fd;
+        request->redirections[i].type = entry->type;
+
+        if (entry->type == redirectDuplicate)
+        {
+            request->redirections[i].source = entry->sourceFd;
+        }
+        else
+        {
+            request->redirections[i].source = numFds;
+            fds[numFds] = entry->sourceFd;
+            numFds++;
+        }
+    }
+
+    vector.iov_base = launcher->message;
+    vector.iov_len = offset;
+    header.msg_iov = &vector;
+    header.msg_iovlen = 1;
+    header.msg_control = control.buffer;
+    header.msg_controllen = CMSG_SPACE(sizeof(int) * numFds);
+    controlHeader = CMSG_FIRSTHDR(&header);
+    controlHeader->cmsg_level = SOL_SOCKET;
+    controlHeader->cmsg_type = SCM_RIGHTS;
+    controlHeader->cmsg_len = CMSG_LEN(sizeof(int) * numFds);
+    memcpy(CMSG_DATA(controlHeader), fds, sizeof(int) * numFds);
+
+    do
+    {
+        sent = sendmsg(launcher->socket, &header, MSG_NOSIGNAL);
+    } while (sent == -1 && errno == EINTR);
+    close(fds[3]);
+
+    /* A message too large for the socket is forked by the shell, while
+     * any other failure means the helper has gone
+     */
+    if (sent == -1)
+    {
+        if (errno != EMSGSIZE && errno != ENOBUFS && errno != EBADF)
+        {
+            fprintf(stderr, "launcher: helper has exited, forking commands in the shell\n");
+            stopLauncher(launcher);
+        }
+        return -1;
+    }
+
+    if (receiveReply(launcher, &reply) == -1)
+    {
+        return -1;
+    }
+
+    return reply.pid;
+}
+
+/* Waits for the reply the helper sends when the command ends */
+void waitForHelper(struct launcher *launcher, pid_t pid, int *status)
+{
+    struct launchReply reply;
+
+    while (launcher->socket != -1)
+    {
+        if (receiveReply(launcher, &reply) == -1)
+        {
+            break;
+        }
+
+        if (reply.exited == true && reply.pid == pid)
+        {
+            *status = reply.status;
+            return;
+        }
+    }
+
+    /* The command's status went with the helper */
+    *status = W_EXITCODE(1, 0);
+}
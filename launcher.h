@@ -0,0 +1,150 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the launcher helper, which forks and execs
+ *              foreground commands for the shell, including:
+ *
+ *               forking the helper with -L at startup, while the shell is
+ *               still small
+ *               sending it each command over a socketpair, with the args,
+ *               the environment if it has changed, the working directory,
+ *               fds 0 - 2 and the opened files of the redirections, which
+ *               are passed with SCM_RIGHTS
+ *               the helper forking and execing the command and sending
+ *               back its PID, then its wait status once it has ended
+ *
+ *              A fork copies the page tables of the process that calls
+ *              it, so the time the shell takes to launch a command grows
+ *              with its history, caches and job table. The helper forks
+ *              from its own few pages instead, so a launch costs the same
+ *              however large the shell has become.
+ *
+ *              Only foreground commands without a time limit go through
+ *              the helper. Background jobs and jobs with a time limit are
+ *              forked by the shell, since the job table and the timer wait
+ *              on the shell's own children. A command the helper can't
+ *              take, such as one whose arguments don't fit a message, is
+ *              forked by the shell as well.
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 57 and
+ *  61.13.3 and man page unix(7)
+ *
+ **************************************************************************/
+
+#ifndef LAUNCHER_H
+#define LAUNCHER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "redirection.h"  /* for the redirection table sent with a command */
+
+/* The largest message the helper takes: the request, the args and the
+ * environment. A command that needs more is forked by the shell.
+ */
+#define LAUNCH_MESSAGE_SIZE (128 * 1024)
+
+/* The fds sent with a command: fds 0 - 2, the working directory and one
+ * for each redirection
+ */
+#define LAUNCH_BASE_FDS 4
+#define LAUNCH_MAX_FDS (LAUNCH_BASE_FDS + MAX_REDIRECTIONS)
+
+struct command;
+
+/* A redirection of a command sent to the helper */
+struct launchRedirection
+{
+    enum redirectionType type;
+    int fd;  /* the fd of the command that is redirected */
+    int source;  /* the index of the sent fd it is set to, or M for N>&M */
+};
+
+/* The fixed part of a request, which the args and the environment follow */
+struct launchRequest
+{
+    int numArgs;
+    int argsLength;  /* the bytes of the args, each ended by '\0' */
+    int environmentLength;  /* the bytes of the environment, or 0 if unchanged */
+    bool inBackground;  /* true if the command ignores SIGINT */
+    int numRedirections;
+    struct launchRedirection redirections[MAX_REDIRECTIONS];
+};
+
+/* A reply of the helper: the PID of a command it has launched, then its
+ * wait status once it has ended
+ */
+struct launchReply
+{
+    pid_t pid;  /* the command's PID, or -1 if it couldn't be forked */
+    int status;  /* the wait status, or the errno of a failed fork */
+    bool exited;  /* true for the reply sent when the command has ended */
+};
+
+/* The shell's end of the helper */
+struct launcher
+{
+    int socket;  /* -1 if the shell forks its commands itself */
+    pid_t pid;
+
+    /* The environment the helper was forked with, so a command is only
+     * sent the environment if it has changed since
+     */
+    char **environment;
+    char **environmentCopy;
+    int environmentCount;
+
+    char *message;  /* the buffer a request is built in */
+};
+
+/* Initializes a launcher that isn't running, so commands are forked by
+ * the shell.
+ * input: the launcher: struct launcher *
+ */
+void initializeLauncher(struct launcher *launcher);
+
+/* Forks the helper. It is best called before the shell allocates much.
+ * input: the launcher: struct launcher *
+ * output: 0 if the helper is running or -1 after printing an error, when
+ *         commands go on being forked by the shell
+ */
+int startLauncher(struct launcher *launcher);
+
+/* Closes the socket, which ends the helper, and waits for it.
+ * input: the launcher: struct launcher *
+ */
+void stopLauncher(struct launcher *launcher);
+
+/* Closes a copy of the shell's end of the socket without ending the
+ * helper, as in a child of the shell that goes on running commands, so
+ * its requests and replies aren't mixed up with the shell's.
+ * input: the launcher: struct launcher *
+ */
+void releaseLauncher(struct launcher *launcher);
+
+/* Sends a command whose redirections have been opened to the helper,
+ * which forks and execs it.
+ * input: the launcher: struct launcher *
+ *        the command: struct command *
+ * output: the PID of the command, or -1 if the helper couldn't launch it
+ *         and the shell should fork it itself
+ */
+pid_t launchWithHelper(struct launcher *launcher, struct command *command);
+
+/* Waits for a command launched by the helper to end. If the helper has
+ * gone the launcher is stopped and the command reported as failed.
+ * input: the launcher: struct launcher *
+ *        the PID returned by launchWithHelper: pid_t
+ *        where to store the wait status: int *
+ */
+void waitForHelper(struct launcher *launcher, pid_t pid, int *status);
+
+#endif
@@ -0,0 +1,289 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the io_uring used to open several files with a
+ *              single system call including:
+ *
+ *               setting up the ring the first time it is used
+ *               opening a list of files as a chain of IORING_OP_OPENAT
+ *               requests, where a failed open cancels those after it
+ *               reporting that io_uring can't be used, so the caller can
+ *               open the files itself
+ *
+ *  Reference: man pages io_uring_setup(2), io_uring_enter(2) and
+ *  https://kernel.dk/io_uring.pdf
+ *
+ **************************************************************************/
+
+#include "openRing.h"
+#include "bashShell.h"
+
+/* The ring of the process, which is shared by the threads of any embedded
+ * sessions under the mutex
+ */
+static struct openRing ring = { .fd = -1 };
+static pthread_mutex_t ringMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Unmaps the rings and closes the io_uring fd. Closing the fd cancels any
+ * requests that haven't completed.
+ */
+static void releaseRing(void)
+{
+    if (ring.sqes != NULL)
+    {
+        munmap(ring.sqes, ring.sqesSize);
+    }
+
+    if (ring.cqMemory != NULL && ring.cqMemory != ring.sqMemory)
+    {
+        munmap(ring.cqMemory, ring.cqSize);
+    }
+
+    if (ring.sqMemory != NULL)
+    {
+        munmap(ring.sqMemory, ring.sqSize);
+    }
+
+    if (ring.fd != -1)
+    {
+        close(ring.fd);
+    }
+
+    ring.fd = -1;
+    ring.sqMemory = NULL;
+    ring.cqMemory = NULL;
+    ring.sqes = NULL;
+}
+
+/* Maps a region of the io_uring fd, returning NULL if it can't be */
+static void *mapRing(size_t size, off_t offset)
+{
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring.fd, offset);
+
+    return (memory == MAP_FAILED) ? NULL : memory;
+}
+
+/* Sets up the ring if this process hasn't yet. Returns -1 if io_uring can't
+ * be used, as on kernels before 5.6 or under a seccomp filter, in which case
+ * it isn't tried again.
+ */
+static int setUpRing(void)
+{
+    struct io_uring_params params;
+
+    /* A forked child must not submit to its parent's rings, which it
+     * shares, so it lets go of them and sets up its own
+     */
+    if (ring.fd != -1 && ring.owner != getpid())
+    {
+        releaseRing();
+    }
+
+    if (ring.fd != -1)
+    {
+        return 0;
+    }
+
+    if (ring.unavailable == true)
+    {
+        return -1;
+    }
+
+    memset(&params, 0, sizeof(params));
+    ring.fd = syscall(SYS_io_uring_setup, OPEN_RING_ENTRIES, &params);
+    if (ring.fd == -1)
+    {
+        ring.unavailable = true;
+        return -1;
+    }
+    ring.owner = getpid();
+
+    ring.sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring.sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    /* Kernels from 5.4 map both rings with the one mmap */
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring.cqSize > ring.sqSize)
+        {
+            ring.sqSize = ring.cqSize;
+        }
+        ring.cqSize = ring.sqSize;
+    }
+
+    ring.sqMemory = mapRing(ring.sqSize, IORING_OFF_SQ_RING);
+    if (ring.sqMemory != NULL)
+    {
+        ring.cqMemory = (params.features & IORING_FEAT_SINGLE_MMAP)
+                        ? ring.sqMemory : mapRing(ring.cqSize, IORING_OFF_CQ_RING);
+        ring.sqes = mapRing(ring.sqesSize, IORING_OFF_SQES);
+    }
+
+    if (ring.sqMemory == NULL || ring.cqMemory == NULL || ring.sqes == NULL)
+    {
+        releaseRing();
+        ring.unavailable = true;
+        return -1;
+    }
+
+    ring.sqTail = (unsigned *)((char *)ring.sqMemory + params.sq_off.tail);
+    ring.sqMask = (unsigned *)((char *)ring.sqMemory + params.sq_off.ring_mask);
+    ring.sqArray = (unsigned *)((char *)ring.sqMemory + params.sq_off.array);
+
+    ring.cqHead = (unsigned *)((char *)ring.cqMemory + params.cq_off.head);
+    ring.cqTail = (unsigned *)((char *)ring.cqMemory + params.cq_off.tail);
+    ring.cqMask = (unsigned *)((char *)ring.cqMemory + params.cq_off.ring_mask);
+    ring.cqes = (struct io_uring_cqe *)((char *)ring.cqMemory + params.cq_off.cqes);
+
+    return 0;
+}
+
+/* Submits the entries given and waits for at least the number of
+ * completions given
+ */
+static int enterRing(unsigned toSubmit, unsigned minComplete)
+{
+    return syscall(SYS_io_uring_enter, ring.fd, toSubmit, minComplete,
+                   (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+}
+
+/* Takes the completions in the ring, putting the result of each open in
+ * results, and returns how many there were
+ */
+static int reapCompletions(int results[])
+{
+    unsigned head = *ring.cqHead;
+    unsigned tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+    struct io_uring_cqe *completion;
+    int numReaped = 0;
+
+    while (head != tail)
+    {
+        completion = &ring.cqes[head & *ring.cqMask];
+        results[completion->user_data] = completion->res;
+        ++head;
+        ++numReaped;
+    }
+
+    /* the kernel may reuse the entries once the head has passed them */
+    __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+
+    return numReaped;
+}
+
+/* Opens the files in order with a single io_uring submission. */
+int openFilesLinked(char *paths[], int flags[], int results[], int count)
+{
+    struct io_uring_sqe *entry;
+    unsigned tail;
+    unsigned index;
+    struct timespec pollInterval = { 0, OPEN_RING_POLL_NANOSECONDS };
+    bool waitFailed = false;
+    int submitted;
+    int numReaped = 0;
+    int i;
+
+    if (count < 1 || count > OPEN_RING_ENTRIES)
+    {
+        return -1;
+    }
+
+    pthread_mutex_lock(&ringMutex);
+
+    if (setUpRing() == -1)
+    {
+        pthread_mutex_unlock(&ringMutex);
+        return -1;
+    }
+
+    /* The shell is the only submitter, so the tail can be read plainly */
+    tail = *ring.sqTail;
+
+    for (i = 0; i < count; i++)
+    {
+        index = (tail + i) & *ring.sqMask;
+        entry = &ring.sqes[index];
+
+        memset(entry, 0, sizeof(struct io_uring_sqe));
+        entry->opcode = IORING_OP_OPENAT;
+        entry->fd = AT_FDCWD;
+        entry->addr = (uint64_t)(uintptr_t)paths[i];
+        entry->len = OPEN_RING_MODE;
+        entry->open_flags = flags[i];
+        entry->user_data = i;
+
+        /* Each open waits for the one before it and is cancelled if it
+         * fails, as the opens of a commandline are done in order
+         */
+        if (i < count - 1)
+        {
+            entry->flags = IOSQE_IO_LINK;
+        }
+
+        ring.sqArray[index] = index;
+        results[i] = -ECANCELED;
+    }
+
+    /* the entries must be written before the kernel sees the new tail */
+    __atomic_store_n(ring.sqTail, tail + count, __ATOMIC_RELEASE);
+
+    submitted = enterRing(count, 0);
+    if (submitted < 1)
+    {
+        /* The kernel took none of the entries, so no file was opened and
+         * the opens are left to the caller from then on
+         */
+        releaseRing();
+        ring.unavailable = true;
+        pthread_mutex_unlock(&ringMutex);
+        return -1;
+    }
+
+    numReaped = reapCompletions(results);
+    while (numReaped < submitted)
+    {
+        /* The kernel posts the completions to the ring whether or not the
+         * shell waits in io_uring_enter, so if waiting fails they are
+         * polled for. Closing the ring before they were reaped would leak
+         * the fds of the opens that finished and report them as cancelled.
+         */
+        if (enterRing(0, submitted - numReaped) == -1 && errno != EINTR)
+        {
+            waitFailed = true;
+            nanosleep(&pollInterval, NULL);
+        }
+
+        numReaped += reapCompletions(results);
+    }
+
+    /* Nothing is expected to fail to submit on a ring this size, but if the
+     * kernel took only some of the entries, the files it opened are kept
+     * and the rest are opened here in order, stopping at a failure as the
+     * chain would. Opening them all again would leak the fds and truncate
+     * a file twice.
+     */
+    if (submitted < count)
+    {
+        for (i = submitted; i < count; i++)
+        {
+            results[i] = (results[i - 1] >= 0) ? open(paths[i], flags[i], OPEN_RING_MODE) : -ECANCELED;
+            if (results[i] == -1)
+            {
+                results[i] = -errno;
+            }
+        }
+    }
+
+    /* after a failure the opens are left to the caller from then on */
+    if (submitted < count || waitFailed == true)
+    {
+        releaseRing();
+        ring.unavailable = true;
+    }
+
+    pthread_mutex_unlock(&ringMutex);
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines an io_uring used to open several files with a single
+ *              system call including:
+ *
+ *               setting up the ring the first time it is used
+ *               opening a list of files as a chain of IORING_OP_OPENAT
+ *               requests, where a failed open cancels those after it
+ *               reporting that io_uring can't be used, so the caller can
+ *               open the files itself
+ *
+ *              The ring belongs to the process that set it up. A child
+ *              forked from the shell sets up a ring of its own rather than
+ *              sharing the memory of its parent's.
+ *
+ *  Reference: man pages io_uring_setup(2), io_uring_enter(2) and
+ *  https://kernel.dk/io_uring.pdf
+ *
+ **************************************************************************/
+
+#ifndef OPEN_RING_H
+#define OPEN_RING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>        /* for AT_FDCWD */
+#include <pthread.h>
+#include <time.h>         /* for nanosleep */
+#include <unistd.h>
+#include <sys/mman.h>     /* for mapping the rings */
+#include <sys/types.h>
+#include <sys/syscall.h>  /* for SYS_io_uring_setup and SYS_io_uring_enter */
+#include <linux/io_uring.h>
+
+/* The most files opened with one submission, which is the most
+ * redirections a commandline can have
+ */
+#define OPEN_RING_ENTRIES 16
+
+/* The mode files are created with, as by the redirections */
+#define OPEN_RING_MODE 0644
+
+/* How often the completions are polled for if waiting for them fails */
+#define OPEN_RING_POLL_NANOSECONDS 100000
+
+/* The mapped rings of the process's io_uring */
+struct openRing
+{
+    int fd;  /* the io_uring fd, or -1 if it isn't set up */
+    pid_t owner;  /* the process that set it up */
+    bool unavailable;  /* true once setting it up has failed */
+
+    /* The submission queue: the ring of indexes and the array of entries
+     * they index
+     */
+    void *sqMemory;
+    size_t sqSize;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+
+    /* The completion queue, which may share the submission queue's memory */
+    void *cqMemory;
+    size_t cqSize;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+};
+
+/* Opens the files in order with a single io_uring submission. The opens are
+ * linked, so one that fails cancels the rest and no file after it is
+ * created or truncated.
+ * input: the file names: char *[]
+ *        the open flags of each file: int []
+ *        the array to put the fd of each file in, or -errno if it wasn't
+ *        opened: int []
+ *        the number of files, at most OPEN_RING_ENTRIES: int
+ * output: 0 if the opens were run, or -1 if io_uring can't be used and no
+ *         file was opened. If the kernel takes only some of the opens, the
+ *         rest are opened with open and 0 is returned.
+ */
+int openFilesLinked(char *paths[], int flags[], int results[], int count);
+
+#endif
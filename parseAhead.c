@@ -0,0 +1,436 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the parse-ahead producer thread and the functions
+ *              for running commands it has parsed including:
+ *
+ *               reading, $$ expanding and parsing commandlines on a
+ *               producer thread while the shell waits on a command
+ *               passing parsed commands to the shell through a single
+ *               producer single consumer ring
+ *               stopping the producer at inbuilt commands until they
+ *               have run, so they act as barriers
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 29, 30,
+ *  33 and 53
+ *
+ **************************************************************************/
+
+#include "parseAhead.h"
+#include "bashShell.h"  /* for the shell state, parseListCommand and launchCommand */
+
+/* Waits on the semaphore, restarting if a signal interrupts the wait */
+static void waitSemaphore(sem_t *semaphore)
+{
+    while (sem_wait(semaphore) == -1 && errno == EINTR)
+    {
+        continue;
+    }
+}
+
+/* Creates an item of the kind, copying the text if there is any */
+static struct aheadItem *newAheadItem(enum aheadKind kind, enum connector connector, char *text)
+{
+    struct aheadItem *item = malloc(sizeof(struct aheadItem));
+
+    if (item == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    item->kind = kind;
+    item->connector = connector;
+    item->barrier = false;
+    item->command = NULL;
+    item->hereFileDescriptor = -1;
+    item->text = NULL;
+    item->lastLine = false;
+
+    if (text != NULL)
+    {
+        item->text = getEmptyString(strlen(text) + 1);
+        strcpy(item->text, text);
+    }
+
+    return item;
+}
+
+/* Frees an item, closing the memory file of its here-document. */
+void freeAheadItem(struct aheadItem *item)
+{
+    if (item->command != NULL)
+    {
+        freeCommand(item->command);
+        free(item->command);
+    }
+
+    if (item->hereFileDescriptor != -1)
+    {
+        close(item->hereFileDescriptor);
+    }
+
+    free(item->text);
+    free(item);
+}
+
+/* Puts the item in the ring, waiting while the ring is full. A barrier item
+ * isn't returned from until the shell has run it. Returns false, with the
+ * item freed if it wasn't put in the ring, once the shell has stopped the
+ * producer.
+ */
+static bool pushAheadItem(struct parseAhead *ahead, struct aheadItem *item)
+{
+    struct aheadRing *ring = &ahead->ring;
+    bool barrier = item->barrier;  /* the shell may free the item once it's taken */
+
+    waitSemaphore(&ring->freeSlots);
+
+    /* stopParseAhead posts a free slot to wake the producer even when the
+     * ring is full, so the slot at the tail may still hold an item the
+     * shell hasn't taken
+     */
+    if (atomic_load(&ahead->stopRequested) == true)
+    {
+        freeAheadItem(item);
+        return false;
+    }
+
+    ring->slots[ring->tail % AHEAD_RING_SIZE] = item;
+    ++ring->tail;
+
+    /* the post publishes the slot to the shell */
+    sem_post(&ring->filledSlots);
+
+    if (barrier == true)
+    {
+        waitSemaphore(&ahead->barrierDone);
+    }
+
+    return (atomic_load(&ahead->stopRequested) == false);
+}
+
+/* Waits for and takes the next item from the ring. */
+struct aheadItem *takeAheadItem(struct parseAhead *ahead)
+{
+    struct aheadRing *ring = &ahead->ring;
+    struct aheadItem *item;
+
+    waitSemaphore(&ring->filledSlots);
+
+    item = ring->slots[ring->head % AHEAD_RING_SIZE];
+    ++ring->head;
+
+    sem_post(&ring->freeSlots);
+
+    return item;
+}
+
+/* Lets the producer go on after a barrier item has run. */
+void releaseAheadBarrier(struct parseAhead *ahead)
+{
+    sem_post(&ahead->barrierDone);
+}
+
+/* Parses a command of a list into an item. A here-document body is read
+ * now, since the producer owns the input, and its memory file is made so
+ * the shell only has to fork.
+ */
+static struct aheadItem *parseAheadItem(struct shellState *shell, char *text, enum connector connector)
+{
+    struct aheadItem *item;
+    struct command *command;
+    char commandCopy[MAX_COMMAND_LINE_EXPANDED];  /* parseListCommand splits up the command */
+    enum lineType type = classifyCommandLine(text);
+
+    command = malloc(sizeof(struct command));
+    if (command == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    strcpy(commandCopy, text);
+    initializeCommand(command, shell->jobDeadline);
+
+    /* Inbuilt commands and commands that don't parse are run from their
+     * text by runListCommand, which prints any errors in order with the
+     * output of the commands around them. Inbuilt commands can change what
+     * later commands do, such as cd or exit, so they are barriers. So is
+     * a command with a here-document, such as one with $(...), since the
+     * shell reads its body from the input when it runs, and the producer
+     * mustn't read past it first.
+     */
+    if (parseListCommand(commandCopy, command) == false)
+    {
+        freeCommand(command);
+        free(command);
+
+        item = newAheadItem(aheadListCommand, connector, text);
+        item->barrier = (type != externalLine || hasHereDocument(text));
+        return item;
+    }
+
+    item = newAheadItem(aheadCommand, connector, NULL);
+    item->command = command;
+
+    if (command->hereType == hereDocument)
+    {
+        item->hereFileDescriptor = createHereDocument(shell->input, command->hereWord, shell->parentPID);
+
+        /* a command without its here-document is not run */
+        if (item->hereFileDescriptor == -1
+            || addRedirection(&command->redirections, 0, redirectDescriptor, NULL,
+                              item->hereFileDescriptor) == -1)
+        {
+            freeCommand(command);
+            free(command);
+            item->command = NULL;
+        }
+        else
+        {
+            command->hereType = noHere;
+        }
+    }
+
+    return item;
+}
+
+/* Expands, splits and parses a commandline and puts an item for each of
+ * its commands in the ring. The last item of the last commandline is marked
+ * as such. Returns false if the shell stopped the producer while it waited
+ * at a barrier or on a full ring.
+ */
+static bool produceCommandLine(struct parseAhead *ahead, char *line, bool lastLine)
+{
+    struct shellState *shell = ahead->shell;
+    char bufferExpanded[MAX_COMMAND_LINE_EXPANDED];
+    struct commandList list;
+    struct aheadItem *item;
+    int i;
+
+    /* Comments and lines that are too long or aren't valid lists are run
+     * whole so runCommandLine prints any error.
+     */
+    if (expandString(line, shell->parentPID, bufferExpanded) == commandLineTooLong
+        || classifyCommandLine(bufferExpanded) == commentLine
+        || splitCommandList(bufferExpanded, &list, false) == -1)
+    {
+        item = newAheadItem(aheadCommandLine, connectLine, line);
+        item->lastLine = lastLine;
+        item->barrier = hasHereDocument(line);
+        return pushAheadItem(ahead, item);
+    }
+
+    for (i = 0; i < list.count; i++)
+    {
+        /* a comment after a connector does nothing, as in runCommandLine */
+        if (i > 0 && classifyCommandLine(list.commands[i].text) == commentLine)
+        {
+            continue;
+        }
+
+        item = parseAheadItem(shell, list.commands[i].text, list.commands[i].connector);
+        item->lastLine = (lastLine == true && i == list.count - 1);
+        if (pushAheadItem(ahead, item) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* The producer thread. Reads commandlines until the input ends or the
+ * shell stops it.
+ */
+static void *produceCommands(void *argument)
+{
+    struct parseAhead *ahead = argument;
+    char *line = NULL;  /* the line returned by getline */
+    size_t lineCapacity = 0;
+    bool stopped = false;
+
+    while (stopped == false && getline(&line, &lineCapacity, ahead->shell->input) >= 0)
+    {
+        readBlockLines(ahead->shell->input, &line, &lineCapacity, false);
+        stopped = !produceCommandLine(ahead, line, atEndOfInput(ahead->shell->input));
+    }
+
+    free(line);
+
+    if (stopped == false)
+    {
+        pushAheadItem(ahead, newAheadItem(aheadEnd, connectLine, NULL));
+    }
+
+    return NULL;
+}
+
+/* Starts the producer thread, which reads from the shell's input with all
+ * signals blocked so they are handled by the shell.
+ */
+int startParseAhead(struct parseAhead *ahead, struct shellState *shell)
+{
+    sigset_t allSignals, previousMask;
+    int createReturn;
+
+    ahead->shell = shell;
+    ahead->ring.head = 0;
+    ahead->ring.tail = 0;
+    atomic_init(&ahead->stopRequested, false);
+
+    sem_init(&ahead->ring.filledSlots, 0, 0);
+    sem_init(&ahead->ring.freeSlots, 0, AHEAD_RING_SIZE);
+    sem_init(&ahead->barrierDone, 0, 0);
+
+    /* The thread inherits the signal mask, so block everything while it is
+     * created and then restore the shell's mask.
+     * Reference: The Linux Programming Interface by Kerrisk pg 683
+     */
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &previousMask);
+    createReturn = pthread_create(&ahead->producer, NULL, produceCommands, ahead);
+    pthread_sigmask(SIG_SETMASK, &previousMask, NULL);
+
+    if (createReturn != 0)
+    {
+        sem_destroy(&ahead->ring.filledSlots);
+        sem_destroy(&ahead->ring.freeSlots);
+        sem_destroy(&ahead->barrierDone);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Stops the producer thread, frees any items left in the ring and destroys
+ * the semaphores.
+ */
+void stopParseAhead(struct parseAhead *ahead)
+{
+    struct aheadItem *item;
+
+    atomic_store(&ahead->stopRequested, true);
+
+    /* wake the producer whether it waits at a barrier or on a full ring */
+    sem_post(&ahead->barrierDone);
+    sem_post(&ahead->ring.freeSlots);
+
+    pthread_join(ahead->producer, NULL);
+
+    /* The producer has ended, so the items the shell hasn't taken are the
+     * ones from the head to the tail
+     */
+    while (ahead->ring.head != ahead->ring.tail)
+    {
+        item = ahead->ring.slots[ahead->ring.head % AHEAD_RING_SIZE];
+        ++ahead->ring.head;
+        freeAheadItem(item);
+    }
+
+    sem_destroy(&ahead->ring.filledSlots);
+    sem_destroy(&ahead->ring.freeSlots);
+    sem_destroy(&ahead->barrierDone);
+}
+
+/* Reads and runs commandlines from the shell's input with parse-ahead until
+ * the user exits or the input ends.
+ */
+int runShellAhead(struct shellState *shell)
+{
+    struct parseAhead ahead;
+    struct aheadItem *item;
+
+    if (startParseAhead(&ahead, shell) == -1)
+    {
+        return -1;
+    }
+
+    while (shell->exitRequested == false)
+    {
+        item = takeAheadItem(&ahead);
+
+        /* As in runShell, finished background jobs are reported, scheduled
+         * commands that are due are run and the prompt is printed before
+         * each commandline
+         */
+        if (item->connector == connectLine)
+        {
+            reapBackgroundJobs(shell);
+            runDueEntries(shell);
+            fflush(stdout);
+            if (shell->prompt == true)
+            {
+                printf(": ");
+            }
+        }
+
+        /* The first command of a line always runs. A command after && or ||
+         * that is skipped already had its here-document read.
+         */
+        if (listCommandRuns(item->connector, shell->lastStatus))
+        {
+            switch (item->kind)
+            {
+                case aheadCommand:
+                {
+                    if (item->command != NULL)
+                    {
+                        shell->tailCommand = item->lastLine;
+                        launchCommand(shell, item->command);
+                        shell->tailCommand = false;
+                    }
+                    else
+                    {
+                        sprintf(shell->exitStatusStr,"exit value %d",1);
+                        shell->lastStatus = 1;
+                    }
+                    break;
+                }
+                case aheadListCommand:
+                {
+                    shell->tailCommand = item->lastLine;
+                    runListCommand(shell, item->text);
+                    shell->tailCommand = false;
+                    break;
+                }
+                case aheadCommandLine:
+                {
+                    shell->lastLine = item->lastLine;
+                    runCommandLine(shell, item->text);
+                    shell->lastLine = false;
+                    break;
+                }
+                case aheadEnd:
+                {
+                    /* the input has ended so exit as if the user entered
+                     * "exit", once the scheduled commands are done
+                     */
+                    runScheduleToEnd(shell);
+                    exitShell(shell);
+                    break;
+                }
+            }
+        }
+
+        /* The producer waits at the barrier of an exit, so it is told to
+         * stop before it is let go rather than reading on.
+         */
+        if (shell->exitRequested == true)
+        {
+            atomic_store(&ahead.stopRequested, true);
+        }
+
+        if (item->barrier == true)
+        {
+            releaseAheadBarrier(&ahead);
+        }
+
+        freeAheadItem(item);
+    }
+
+    stopParseAhead(&ahead);
+
+    return 0;
+}
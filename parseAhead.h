@@ -0,0 +1,143 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the parse-ahead producer thread and the functions
+ *              for running commands it has parsed including:
+ *
+ *               reading, $$ expanding and parsing commandlines on a
+ *               producer thread while the shell waits on a command
+ *               passing parsed commands to the shell through a single
+ *               producer single consumer ring
+ *               stopping the producer at inbuilt commands until they
+ *               have run, so they act as barriers
+ *
+ *              Parse-ahead is used when commandlines don't come from a
+ *              terminal, so the next command can be forked as soon as the
+ *              last one exits.
+ *
+ **************************************************************************/
+
+#ifndef PARSE_AHEAD_H
+#define PARSE_AHEAD_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <pthread.h>     /* for the producer thread */
+#include <semaphore.h>   /* for sleeping while the ring is empty or full */
+#include <stdatomic.h>   /* for the flag that stops the producer */
+#include "commandList.h" /* for the connector of each command */
+
+/* The number of parsed commands the ring holds, which is a power of 2 */
+#define AHEAD_RING_SIZE 64
+
+/* The kind of an item in the ring:
+ * aheadCommand      a parsed command that is ready to launch
+ * aheadListCommand  an inbuilt command of a list or a command that
+ *                   doesn't parse, run with runListCommand
+ * aheadCommandLine  a whole commandline run with runCommandLine, used for
+ *                   comments and lines that are too long or not valid lists
+ * aheadEnd          the input has ended
+ */
+enum aheadKind{ aheadCommand, aheadListCommand, aheadCommandLine, aheadEnd};
+
+struct command;
+struct shellState;
+
+/* A commandline or command read and parsed by the producer */
+struct aheadItem
+{
+    enum aheadKind kind;
+    enum connector connector;
+
+    /* true if the producer waits for the item to run before going on */
+    bool barrier;
+
+    /* the parsed command of an aheadCommand, with the memory file of its
+     * here-document already made, or NULL
+     */
+    struct command *command;
+    int hereFileDescriptor;
+
+    /* the text of an aheadListCommand or aheadCommandLine, or NULL */
+    char *text;
+
+    /* true if the item is the last of the input, so its command can be
+     * exec'd in place of the shell
+     */
+    bool lastLine;
+};
+
+/* A ring of items passed from the producer to the shell. Each index is
+ * only changed by one thread. The semaphores count the filled and free
+ * slots; sem_post and sem_wait are atomic operations that only make a
+ * system call when the ring is empty or full, so passing an item doesn't
+ * take a lock.
+ */
+struct aheadRing
+{
+    struct aheadItem *slots[AHEAD_RING_SIZE];
+    unsigned int head;  /* the next slot the shell takes, only used by the shell */
+    unsigned int tail;  /* the next slot the producer fills, only used by the producer */
+    sem_t filledSlots;
+    sem_t freeSlots;
+};
+
+/* The state shared by the shell and the producer */
+struct parseAhead
+{
+    struct aheadRing ring;
+    pthread_t producer;
+
+    /* posted by the shell after it runs a barrier item */
+    sem_t barrierDone;
+
+    /* set by the shell to tell the producer to stop */
+    atomic_bool stopRequested;
+
+    /* the producer only reads the input, parentPID and jobDeadline */
+    struct shellState *shell;
+};
+
+/* Starts the producer thread, which reads from the shell's input with all
+ * signals blocked so they are handled by the shell.
+ * input: the parse-ahead state: struct parseAhead *
+ *        the shell: struct shellState *
+ * output: 0 if successful or -1 if the thread couldn't be started
+ */
+int startParseAhead(struct parseAhead *ahead, struct shellState *shell);
+
+/* Waits for and takes the next item from the ring.
+ * input: the parse-ahead state: struct parseAhead *
+ * output: the item, which is freed with freeAheadItem
+ */
+struct aheadItem *takeAheadItem(struct parseAhead *ahead);
+
+/* Lets the producer go on after a barrier item has run.
+ * input: the parse-ahead state: struct parseAhead *
+ */
+void releaseAheadBarrier(struct parseAhead *ahead);
+
+/* Frees an item, closing the memory file of its here-document.
+ * input: the item: struct aheadItem *
+ */
+void freeAheadItem(struct aheadItem *item);
+
+/* Stops the producer thread, frees any items left in the ring and destroys
+ * the semaphores. The producer has to be waiting at a barrier or finished,
+ * as it is once the shell has run an exit or reached the end of the input.
+ * input: the parse-ahead state: struct parseAhead *
+ */
+void stopParseAhead(struct parseAhead *ahead);
+
+/* Reads and runs commandlines from the shell's input with parse-ahead until
+ * the user exits or the input ends.
+ * input: the shell: struct shellState *
+ * output: 0 if successful or -1 if the producer couldn't be started
+ */
+int runShellAhead(struct shellState *shell);
+
+#endif
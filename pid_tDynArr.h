@@ -12,6 +12,9 @@
  *
  **************************************************************************/
 
+#ifndef PID_T_DYN_ARR_H
+#define PID_T_DYN_ARR_H
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <unistd.h>  
@@ -59,4 +62,6 @@ pid_t *getPidReturnArray(int size);
  *        the size of the array: int
  * output: the new size of the array: int
  */
-int increasePidReturnArray(pid_t **arr, int oldCapacity);
\ No newline at end of file
+int increasePidReturnArray(pid_t **arr, int oldCapacity);
+
+#endif
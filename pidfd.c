@@ -0,0 +1,29 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements wrappers for the Linux process file descriptor
+ *              (pidfd) system calls including:
+ *
+ *               opening a pidfd that refers to a process
+ *               sending a signal through a pidfd
+ *
+ *  glibc doesn't wrap these calls on every system so they are made
+ *  directly with syscall(). Reference: man pages pidfd_open(2) and
+ *  pidfd_send_signal(2)
+ *
+ **************************************************************************/
+
+#include "pidfd.h"
+
+/* Opens a pidfd with the close-on-exec flag set for the process pid. */
+int pidfdOpen(pid_t pid)
+{
+    /* pidfds are always close-on-exec, the flags argument must be 0 */
+    return (int)syscall(SYS_pidfd_open, pid, 0);
+}
+
+/* Sends the signal to the process referred to by the pidfd. */
+int pidfdSendSignal(int pidfd, int theSignal)
+{
+    return (int)syscall(SYS_pidfd_send_signal, pidfd, theSignal, NULL, 0);
+}
@@ -0,0 +1,39 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines wrappers for the Linux process file descriptor
+ *              (pidfd) system calls including:
+ *
+ *               opening a pidfd that refers to a process
+ *               sending a signal through a pidfd
+ *
+ *              A pidfd always refers to the same process, so unlike a raw
+ *              PID it can't be reused by an unrelated process after the
+ *              original one has been reaped. A pidfd becomes readable in
+ *              poll() when its process terminates.
+ *
+ **************************************************************************/
+
+#ifndef PIDFD_H
+#define PIDFD_H
+
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>    /* includes pid_t type */
+#include <sys/syscall.h>  /* for SYS_pidfd_open and SYS_pidfd_send_signal */
+
+/* Opens a pidfd with the close-on-exec flag set for the process pid.
+ * input: the process id: pid_t
+ * output: the pidfd or -1 on error (errno is ENOSYS on old kernels)
+ */
+int pidfdOpen(pid_t pid);
+
+/* Sends the signal to the process referred to by the pidfd.
+ * input: the pidfd: int
+ *        the signal number: int
+ * output: 0 on success or -1 on error (errno is ESRCH if the process has
+ *         already terminated)
+ */
+int pidfdSendSignal(int pidfd, int theSignal);
+
+#endif
@@ -0,0 +1,553 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the functions for managing the redirection table
+ *              including:
+ *
+ *               recognizing the operators <, >, >>, N<, N>, N>>, N>&M,
+ *               &> and &>> with a separate or attached file name, and >z
+ *               and N>z with a separate one
+ *               adding redirections to the table in commandline order
+ *               opening the files of a table close-on-exec, several at
+ *               once with io_uring
+ *               applying a table to fds 0 - 9 with the fewest dup3 calls
+ *               closing every other descriptor with close_range
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapter 5 and man
+ *  pages dup3(2) and close_range(2)
+ *
+ **************************************************************************/
+
+#include "redirection.h"
+#include "bashShell.h"  /* for getEmptyString and ERROR_MESSAGE_MAX */
+
+/* Empties the redirection table. */
+void initializeRedirections(struct redirectionTable *table)
+{
+    table->count = 0;
+    table->fanOuts = NULL;
+}
+
+/* Frees the file names in the table and empties it. */
+void freeRedirections(struct redirectionTable *table)
+{
+    int i;
+
+    for (i = 0; i < table->count; i++)
+    {
+        if (table->entries[i].fileName != NULL)
+        {
+            freeString(table->entries[i].fileName);
+        }
+    }
+
+    table->count = 0;
+}
+
+/* Adds a redirection of the target fd to an open fd or file. */
+int addRedirection(struct redirectionTable *table, int fd, enum redirectionType type,
+                   char *fileName, int sourceFd)
+{
+    struct redirection *entry;
+
+    /* a NULL table only checks that a token is a redirection */
+    if (table == NULL)
+    {
+        return 0;
+    }
+
+    if (table->count == MAX_REDIRECTIONS)
+    {
+        return -1;
+    }
+
+    entry = &table->entries[table->count];
+    entry->fd = fd;
+    entry->type = type;
+    entry->fileName = NULL;
+    entry->sourceFd = sourceFd;
+
+    if (fileName != NULL)
+    {
+        entry->fileName = getEmptyString(strlen(fileName) + 1);
+        strcpy(entry->fileName, fileName);
+    }
+
+    ++table->count;
+
+    return 0;
+}
+
+/* Returns the index of the last file redirection in the table, which is
+ * the one waiting for a file name, or -1 if there isn't one.
+ */
+static int lastFileRedirection(struct redirectionTable *table)
+{
+    int i;
+
+    for (i = table->count - 1; i >= 0; i--)
+    {
+        if (table->entries[i].type != redirectDuplicate
+            && table->entries[i].type != redirectDescriptor)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/* Sets the file name of the last operator added by parseRedirection. */
+void addRedirectionFile(struct redirectionTable *table, char *fileName)
+{
+    int index = lastFileRedirection(table);
+
+    if (index != -1)
+    {
+        table->entries[index].fileName = getEmptyString(strlen(fileName) + 1);
+        strcpy(table->entries[index].fileName, fileName);
+    }
+}
+
+/* Checks if the token is a redirection operator and if so adds it to the
+ * table.
+ */
+enum redirectionStatus parseRedirection(struct redirectionTable *table, char *token)
+{
+    char *position = token;  /* the current position in the token */
+    int fd = -1;  /* the target fd, -1 until it's known */
+    bool bothStreams = false;  /* true for &> and &>> */
+    enum redirectionType type;
+
+    /* << and <<< are here-documents and here-strings */
+    if (strncmp(token, "<<", 2) == 0)
+    {
+        return notRedirection;
+    }
+
+    /* &> and &>> redirect both stdout and stderr */
+    if (strncmp(position, "&>", 2) == 0)
+    {
+        bothStreams = true;
+        ++position;
+    }
+    /* an explicit target fd as in 2> */
+    else if (isdigit((unsigned char)position[0]) && (position[1] == '<' || position[1] == '>'))
+    {
+        fd = position[0] - '0';
+        ++position;
+    }
+
+    if (*position == '<')
+    {
+        type = redirectInput;
+        ++position;
+    }
+    else if (*position == '>' && *(position + 1) == '>')
+    {
+        type = redirectAppend;
+        position += 2;
+    }
+    else if (*position == '>')
+    {
+        type = redirectOutput;
+        position += 1;
+
+        /* >z on its own compresses the output into the file that follows,
+         * while >zfile is still the file zfile
+         */
+        if (position[0] == 'z' && position[1] == '\0')
+        {
+            type = redirectCompressed;
+            position += 1;
+        }
+    }
+    else
+    {
+        return notRedirection;
+    }
+
+    if (fd == -1)
+    {
+        fd = (type == redirectInput) ? 0 : 1;
+    }
+
+    /* N>&M and N<&M make fd N a copy of fd M */
+    if (bothStreams == false && *position == '&')
+    {
+        if (isdigit((unsigned char)position[1]) && position[2] == '\0')
+        {
+            if (addRedirection(table, fd, redirectDuplicate, NULL, position[1] - '0') == -1)
+            {
+                return redirectionError;
+            }
+            return redirectionComplete;
+        }
+
+        /* >&file is the same as &>file */
+        if (type == redirectInput)
+        {
+            return notRedirection;
+        }
+        bothStreams = true;
+        ++position;
+    }
+
+    if (addRedirection(table, fd, type, (*position != '\0') ? position : NULL, NOT_OPENED) == -1
+        || (bothStreams == true && addRedirection(table, 2, redirectDuplicate, NULL, 1) == -1))
+    {
+        return redirectionError;
+    }
+
+    return (*position != '\0') ? redirectionComplete : redirectionNeedsFile;
+}
+
+/* Redirects stdin from and stdout to /dev/null, as is done for a background
+ * process, unless they are already redirected.
+ */
+void addBackgroundRedirections(struct redirectionTable *table)
+{
+    /* If input is not redirected from a file then set it to redirect
+     * from /dev/null
+     */
+    if (isRedirected(table, 0) == false)
+    {
+        addRedirection(table, 0, redirectInput, "/dev/null", NOT_OPENED);
+    }
+
+    /* If output is not redirected to a file then set it to redirect
+     * to /dev/null
+     */
+    if (isRedirected(table, 1) == false)
+    {
+        addRedirection(table, 1, redirectOutput, "/dev/null", NOT_OPENED);
+    }  
+}
+
+/* Returns true if any redirection in the table targets the fd. */
+bool isRedirected(struct redirectionTable *table, int fd)
+{
+    int i;
+
+    for (i = 0; i < table->count; i++)
+    {
+        if (table->entries[i].fd == fd)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Returns true if any redirection in the table compresses its output. */
+bool hasCompressedOutput(struct redirectionTable *table)
+{
+    int i;
+
+    for (i = 0; i < table->count; i++)
+    {
+        if (table->entries[i].type == redirectCompressed)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Opens the file of every file redirection in the table close-on-exec and
+ * stores the descriptor in sourceFd.
+ */
+int openRedirections(struct redirectionTable *table)
+{
+    int i;
+    int highFd;
+    int maxTarget = -1;  /* the highest fd the table redirects */
+    char errorMessage[ERROR_MESSAGE_MAX];
+    struct redirection *entry;
+
+    /* The files to open, in commandline order, and the entry each is for */
+    char *paths[MAX_REDIRECTIONS];
+    int flags[MAX_REDIRECTIONS];
+    int results[MAX_REDIRECTIONS];  /* the fd of each file or -errno */
+    int entryIndexes[MAX_REDIRECTIONS];
+    int numOpens = 0;
+    int failed = -1;  /* the first open that failed */
+
+    for (i = 0; i < table->count; i++)
+    {
+        if (table->entries[i].fd > maxTarget)
+        {
+            maxTarget = table->entries[i].fd;
+        }
+    }
+
+    for (i = 0; i < table->count; i++)
+    {
+        entry = &table->entries[i];
+
+        /* skip fd copies and files that were already opened */
+        if (entry->type == redirectDuplicate || entry->type == redirectDescriptor
+            || entry->sourceFd != NOT_OPENED)
+        {
+            continue;
+        }
+
+        /* O_CLOEXEC so the original descriptor never survives execvp */
+        if (entry->type == redirectInput)
+        {
+            flags[numOpens] = O_RDONLY | O_CLOEXEC;
+        }
+        else if (entry->type == redirectAppend)
+        {
+            flags[numOpens] = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+        }
+        else
+        {
+            flags[numOpens] = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+        }
+
+        paths[numOpens] = entry->fileName;
+        entryIndexes[numOpens] = i;
+        ++numOpens;
+    }
+
+    /* Several files are opened with one io_uring submission rather than a
+     * system call each. A single file, or a kernel without io_uring, uses
+     * open, stopping at the first file that can't be opened as the linked
+     * opens of the ring do.
+     */
+    if (numOpens < MIN_RING_OPENS || openFilesLinked(paths, flags, results, numOpens) == -1)
+    {
+        for (i = 0; i < numOpens; i++)
+        {
+            results[i] = (failed == -1) ? open(paths[i], flags[i], OPEN_RING_MODE) : -ECANCELED;
+            if (results[i] == -1)
+            {
+                results[i] = -errno;
+                failed = i;
+            }
+        }
+    }
+
+    failed = -1;
+    for (i = 0; i < numOpens; i++)
+    {
+        /* a file opened after one that failed is closed, since the table
+         * only holds the files before the failure
+         */
+        if (failed != -1 || results[i] < 0)
+        {
+            if (failed == -1)
+            {
+                failed = i;
+            }
+            else if (results[i] >= 0)
+            {
+                close(results[i]);
+            }
+            continue;
+        }
+
+        entry = &table->entries[entryIndexes[i]];
+        entry->sourceFd = results[i];
+
+        /* Move the descriptor out of the way if it landed on an fd the table
+         * redirects, so applying the table can't overwrite it too early.
+         */
+        if (entry->sourceFd <= maxTarget)
+        {
+            highFd = fcntl(entry->sourceFd, F_DUPFD_CLOEXEC, MAX_REDIRECT_FD + 1);
+            close(entry->sourceFd);
+            entry->sourceFd = highFd;
+
+            if (highFd == -1)
+            {
+                perror("fcntl() unsuccessful");
+                failed = numOpens;
+            }
+        }
+    }
+
+    /* if unsuccessful in opening a file print an error message to stderr */
+    if (failed != -1)
+    {
+        if (failed < numOpens)
+        {
+            entry = &table->entries[entryIndexes[failed]];
+            memset(errorMessage,'\0', ERROR_MESSAGE_MAX);
+            snprintf(errorMessage, ERROR_MESSAGE_MAX, "cannot open %s for %s\n", entry->fileName,
+                     (entry->type == redirectInput) ? "input" : "output");
+            fputs(errorMessage, stderr);
+        }
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Closes the files opened by openRedirections and any fan-outs that were
+ * never started, as when the redirections of an exec are not applied after
+ * all.
+ */
+void closeRedirections(struct redirectionTable *table)
+{
+    struct redirection *entry;
+    int i;
+
+    for (i = 0; i < table->count; i++)
+    {
+        entry = &table->entries[i];
+
+        /* fd copies and descriptors the shell opened aren't owned by the table */
+        if (entry->type != redirectDuplicate && entry->type != redirectDescriptor
+            && entry->sourceFd != NOT_OPENED)
+        {
+            close(entry->sourceFd);
+            entry->sourceFd = NOT_OPENED;
+        }
+    }
+
+    closeFanOuts(table);
+}
+
+/* Applies the opened redirection table to the current process. Each target
+ * fd is dup3'd at most once from its final source, then every fd except 0 -
+ * 2 and the redirected fds is closed.
+ */
+int applyRedirections(struct redirectionTable *table)
+{
+    /* source[t] is the fd that target t should end up a copy of. Sources
+     * 0 - 9 refer to the fds as they were before any redirection.
+     */
+    int source[MAX_REDIRECT_FD + 1];
+    bool pending[MAX_REDIRECT_FD + 1];
+    int numPending = 0;
+    int t, u;
+    bool applied;
+    bool neededLater;
+    int savedFd;
+    struct redirection *entry;
+
+    for (t = 0; t <= MAX_REDIRECT_FD; t++)
+    {
+        source[t] = t;
+    }
+
+    /* Work out the final source of each target in commandline order, so
+     * 2>&1 > file and > file 2>&1 both mean what they do in bash.
+     */
+    for (t = 0; t < table->count; t++)
+    {
+        entry = &table->entries[t];
+
+        if (entry->type == redirectDuplicate)
+        {
+            source[entry->fd] = source[entry->sourceFd];
+        }
+        else
+        {
+            source[entry->fd] = entry->sourceFd;
+        }
+    }
+
+    for (t = 0; t <= MAX_REDIRECT_FD; t++)
+    {
+        pending[t] = (source[t] != t);
+        if (pending[t] == true)
+        {
+            ++numPending;
+        }
+    }
+
+    /* Apply a target only once no other pending target still needs its
+     * original fd. Only a cycle such as 3>&1 1>&2 2>&3 needs a saved copy.
+     */
+    while (numPending > 0)
+    {
+        applied = false;
+
+        for (t = 0; t <= MAX_REDIRECT_FD; t++)
+        {
+            if (pending[t] == false)
+            {
+                continue;
+            }
+
+            neededLater = false;
+            for (u = 0; u <= MAX_REDIRECT_FD; u++)
+            {
+                if (u != t && pending[u] == true && source[u] == t)
+                {
+                    neededLater = true;
+                }
+            }
+
+            if (neededLater == false)
+            {
+                if (dup3(source[t], t, 0) == -1)
+                {
+                    fprintf(stderr, "%d: bad file descriptor\n", source[t]);
+                    return -1;
+                }
+                pending[t] = false;
+                --numPending;
+                applied = true;
+            }
+        }
+
+        /* break a cycle by saving the first pending target's original fd */
+        if (applied == false)
+        {
+            for (t = 0; pending[t] == false; t++);
+
+            savedFd = fcntl(t, F_DUPFD_CLOEXEC, MAX_REDIRECT_FD + 1);
+            if (savedFd == -1)
+            {
+                perror("fcntl() unsuccessful");
+                return -1;
+            }
+
+            for (u = 0; u <= MAX_REDIRECT_FD; u++)
+            {
+                if (u != t && source[u] == t)
+                {
+                    source[u] = savedFd;
+                }
+            }
+        }
+    }
+
+    closeUnusedDescriptors(table);
+
+    return 0;
+}
+
+/* Closes every fd from 3 up except those that are redirected in the table. */
+void closeUnusedDescriptors(struct redirectionTable *table)
+{
+    unsigned int low = 3;  /* the first fd of the next range to close */
+    unsigned int fd;
+    long maxOpen;
+
+    for (fd = 3; fd <= MAX_REDIRECT_FD + 1; fd++)
+    {
+        /* close the range below a kept fd, or everything from the end */
+        if (fd == MAX_REDIRECT_FD + 1 || isRedirected(table, fd))
+        {
+            if (low < fd && syscall(SYS_close_range, low,
+                        (fd == MAX_REDIRECT_FD + 1) ? MAX_FD_VALUE : fd - 1, 0) == -1)
+            {
+                /* kernels before 5.9 have no close_range */
+                maxOpen = sysconf(_SC_OPEN_MAX);
+                for (; low < (unsigned int)maxOpen && (fd == MAX_REDIRECT_FD + 1 || low < fd); low++)
+                {
+                    close(low);
+                }
+            }
+
+            low = fd + 1;
+        }
+    }
+}
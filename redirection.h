@@ -0,0 +1,174 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the redirection table and functions for managing it
+ *              including:
+ *
+ *               recognizing the operators <, >, >>, N<, N>, N>>, N>&M,
+ *               &> and &>> with a separate or attached file name, and >z
+ *               and N>z with a separate one
+ *               adding redirections to the table in commandline order
+ *               opening the files of a table close-on-exec, several at
+ *               once with io_uring
+ *               applying a table to fds 0 - 9 with the fewest dup3 calls
+ *               closing every other descriptor with close_range
+ *
+ *              After applying a table the child holds exactly fds 0 - 2
+ *              plus any other fds it redirected, so nothing the shell has
+ *              open leaks across execvp.
+ *
+ **************************************************************************/
+
+#ifndef REDIRECTION_H
+#define REDIRECTION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>        /* use for opening files to get descriptors */
+#include <unistd.h>
+#include <sys/syscall.h>  /* for SYS_close_range */
+
+/* Maximum number of redirections on a single commandline */
+#define MAX_REDIRECTIONS 16
+
+/* The highest fd a redirection may target, as with the N in N> */
+#define MAX_REDIRECT_FD 9
+
+/* The fewest files a table opens with io_uring rather than open, since a
+ * single open is cheaper as a plain system call
+ */
+#define MIN_RING_OPENS 2
+
+/* Used with close_range to mean the highest possible fd */
+#define MAX_FD_VALUE ~0U
+
+/* Use to indicate a redirection whose file has not been opened */
+#define NOT_OPENED -1
+
+/* The kind of redirection:
+ * redirectInput      N< file   (N defaults to 0)
+ * redirectOutput     N> file   (N defaults to 1)
+ * redirectAppend     N>> file  (N defaults to 1)
+ * redirectCompressed N>z file  (N defaults to 1) gzip the output into file
+ * redirectDuplicate  N>&M      make N a copy of M
+ * redirectDescriptor make N a copy of an fd the shell already opened, such
+ *                    as a here-document memory file
+ */
+enum redirectionType{ redirectInput, redirectOutput, redirectAppend,
+                      redirectCompressed, redirectDuplicate, redirectDescriptor};
+
+/* Used to indicate how parseRedirection used the token */
+enum redirectionStatus{ notRedirection, redirectionComplete, redirectionNeedsFile,
+                        redirectionError};
+
+/* A single redirection of the target fd */
+struct redirection
+{
+    int fd;  /* the fd that is redirected */
+    enum redirectionType type;
+    char *fileName;  /* dynamic string for file types, otherwise NULL */
+    int sourceFd;  /* M for redirectDuplicate, or the opened fd */
+};
+
+struct fanOut;
+
+/* The redirections of a commandline, applied in order */
+struct redirectionTable
+{
+    struct redirection entries[MAX_REDIRECTIONS];
+    int count;
+
+    /* The fds sent to several files by openFanOuts, or NULL */
+    struct fanOut *fanOuts;
+};
+
+/* Empties the redirection table.
+ * input: the table: struct redirectionTable *
+ */
+void initializeRedirections(struct redirectionTable *table);
+
+/* Frees the file names in the table and empties it.
+ * input: the table: struct redirectionTable *
+ */
+void freeRedirections(struct redirectionTable *table);
+
+/* Checks if the token is a redirection operator and if so adds it to the
+ * table. &> and &>> add two entries, N> file and 2>&1. If the file name is
+ * attached to the operator, as in 2>err.txt, it is used, otherwise the
+ * caller must pass the next token to addRedirectionFile.
+ * input: the table, or NULL to only check the token: struct redirectionTable *
+ *        the commandline token: char *
+ * output: notRedirection, redirectionComplete, redirectionNeedsFile or
+ *         redirectionError if the table is full
+ */
+enum redirectionStatus parseRedirection(struct redirectionTable *table, char *token);
+
+/* Sets the file name of the last operator added by parseRedirection.
+ * input: the table: struct redirectionTable *
+ *        the file name: char *
+ */
+void addRedirectionFile(struct redirectionTable *table, char *fileName);
+
+/* Adds a redirection of the target fd to an open fd or file.
+ * input: the table: struct redirectionTable *
+ *        the target fd: int
+ *        the redirection type: enum redirectionType
+ *        the file name for file types, otherwise NULL: char *
+ *        the source fd for redirectDuplicate and redirectDescriptor: int
+ * output: 0 if successful or -1 if the table is full
+ */
+int addRedirection(struct redirectionTable *table, int fd, enum redirectionType type,
+                   char *fileName, int sourceFd);
+
+/* Redirects stdin from and stdout to /dev/null, as is done for a background
+ * process, unless they are already redirected.
+ * input: the table: struct redirectionTable *
+ */
+void addBackgroundRedirections(struct redirectionTable *table);
+
+/* Returns true if any redirection in the table targets the fd.
+ * input: the table: struct redirectionTable *
+ *        the fd: int
+ */
+bool isRedirected(struct redirectionTable *table, int fd);
+
+/* Returns true if any redirection in the table compresses its output with
+ * >z, which needs the shell to copy it through a fan-out.
+ * input: the table: struct redirectionTable *
+ */
+bool hasCompressedOutput(struct redirectionTable *table);
+
+/* Opens the file of every file redirection in the table close-on-exec and
+ * stores the descriptor in sourceFd. The files are opened in order and no
+ * file after one that can't be opened is created or truncated.
+ * input: the table: struct redirectionTable *
+ * output: 0 if successful or -1 after printing an error if a file couldn't
+ *         be opened, when the files before it are left open in the table
+ */
+int openRedirections(struct redirectionTable *table);
+
+/* Closes the files opened by openRedirections and any fan-outs that were
+ * never started, as when the redirections of an exec are not applied after
+ * all.
+ * input: the table: struct redirectionTable *
+ */
+void closeRedirections(struct redirectionTable *table);
+
+/* Applies the opened redirection table to the current process. Each target
+ * fd is dup3'd at most once from its final source, then every fd except 0 -
+ * 2 and the redirected fds is closed.
+ * input: the table: struct redirectionTable *
+ * output: 0 if successful or -1 on error
+ */
+int applyRedirections(struct redirectionTable *table);
+
+/* Closes every fd from 3 up except those that are redirected in the table.
+ * input: the table: struct redirectionTable *
+ */
+void closeUnusedDescriptors(struct redirectionTable *table);
+
+#endif
@@ -0,0 +1,1086 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the cache of command results and the cached
+ *              inbuilt command including:
+ *
+ *               keying a command on its arguments, working directory,
+ *               executable, a subset of the environment and the
+ *               fingerprint of each input file
+ *               storing output files by the hash of their contents, so
+ *               equal outputs are kept once
+ *               restoring an output file with a reflink or copy_file_range
+ *               instead of running the command again
+ *               evicting the least recently used results once the store
+ *               is larger than its size limit
+ *               counting hits, misses, stores and evictions
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 5, 15,
+ *  18 and 55, and the ioctl_ficlone(2) and copy_file_range(2) man pages
+ *
+ **************************************************************************/
+
+#include "resultCache.h"
+#include "bashShell.h"  /* for parsing and launching the command */
+
+/* Size of the buffer used when copy_file_range can't copy a file */
+#define COPY_BUFFER_SIZE 65536
+
+/* Written at the start of every key so a change to how keys are made can't
+ * match old entries
+ */
+#define RESULT_KEY_VERSION "bashShell result key 1"
+
+/* The store and its size limit */
+/* The longest name added to the store's directory, "/objects/" and a hash
+ * with its '\0', so every path in the store fits in PATH_MAX
+ */
+#define RESULT_PATH_SUFFIX_LENGTH (sizeof("/objects/") + RESULT_HASH_LENGTH)
+
+struct resultStore
+{
+    char dir[PATH_MAX - RESULT_PATH_SUFFIX_LENGTH];
+    uint64_t sizeLimit;
+};
+
+/* The key of a command as it is built, before it is hashed */
+struct keyBuffer
+{
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+};
+
+/* An entry of the store read while evicting */
+struct storeEntry
+{
+    char name[RESULT_HASH_LENGTH + 1];
+    char object[RESULT_HASH_LENGTH + 1];
+    uint64_t size;
+    struct timespec lastUse;
+    int objectIndex;  /* the index of its object among the distinct objects */
+};
+
+/* Rotates a 64 bit value left by count bits */
+static uint64_t rotateLeft(uint64_t value, int count)
+{
+    return (value << count) | (value >> (64 - count));
+}
+
+/* Mixes the bits of a lane so every input bit affects every output bit.
+ * Reference: the fmix64 finalizer of MurmurHash3
+ */
+static uint64_t mixLane(uint64_t value)
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+
+    return value;
+}
+
+/* Hashes bytes into a 128 bit hash. One lane is FNV-1a over 8 byte words
+ * and the other a multiply and rotate hash of the same words, so the two
+ * lanes don't collide together.
+ */
+void hashResultBytes(const unsigned char *bytes, size_t size, struct resultHash *hash)
+{
+    uint64_t first = 14695981039346656037ULL;  /* FNV-1a offset basis */
+    uint64_t second = 0x9e3779b97f4a7c15ULL ^ size;
+    uint64_t word;
+    size_t i;
+
+    for (i = 0; i + sizeof(word) <= size; i += sizeof(word))
+    {
+        memcpy(&word, bytes + i, sizeof(word));
+        first = (first ^ word) * 1099511628211ULL;  /* FNV prime */
+        second = rotateLeft(second ^ (word * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+    }
+
+    /* the last bytes are padded with zeros and marked with their number */
+    word = (uint64_t)(size - i) << 56;
+    memcpy(&word, bytes + i, size - i);
+    first = (first ^ word) * 1099511628211ULL;
+    second = rotateLeft(second ^ (word * 0x87c37b91114253d5ULL), 31) * 0x4cf5ad432745937fULL;
+
+    hash->lanes[0] = mixLane(first ^ size);
+    hash->lanes[1] = mixLane(second ^ hash->lanes[0]);
+}
+
+/* Puts a hash in str as RESULT_HASH_LENGTH hex digits */
+static void hashToString(struct resultHash *hash, char str[])
+{
+    snprintf(str, RESULT_HASH_LENGTH + 1, "%016llx%016llx",
+             (unsigned long long)hash->lanes[0], (unsigned long long)hash->lanes[1]);
+}
+
+/* Appends a field to the key after its length, so fields can't run into
+ * each other
+ */
+static void appendKey(struct keyBuffer *key, const void *bytes, size_t size)
+{
+    uint32_t length = size;
+
+    while (key->size + sizeof(length) + size > key->capacity)
+    {
+        key->capacity = (key->capacity == 0) ? 1024 : key->capacity * 2;
+        key->data = realloc(key->data, key->capacity);
+        if (key->data == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+    }
+
+    memcpy(key->data + key->size, &length, sizeof(length));
+    memcpy(key->data + key->size + sizeof(length), bytes, size);
+    key->size += sizeof(length) + size;
+}
+
+static void appendKeyString(struct keyBuffer *key, char *str)
+{
+    appendKey(key, str, strlen(str));
+}
+
+/* Appends what identifies a version of a file without reading it: its
+ * device, inode, size and modification and change times
+ */
+static void appendFileStat(struct keyBuffer *key, struct stat *fileStat)
+{
+    uint64_t fields[7];
+
+    fields[0] = fileStat->st_dev;
+    fields[1] = fileStat->st_ino;
+    fields[2] = fileStat->st_size;
+    fields[3] = fileStat->st_mtim.tv_sec;
+    fields[4] = fileStat->st_mtim.tv_nsec;
+    fields[5] = fileStat->st_ctim.tv_sec;
+    fields[6] = fileStat->st_ctim.tv_nsec;
+
+    appendKey(key, fields, sizeof(fields));
+}
+
+/* Hashes the contents of an open file by mapping it. Returns 0 if
+ * successful or -1 on error.
+ */
+static int hashFile(int fd, off_t size, struct resultHash *hash)
+{
+    unsigned char *contents;
+
+    /* an empty file can't be mapped */
+    if (size == 0)
+    {
+        hashResultBytes((unsigned char *)"", 0, hash);
+        return 0;
+    }
+
+    contents = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (contents == MAP_FAILED)
+    {
+        return -1;
+    }
+
+    madvise(contents, size, MADV_SEQUENTIAL);
+    hashResultBytes(contents, size, hash);
+    munmap(contents, size);
+
+    return 0;
+}
+
+/* Appends the fingerprint of an input file, either its stat or the hash of
+ * its contents. Returns 0 if successful or -1 if it can't be read.
+ */
+static int appendInputFile(struct keyBuffer *key, char *fileName, bool hashContents)
+{
+    struct stat inputStat;
+    struct resultHash hash;
+    int fd;
+    int result = 0;
+
+    fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return -1;
+    }
+
+    if (fstat(fd, &inputStat) == -1 || !S_ISREG(inputStat.st_mode))
+    {
+        result = -1;
+    }
+    else if (hashContents == true)
+    {
+        result = hashFile(fd, inputStat.st_size, &hash);
+        appendKey(key, &hash, sizeof(hash));
+    }
+    else
+    {
+        appendFileStat(key, &inputStat);
+    }
+
+    close(fd);
+    return result;
+}
+
+/* Appends NAME=value, or NAME alone if it isn't set, for each of the
+ * ':' separated names
+ */
+static void appendEnvironment(struct keyBuffer *key, char *names)
+{
+    char namesCopy[PATH_MAX];
+    char *name;
+    char *savePosition;
+    char *value;
+
+    snprintf(namesCopy, PATH_MAX, "%s", names);
+
+    for (name = strtok_r(namesCopy, ":", &savePosition); name != NULL;
+         name = strtok_r(NULL, ":", &savePosition))
+    {
+        value = getenv(name);
+        appendKeyString(key, name);
+        appendKeyString(key, (value == NULL) ? "" : value);
+        appendKey(key, (value == NULL) ? "u" : "s", 1);
+    }
+}
+
+/* Finds the output file of a command that can be cached and builds its key.
+ * The command has to redirect stdout to a file with > and stdin from a
+ * file with <, since a command reading the shell's own stdin would be keyed
+ * without its input. Returns 0 if successful or -1 if the command can't be
+ * cached.
+ */
+static int buildResultKey(struct command *command, bool hashContents,
+                          char **outputFile, struct resultHash *keyHash)
+{
+    struct keyBuffer key = {NULL, 0, 0};
+    struct redirection *entry;
+    struct stat executableStat;
+    char path[PATH_MAX];  /* the path of the executable */
+    char workingDir[PATH_MAX];
+    char *extraNames = getenv(RESULT_CACHE_ENV_VARIABLE);
+    bool hasInput = false;
+    int result = 0;
+    int i;
+
+    *outputFile = NULL;
+
+    if (command->numArgs == 0 || command->inBackground == true || command->hereType != noHere
+        || findExecutable(command->args[0], path) == false
+        || stat(path, &executableStat) == -1 || getcwd(workingDir, PATH_MAX) == NULL)
+    {
+        return -1;
+    }
+
+    appendKeyString(&key, RESULT_KEY_VERSION);
+
+    /* relative file names in the arguments depend on the working directory */
+    appendKeyString(&key, workingDir);
+
+    /* a rebuilt executable gives a new key */
+    appendFileStat(&key, &executableStat);
+
+    for (i = 0; i < command->numArgs; i++)
+    {
+        appendKeyString(&key, command->args[i]);
+    }
+
+    appendEnvironment(&key, RESULT_CACHE_KEY_ENV);
+    if (extraNames != NULL)
+    {
+        appendEnvironment(&key, extraNames);
+    }
+
+    for (i = 0; i < command->redirections.count && result == 0; i++)
+    {
+        entry = &command->redirections.entries[i];
+
+        if (entry->fd == 0 && entry->type == redirectInput)
+        {
+            appendKeyString(&key, entry->fileName);
+            result = appendInputFile(&key, entry->fileName, hashContents);
+            hasInput = true;
+        }
+        else if (entry->fd == 1 && entry->type == redirectOutput && *outputFile == NULL)
+        {
+            *outputFile = entry->fileName;
+        }
+        else
+        {
+            result = -1;
+        }
+    }
+
+    if (*outputFile == NULL || hasInput == false)
+    {
+        result = -1;
+    }
+
+    if (result == 0)
+    {
+        hashResultBytes(key.data, key.size, keyHash);
+    }
+
+    free(key.data);
+    return result;
+}
+
+/* Makes the directory and any missing parents. Returns 0 if successful or
+ * -1 on error.
+ */
+static int makeDirectories(char *path)
+{
+    char partial[PATH_MAX];
+    char *slash;
+
+    snprintf(partial, PATH_MAX, "%s", path);
+
+    for (slash = strchr(partial + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/'))
+    {
+        *slash = '\0';
+        if (mkdir(partial, 0700) == -1 && errno != EEXIST)
+        {
+            return -1;
+        }
+        *slash = '/';
+    }
+
+    if (mkdir(partial, 0700) == -1 && errno != EEXIST)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Parses a size such as 100, 64K, 256M or 2G into bytes */
+static uint64_t parseSize(char *text)
+{
+    char *end;
+    uint64_t size = strtoull(text, &end, 10);
+
+    switch (*end)
+    {
+        case 'G': case 'g': size *= 1024;  /* falls through */
+        case 'M': case 'm': size *= 1024;  /* falls through */
+        case 'K': case 'k': size *= 1024;
+    }
+
+    return size;
+}
+
+/* Finds the store from the environment and makes its directories. Returns
+ * 0 if successful or -1 after printing an error. A directory too long for
+ * the paths in the store to fit in PATH_MAX isn't used, so every path built
+ * from store->dir afterwards fits.
+ */
+static int openResultStore(struct resultStore *store)
+{
+    char path[PATH_MAX];
+    char *dir = getenv(RESULT_CACHE_DIR_VARIABLE);
+    char *sizeText = getenv(RESULT_CACHE_SIZE_VARIABLE);
+    int length;
+
+    if (dir != NULL && dir[0] != '\0')
+    {
+        length = snprintf(store->dir, sizeof(store->dir), "%s", dir);
+    }
+    else if ((dir = getenv("XDG_CACHE_HOME")) != NULL && dir[0] != '\0')
+    {
+        length = snprintf(store->dir, sizeof(store->dir), "%s/bashShell/results", dir);
+    }
+    else if ((dir = getenv("HOME")) != NULL && dir[0] != '\0')
+    {
+        length = snprintf(store->dir, sizeof(store->dir), "%s/.cache/bashShell/results", dir);
+    }
+    else
+    {
+        fprintf(stderr, "cached: set %s or HOME\n", RESULT_CACHE_DIR_VARIABLE);
+        return -1;
+    }
+
+    if (length < 0 || (size_t)length >= sizeof(store->dir))
+    {
+        fprintf(stderr, "cached: the cache directory is too long, so the command isn't cached\n");
+        return -1;
+    }
+
+    store->sizeLimit = (sizeText != NULL) ? parseSize(sizeText) : RESULT_CACHE_DEFAULT_SIZE;
+
+    snprintf(path, PATH_MAX, "%s/objects", store->dir);
+    if (makeDirectories(path) == -1)
+    {
+        fprintf(stderr, "cached: cannot create %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    snprintf(path, PATH_MAX, "%s/entries", store->dir);
+    if (makeDirectories(path) == -1)
+    {
+        fprintf(stderr, "cached: cannot create %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Takes the lock of the store, so only one shell changes it at a time.
+ * Returns the locked fd, which is closed to unlock, or -1 on error.
+ */
+static int lockResultStore(struct resultStore *store)
+{
+    char path[PATH_MAX];
+    int fd;
+
+    snprintf(path, PATH_MAX, "%s/lock", store->dir);
+
+    fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd != -1 && flock(fd, LOCK_EX) == -1)
+    {
+        close(fd);
+        fd = -1;
+    }
+
+    return fd;
+}
+
+/* Reads the counters of the store, which are 0 if it has none yet */
+static void readStats(struct resultStore *store, struct resultCacheStats *stats)
+{
+    char path[PATH_MAX];
+    int fd;
+
+    memset(stats, 0, sizeof(struct resultCacheStats));
+    snprintf(path, PATH_MAX, "%s/stats", store->dir);
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd != -1)
+    {
+        if (pread(fd, stats, sizeof(struct resultCacheStats), 0) != sizeof(struct resultCacheStats))
+        {
+            memset(stats, 0, sizeof(struct resultCacheStats));
+        }
+        close(fd);
+    }
+}
+
+/* Writes the counters of the store while it is locked */
+static void writeStats(struct resultStore *store, struct resultCacheStats *stats)
+{
+    char path[PATH_MAX];
+    int fd;
+
+    snprintf(path, PATH_MAX, "%s/stats", store->dir);
+
+    fd = open(path, O_WRONLY | O_CREAT | O_CLOEXEC, 0600);
+    if (fd != -1)
+    {
+        pwrite(fd, stats, sizeof(struct resultCacheStats), 0);
+        close(fd);
+    }
+}
+
+/* Adds a hit or a miss that wasn't stored to the counters */
+static void countResult(struct resultStore *store, bool hit)
+{
+    struct resultCacheStats stats;
+    int lockFd = lockResultStore(store);
+
+    if (lockFd == -1)
+    {
+        return;
+    }
+
+    readStats(store, &stats);
+    if (hit == true)
+    {
+        ++stats.hits;
+    }
+    else
+    {
+        ++stats.misses;
+    }
+    writeStats(store, &stats);
+
+    close(lockFd);
+}
+
+/* Writes size bytes at offset, continuing after a short write. Returns 0 if
+ * successful or -1 on error.
+ */
+static int writeAllAt(int fd, char *buffer, size_t size, off_t offset)
+{
+    ssize_t written;
+
+    while (size > 0)
+    {
+        written = pwrite(fd, buffer, size, offset);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+        buffer += written;
+        size -= written;
+        offset += written;
+    }
+
+    return 0;
+}
+
+/* Copies the whole of one file into another, sharing its blocks with a
+ * reflink where the file system allows, then with copy_file_range and last
+ * with read and write.
+ */
+int copyFileContents(int sourceFd, int targetFd, off_t size)
+{
+    char buffer[COPY_BUFFER_SIZE];
+    loff_t sourceOffset = 0;
+    loff_t targetOffset = 0;
+    ssize_t copied;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    /* On btrfs and XFS a reflink shares the blocks, so nothing is copied */
+    if (ioctl(targetFd, FICLONE, sourceFd) == 0)
+    {
+        return 0;
+    }
+
+    /* copy_file_range copies in the kernel without passing through the
+     * shell, and stops early on file systems that can't
+     */
+    while (sourceOffset < size)
+    {
+        copied = copy_file_range(sourceFd, &sourceOffset, targetFd, &targetOffset,
+                                 size - sourceOffset, 0);
+        if (copied <= 0)
+        {
+            break;
+        }
+    }
+
+    /* read and write whatever copy_file_range couldn't */
+    while (sourceOffset < size)
+    {
+        copied = pread(sourceFd, buffer, COPY_BUFFER_SIZE, sourceOffset);
+        if (copied <= 0)
+        {
+            if (copied == -1 && errno == EINTR)
+            {
+                continue;
+            }
+            return -1;
+        }
+
+        if (writeAllAt(targetFd, buffer, copied, sourceOffset) == -1)
+        {
+            return -1;
+        }
+        sourceOffset += copied;
+    }
+
+    return 0;
+}
+
+/* Reads the object hash and size of an entry. Returns 0 if successful or -1
+ * if it can't be read.
+ */
+static int readEntry(int dirFd, char *name, char object[], uint64_t *size)
+{
+    char contents[RESULT_HASH_LENGTH + 32];
+    unsigned long long entrySize;
+    ssize_t length;
+    int fd;
+
+    fd = openat(dirFd, name, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return -1;
+    }
+
+    length = read(fd, contents, sizeof(contents) - 1);
+    close(fd);
+
+    if (length <= 0)
+    {
+        return -1;
+    }
+    contents[length] = '\0';
+
+    if (sscanf(contents, "%32s %llu", object, &entrySize) != 2
+        || strlen(object) != RESULT_HASH_LENGTH)
+    {
+        return -1;
+    }
+
+    *size = entrySize;
+    return 0;
+}
+
+/* Restores the output of a key from the store. Returns 0 on a hit or -1 if
+ * the key isn't stored or the output couldn't be restored.
+ */
+static int restoreResult(struct resultStore *store, char *keyString, char *outputFile)
+{
+    char path[PATH_MAX];
+    char object[RESULT_HASH_LENGTH + 1];
+    struct stat objectStat;
+    uint64_t size;
+    int entriesFd;
+    int objectFd;
+    int outputFd;
+    int result;
+
+    snprintf(path, PATH_MAX, "%s/entries", store->dir);
+    entriesFd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (entriesFd == -1)
+    {
+        return -1;
+    }
+
+    result = readEntry(entriesFd, keyString, object, &size);
+    if (result == 0)
+    {
+        /* the entry's time of last use is what LRU eviction goes by */
+        utimensat(entriesFd, keyString, NULL, 0);
+    }
+    close(entriesFd);
+
+    if (result == -1)
+    {
+        return -1;
+    }
+
+    /* the object may have been evicted since the entry was read */
+    snprintf(path, PATH_MAX, "%s/objects/%s", store->dir, object);
+    objectFd = open(path, O_RDONLY | O_CLOEXEC);
+    if (objectFd == -1)
+    {
+        return -1;
+    }
+
+    if (fstat(objectFd, &objectStat) == -1 || (uint64_t)objectStat.st_size != size)
+    {
+        close(objectFd);
+        return -1;
+    }
+
+    /* opened as > opens it in the child */
+    outputFd = open(outputFile, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (outputFd == -1)
+    {
+        close(objectFd);
+        return -1;
+    }
+
+    result = copyFileContents(objectFd, outputFd, size);
+
+    close(objectFd);
+    close(outputFd);
+
+    return result;
+}
+
+/* Orders entries by object hash */
+static int compareObjects(const void *a, const void *b)
+{
+    return strcmp(((const struct storeEntry *)a)->object, ((const struct storeEntry *)b)->object);
+}
+
+/* Orders entries from the most to the least recently used */
+static int compareLastUse(const void *a, const void *b)
+{
+    const struct timespec *first = &((const struct storeEntry *)a)->lastUse;
+    const struct timespec *second = &((const struct storeEntry *)b)->lastUse;
+
+    if (first->tv_sec != second->tv_sec)
+    {
+        return (first->tv_sec < second->tv_sec) ? 1 : -1;
+    }
+    return (first->tv_nsec < second->tv_nsec) - (first->tv_nsec > second->tv_nsec);
+}
+
+/* Evicts the least recently used entries until the objects the rest refer
+ * to fit in the size limit, then removes objects no entry refers to. Called
+ * with the store locked.
+ */
+static void evictResults(struct resultStore *store, struct resultCacheStats *stats)
+{
+    char path[PATH_MAX];
+    struct storeEntry *entries = NULL;
+    char (*objects)[RESULT_HASH_LENGTH + 1];  /* the distinct objects in hash order */
+    bool *keptObjects;
+    struct dirent *dirEntry;
+    struct stat entryStat;
+    DIR *dir;
+    int numEntries = 0;
+    int capacity = 0;
+    int numObjects = 0;
+    int low, high, middle, comparison;
+    uint64_t keptBytes = 0;
+    int i;
+
+    snprintf(path, PATH_MAX, "%s/entries", store->dir);
+    dir = opendir(path);
+    if (dir == NULL)
+    {
+        return;
+    }
+
+    while ((dirEntry = readdir(dir)) != NULL)
+    {
+        if (dirEntry->d_name[0] == '.' || strlen(dirEntry->d_name) != RESULT_HASH_LENGTH)
+        {
+            continue;
+        }
+
+        if (numEntries == capacity)
+        {
+            capacity = (capacity == 0) ? 64 : capacity * 2;
+            entries = realloc(entries, capacity * sizeof(struct storeEntry));
+            if (entries == NULL)
+            {
+                fprintf(stderr, "Malloc not successful\n");
+                exit(1);
+            }
+        }
+
+        strcpy(entries[numEntries].name, dirEntry->d_name);
+        if (fstatat(dirfd(dir), dirEntry->d_name, &entryStat, 0) == 0
+            && readEntry(dirfd(dir), dirEntry->d_name, entries[numEntries].object,
+                         &entries[numEntries].size) == 0)
+        {
+            entries[numEntries].lastUse = entryStat.st_mtim;
+            ++numEntries;
+        }
+    }
+
+    /* Number the distinct objects so entries sharing one count it once */
+    qsort(entries, numEntries, sizeof(struct storeEntry), compareObjects);
+
+    objects = malloc((numEntries + 1) * sizeof(*objects));
+    keptObjects = calloc(numEntries + 1, sizeof(bool));
+    if (objects == NULL || keptObjects == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < numEntries; i++)
+    {
+        if (numObjects == 0 || strcmp(objects[numObjects - 1], entries[i].object) != 0)
+        {
+            strcpy(objects[numObjects++], entries[i].object);
+        }
+        entries[i].objectIndex = numObjects - 1;
+    }
+
+    /* Keep the most recently used entries while their objects fit */
+    qsort(entries, numEntries, sizeof(struct storeEntry), compareLastUse);
+
+    for (i = 0; i < numEntries; i++)
+    {
+        if (keptObjects[entries[i].objectIndex] == true)
+        {
+            continue;
+        }
+
+        if (keptBytes + entries[i].size <= store->sizeLimit)
+        {
+            keptObjects[entries[i].objectIndex] = true;
+            keptBytes += entries[i].size;
+        }
+        else if (unlinkat(dirfd(dir), entries[i].name, 0) == 0)
+        {
+            ++stats->evictions;
+        }
+    }
+
+    closedir(dir);
+
+    /* Remove every object that no kept entry refers to, found by a binary
+     * search of the distinct objects
+     */
+    snprintf(path, PATH_MAX, "%s/objects", store->dir);
+    dir = opendir(path);
+    if (dir != NULL)
+    {
+        while ((dirEntry = readdir(dir)) != NULL)
+        {
+            if (dirEntry->d_name[0] == '.' || strlen(dirEntry->d_name) != RESULT_HASH_LENGTH)
+            {
+                continue;
+            }
+
+            low = 0;
+            high = numObjects - 1;
+            comparison = 1;
+            while (low <= high && comparison != 0)
+            {
+                middle = (low + high) / 2;
+                comparison = strcmp(dirEntry->d_name, objects[middle]);
+                if (comparison < 0)
+                {
+                    high = middle - 1;
+                }
+                else if (comparison > 0)
+                {
+                    low = middle + 1;
+                }
+            }
+
+            if (comparison != 0 || keptObjects[middle] == false)
+            {
+                unlinkat(dirfd(dir), dirEntry->d_name, 0);
+            }
+        }
+        closedir(dir);
+    }
+
+    stats->bytes = keptBytes;
+
+    free(entries);
+    free(objects);
+    free(keptObjects);
+}
+
+/* Writes text to a new file in the entries of the store and renames it to
+ * the key, so readers only ever see a whole entry. Returns 0 if successful
+ * or -1 on error.
+ */
+static int writeEntryAtomically(struct resultStore *store, char *keyString, char *text)
+{
+    char temporaryPath[PATH_MAX];
+    char path[PATH_MAX];
+    int fd;
+
+    snprintf(temporaryPath, PATH_MAX, "%s/entries/.tmpXXXXXX", store->dir);
+    snprintf(path, PATH_MAX, "%s/entries/%.*s", store->dir, RESULT_HASH_LENGTH, keyString);
+
+    fd = mkostemp(temporaryPath, O_CLOEXEC);
+    if (fd == -1)
+    {
+        return -1;
+    }
+
+    if (writeAllAt(fd, text, strlen(text), 0) == -1 || rename(temporaryPath, path) == -1)
+    {
+        close(fd);
+        unlink(temporaryPath);
+        return -1;
+    }
+
+    close(fd);
+    return 0;
+}
+
+/* Stores the output file of a command that succeeded under its key. An
+ * output equal to one already stored shares its object.
+ */
+static void storeResult(struct resultStore *store, char *keyString, char *outputFile)
+{
+    char path[PATH_MAX];
+    char temporaryPath[PATH_MAX];
+    char objectString[RESULT_HASH_LENGTH + 1];
+    char entryText[RESULT_HASH_LENGTH + 32];
+    struct resultCacheStats stats;
+    struct resultHash contentHash;
+    struct stat outputStat, objectStat;
+    uint64_t newBytes = 0;
+    int outputFd;
+    int objectFd;
+    int lockFd;
+
+    outputFd = open(outputFile, O_RDONLY | O_CLOEXEC);
+    if (outputFd == -1)
+    {
+        countResult(store, false);
+        return;
+    }
+
+    /* only a regular file can be hashed and restored */
+    if (fstat(outputFd, &outputStat) == -1 || !S_ISREG(outputStat.st_mode)
+        || hashFile(outputFd, outputStat.st_size, &contentHash) == -1)
+    {
+        close(outputFd);
+        countResult(store, false);
+        return;
+    }
+
+    hashToString(&contentHash, objectString);
+
+    lockFd = lockResultStore(store);
+    if (lockFd == -1)
+    {
+        close(outputFd);
+        return;
+    }
+
+    readStats(store, &stats);
+    ++stats.misses;
+
+    snprintf(path, PATH_MAX, "%s/objects/%s", store->dir, objectString);
+
+    /* Copy the output into a new object unless an equal one is stored */
+    if (stat(path, &objectStat) == -1 || objectStat.st_size != outputStat.st_size)
+    {
+        snprintf(temporaryPath, PATH_MAX, "%s/objects/.tmpXXXXXX", store->dir);
+        objectFd = mkostemp(temporaryPath, O_CLOEXEC);
+
+        if (objectFd == -1 || copyFileContents(outputFd, objectFd, outputStat.st_size) == -1
+            || rename(temporaryPath, path) == -1)
+        {
+            if (objectFd != -1)
+            {
+                close(objectFd);
+                unlink(temporaryPath);
+            }
+            writeStats(store, &stats);
+            close(lockFd);
+            close(outputFd);
+            return;
+        }
+
+        close(objectFd);
+        newBytes = outputStat.st_size;
+    }
+
+    close(outputFd);
+
+    snprintf(entryText, sizeof(entryText), "%s %llu\n", objectString,
+             (unsigned long long)outputStat.st_size);
+
+    if (writeEntryAtomically(store, keyString, entryText) == 0)
+    {
+        ++stats.stores;
+        stats.bytes += newBytes;
+    }
+
+    if (stats.bytes > store->sizeLimit)
+    {
+        evictResults(store, &stats);
+    }
+
+    writeStats(store, &stats);
+    close(lockFd);
+}
+
+/* Prints the counters and size of the store */
+static void printStats(struct resultStore *store)
+{
+    struct resultCacheStats stats;
+    uint64_t lookups;
+
+    readStats(store, &stats);
+    lookups = stats.hits + stats.misses;
+
+    printf("hits %llu misses %llu (%.1f%% hit rate) stores %llu evictions %llu\n",
+           (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+           (lookups > 0) ? 100.0 * stats.hits / lookups : 0.0,
+           (unsigned long long)stats.stores, (unsigned long long)stats.evictions);
+    printf("%llu of %llu bytes stored in %s\n", (unsigned long long)stats.bytes,
+           (unsigned long long)store->sizeLimit, store->dir);
+}
+
+/* Runs "cached [-c] command [args] < input > output" or "cached -s". */
+void cachedBuiltin(struct shellState *shell, char commandLine[])
+{
+    struct resultStore store;
+    struct resultHash keyHash;
+    struct command command;
+    char keyString[RESULT_HASH_LENGTH + 1];
+    char *rest = commandLine + strlen("cached");
+    char *outputFile;
+    bool hashContents = false;
+    bool tailCommand = shell->tailCommand;
+
+    while (isspace((unsigned char)*rest))
+    {
+        ++rest;
+    }
+
+    if (strncmp(rest, "-s", 2) == 0 && (rest[2] == '\0' || isspace((unsigned char)rest[2])))
+    {
+        if (openResultStore(&store) == -1)
+        {
+            shell->lastStatus = 1;
+            return;
+        }
+        printStats(&store);
+        shell->lastStatus = 0;
+        return;
+    }
+
+    if (strncmp(rest, "-c", 2) == 0 && isspace((unsigned char)rest[2]))
+    {
+        hashContents = true;
+        rest += 2;
+    }
+
+    initializeCommand(&command, shell->jobDeadline);
+
+    if (parseArguments(rest, &command) == -1)
+    {
+        sprintf(shell->exitStatusStr,"exit value %d",1);
+        shell->lastStatus = 1;
+        freeCommand(&command);
+        return;
+    }
+
+    if (command.numArgs == 0)
+    {
+        printf("usage: cached [-c] command [args] < input > output | cached -s\n");
+        sprintf(shell->exitStatusStr,"exit value %d",CACHED_USAGE_ERROR);
+        shell->lastStatus = CACHED_USAGE_ERROR;
+        freeCommand(&command);
+        return;
+    }
+
+    /* A command that can't be cached, or a store that can't be used, just
+     * runs the command
+     */
+    if (buildResultKey(&command, hashContents, &outputFile, &keyHash) == -1
+        || openResultStore(&store) == -1)
+    {
+        launchCommand(shell, &command);
+        freeCommand(&command);
+        return;
+    }
+
+    hashToString(&keyHash, keyString);
+
+    if (restoreResult(&store, keyString, outputFile) == 0)
+    {
+        countResult(&store, true);
+        sprintf(shell->exitStatusStr,"exit value %d",0);
+        shell->lastStatus = 0;
+        freeCommand(&command);
+        return;
+    }
+
+    /* The command has to come back to the shell to be stored, so it isn't
+     * exec'd in place of the shell
+     */
+    shell->tailCommand = false;
+    launchCommand(shell, &command);
+    shell->tailCommand = tailCommand;
+
+    if (shell->lastStatus == 0)
+    {
+        storeResult(&store, keyString, outputFile);
+    }
+    else
+    {
+        countResult(&store, false);
+    }
+
+    freeCommand(&command);
+}
@@ -0,0 +1,119 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the cache of command results and the cached inbuilt
+ *              command including:
+ *
+ *               keying a command on its arguments, working directory,
+ *               executable, a subset of the environment and the
+ *               fingerprint of each input file
+ *               storing output files by the hash of their contents, so
+ *               equal outputs are kept once
+ *               restoring an output file with a reflink or copy_file_range
+ *               instead of running the command again
+ *               evicting the least recently used results once the store
+ *               is larger than its size limit
+ *               counting hits, misses, stores and evictions
+ *
+ *              "cached cmd args < in > out" runs the command the first
+ *              time and restores out on later runs with the same key.
+ *              Only commands that exit with 0 and write a regular file
+ *              with > are stored; other commands are run as usual.
+ *
+ *              The store is in $BASHSHELL_CACHE_DIR, or bashShell/results
+ *              in $XDG_CACHE_HOME or ~/.cache. It holds:
+ *
+ *               objects/HASH   an output file, named by its content hash
+ *               entries/KEY    the HASH and size of a key's output, whose
+ *                              modification time is its last use
+ *               stats          the counters and the size of the objects
+ *               lock           locked with flock while the store changes
+ *
+ **************************************************************************/
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>       /* for the fixed size counters and hashes */
+#include <string.h>
+#include <limits.h>       /* for PATH_MAX */
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>       /* for reading the entries when evicting */
+#include <sys/file.h>     /* for flock */
+#include <sys/ioctl.h>
+#include <sys/mman.h>     /* for mapping files while hashing them */
+#include <sys/stat.h>
+#include <linux/fs.h>     /* for FICLONE */
+
+/* The environment variables that can name the store and its size limit */
+#define RESULT_CACHE_DIR_VARIABLE "BASHSHELL_CACHE_DIR"
+#define RESULT_CACHE_SIZE_VARIABLE "BASHSHELL_CACHE_SIZE"
+
+/* Names of extra environment variables, separated by ':', that are part of
+ * the key of every command
+ */
+#define RESULT_CACHE_ENV_VARIABLE "BASHSHELL_CACHE_ENV"
+
+/* The environment variables that are always part of the key */
+#define RESULT_CACHE_KEY_ENV "PATH:LANG:LC_ALL:LC_CTYPE:TZ"
+
+/* The default size limit of the objects in the store */
+#define RESULT_CACHE_DEFAULT_SIZE (256ULL * 1024 * 1024)
+
+/* The exit status of cached without a command, as in bash */
+#define CACHED_USAGE_ERROR 2
+
+/* Number of hex digits in a key or content hash of 128 bits */
+#define RESULT_HASH_LENGTH 32
+
+/* The counters of the store, kept in its stats file */
+struct resultCacheStats
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t stores;
+    uint64_t evictions;
+    uint64_t bytes;  /* the total size of the objects */
+};
+
+/* A 128 bit hash, from two 64 bit lanes hashed differently */
+struct resultHash
+{
+    uint64_t lanes[2];
+};
+
+struct shellState;
+
+/* Runs "cached [-c] command [args] < input > output" or "cached -s".
+ * A command without < reads the shell's stdin, which isn't part of the key,
+ * so it is run without being cached. Without -c an input file is fingerprinted by its inode, size and times;
+ * with -c its contents are hashed. -s prints the statistics of the store.
+ * Sets the exit status of the shell.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ */
+void cachedBuiltin(struct shellState *shell, char commandLine[]);
+
+/* Hashes bytes into a 128 bit hash.
+ * input: the bytes: const unsigned char *
+ *        the number of bytes: size_t
+ *        the hash to fill in: struct resultHash *
+ */
+void hashResultBytes(const unsigned char *bytes, size_t size, struct resultHash *hash);
+
+/* Copies the whole of one file into another, sharing its blocks with a
+ * reflink where the file system allows, then with copy_file_range and
+ * last with read and write.
+ * input: the file copied from: int
+ *        the empty file copied into: int
+ *        the size of the file copied from: off_t
+ * output: 0 if successful or -1 on error
+ */
+int copyFileContents(int sourceFd, int targetFd, off_t size);
+
+#endif
@@ -0,0 +1,889 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the functions for caching and running compiled
+ *              scripts including:
+ *
+ *               compiling each command of a script into an entry holding
+ *               its pre-split arguments, redirections, background flag,
+ *               time limit, here-document body and the ;, && or || that
+ *               joins it to the command before it
+ *               recording where $$ is substituted in each string
+ *               writing the compiled script to a cache file beside it
+ *               mapping the cache file on later runs and running it without
+ *               expanding or parsing any commandline
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 15 and 49
+ *
+ **************************************************************************/
+
+#include "scriptCache.h"
+#include "bashShell.h"  /* for the shell state, parseArguments and launchCommand */
+
+/* Rounds size up to the next multiple of CACHE_ALIGNMENT */
+static size_t alignSection(size_t size)
+{
+    return (size + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+}
+
+/* Adds bytes to the end of the buffer, doubling its capacity when full.
+ * Returns the offset the bytes were added at.
+ */
+static size_t appendBytes(struct irBuffer *buffer, const void *bytes, size_t size)
+{
+    size_t offset = buffer->size;
+    char *data;
+
+    if (buffer->size + size > buffer->capacity)
+    {
+        buffer->capacity = (buffer->capacity == 0) ? 256 : buffer->capacity;
+        while (buffer->size + size > buffer->capacity)
+        {
+            buffer->capacity *= 2;
+        }
+
+        data = realloc(buffer->data, buffer->capacity);
+        if (data == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+        buffer->data = data;
+    }
+
+    memcpy(buffer->data + buffer->size, bytes, size);
+    buffer->size += size;
+
+    return offset;
+}
+
+/* Frees the bytes held by the buffer. */
+static void freeBuffer(struct irBuffer *buffer)
+{
+    free(buffer->data);
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+}
+
+/* Returns the number of strings added to the builder so far */
+static uint32_t numStrings(struct irBuilder *builder)
+{
+    return builder->strings.size / sizeof(struct irString);
+}
+
+/* Adds the text to the string pool and returns its string index. If
+ * substitute is true each $$ is removed from the text and its offset is
+ * recorded, scanning from left to right as expandString does.
+ */
+static uint32_t addString(struct irBuilder *builder, char *text, bool substitute)
+{
+    struct irString string;
+    uint32_t offset;  /* offset of a $$ in the string with $$ removed */
+    char *position = text;
+    char *location;  /* location of the next $$ in text */
+
+    string.offset = builder->pool.size;
+    string.firstSubstitution = builder->substitutions.size / sizeof(uint32_t);
+    string.numSubstitutions = 0;
+
+    while (substitute == true && (location = strstr(position, "$$")) != NULL)
+    {
+        appendBytes(&builder->pool, position, location - position);
+
+        offset = builder->pool.size - string.offset;
+        appendBytes(&builder->substitutions, &offset, sizeof(offset));
+        ++string.numSubstitutions;
+
+        position = location + 2;  /* jump past $$ */
+    }
+
+    appendBytes(&builder->pool, position, strlen(position) + 1);
+    string.length = builder->pool.size - string.offset - 1;
+
+    appendBytes(&builder->strings, &string, sizeof(string));
+
+    return numStrings(builder) - 1;
+}
+
+/* Reads the body of a here-document from the script up to its delimiter
+ * line into body as one '\0' ended string. Returns -1 if the script ends
+ * before the delimiter or a line is too long, so the warning or error is
+ * printed when the script is run line by line.
+ */
+static int compileHereDocument(FILE *script, char *delimiter, struct irBuffer *body)
+{
+    char *line = NULL;  /* the line returned by getline */
+    size_t lineCapacity = 0;
+    ssize_t lineSize;
+    int result = -1;
+
+    while ((lineSize = getline(&line, &lineCapacity, script)) >= 0)
+    {
+        /* compare the line without its newline against the delimiter */
+        if (lineSize > 0 && line[lineSize - 1] == '\n')
+        {
+            line[--lineSize] = '\0';
+        }
+        if (strcmp(line, delimiter) == 0)
+        {
+            result = 0;
+            break;
+        }
+
+        if (lineSize >= MAX_COMMAND_LINE)
+        {
+            break;
+        }
+
+        appendBytes(body, line, lineSize);
+        appendBytes(body, "\n", 1);
+    }
+
+    appendBytes(body, "", 1);
+    free(line);
+
+    return result;
+}
+
+/* Adds the arguments, redirections, flags and here-document or here-string
+ * body of a parsed command to its entry. Returns -1 if the command can't be
+ * compiled.
+ */
+static int compileCommand(struct irBuilder *builder, FILE *script,
+                          struct command *command, struct irEntry *entry)
+{
+    struct irRedirection redirection;
+    struct irBuffer body = {0};  /* the here-document or here-string body */
+    int i;
+
+    entry->kind = irCommand;
+
+    if (command->inBackground == true)
+    {
+        entry->flags |= IR_BACKGROUND;
+    }
+    if (command->haveTimeout == true)
+    {
+        entry->flags |= IR_TIMEOUT;
+        entry->timeout = command->timeout;
+        entry->killAfter = command->killAfter;
+    }
+
+    /* the args are added first so they are consecutive strings */
+    entry->firstArg = numStrings(builder);
+    entry->numArgs = command->numArgs;
+    for (i = 0; i < command->numArgs; i++)
+    {
+        addString(builder, command->args[i], true);
+    }
+
+    entry->firstRedirection = builder->redirections.size / sizeof(struct irRedirection);
+    entry->numRedirections = command->redirections.count;
+    for (i = 0; i < command->redirections.count; i++)
+    {
+        redirection.fd = command->redirections.entries[i].fd;
+        redirection.type = command->redirections.entries[i].type;
+        redirection.sourceFd = command->redirections.entries[i].sourceFd;
+        redirection.fileName = IR_NONE;
+
+        if (command->redirections.entries[i].fileName != NULL)
+        {
+            redirection.fileName = addString(builder, command->redirections.entries[i].fileName, true);
+        }
+
+        appendBytes(&builder->redirections, &redirection, sizeof(redirection));
+    }
+
+    entry->hereType = command->hereType;
+
+    if (command->hereType == hereString)
+    {
+        appendBytes(&body, command->hereWord, strlen(command->hereWord));
+        appendBytes(&body, "\n", 2);
+    }
+    /* The delimiter of a here-document is compared to its body lines after
+     * $$ is expanded, which can't be done until the script is run.
+     */
+    else if (command->hereType == hereDocument
+             && (strstr(command->hereWord, "$$") != NULL
+                 || compileHereDocument(script, command->hereWord, &body) == -1))
+    {
+        freeBuffer(&body);
+        return -1;
+    }
+
+    if (command->hereType != noHere)
+    {
+        entry->text = addString(builder, body.data, true);
+    }
+
+    freeBuffer(&body);
+
+    return 0;
+}
+
+/* Adds an entry that runs the text as an inbuilt command or as a
+ * commandline that is expanded and parsed when it is run. Returns -1 if
+ * the text has a here-document, whose body the cached script couldn't
+ * read when it runs, since the script has been read to its end by then.
+ */
+static int addLineEntry(struct irBuilder *builder, char *text, enum connector connector)
+{
+    struct irEntry entry = {0};
+
+    if (hasHereDocument(text))
+    {
+        return -1;
+    }
+
+    entry.kind = irLine;
+    entry.connector = connector;
+    entry.hereType = noHere;
+    entry.text = addString(builder, text, false);
+
+    appendBytes(&builder->entries, &entry, sizeof(entry));
+
+    return 0;
+}
+
+/* Compiles a command of a list into an entry. Commands that can be launched
+ * as a process are parsed now and anything else is stored as its original
+ * text. Returns -1 if the script can't be compiled.
+ */
+static int compileListCommand(struct irBuilder *builder, FILE *script, char *text,
+                              enum connector connector)
+{
+    struct irEntry entry = {0};
+    struct command command;
+    char commandCopy[MAX_COMMAND_LINE];  /* parseArguments splits up the command */
+    enum lineType type = classifyCommandLine(text);
+    bool compiled = false;  /* true once the command is parsed into an entry */
+    int result = 0;
+
+    /* Comments are left out altogether */
+    if (type == commentLine)
+    {
+        return 0;
+    }
+
+    /* Commands are parsed before $$ is expanded, which gives the same result
+     * since a pid only has digits, unless the pid could become the N of
+     * N> or a time limit. Those commands and commands that don't parse are
+     * run from their original text.
+     */
+    if ((type == externalLine || (type == timeoutLine && strstr(text, "$$") == NULL))
+        && strstr(text, "$$<") == NULL && strstr(text, "$$>") == NULL)
+    {
+        strcpy(commandCopy, text);
+        initializeCommand(&command, NO_TIMEOUT);
+
+        if (parseListCommand(commandCopy, &command) == true)
+        {
+            entry.connector = connector;
+            entry.text = IR_NONE;
+            result = compileCommand(builder, script, &command, &entry);
+            appendBytes(&builder->entries, &entry, sizeof(entry));
+            compiled = true;
+        }
+
+        freeCommand(&command);
+    }
+
+    if (compiled == false)
+    {
+        result = addLineEntry(builder, text, connector);
+    }
+
+    return result;
+}
+
+/* Compiles a line of the script into an entry for each command of its list.
+ * Returns -1 if the script can't be compiled.
+ */
+static int compileLine(struct irBuilder *builder, FILE *script, char *line)
+{
+    char lineCopy[MAX_COMMAND_LINE];  /* splitCommandList splits up the line */
+    struct commandList list;
+    int i;
+
+    /* Comments and blank lines are left out altogether */
+    if (classifyCommandLine(line) == commentLine)
+    {
+        return 0;
+    }
+
+    /* Lines that are too long or aren't a valid list are run from their
+     * original line so the error is printed then.
+     */
+    if (strlen(line) >= MAX_COMMAND_LINE)
+    {
+        return addLineEntry(builder, line, connectLine);
+    }
+
+    strcpy(lineCopy, line);
+
+    if (splitCommandList(lineCopy, &list, false) == -1)
+    {
+        return addLineEntry(builder, line, connectLine);
+    }
+
+    for (i = 0; i < list.count; i++)
+    {
+        if (compileListCommand(builder, script, list.commands[i].text, list.commands[i].connector) == -1)
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/* Compiles a script into a cache image, with the header filled in. */
+char *compileScript(FILE *script, struct cacheHeader *key, size_t *imageSize)
+{
+    struct irBuilder builder = {{0}};
+    struct cacheHeader *header;
+    char *line = NULL;  /* the line returned by getline */
+    size_t lineCapacity = 0;
+    char *image = NULL;
+    size_t offset;
+    int result = 0;
+
+    while (result == 0 && getline(&line, &lineCapacity, script) >= 0)
+    {
+        /* a loop or function is stored as one line up to its end */
+        readBlockLines(script, &line, &lineCapacity, false);
+        result = compileLine(&builder, script, line);
+    }
+
+    free(line);
+    rewind(script);
+
+    /* Lay out the header followed by each section */
+    offset = alignSection(sizeof(struct cacheHeader));
+    offset = alignSection(offset + builder.entries.size);
+    offset = alignSection(offset + builder.strings.size);
+    offset = alignSection(offset + builder.redirections.size);
+    offset = alignSection(offset + builder.substitutions.size);
+    offset += builder.pool.size;
+
+    if (result == 0 && offset < UINT32_MAX)
+    {
+        image = getEmptyString(offset);
+        memset(image, '\0', offset);
+        *imageSize = offset;
+
+        header = (struct cacheHeader *)image;
+        *header = *key;
+        header->totalSize = offset;
+
+        header->numEntries = builder.entries.size / sizeof(struct irEntry);
+        header->entriesOffset = alignSection(sizeof(struct cacheHeader));
+        header->numStrings = numStrings(&builder);
+        header->stringsOffset = alignSection(header->entriesOffset + builder.entries.size);
+        header->numRedirections = builder.redirections.size / sizeof(struct irRedirection);
+        header->redirectionsOffset = alignSection(header->stringsOffset + builder.strings.size);
+        header->numSubstitutions = builder.substitutions.size / sizeof(uint32_t);
+        header->substitutionsOffset = alignSection(header->redirectionsOffset + builder.redirections.size);
+        header->poolSize = builder.pool.size;
+        header->poolOffset = alignSection(header->substitutionsOffset + builder.substitutions.size);
+
+        /* empty sections have a NULL buffer */
+        if (builder.entries.size > 0)
+        {
+            memcpy(image + header->entriesOffset, builder.entries.data, builder.entries.size);
+            memcpy(image + header->stringsOffset, builder.strings.data, builder.strings.size);
+            memcpy(image + header->poolOffset, builder.pool.data, builder.pool.size);
+        }
+        if (builder.redirections.size > 0)
+        {
+            memcpy(image + header->redirectionsOffset, builder.redirections.data, builder.redirections.size);
+        }
+        if (builder.substitutions.size > 0)
+        {
+            memcpy(image + header->substitutionsOffset, builder.substitutions.data, builder.substitutions.size);
+        }
+    }
+
+    freeBuffer(&builder.entries);
+    freeBuffer(&builder.strings);
+    freeBuffer(&builder.redirections);
+    freeBuffer(&builder.substitutions);
+    freeBuffer(&builder.pool);
+
+    return image;
+}
+
+/* Returns true if count elements of elementSize starting at offset are
+ * within an image of imageSize.
+ */
+static bool sectionInBounds(uint64_t offset, uint64_t count, uint64_t elementSize, size_t imageSize)
+{
+    return offset % CACHE_ALIGNMENT == 0 && offset + count * elementSize <= imageSize;
+}
+
+/* Returns true if the string index refers to a '\0' ended string in the
+ * pool whose substitutions are in order and within it.
+ */
+static bool validString(char *image, uint32_t index)
+{
+    struct cacheHeader *header = (struct cacheHeader *)image;
+    struct irString *string;
+    uint32_t *substitutions;
+    uint32_t previous = 0;
+    uint32_t i;
+
+    if (index >= header->numStrings)
+    {
+        return false;
+    }
+
+    string = (struct irString *)(image + header->stringsOffset) + index;
+    substitutions = (uint32_t *)(image + header->substitutionsOffset) + string->firstSubstitution;
+
+    if ((uint64_t)string->offset + string->length >= header->poolSize
+        || image[header->poolOffset + string->offset + string->length] != '\0'
+        || (uint64_t)string->firstSubstitution + string->numSubstitutions > header->numSubstitutions)
+    {
+        return false;
+    }
+
+    for (i = 0; i < string->numSubstitutions; i++)
+    {
+        if (substitutions[i] < previous || substitutions[i] > string->length)
+        {
+            return false;
+        }
+        previous = substitutions[i];
+    }
+
+    return true;
+}
+
+/* Returns true if the cache image is complete, matches the key and all of
+ * its indices and offsets are in bounds.
+ */
+bool validCacheImage(char *image, size_t imageSize, struct cacheHeader *key)
+{
+    struct cacheHeader *header = (struct cacheHeader *)image;
+    struct irEntry *entry;
+    struct irRedirection *redirection;
+    uint32_t i, j;
+
+    if (imageSize < sizeof(struct cacheHeader)
+        || memcmp(header->magic, key->magic, CACHE_MAGIC_LENGTH) != 0
+        || header->formatVersion != key->formatVersion
+        || memcmp(header->shellVersion, key->shellVersion, CACHE_VERSION_LENGTH) != 0
+        || header->pathHash != key->pathHash
+        || header->mtimeSeconds != key->mtimeSeconds
+        || header->mtimeNanoseconds != key->mtimeNanoseconds
+        || header->scriptSize != key->scriptSize
+        || header->totalSize != imageSize)
+    {
+        return false;
+    }
+
+    if (!sectionInBounds(header->entriesOffset, header->numEntries, sizeof(struct irEntry), imageSize)
+        || !sectionInBounds(header->stringsOffset, header->numStrings, sizeof(struct irString), imageSize)
+        || !sectionInBounds(header->redirectionsOffset, header->numRedirections,
+                            sizeof(struct irRedirection), imageSize)
+        || !sectionInBounds(header->substitutionsOffset, header->numSubstitutions, sizeof(uint32_t), imageSize)
+        || !sectionInBounds(header->poolOffset, header->poolSize, 1, imageSize))
+    {
+        return false;
+    }
+
+    for (i = 0; i < header->numEntries; i++)
+    {
+        entry = (struct irEntry *)(image + header->entriesOffset) + i;
+
+        if (entry->connector > connectOr)
+        {
+            return false;
+        }
+
+        if (entry->kind == irLine)
+        {
+            if (!validString(image, entry->text))
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if (entry->kind != irCommand
+            || entry->numArgs >= MAX_NUM_ARGS
+            || (uint64_t)entry->firstArg + entry->numArgs > header->numStrings
+            || entry->numRedirections > MAX_REDIRECTIONS
+            || (uint64_t)entry->firstRedirection + entry->numRedirections > header->numRedirections
+            || entry->hereType > hereString
+            || (entry->hereType != noHere && !validString(image, entry->text)))
+        {
+            return false;
+        }
+
+        for (j = 0; j < entry->numArgs; j++)
+        {
+            if (!validString(image, entry->firstArg + j))
+            {
+                return false;
+            }
+        }
+
+        for (j = 0; j < entry->numRedirections; j++)
+        {
+            redirection = (struct irRedirection *)(image + header->redirectionsOffset)
+                          + entry->firstRedirection + j;
+
+            if (redirection->fd < 0 || redirection->fd > MAX_REDIRECT_FD)
+            {
+                return false;
+            }
+
+            if (redirection->type == redirectDuplicate)
+            {
+                if (redirection->sourceFd < 0 || redirection->sourceFd > MAX_REDIRECT_FD)
+                {
+                    return false;
+                }
+            }
+            else if ((redirection->type != redirectInput && redirection->type != redirectOutput
+                      && redirection->type != redirectAppend && redirection->type != redirectCompressed)
+                     || !validString(image, redirection->fileName))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Returns the string with the pid inserted at each of its substitution
+ * offsets, as a dynamic string.
+ */
+static char *expandIrString(char *image, uint32_t index, char pidStr[])
+{
+    struct cacheHeader *header = (struct cacheHeader *)image;
+    struct irString *string = (struct irString *)(image + header->stringsOffset) + index;
+    uint32_t *substitutions = (uint32_t *)(image + header->substitutionsOffset)
+                              + string->firstSubstitution;
+    char *text = image + header->poolOffset + string->offset;
+    size_t pidLength = strlen(pidStr);
+    size_t copied = 0;  /* the number of chars of text copied so far */
+    char *expanded;
+    char *position;
+    uint32_t i;
+
+    expanded = getEmptyString(string->length + string->numSubstitutions * pidLength + 1);
+    position = expanded;
+
+    for (i = 0; i < string->numSubstitutions; i++)
+    {
+        memcpy(position, text + copied, substitutions[i] - copied);
+        position += substitutions[i] - copied;
+        copied = substitutions[i];
+
+        memcpy(position, pidStr, pidLength);
+        position += pidLength;
+    }
+
+    memcpy(position, text + copied, string->length - copied + 1);
+
+    return expanded;
+}
+
+/* Builds a command from a compiled entry and launches it. */
+static void runCompiledCommand(struct shellState *shell, char *image,
+                               struct irEntry *entry, char pidStr[])
+{
+    struct cacheHeader *header = (struct cacheHeader *)image;
+    struct irRedirection *redirection;
+    struct command command;
+    char *fileName;
+    char *body;
+    int hereFileDescriptor = -1;
+    uint32_t i;
+
+    initializeCommand(&command, shell->jobDeadline);
+
+    command.inBackground = (entry->flags & IR_BACKGROUND) != 0;
+    if ((entry->flags & IR_TIMEOUT) != 0)
+    {
+        command.timeout = entry->timeout;
+        command.killAfter = entry->killAfter;
+        command.haveTimeout = true;
+    }
+
+    for (i = 0; i < entry->numArgs; i++)
+    {
+        command.args[command.numArgs++] = expandIrString(image, entry->firstArg + i, pidStr);
+    }
+
+    for (i = 0; i < entry->numRedirections; i++)
+    {
+        redirection = (struct irRedirection *)(image + header->redirectionsOffset)
+                      + entry->firstRedirection + i;
+        fileName = NULL;
+
+        if (redirection->fileName != IR_NONE)
+        {
+            fileName = expandIrString(image, redirection->fileName, pidStr);
+        }
+
+        addRedirection(&command.redirections, redirection->fd, redirection->type,
+                       fileName, redirection->sourceFd);
+        free(fileName);
+    }
+
+    /* The body of a here-document or here-string was read when the script
+     * was compiled, so only its memory file is made here.
+     */
+    if (entry->hereType != noHere && command.numArgs > 0)
+    {
+        body = expandIrString(image, entry->text, pidStr);
+        hereFileDescriptor = createHereBody(body, strlen(body));
+        free(body);
+
+        if (hereFileDescriptor == -1
+            || addRedirection(&command.redirections, 0, redirectDescriptor, NULL, hereFileDescriptor) == -1)
+        {
+            if (hereFileDescriptor != -1)
+            {
+                fprintf(stderr, "A commandline has a maximum of %d redirections\n", MAX_REDIRECTIONS);
+                close(hereFileDescriptor);
+            }
+            sprintf(shell->exitStatusStr,"exit value %d",1);
+            freeCommand(&command);
+            return;
+        }
+    }
+
+    launchCommand(shell, &command);
+
+    /* The child has its own copy of the memory file */
+    if (hereFileDescriptor != -1)
+    {
+        close(hereFileDescriptor);
+    }
+
+    freeCommand(&command);
+}
+
+/* Runs each entry of a valid cache image. */
+void runCacheImage(struct shellState *shell, char *image)
+{
+    struct cacheHeader *header = (struct cacheHeader *)image;
+    struct irEntry *entries = (struct irEntry *)(image + header->entriesOffset);
+    struct irString *strings = (struct irString *)(image + header->stringsOffset);
+    char pidStr[MAX_INT_LENGTH];  /* the value of $$ */
+    uint32_t i;
+
+    intToString(pidStr, (int)shell->parentPID);
+
+    for (i = 0; i < header->numEntries && shell->exitRequested == false; i++)
+    {
+        /* finished background jobs are reported and scheduled commands that
+         * are due are run between lines of the script
+         */
+        if (entries[i].connector == connectLine)
+        {
+            reapBackgroundJobs(shell);
+            runDueEntries(shell);
+            fflush(stdout);
+        }
+
+        /* a command after && or || is skipped as in runCommandLine */
+        if (!listCommandRuns(entries[i].connector, shell->lastStatus))
+        {
+            continue;
+        }
+
+        /* The last command of the script can be exec'd in place of the shell */
+        shell->lastLine = (i == header->numEntries - 1);
+        shell->tailCommand = shell->lastLine;
+
+        if (entries[i].kind == irLine)
+        {
+            runCommandLine(shell, image + header->poolOffset + strings[entries[i].text].offset);
+        }
+        else
+        {
+            runCompiledCommand(shell, image, &entries[i], pidStr);
+        }
+    }
+
+    shell->lastLine = false;
+    shell->tailCommand = false;
+
+    /* As when the input of the shell ends, the script ending exits the shell
+     * once the scheduled commands are done
+     */
+    if (shell->exitRequested == false)
+    {
+        runScheduleToEnd(shell);
+        exitShell(shell);
+    }
+}
+
+/* Fills in the key a cache file must match to be used for the script. */
+static int scriptKey(FILE *script, char *scriptName, struct cacheHeader *key)
+{
+    char resolvedPath[PATH_MAX];
+    struct stat scriptStat;
+    char *path = scriptName;
+    uint64_t hash = 14695981039346656037ULL;  /* FNV-1a offset basis */
+
+    if (fstat(fileno(script), &scriptStat) == -1 || !S_ISREG(scriptStat.st_mode))
+    {
+        return -1;
+    }
+
+    if (realpath(scriptName, resolvedPath) != NULL)
+    {
+        path = resolvedPath;
+    }
+
+    /* hash the path with 64 bit FNV-1a */
+    for (; *path != '\0'; path++)
+    {
+        hash = (hash ^ (unsigned char)*path) * 1099511628211ULL;
+    }
+
+    memset(key, '\0', sizeof(struct cacheHeader));
+    memcpy(key->magic, CACHE_MAGIC, CACHE_MAGIC_LENGTH);
+    key->formatVersion = CACHE_FORMAT_VERSION;
+    strncpy(key->shellVersion, SHELL_VERSION, CACHE_VERSION_LENGTH - 1);
+    key->pathHash = hash;
+    key->mtimeSeconds = scriptStat.st_mtim.tv_sec;
+    key->mtimeNanoseconds = scriptStat.st_mtim.tv_nsec;
+    key->scriptSize = scriptStat.st_size;
+
+    return 0;
+}
+
+/* Returns the path of the cache file of the script as a dynamic string */
+static char *cachePath(char *scriptName)
+{
+    char *directoryCopy = getEmptyString(strlen(scriptName) + 1);
+    char *nameCopy = getEmptyString(strlen(scriptName) + 1);
+    char *path;
+
+    /* dirname and basename may change their argument */
+    strcpy(directoryCopy, scriptName);
+    strcpy(nameCopy, scriptName);
+
+    path = getEmptyString(2 * strlen(scriptName) + strlen(CACHE_PREFIX) + strlen(CACHE_SUFFIX) + 3);
+    sprintf(path, "%s/%s%s%s", dirname(directoryCopy), CACHE_PREFIX, basename(nameCopy), CACHE_SUFFIX);
+
+    free(directoryCopy);
+    free(nameCopy);
+
+    return path;
+}
+
+/* Writes the image to a temporary file and renames it to the cache file, so
+ * another shell never maps a partly written cache. Failing to write the
+ * cache isn't an error since the script can still be run.
+ */
+static void writeCacheFile(char *path, char *image, size_t imageSize)
+{
+    char *temporaryPath = getEmptyString(strlen(path) + strlen(".XXXXXX") + 1);
+    int fileDescriptor;
+    ssize_t written;
+    size_t total = 0;
+
+    sprintf(temporaryPath, "%s.XXXXXX", path);
+
+    fileDescriptor = mkostemp(temporaryPath, O_CLOEXEC);
+    if (fileDescriptor == -1)
+    {
+        free(temporaryPath);
+        return;
+    }
+
+    while (total < imageSize)
+    {
+        written = write(fileDescriptor, image + total, imageSize - total);
+        if (written == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            break;
+        }
+        total += written;
+    }
+
+    if (close(fileDescriptor) == -1 || total != imageSize || rename(temporaryPath, path) == -1)
+    {
+        unlink(temporaryPath);
+    }
+
+    free(temporaryPath);
+}
+
+/* Runs a script from its cache file, compiling the script and writing the
+ * cache file first if it is missing or out of date.
+ */
+int runCachedScript(struct shellState *shell, char *scriptName)
+{
+    struct cacheHeader key;
+    struct stat cacheStat;
+    char *path;
+    char *image = MAP_FAILED;
+    size_t imageSize = 0;
+    int fileDescriptor;
+
+    if (scriptKey(shell->input, scriptName, &key) == -1)
+    {
+        return -1;
+    }
+
+    path = cachePath(scriptName);
+
+    /* Map an existing cache file, which is used if it was compiled from this
+     * version of the script by this version of the shell
+     */
+    fileDescriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (fileDescriptor != -1)
+    {
+        if (fstat(fileDescriptor, &cacheStat) == 0 && cacheStat.st_size >= (off_t)sizeof(struct cacheHeader))
+        {
+            imageSize = cacheStat.st_size;
+            image = mmap(NULL, imageSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        }
+        close(fileDescriptor);
+
+        if (image != MAP_FAILED && validCacheImage(image, imageSize, &key))
+        {
+            free(path);
+            runCacheImage(shell, image);
+            munmap(image, imageSize);
+            return 0;
+        }
+
+        if (image != MAP_FAILED)
+        {
+            munmap(image, imageSize);
+        }
+    }
+
+    /* Otherwise compile the script and replace the cache file */
+    image = compileScript(shell->input, &key, &imageSize);
+    if (image == NULL)
+    {
+        free(path);
+        return -1;
+    }
+
+    writeCacheFile(path, image, imageSize);
+    free(path);
+
+    runCacheImage(shell, image);
+    free(image);
+
+    return 0;
+}
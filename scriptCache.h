@@ -0,0 +1,191 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the compiled form of a script and the functions for
+ *              caching and running it including:
+ *
+ *               compiling each command of a script into an entry holding
+ *               its pre-split arguments, redirections, background flag,
+ *               time limit, here-document body and the ;, && or || that
+ *               joins it to the command before it
+ *               recording where $$ is substituted in each string
+ *               writing the compiled script to a cache file beside it
+ *               mapping the cache file on later runs and running it without
+ *               expanding or parsing any commandline
+ *
+ *              The cache file .NAME.bshc is keyed by the script's path,
+ *              modification time and size and by the shell version, and is
+ *              rebuilt when any of them change. Inbuilt commands are stored
+ *              as their original line and run as usual. A script with a
+ *              here-document on a line stored that way isn't cached, since
+ *              the body is read from the script when the line runs.
+ *
+ **************************************************************************/
+
+#ifndef SCRIPT_CACHE_H
+#define SCRIPT_CACHE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>     /* for the fixed size fields of the cache file */
+#include <string.h>
+#include <limits.h>     /* for PATH_MAX */
+#include <fcntl.h>
+#include <unistd.h>
+#include <libgen.h>     /* for dirname and basename */
+#include <sys/mman.h>   /* for mmap */
+#include <sys/stat.h>   /* for the modification time and size of the script */
+
+/* Identifies a cache file and the layout of its contents */
+#define CACHE_MAGIC "BSHCACHE"
+#define CACHE_MAGIC_LENGTH 8
+#define CACHE_FORMAT_VERSION 2
+#define CACHE_VERSION_LENGTH 16
+
+/* The cache file of script NAME is .NAME.bshc in the same directory */
+#define CACHE_PREFIX "."
+#define CACHE_SUFFIX ".bshc"
+
+/* Sections of the cache file start on multiples of this */
+#define CACHE_ALIGNMENT 8
+
+/* Used for a string index that doesn't refer to a string */
+#define IR_NONE UINT32_MAX
+
+/* The kind of a compiled line:
+ * irCommand  a command that is launched as a process
+ * irLine     an inbuilt command, run from its original line
+ */
+enum irKind{ irCommand, irLine};
+
+/* Flags of a compiled command */
+#define IR_BACKGROUND 1
+#define IR_TIMEOUT 2
+
+/* The header at the start of a cache file. Offsets are from the start of
+ * the file.
+ */
+struct cacheHeader
+{
+    char magic[CACHE_MAGIC_LENGTH];
+    uint32_t formatVersion;
+    char shellVersion[CACHE_VERSION_LENGTH];
+
+    /* the key of the script the cache was compiled from */
+    uint64_t pathHash;
+    int64_t mtimeSeconds;
+    int64_t mtimeNanoseconds;
+    int64_t scriptSize;
+
+    uint64_t totalSize;  /* the size of the whole cache file */
+
+    uint32_t numEntries;
+    uint32_t entriesOffset;
+    uint32_t numStrings;
+    uint32_t stringsOffset;
+    uint32_t numRedirections;
+    uint32_t redirectionsOffset;
+    uint32_t numSubstitutions;
+    uint32_t substitutionsOffset;
+    uint32_t poolSize;
+    uint32_t poolOffset;
+};
+
+/* A '\0' ended string in the pool with $$ removed. The pid is inserted at
+ * each of its substitution offsets when the command is run.
+ */
+struct irString
+{
+    uint32_t offset;  /* offset of the string in the pool */
+    uint32_t length;
+    uint32_t firstSubstitution;
+    uint32_t numSubstitutions;
+};
+
+/* A compiled redirection, as in struct redirection */
+struct irRedirection
+{
+    int32_t fd;
+    int32_t type;
+    int32_t sourceFd;
+    uint32_t fileName;  /* string index or IR_NONE */
+};
+
+/* A compiled line of the script */
+struct irEntry
+{
+    uint32_t kind;
+    uint32_t connector;  /* how the command is joined to the one before it */
+    uint32_t flags;
+    uint32_t hereType;
+
+    /* the original line of an irLine, or the here-document or here-string
+     * body of an irCommand, or IR_NONE
+     */
+    uint32_t text;
+
+    uint32_t firstArg;  /* the args are consecutive strings */
+    uint32_t numArgs;
+    uint32_t firstRedirection;
+    uint32_t numRedirections;
+
+    double timeout;
+    double killAfter;
+};
+
+/* A growable array of bytes used to build a section of the cache file */
+struct irBuffer
+{
+    char *data;
+    size_t size;
+    size_t capacity;
+};
+
+/* The sections of a script as it is compiled */
+struct irBuilder
+{
+    struct irBuffer entries;
+    struct irBuffer strings;
+    struct irBuffer redirections;
+    struct irBuffer substitutions;
+    struct irBuffer pool;
+};
+
+struct shellState;
+
+/* Runs a script from its cache file, compiling the script and writing the
+ * cache file first if it is missing or out of date. If the cache file can't
+ * be written the compiled script is still run.
+ * input: the shell, whose input is the opened script: struct shellState *
+ *        the path of the script: char *
+ * output: 0 if the script was run, or -1 if it couldn't be compiled, such
+ *         as when a here-document delimiter holds $$, in which case the
+ *         script should be run line by line
+ */
+int runCachedScript(struct shellState *shell, char *scriptName);
+
+/* Compiles a script into a cache image, with the header filled in.
+ * input: the opened script, which is rewound afterwards: FILE *
+ *        the key of the script: struct cacheHeader *
+ *        set to the size of the image: size_t *
+ * output: a dynamic array holding the image or NULL if the script can't
+ *         be compiled
+ */
+char *compileScript(FILE *script, struct cacheHeader *key, size_t *imageSize);
+
+/* Returns true if the cache image is complete, matches the key and all of
+ * its indices and offsets are in bounds.
+ * input: the image: char *
+ *        the size of the image: size_t
+ *        the key of the script: struct cacheHeader *
+ */
+bool validCacheImage(char *image, size_t imageSize, struct cacheHeader *key);
+
+/* Runs each entry of a valid cache image.
+ * input: the shell: struct shellState *
+ *        the image: char *
+ */
+void runCacheImage(struct shellState *shell, char *image);
+
+#endif
@@ -0,0 +1,919 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements shell functions and aliases including:
+ *
+ *               a hash table of the functions and aliases, hashed with
+ *               FNV-1a and chained, that doubles when it is three quarters
+ *               full
+ *               parsing the body of a function once into templates and the
+ *               value of an alias once into a command
+ *               expanding an alias in place into the command launched
+ *               calling a function with its arguments as the positional
+ *               parameters of its templates, in the shell's own process
+ *               the alias, unalias and return inbuilt commands
+ *
+ *              A call never tokenizes or parses the function or alias
+ *              again, and only a function run in the background forks.
+ *
+ **************************************************************************/
+
+#include "shellFunction.h"
+#include "bashShell.h"  /* for parsing, launching and running commands */
+
+/* Returns the text past any leading whitespace */
+static char *skipSpaces(char *text)
+{
+    while (*text != '\0' && isspace((unsigned char)*text))
+    {
+        ++text;
+    }
+
+    return text;
+}
+
+/* Ends the text before any trailing whitespace */
+static void trimSpaces(char *text)
+{
+    size_t length = strlen(text);
+
+    while (length > 0 && isspace((unsigned char)text[length - 1]))
+    {
+        --length;
+    }
+
+    text[length] = '\0';
+}
+
+/* Returns true if the character can be part of the name of an alias */
+static bool isAliasCharacter(char character)
+{
+    return isalnum((unsigned char)character) || character == '_'
+           || character == '-' || character == '.';
+}
+
+/* Returns the FNV-1a hash of the name */
+static uint32_t hashName(char *name)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    while (*name != '\0')
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/* Initializes an empty table, whose buckets are made by addDefinition. */
+void initializeFunctions(struct functionTable *table)
+{
+    table->buckets = NULL;
+    table->capacity = 0;
+    table->count = 0;
+    table->depth = 0;
+    table->returning = false;
+}
+
+/* Frees a definition and what it holds */
+static void freeDefinition(struct definition *definition)
+{
+    freeTemplates(&definition->commands);
+
+    if (definition->template != NULL)
+    {
+        freeCommand(definition->template);
+        free(definition->template);
+    }
+
+    free(definition->name);
+    free(definition->text);
+    free(definition);
+}
+
+/* Frees the functions and aliases of the table. */
+void freeFunctions(struct functionTable *table)
+{
+    struct definition *definition;
+    struct definition *next;
+    int i;
+
+    for (i = 0; i < table->capacity; i++)
+    {
+        for (definition = table->buckets[i]; definition != NULL; definition = next)
+        {
+            next = definition->next;
+            freeDefinition(definition);
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+/* Returns the function or alias of the name, or NULL if there isn't one */
+static struct definition *findDefinition(struct functionTable *table, enum definitionKind kind, char *name)
+{
+    struct definition *definition;
+
+    if (table->count == 0)
+    {
+        return NULL;
+    }
+
+    for (definition = table->buckets[hashName(name) & (table->capacity - 1)];
+         definition != NULL; definition = definition->next)
+    {
+        if (definition->kind == kind && strcmp(definition->name, name) == 0)
+        {
+            return definition;
+        }
+    }
+
+    return NULL;
+}
+
+/* Doubles the number of buckets of the table and moves each definition to
+ * its new bucket
+ */
+static void growTable(struct functionTable *table)
+{
+    struct definition **buckets;
+    struct definition *definition;
+    struct definition *next;
+    int capacity = table->capacity * 2;
+    uint32_t bucket;
+    int i;
+
+    buckets = calloc(capacity, sizeof(struct definition *));
+    if (buckets == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < table->capacity; i++)
+    {
+        for (definition = table->buckets[i]; definition != NULL; definition = next)
+        {
+            next = definition->next;
+            bucket = hashName(definition->name) & (capacity - 1);
+            definition->next = buckets[bucket];
+            buckets[bucket] = definition;
+        }
+    }
+
+    free(table->buckets);
+    table->buckets = buckets;
+    table->capacity = capacity;
+}
+
+/* Adds an empty function or alias of the name to the table and returns it */
+static struct definition *addDefinition(struct functionTable *table, enum definitionKind kind, char *name)
+{
+    struct definition *definition;
+    uint32_t bucket;
+
+    if (table->buckets == NULL)
+    {
+        table->capacity = FUNCTION_TABLE_CAPACITY;
+        table->buckets = calloc(table->capacity, sizeof(struct definition *));
+        if (table->buckets == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+    }
+    else if ((table->count + 1) * 4 > table->capacity * 3)
+    {
+        growTable(table);
+    }
+
+    definition = malloc(sizeof(struct definition));
+    if (definition == NULL || (definition->name = strdup(name)) == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    definition->kind = kind;
+    definition->text = NULL;
+    definition->commands.commands = NULL;
+    definition->commands.count = 0;
+    definition->template = NULL;
+    definition->active = 0;
+
+    bucket = hashName(name) & (table->capacity - 1);
+    definition->next = table->buckets[bucket];
+    table->buckets[bucket] = definition;
+    ++table->count;
+
+    return definition;
+}
+
+/* Removes a function or alias from the table and frees it */
+static void removeDefinition(struct functionTable *table, struct definition *definition)
+{
+    struct definition **link = &table->buckets[hashName(definition->name) & (table->capacity - 1)];
+
+    while (*link != definition)
+    {
+        link = &(*link)->next;
+    }
+
+    *link = definition->next;
+    --table->count;
+    freeDefinition(definition);
+}
+
+/* Sets the exit status of the shell */
+static void setStatus(struct shellState *shell, int status)
+{
+    sprintf(shell->exitStatusStr,"exit value %d",status);
+    shell->lastStatus = status;
+}
+
+/* Defines the function of a NAME() { COMMANDS; } commandline, replacing any
+ * function of that name.
+ */
+void functionBuiltin(struct shellState *shell, char commandText[])
+{
+    char name[MAX_VARIABLE_NAME];
+    struct definition *function;
+    struct templateParameters parameters;
+    struct templateList commands;
+    struct commandList list;
+    char *body;
+    char *end;
+    size_t nameLength = 0;
+
+    while (isalnum((unsigned char)commandText[nameLength]) || commandText[nameLength] == '_')
+    {
+        ++nameLength;
+    }
+
+    if (nameLength >= MAX_VARIABLE_NAME)
+    {
+        printf("A function name has a maximum length of %d\n", MAX_VARIABLE_NAME - 1);
+        setStatus(shell, FUNCTION_SYNTAX_ERROR);
+        return;
+    }
+
+    memcpy(name, commandText, nameLength);
+    name[nameLength] = '\0';
+
+    /* The body is the text between the { and the last }, which follows a ;
+     * or a space as in bash
+     */
+    trimSpaces(commandText);
+    body = skipSpaces(commandText + functionHeader(commandText));
+    end = commandText + strlen(commandText) - 1;
+
+    if (*body != '{' || end == body || *end != '}'
+        || (end - 1 != body && end[-1] != ';' && !isspace((unsigned char)end[-1])))
+    {
+        printf("syntax error: %s() needs a body of { COMMANDS; }\n", name);
+        setStatus(shell, FUNCTION_SYNTAX_ERROR);
+        return;
+    }
+
+    function = findDefinition(&shell->functions, functionDefinition, name);
+    if (function != NULL && function->active > 0)
+    {
+        printf("%s: a function can't be defined again while it runs\n", name);
+        setStatus(shell, 1);
+        return;
+    }
+
+    /* The templates point into the body, which is kept with them */
+    body = strndup(body + 1, end - body - 1);
+    if (body == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    positionalParameters(&parameters, NULL, 0);
+    commands.commands = NULL;
+    commands.count = 0;
+
+    if (splitCommandList(body, &list, true) == -1
+        || compileTemplates(shell, list.commands, list.count, &parameters, &commands) == -1)
+    {
+        freeTemplates(&commands);
+        free(body);
+        setStatus(shell, FUNCTION_SYNTAX_ERROR);
+        return;
+    }
+
+    if (function == NULL)
+    {
+        function = addDefinition(&shell->functions, functionDefinition, name);
+    }
+    else
+    {
+        freeTemplates(&function->commands);
+        free(function->text);
+    }
+
+    function->text = body;
+    function->commands = commands;
+
+    setStatus(shell, 0);
+}
+
+/* Compares the names of two aliases for qsort */
+static int compareNames(const void *a, const void *b)
+{
+    return strcmp((*(struct definition * const *)a)->name, (*(struct definition * const *)b)->name);
+}
+
+/* Prints an alias in the form it is defined */
+static void printAlias(struct definition *alias)
+{
+    printf("alias %s=%s\n", alias->name, alias->text);
+}
+
+/* Prints every alias, sorted by name as bash does */
+static void listAliases(struct functionTable *table)
+{
+    struct definition **aliases;
+    struct definition *definition;
+    int count = 0;
+    int i;
+
+    aliases = malloc((table->count + 1) * sizeof(struct definition *));
+    if (aliases == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    for (i = 0; i < table->capacity; i++)
+    {
+        for (definition = table->buckets[i]; definition != NULL; definition = definition->next)
+        {
+            if (definition->kind == aliasDefinition)
+            {
+                aliases[count++] = definition;
+            }
+        }
+    }
+
+    qsort(aliases, count, sizeof(struct definition *), compareNames);
+
+    for (i = 0; i < count; i++)
+    {
+        printAlias(aliases[i]);
+    }
+
+    free(aliases);
+}
+
+/* Parses the value of an alias into a command if it is a single command
+ * that can be launched, or returns NULL if it is run from its text
+ */
+static struct command *compileAlias(struct shellState *shell, char *value)
+{
+    char valueCopy[MAX_COMMAND_LINE_EXPANDED];  /* splitting and parsing change the text */
+    struct commandList list;
+    struct command *command;
+
+    strcpy(valueCopy, value);
+    if (splitCommandList(valueCopy, &list, false) == -1 || list.count != 1)
+    {
+        return NULL;
+    }
+
+    command = malloc(sizeof(struct command));
+    if (command == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+
+    strcpy(valueCopy, value);
+    initializeCommand(command, shell->jobDeadline);
+
+    if (parseListCommand(valueCopy, command) == false || command->numArgs == 0)
+    {
+        freeCommand(command);
+        free(command);
+        return NULL;
+    }
+
+    return command;
+}
+
+/* Defines an alias from NAME=VALUE, where the name has the given length */
+static int defineAlias(struct shellState *shell, char *text, size_t nameLength)
+{
+    struct definition *alias;
+    char *value = text + nameLength + 1;
+    size_t valueLength = strlen(value);
+
+    text[nameLength] = '\0';
+
+    /* alias ll='ls -l' is taken as it is in bash */
+    if (valueLength >= 2 && (value[0] == '\'' || value[0] == '"') && value[valueLength - 1] == value[0])
+    {
+        value[valueLength - 1] = '\0';
+        ++value;
+    }
+
+    alias = findDefinition(&shell->functions, aliasDefinition, text);
+    if (alias != NULL && alias->active > 0)
+    {
+        printf("alias: %s can't be defined again while it runs\n", text);
+        return 1;
+    }
+
+    if (alias == NULL)
+    {
+        alias = addDefinition(&shell->functions, aliasDefinition, text);
+    }
+    else
+    {
+        free(alias->text);
+        if (alias->template != NULL)
+        {
+            freeCommand(alias->template);
+            free(alias->template);
+        }
+    }
+
+    alias->text = strdup(value);
+    if (alias->text == NULL)
+    {
+        fprintf(stderr, "Malloc not successful\n");
+        exit(1);
+    }
+    alias->template = compileAlias(shell, value);
+
+    return 0;
+}
+
+/* Runs the alias inbuilt command. */
+void aliasBuiltin(struct shellState *shell, char commandText[])
+{
+    struct definition *alias;
+    char *text = skipSpaces(commandText + strlen("alias"));
+    char *token;
+    char *savePosition;
+    size_t nameLength = 0;
+    int status = 0;
+
+    trimSpaces(text);
+
+    if (*text == '\0')
+    {
+        listAliases(&shell->functions);
+        setStatus(shell, 0);
+        return;
+    }
+
+    while (isAliasCharacter(text[nameLength]))
+    {
+        ++nameLength;
+    }
+
+    /* The value is the rest of the commandline, spaces and all */
+    if (text[nameLength] == '=')
+    {
+        if (nameLength == 0)
+        {
+            printf("alias: `%s': invalid alias name\n", text);
+            status = 1;
+        }
+        else
+        {
+            status = defineAlias(shell, text, nameLength);
+        }
+        setStatus(shell, status);
+        return;
+    }
+
+    for (token = strtok_r(text, " \n", &savePosition); token != NULL;
+         token = strtok_r(NULL, " \n", &savePosition))
+    {
+        alias = findDefinition(&shell->functions, aliasDefinition, token);
+        if (alias == NULL)
+        {
+            printf("alias: %s: not found\n", token);
+            status = 1;
+        }
+        else
+        {
+            printAlias(alias);
+        }
+    }
+
+    setStatus(shell, status);
+}
+
+/* Removes an alias unless it is being expanded. Returns 1 if it can't be. */
+static int removeAlias(struct functionTable *table, struct definition *alias)
+{
+    if (alias->active > 0)
+    {
+        printf("unalias: %s can't be removed while it runs\n", alias->name);
+        return 1;
+    }
+
+    removeDefinition(table, alias);
+
+    return 0;
+}
+
+/* Runs the unalias inbuilt command, which removes the aliases named. */
+void unaliasBuiltin(struct shellState *shell, char commandText[])
+{
+    struct functionTable *table = &shell->functions;
+    struct definition *alias;
+    struct definition *next;
+    char *token;
+    char *savePosition;
+    int status = 0;
+    int i;
+
+    token = strtok_r(commandText + strlen("unalias"), " \n", &savePosition);
+    if (token == NULL)
+    {
+        printf("unalias: usage: unalias [-a] NAME...\n");
+        setStatus(shell, FUNCTION_SYNTAX_ERROR);
+        return;
+    }
+
+    if (strcmp(token, "-a") == 0)
+    {
+        for (i = 0; i < table->capacity; i++)
+        {
+            for (alias = table->buckets[i]; alias != NULL; alias = next)
+            {
+                next = alias->next;
+                if (alias->kind == aliasDefinition)
+                {
+                    status |= removeAlias(table, alias);
+                }
+            }
+        }
+        setStatus(shell, status);
+        return;
+    }
+
+    for (; token != NULL; token = strtok_r(NULL, " \n", &savePosition))
+    {
+        alias = findDefinition(table, aliasDefinition, token);
+        if (alias == NULL)
+        {
+            printf("unalias: %s: not found\n", token);
+            status = 1;
+        }
+        else
+        {
+            status |= removeAlias(table, alias);
+        }
+    }
+
+    setStatus(shell, status);
+}
+
+/* Runs the return inbuilt command. */
+void returnBuiltin(struct shellState *shell, char commandText[])
+{
+    char *token;
+    char *savePosition;
+    char *end;
+    long status;
+
+    if (shell->functions.depth == 0)
+    {
+        printf("return: can only return from a function\n");
+        setStatus(shell, 1);
+        return;
+    }
+
+    token = strtok_r(commandText + strlen("return"), " \n", &savePosition);
+    if (token != NULL)
+    {
+        status = strtol(token, &end, 10);
+        if (*end != '\0' || end == token)
+        {
+            printf("return: %s: numeric argument required\n", token);
+            status = FUNCTION_SYNTAX_ERROR;
+        }
+        setStatus(shell, status & 0xff);
+    }
+
+    /* runTemplates stops at the end of this command */
+    shell->functions.returning = true;
+}
+
+/* Expands an alias parsed into a command: the alias's arguments and
+ * redirections go in front of those of the call, which are borrowed
+ * rather than copied, and the result is launched.
+ */
+static void expandAlias(struct shellState *shell, struct definition *alias, struct command *command)
+{
+    struct command *template = alias->template;
+    struct command expanded;
+    int numArgs = template->numArgs + command->numArgs - 1;
+    int numBorrowed = template->redirections.count + command->redirections.count;
+    int i;
+
+    if (numBorrowed > MAX_REDIRECTIONS)
+    {
+        fprintf(stderr, "A commandline has a maximum of %d redirections\n", MAX_REDIRECTIONS);
+        setStatus(shell, 1);
+        return;
+    }
+
+    /* The call decides how the command runs, as with a time limit or
+     * batch, while the alias can add a here-string or &
+     */
+    expanded = *command;
+    expanded.inBackground = (command->inBackground == true || template->inBackground == true);
+    if (command->hereType == noHere && template->hereType != noHere)
+    {
+        expanded.hereType = template->hereType;
+        strcpy(expanded.hereWord, template->hereWord);
+    }
+
+    if (numArgs < MAX_NUM_ARGS)
+    {
+        expanded.args = expanded.inlineArgs;
+        expanded.argsCapacity = MAX_NUM_ARGS;
+    }
+    else
+    {
+        expanded.args = malloc((numArgs + 1) * sizeof(char *));
+        if (expanded.args == NULL)
+        {
+            fprintf(stderr, "Malloc not successful\n");
+            exit(1);
+        }
+        expanded.argsCapacity = numArgs + 1;
+    }
+
+    memcpy(expanded.args, template->args, template->numArgs * sizeof(char *));
+    memcpy(expanded.args + template->numArgs, command->args + 1, (command->numArgs - 1) * sizeof(char *));
+    expanded.args[numArgs] = NULL;
+    expanded.numArgs = numArgs;
+    expanded.firstSubstitutedArg = (command->firstSubstitutedArg > 0)
+                                   ? command->firstSubstitutedArg + template->numArgs - 1 : -1;
+
+    memcpy(expanded.redirections.entries, template->redirections.entries,
+           template->redirections.count * sizeof(struct redirection));
+    memcpy(expanded.redirections.entries + template->redirections.count, command->redirections.entries,
+           command->redirections.count * sizeof(struct redirection));
+    expanded.redirections.count = numBorrowed;
+
+    alias->active = 1;
+    launchCommand(shell, &expanded);
+    alias->active = 0;
+
+    /* Only the redirections launchCommand added belong to the expansion */
+    for (i = numBorrowed; i < expanded.redirections.count; i++)
+    {
+        free(expanded.redirections.entries[i].fileName);
+    }
+
+    if (expanded.args != expanded.inlineArgs)
+    {
+        free(expanded.args);
+    }
+}
+
+/* Runs an alias of inbuilt commands, a list or a $(...) from its text with
+ * the arguments of the call after it and the call's redirections applied
+ * to every command
+ */
+static void runAliasText(struct shellState *shell, struct definition *alias, struct command *command)
+{
+    char text[MAX_COMMAND_LINE_EXPANDED];
+    struct commandList list;
+    int savedFds[3];  /* the stdio fds of the shell's commands outside the alias */
+    bool tailCommand = shell->tailCommand;
+    size_t length;
+    int i;
+
+    if (command->hereType != noHere || command->inBackground == true)
+    {
+        printf("%s: an alias of inbuilt commands can't take a here-document or &\n", alias->name);
+        setStatus(shell, 1);
+        return;
+    }
+
+    length = strlen(alias->text);
+    if (length >= MAX_COMMAND_LINE_EXPANDED)
+    {
+        printf("The command line has a maximum length of %d\n", MAX_COMMAND_LINE_EXPANDED);
+        setStatus(shell, 1);
+        return;
+    }
+    strcpy(text, alias->text);
+
+    for (i = 1; i < command->numArgs; i++)
+    {
+        if (length + 1 + strlen(command->args[i]) >= MAX_COMMAND_LINE_EXPANDED)
+        {
+            printf("The command line has a maximum length of %d\n", MAX_COMMAND_LINE_EXPANDED);
+            setStatus(shell, 1);
+            return;
+        }
+        text[length++] = ' ';
+        strcpy(text + length, command->args[i]);
+        length += strlen(command->args[i]);
+    }
+
+    if (pushSessionRedirections(shell, &command->redirections, savedFds) == -1)
+    {
+        setStatus(shell, 1);
+        return;
+    }
+
+    if (splitCommandList(text, &list, true) == -1)
+    {
+        setStatus(shell, LIST_SYNTAX_ERROR);
+    }
+    else
+    {
+        /* A command of the alias is never exec'd in place of the shell */
+        shell->tailCommand = false;
+        alias->active = 1;
+
+        for (i = 0; i < list.count && shell->exitRequested == false; i++)
+        {
+            if (listCommandRuns(list.commands[i].connector, shell->lastStatus))
+            {
+                runListCommand(shell, list.commands[i].text);
+            }
+            else
+            {
+                skipListCommand(shell, list.commands[i].text);
+            }
+        }
+
+        alias->active = 0;
+        shell->tailCommand = tailCommand;
+    }
+
+    popSessionRedirections(shell, &command->redirections, savedFds);
+}
+
+/* Expands the command in place if its first argument names an alias. */
+bool launchAlias(struct shellState *shell, struct command *command)
+{
+    struct definition *alias;
+
+    /* Most commands are no alias, and the table isn't searched while it
+     * is empty. A name that came from a $(...) is never an alias.
+     */
+    if (shell->functions.count == 0 || command->numArgs == 0 || command->firstSubstitutedArg == 0)
+    {
+        return false;
+    }
+
+    alias = findDefinition(&shell->functions, aliasDefinition, command->args[0]);
+    if (alias == NULL || alias->active > 0)
+    {
+        return false;
+    }
+
+    if (alias->template != NULL)
+    {
+        expandAlias(shell, alias, command);
+    }
+    else
+    {
+        runAliasText(shell, alias, command);
+    }
+
+    return true;
+}
+
+/* Runs the commands of a function with the arguments of the call as its
+ * positional parameters and the call's redirections applied to them
+ */
+static void callFunction(struct shellState *shell, struct definition *function, struct command *command)
+{
+    struct templateParameters parameters;
+    int savedFds[3];  /* the stdio fds of the shell's commands outside the function */
+    bool tailCommand = shell->tailCommand;
+
+    if (shell->functions.depth == MAX_FUNCTION_DEPTH)
+    {
+        fprintf(stderr, "%s: maximum function nesting level of %d exceeded\n",
+                function->name, MAX_FUNCTION_DEPTH);
+        setStatus(shell, 1);
+        return;
+    }
+
+    if (pushSessionRedirections(shell, &command->redirections, savedFds) == -1)
+    {
+        setStatus(shell, 1);
+        return;
+    }
+
+    /* A function with no commands succeeds, as in bash */
+    setStatus(shell, 0);
+
+    /* A command of a function can run again, so it is never exec'd in
+     * place of the shell
+     */
+    shell->tailCommand = false;
+    ++shell->functions.depth;
+    ++function->active;
+
+    positionalParameters(&parameters, command->args + 1, command->numArgs - 1);
+    runTemplates(shell, &function->commands, &parameters);
+
+    --function->active;
+    --shell->functions.depth;
+    shell->functions.returning = false;
+    shell->tailCommand = tailCommand;
+
+    popSessionRedirections(shell, &command->redirections, savedFds);
+}
+
+/* Calls the function that the command's first argument names. */
+bool launchFunction(struct shellState *shell, struct command *command)
+{
+    struct definition *function;
+    struct sigaction ignoreAction = {0};
+    pid_t spawnPid;
+
+    if (shell->functions.count == 0)
+    {
+        return false;
+    }
+
+    function = findDefinition(&shell->functions, functionDefinition, command->args[0]);
+    if (function == NULL)
+    {
+        return false;
+    }
+
+    if (command->inBackground == false)
+    {
+        callFunction(shell, function, command);
+        return true;
+    }
+
+    /* A function in the background runs in a copy of the shell, which has
+     * no jobs of its own yet. Both streams are flushed so the copy doesn't
+     * write out the shell's buffered output again.
+     */
+    fflush(stdout);
+    fflush(stderr);
+    spawnPid = fork();
+
+    switch (spawnPid)
+    {
+        case -1:
+        {
+            perror("Error creating fork\n");
+            exit(1);
+        }
+        case 0:
+        {
+            ignoreAction.sa_handler = SIG_IGN;
+            sigaction(SIGTSTP, &ignoreAction, NULL);
+
+            freeJobTable(&shell->jobs);
+            initializeJobTable(&shell->jobs, ARRAY_CAPACITY_BG);
+
+            /* The copy forks its own commands, so they can't be mixed up
+             * with the shell's at the launcher helper
+             */
+            releaseLauncher(&shell->launcher);
+
+            /* The scheduled entries and the open /proc files of the jobs
+             * are the shell's, so the copy lets go of them rather than run
+             * an entry a second time. Its closing the copy of the timerfd
+             * leaves the shell's timer armed. The job slots go by the PID
+             * of the shell that holds them, so the copy's jobs take their
+             * own.
+             */
+            freeSchedule(&shell->schedule);
+            initializeSchedule(&shell->schedule);
+            freeJobMonitor(&shell->monitor);
+
+            callFunction(shell, function, command);
+
+            fflush(stdout);
+            _exit(shell->lastStatus & 0xff);
+        }
+        default:
+        {
+            addJob(&shell->jobs, spawnPid);
+            printf("background PID is %d\n", spawnPid);
+            setStatus(shell, 0);
+        }
+    }
+
+    return true;
+}
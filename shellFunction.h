@@ -0,0 +1,164 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines shell functions and aliases including:
+ *
+ *               a hash table of the functions and aliases by name
+ *               defining a function with NAME() { COMMANDS; }, whose
+ *               commands are parsed once into templates
+ *               defining an alias with alias NAME=VALUE, whose value is
+ *               parsed once into a command
+ *               calling a function or alias from launchCommand, in the
+ *               shell's own process
+ *               the alias, unalias and return inbuilt commands
+ *
+ *              A function is called with its arguments as $1 - $9, ${N},
+ *              $# and $@, which are patched into copies of its templates.
+ *              Redirections of 0 - 2 on the call apply to every command
+ *              of the function, and a call ending with & runs the function
+ *              in a child copy of the shell. return [N] leaves a function.
+ *
+ *              An alias of a single command is expanded in place: its
+ *              arguments and redirections go in front of those of the
+ *              call and the result is launched with no more parsing. An
+ *              alias of inbuilt commands, a list or a $(...) is run from
+ *              its text with the arguments of the call after it. An alias
+ *              isn't expanded inside its own expansion.
+ *
+ *              The value of an alias is the rest of the commandline after
+ *              the =, so alias ll=ls -l works without quotes. Inbuilt
+ *              commands can't be replaced by a function or alias.
+ *
+ **************************************************************************/
+
+#ifndef SHELL_FUNCTION_H
+#define SHELL_FUNCTION_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include "commandList.h"      /* for splitting the body of a function */
+#include "commandTemplate.h"  /* for the commands of a function, parsed once */
+
+/* The initial number of buckets of the hash table, which doubles when it
+ * is three quarters full
+ */
+#define FUNCTION_TABLE_CAPACITY 16
+
+/* How deeply functions can call each other before a call fails */
+#define MAX_FUNCTION_DEPTH 100
+
+/* The exit status of a definition that doesn't parse, as in bash */
+#define FUNCTION_SYNTAX_ERROR 2
+
+/* The 32 bit FNV-1a offset basis and prime used to hash names */
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+/* Used to indicate if a definition is a function or an alias, which have
+ * names of their own
+ */
+enum definitionKind{ functionDefinition, aliasDefinition};
+
+struct shellState;
+struct command;
+
+/* A function or alias in the hash table */
+struct definition
+{
+    enum definitionKind kind;
+    char *name;
+
+    /* The body of a function, split up into its commands, or the value of
+     * an alias
+     */
+    char *text;
+
+    struct templateList commands;  /* the commands of a function */
+
+    /* The value of an alias parsed once, or NULL if it is run from its
+     * text
+     */
+    struct command *template;
+
+    /* The number of calls of a function running, or 1 while an alias is
+     * being expanded, when it can't be changed
+     */
+    int active;
+
+    struct definition *next;  /* the next definition in the bucket */
+};
+
+/* The functions and aliases of a shell */
+struct functionTable
+{
+    struct definition **buckets;
+    int capacity;
+    int count;
+
+    int depth;  /* the number of function calls running */
+    bool returning;  /* true once return runs, until the function ends */
+};
+
+/* Initializes an empty table. Its buckets aren't made until the first
+ * function or alias is defined.
+ * input: the table: struct functionTable *
+ */
+void initializeFunctions(struct functionTable *table);
+
+/* Frees the functions and aliases of the table.
+ * input: the table: struct functionTable *
+ */
+void freeFunctions(struct functionTable *table);
+
+/* Defines the function of a NAME() { COMMANDS; } commandline, replacing any
+ * function of that name, and sets the exit status of the shell.
+ * input: the shell: struct shellState *
+ *        the $$ expanded definition: char[]
+ */
+void functionBuiltin(struct shellState *shell, char commandText[]);
+
+/* Runs the alias inbuilt command: alias lists every alias, alias NAME...
+ * prints those named and alias NAME=VALUE defines one.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ */
+void aliasBuiltin(struct shellState *shell, char commandText[]);
+
+/* Runs the unalias inbuilt command, which removes the aliases named.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ */
+void unaliasBuiltin(struct shellState *shell, char commandText[]);
+
+/* Runs the return inbuilt command, which leaves the function running with
+ * the exit status given or that of the last command.
+ * input: the shell: struct shellState *
+ *        the $$ expanded commandline: char[]
+ */
+void returnBuiltin(struct shellState *shell, char commandText[]);
+
+/* Expands the command in place if its first argument names an alias and
+ * launches the result.
+ * input: the shell: struct shellState *
+ *        the parsed command, whose here-document hasn't been read:
+ *        struct command *
+ * output: true if the command was an alias and has been run
+ */
+bool launchAlias(struct shellState *shell, struct command *command);
+
+/* Calls the function that the command's first argument names with the
+ * rest of its arguments.
+ * input: the shell: struct shellState *
+ *        the parsed command, with its here-document, background and
+ *        session redirections added: struct command *
+ * output: true if the command was a function and has been run
+ */
+bool launchFunction(struct shellState *shell, struct command *command);
+
+#endif
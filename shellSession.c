@@ -0,0 +1,168 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Implements the C API for hosting shell sessions inside
+ *              another program including:
+ *
+ *               creating a session with its own job table, exit status
+ *               and stdin, stdout and stderr for its commands
+ *               running commandlines in a session without a terminal
+ *               reaping a session's finished background jobs
+ *               destroying a session and ending its jobs
+ *
+ *  Reference: The Linux Programming Interface by Kerrisk chapters 24 - 26
+ *
+ **************************************************************************/
+
+#include "shellSession.h"
+#include "bashShell.h"  /* for the shell state and runCommandLine */
+
+/* A session is the state of one shell plus the buffer its commandlines are
+ * read into
+ */
+struct shellSession
+{
+    struct shellState shell;
+    char *buffer;  /* the line returned by getline */
+    size_t bufferSize;
+};
+
+/* Creates a session with no jobs and an exit status of 0. */
+struct shellSession *createSession(int stdinFd, int stdoutFd, int stderrFd)
+{
+    struct shellSession *session = malloc(sizeof(struct shellSession));
+
+    if (session == NULL)
+    {
+        return NULL;
+    }
+
+    initializeShell(&session->shell);
+
+    /* A session has no terminal, is read one string at a time and mustn't
+     * exec over the program hosting it
+     */
+    session->shell.input = NULL;
+    session->shell.prompt = false;
+    session->shell.parseAhead = false;
+    session->shell.embedded = true;
+
+    session->shell.stdioFds[0] = stdinFd;
+    session->shell.stdioFds[1] = stdoutFd;
+    session->shell.stdioFds[2] = stderrFd;
+
+    session->buffer = NULL;
+    session->bufferSize = 0;
+
+    return session;
+}
+
+/* Runs one or more commandlines in the session as if they were a script. */
+int runSessionLine(struct shellSession *session, char *commandLines)
+{
+    struct shellState *shell = &session->shell;
+
+    if (shell->exitRequested == true)
+    {
+        return -1;
+    }
+
+    /* fmemopen can't open an empty string */
+    if (commandLines[0] == '\0')
+    {
+        return shell->lastStatus;
+    }
+
+    /* The string is read as the shell's input so the body of a here-document
+     * comes from the lines after its commandline.
+     * Reference: https://man7.org/linux/man-pages/man3/fmemopen.3.html
+     */
+    shell->input = fmemopen(commandLines, strlen(commandLines), "r");
+    if (shell->input == NULL)
+    {
+        perror("fmemopen");
+        return -1;
+    }
+
+    while (shell->exitRequested == false
+           && getline(&session->buffer, &session->bufferSize, shell->input) >= 0)
+    {
+        /* a loop or function is run as one line up to its end, as in a script */
+        readBlockLines(shell->input, &session->buffer, &session->bufferSize, false);
+        runCommandLine(shell, session->buffer);
+    }
+
+    fclose(shell->input);
+    shell->input = NULL;
+
+    /* the output of inbuilt commands is printed before returning to the host */
+    fflush(stdout);
+
+    return shell->lastStatus;
+}
+
+/* Reaps the session's finished background jobs without blocking. */
+int pollSession(struct shellSession *session)
+{
+    if (session->shell.exitRequested == true)
+    {
+        return -1;
+    }
+
+    /* Entries scheduled with every and at run when the host polls, as
+     * they do at the prompt of the shell program
+     */
+    runDueEntries(&session->shell);
+    reapBackgroundJobs(&session->shell);
+    fflush(stdout);
+
+    return session->shell.jobs.numJobs;
+}
+
+/* Returns the exit status of the last command the session ran. */
+int sessionStatus(struct shellSession *session)
+{
+    return session->shell.lastStatus;
+}
+
+/* Ends the session's remaining jobs, reaps them and frees the session. */
+void destroySession(struct shellSession *session)
+{
+    struct jobTable *jobs = &session->shell.jobs;
+    int childExitMethod;
+    bool timedOut;
+    int i;
+
+    /* An exit already sent the jobs SIGTERM */
+    if (session->shell.exitRequested == false)
+    {
+        exitShell(&session->shell);
+    }
+
+    /* Unlike the shell program, the host goes on running, so the jobs are
+     * reaped rather than left as zombies. A job that ignores SIGTERM is sent
+     * it again and then SIGKILL by waitWithTimeout.
+     */
+    for (i = 0; i < jobs->capacity; i++)
+    {
+        if (jobs->pids[i] != BG_UNDEFINED)
+        {
+            waitWithTimeout(jobs->pids[i], &childExitMethod, TIMEOUT_KILL_AFTER,
+                            TIMEOUT_KILL_AFTER, &timedOut);
+        }
+    }
+
+    /* The copies of the jobs' output sent to several files end once the
+     * jobs have, and are finished before the host goes on
+     */
+    waitForFanOuts();
+
+    /* the job table closes the pidfds of the jobs */
+    freeJobTable(jobs);
+    freeHistory(&session->shell.history);
+    freeFunctions(&session->shell.functions);
+    freeJobMonitor(&session->shell.monitor);
+    freeSchedule(&session->shell.schedule);
+    free(session->buffer);
+    free(session);
+}
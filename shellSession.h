@@ -0,0 +1,75 @@
+/**************************************************************************
+ * Name:        Selma Leathem
+ * Date:        10/18/2026
+ * Description: Defines the C API for hosting shell sessions inside another
+ *              program including:
+ *
+ *               creating a session with its own job table, exit status
+ *               and stdin, stdout and stderr for its commands
+ *               running commandlines in a session without a terminal
+ *               reaping a session's finished background jobs
+ *               destroying a session and ending its jobs
+ *
+ *              A process can host many independent sessions. Each only
+ *              waits on its own jobs, so sessions never reap each other's
+ *              children. The messages of inbuilt commands such as status
+ *              and jobs are still printed to the process's stdout.
+ *
+ *              Link with libbashShell.a, -pthread and -lz.
+ *
+ **************************************************************************/
+
+#ifndef SHELL_SESSION_H
+#define SHELL_SESSION_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/* A shell session, which is only used through the functions below */
+struct shellSession;
+
+/* Creates a session with no jobs and an exit status of 0. Commands it runs
+ * get the given fds as stdin, stdout and stderr unless they redirect them.
+ * The fds stay owned by the caller and must stay open while the session is
+ * used.
+ * input: the stdin of the session's commands or -1 for the process's: int
+ *        the stdout of the session's commands or -1 for the process's: int
+ *        the stderr of the session's commands or -1 for the process's: int
+ * output: the session or NULL if it couldn't be created
+ */
+struct shellSession *createSession(int stdinFd, int stdoutFd, int stderrFd);
+
+/* Runs one or more commandlines in the session as if they were a script,
+ * so a here-document body can follow its commandline and a loop or a
+ * function definition can span lines, which must all be in the one call.
+ * Functions stay defined for later calls. Foreground commands are waited
+ * for before returning. exit ends the session.
+ * input: the session: struct shellSession *
+ *        the commandlines, each ended by a newline or the end of the
+ *        string: char *
+ * output: the exit status of the last command run, or -1 if the session
+ *         had already exited
+ */
+int runSessionLine(struct shellSession *session, char *commandLines);
+
+/* Launches the runs of every and at entries that are due and reaps the
+ * session's finished background jobs without blocking, printing their
+ * status as the shell does before each prompt. A host that schedules
+ * commands calls it at least as often as they should run.
+ * input: the session: struct shellSession *
+ * output: the number of jobs still running, or -1 if the session has exited
+ */
+int pollSession(struct shellSession *session);
+
+/* Returns the exit status of the last command the session ran.
+ * input: the session: struct shellSession *
+ */
+int sessionStatus(struct shellSession *session);
+
+/* Ends the session's remaining jobs with SIGTERM, and then SIGKILL if they
+ * ignore it, reaps them and frees the session.
+ * input: the session: struct shellSession *
+ */
+void destroySession(struct shellSession *session);
+
+#endif
@@ -0,0 +1,70 @@
+#!/bin/sh
+###########################################################################
+# Name:        Selma Leathem
+# Date:        10/18/2026
+# Description: Checks that commands launched by the shell start with only
+#              fds 0 - 2 and the fds they redirect, by having each one list
+#              /proc/self/fd into a file.
+#
+#              The shell is started with fd 7 open, as a shell holding a
+#              script, history or ring would be, so an fd that leaks into
+#              a command shows up in its list. The fd ls opens to read the
+#              directory is left out.
+#
+#              usage: fdCheck.sh [shell]
+#
+###########################################################################
+
+# the shell is run from the temporary directory, so its path is made absolute
+SHELL_PROGRAM=$(realpath "${1:-./bashShell}")
+DIRECTORY=$(mktemp -d)
+FAILED=0
+
+trap 'rm -rf "$DIRECTORY"' EXIT
+
+# Prints the fds in a listing of ls -l /proc/self/fd, apart from ls's own
+listedFds()
+{
+    grep -- '->' "$1" | grep -v -- '-> /proc/[0-9]*/fd' \
+        | sed 's/.* \([0-9][0-9]*\) -> .*/\1/' | sort -n | tr '\n' ' '
+}
+
+# Runs the shell with the arguments after the first, which is the fds the
+# listing in $DIRECTORY/out should show
+check()
+{
+    expected=$1
+    shift
+    rm -f "$DIRECTORY/out"
+
+    "$SHELL_PROGRAM" "$@" 7</dev/null >/dev/null 2>&1
+    actual=$(listedFds "$DIRECTORY/out")
+
+    if [ "$actual" = "$expected" ]; then
+        echo "ok    $*"
+    else
+        echo "FAIL  $*: fds $actual instead of $expected"
+        FAILED=1
+    fi
+}
+
+cd "$DIRECTORY" || exit 1
+
+printf 'ls -l /proc/self/fd > out\necho done\n' > forked.sh
+printf 'ls -l /proc/self/fd > out\n' > last.sh
+
+check "0 1 2 " -c 'ls -l /proc/self/fd > out'
+check "0 1 2 " -c 'ls -l /proc/self/fd > out; echo done'
+check "0 1 2 " -N forked.sh
+check "0 1 2 " forked.sh
+check "0 1 2 " -S forked.sh
+check "0 1 2 " last.sh
+check "0 1 2 " -L -c 'ls -l /proc/self/fd > out; echo done'
+check "0 1 2 " -c 'ls -l /proc/self/fd > out 2>&1; echo done'
+check "0 1 2 " -c 'ls -l /proc/self/fd < /dev/null > out; echo done'
+check "0 1 2 5 " -c 'ls -l /proc/self/fd > out 5> five; echo done'
+check "0 1 2 " -c 'ls -l /proc/self/fd > out > copy; echo done'
+check "0 1 2 " -c 'ls -l /proc/self/fd > out &
+wait'
+
+exit $FAILED
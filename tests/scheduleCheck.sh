@@ -0,0 +1,51 @@
+#!/bin/sh
+###########################################################################
+# Name:        Selma Leathem
+# Date:        10/18/2026
+# Description: Checks what happens to an every entry that comes due while
+#              a foreground command runs: it doesn't run during the
+#              command, runs once when it ends, and the runs it missed are
+#              counted as skipped in the listing of every.
+#
+#              An entry of every 0.1s is scheduled before a sleep of
+#              0.55s, in each way the shell reads a script.
+#
+#              usage: scheduleCheck.sh [shell]
+#
+###########################################################################
+
+# the shell is run from the temporary directory, so its path is made absolute
+SHELL_PROGRAM=$(realpath "${1:-./bashShell}")
+DIRECTORY=$(mktemp -d)
+FAILED=0
+
+trap 'rm -rf "$DIRECTORY"' EXIT
+
+# Runs the script with the options given and checks the listing of the entry
+check()
+{
+    listing=$("$SHELL_PROGRAM" "$@" every.sh 2>&1 | grep '^\[1\] every')
+    runs=$(echo "$listing" | sed -n 's/.* \([0-9][0-9]*\) runs, .*/\1/p')
+    skipped=$(echo "$listing" | sed -n 's/.* \([0-9][0-9]*\) skipped$/\1/p')
+
+    # the first run may be made before the sleep or after it with the
+    # catch up run, and one of the missed runs may fall either side
+    if [ -n "$runs" ] && [ "$runs" -ge 1 ] && [ "$runs" -le 2 ] \
+       && [ -n "$skipped" ] && [ "$skipped" -ge 3 ]; then
+        echo "ok    $* every.sh: $runs runs, $skipped skipped"
+    else
+        echo "FAIL  $* every.sh: $listing"
+        FAILED=1
+    fi
+}
+
+cd "$DIRECTORY" || exit 1
+
+printf 'every 0.1 /bin/true\nsleep 0.55\nevery\nevery -d all\n' > every.sh
+
+check -N -S
+check -S
+check -N
+check
+
+exit $FAILED